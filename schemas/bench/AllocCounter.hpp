@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+
+namespace hexarch {
+namespace bench {
+
+    // Counters maintained by the replacement operator new/delete in AllocCounter.cpp.
+    struct AllocStats {
+        std::size_t allocations;
+        std::size_t bytes;
+    };
+
+    AllocStats allocSnapshot();
+
+    inline AllocStats allocDelta(const AllocStats& before, const AllocStats& after) {
+        return { after.allocations - before.allocations, after.bytes - before.bytes };
+    }
+
+} // namespace bench
+} // namespace hexarch
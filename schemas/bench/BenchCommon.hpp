@@ -0,0 +1,53 @@
+#pragma once
+
+#include "AllocCounter.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace hexarch {
+namespace bench {
+
+    // Keeps the compiler from discarding a value computed only for measurement.
+    template <typename T>
+    inline void doNotOptimize(const T& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    struct BenchResult {
+        std::string name;
+        std::size_t iterations;
+        double nsPerOp;
+        double allocsPerOp;
+        double bytesPerOp;
+    };
+
+    // Runs fn() `iterations` times and reports wall time and heap traffic per call.
+    template <typename Fn>
+    BenchResult runBench(const std::string& name, std::size_t iterations, Fn&& fn) {
+        for (std::size_t i = 0; i < iterations / 10 + 1; ++i) {
+            fn();
+        }
+
+        const AllocStats before = allocSnapshot();
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) {
+            fn();
+        }
+        const auto end = std::chrono::steady_clock::now();
+        const AllocStats delta = allocDelta(before, allocSnapshot());
+
+        const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        return { name, iterations, ns / iterations,
+                 static_cast<double>(delta.allocations) / iterations,
+                 static_cast<double>(delta.bytes) / iterations };
+    }
+
+    inline void printResult(const BenchResult& r) {
+        std::printf("%-40s %12.1f ns/op %10.2f allocs/op %12.1f B/op\n",
+                    r.name.c_str(), r.nsPerOp, r.allocsPerOp, r.bytesPerOp);
+    }
+
+} // namespace bench
+} // namespace hexarch
@@ -0,0 +1,95 @@
+// Aggregating a large batch: iterating row models through getters (the
+// previous pattern) versus the columnar OrderBatch/ProductTable with the
+// scalar and the dispatched SIMD column kernels. Also times the row <-> column
+// conversion so the break-even point is visible.
+//
+// Build: g++ -std=c++17 -O2 -I<component src> ColumnarBench.cpp AllocCounter.cpp
+//        domain/model/{Order,Product,OrderBatch,ProductTable}.cpp
+
+#include "BenchCommon.hpp"
+
+#include "domain/model/OrderBatch.hpp"
+#include "domain/model/ProductTable.hpp"
+#include "utils/ColumnKernels.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace c_hex::domain::model;
+using namespace hexarch::bench;
+using hexarch::utils::Bitmap;
+
+namespace {
+
+    constexpr std::size_t kRows = 2000000;
+    constexpr std::size_t kIterations = 20;
+
+}
+
+int main() {
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> amount(1.0, 5000.0);
+    std::vector<Order> orders;
+    std::vector<Product> products;
+    orders.reserve(kRows);
+    products.reserve(kRows);
+    for (std::size_t i = 0; i < kRows; ++i) {
+        orders.emplace_back("ORD-" + std::to_string(i % 100000), amount(rng), static_cast<int>(rng() % 20));
+        products.emplace_back(static_cast<int>(i), "sku-" + std::to_string(i % 5000), amount(rng) / 10.0, rng() % 4 != 0);
+    }
+
+    printResult(runBench("convert/orders-to-columns", 3, [&] { doNotOptimize(OrderBatch::fromRows(orders).size()); }));
+    const OrderBatch batch = OrderBatch::fromRows(orders);
+    const ProductTable table = ProductTable::fromRows(products);
+    printResult(runBench("convert/columns-to-orders", 3, [&] { doNotOptimize(batch.toRows().size()); }));
+
+    printResult(runBench("orders/rows-sum-min-max", kIterations, [&] {
+        double sum = 0.0, lo = 1e300, hi = -1e300;
+        std::int64_t items = 0;
+        for (const Order& o : orders) {
+            sum += o.getTotalAmount();
+            lo = o.getTotalAmount() < lo ? o.getTotalAmount() : lo;
+            hi = o.getTotalAmount() > hi ? o.getTotalAmount() : hi;
+            items += o.getItemCount();
+        }
+        doNotOptimize(sum + lo + hi + static_cast<double>(items));
+    }));
+
+    const hexarch::utils::ColumnKernelSet& scalar = hexarch::utils::scalarColumnKernels();
+    printResult(runBench("orders/columns-scalar-kernels", kIterations, [&] {
+        const double* v = batch.totalAmountColumn().data();
+        const double sum = scalar.sumF64(v, batch.size()) + scalar.minF64(v, batch.size()) + scalar.maxF64(v, batch.size());
+        doNotOptimize(sum + static_cast<double>(scalar.sumI32(batch.itemCountColumn().data(), batch.size())));
+    }));
+
+    printResult(runBench("orders/columns-simd-kernels", kIterations, [&] {
+        doNotOptimize(batch.sumTotalAmount() + batch.minTotalAmount() + batch.maxTotalAmount()
+                      + static_cast<double>(batch.sumItemCount()));
+    }));
+
+    printResult(runBench("products/rows-filter-instock-sum", kIterations, [&] {
+        double sum = 0.0;
+        for (const Product& p : products) {
+            if (p.isInStock() && p.getPrice() >= 100.0 && p.getPrice() < 300.0) sum += p.getPrice();
+        }
+        doNotOptimize(sum);
+    }));
+
+    Bitmap pick(table.size());
+    printResult(runBench("products/columns-scalar-kernels", kIterations, [&] {
+        scalar.filterRangeF64(table.priceColumn().data(), table.size(), 100.0, 300.0, pick.data());
+        pick &= table.getInStock();
+        doNotOptimize(scalar.sumSelectedF64(table.priceColumn().data(), table.size(), pick.data()));
+    }));
+
+    printResult(runBench("products/columns-simd-kernels", kIterations, [&] {
+        Bitmap selection = table.filterPrice(100.0, 300.0);
+        selection &= table.getInStock();
+        doNotOptimize(table.sumPrice(selection));
+    }));
+
+    return 0;
+}
@@ -0,0 +1,117 @@
+// Publishing a high-churn entity after a small change: the whole object
+// (markAllDirty, what adapters republished before) versus the field/row
+// delta from encodeDelta, and the receiver's applyDelta. Prints bytes per
+// update next to the timings.
+//
+// Build: g++ -std=c++17 -O2 -I<component src> DeltaBench.cpp AllocCounter.cpp
+//        domain/model/{Customer,WarehouseLayout,FinancialPortfolio}.cpp
+
+#include "BenchCommon.hpp"
+
+#include "domain/model/Customer.hpp"
+#include "domain/model/FinancialPortfolio.hpp"
+#include "domain/model/WarehouseLayout.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace c_hex::domain::model;
+using namespace hexarch::bench;
+
+namespace {
+
+    constexpr std::size_t kIterations = 200;
+    constexpr std::size_t kAssets = 200;
+
+    void printBytes(const char* name, std::size_t full, std::size_t delta) {
+        std::printf("%-40s %12zu B full %10zu B delta\n", name, full, delta);
+    }
+
+}
+
+int main() {
+    std::mt19937_64 rng(42);
+    std::vector<unsigned char> buffer;
+
+    // 100 x 200 x 16 bins (~1.2 MB); each update moves stock in a few bins.
+    WarehouseLayout layout(1, "zone-a", Grid3D<int>(100, 200, 16), Grid2D<double>(100, 200, 4.0), true, "manager", 320000);
+    WarehouseLayout replica;
+    layout.encodeDelta(buffer);
+    replica.applyDelta(buffer.data(), buffer.size());
+    const std::size_t layoutFull = buffer.size();
+
+    auto touchBins = [&] {
+        layout.clearDirty();
+        for (int i = 0; i < 8; ++i) {
+            layout.setBin({ rng() % 100, rng() % 200, rng() % 16 }, static_cast<int>(rng() % 50));
+        }
+    };
+    printResult(runBench("warehouse/encode-full", kIterations, [&] {
+        touchBins();
+        layout.markAllDirty();
+        layout.encodeDelta(buffer);
+        doNotOptimize(buffer.size());
+    }));
+    printResult(runBench("warehouse/encode-delta", kIterations, [&] {
+        touchBins();
+        layout.encodeDelta(buffer);
+        doNotOptimize(buffer.size());
+    }));
+    printResult(runBench("warehouse/apply-delta", kIterations, [&] {
+        touchBins();
+        layout.encodeDelta(buffer);
+        doNotOptimize(replica.applyDelta(buffer.data(), buffer.size()));
+    }));
+    printBytes("warehouse/8-bins", layoutFull, buffer.size());
+
+    // 1000 periods x 200 assets; each update appends a period and revalues.
+    FinancialPortfolio portfolio("PF-1", "owner", 1e6);
+    std::normal_distribution<double> ret(0.0, 0.01);
+    std::vector<double> period(kAssets);
+    auto nextPeriod = [&] {
+        for (double& r : period) r = ret(rng);
+    };
+    for (int t = 0; t < 1000; ++t) {
+        nextPeriod();
+        portfolio.appendReturns(period);
+    }
+    FinancialPortfolio portfolioReplica;
+    portfolio.encodeDelta(buffer);
+    portfolioReplica.applyDelta(buffer.data(), buffer.size());
+    const std::size_t portfolioFull = buffer.size();
+
+    auto appendPeriod = [&] {
+        portfolio.clearDirty();
+        nextPeriod();
+        portfolio.appendReturns(period);
+        portfolio.setTotalValue(portfolio.getTotalValue() * 1.0001);
+    };
+    printResult(runBench("portfolio/append-encode-full", kIterations, [&] {
+        appendPeriod();
+        portfolio.markAllDirty();
+        portfolio.encodeDelta(buffer);
+        doNotOptimize(buffer.size());
+    }));
+    printResult(runBench("portfolio/append-encode-delta", kIterations, [&] {
+        appendPeriod();
+        portfolio.encodeDelta(buffer);
+        doNotOptimize(buffer.size());
+    }));
+    printBytes("portfolio/append-period", portfolioFull, buffer.size());
+
+    Customer customer(42, "Ada", "Lovelace", "ada@example.com", 36);
+    customer.encodeDelta(buffer);
+    const std::size_t customerFull = buffer.size();
+    printResult(runBench("customer/set-email-encode-delta", kIterations * 100, [&] {
+        customer.clearDirty();
+        customer.setEmail("ada@example.org");
+        customer.encodeDelta(buffer);
+        doNotOptimize(buffer.size());
+    }));
+    printBytes("customer/set-email", customerFull, buffer.size());
+
+    return 0;
+}
@@ -0,0 +1,124 @@
+// Forward-pass throughput: naive nested-vector loop versus InferenceEngine
+// (scalar, SIMD, SIMD + thread pool, float32).
+//
+// Build: g++ -std=c++17 -O2 -pthread -I<component src> InferenceBench.cpp AllocCounter.cpp
+//        domain/model/NeuralNetworkConfig.cpp domain/logic/InferenceEngine.cpp
+
+#include "BenchCommon.hpp"
+
+#include "domain/logic/InferenceEngine.hpp"
+#include "domain/model/NeuralNetworkConfig.hpp"
+#include "utils/ThreadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace c_hex::domain;
+using namespace hexarch::bench;
+
+namespace {
+
+    constexpr std::size_t kBatch = 256;
+    constexpr std::size_t kIterations = 20;
+
+    using Nested3 = std::vector<std::vector<std::vector<double>>>;
+    using Nested2 = std::vector<std::vector<double>>;
+
+    // The evaluation loop callers wrote against the old nested-vector model.
+    void naiveForward(const Nested3& w, const Nested2& b, const std::vector<double>& input,
+                      std::size_t batch, std::vector<double>& output) {
+        const std::size_t inputs = w.front().front().size();
+        const std::size_t outputs = w.back().size();
+        for (std::size_t s = 0; s < batch; ++s) {
+            std::vector<double> a(input.begin() + s * inputs, input.begin() + (s + 1) * inputs);
+            for (std::size_t l = 0; l < w.size(); ++l) {
+                std::vector<double> next(w[l].size());
+                for (std::size_t o = 0; o < w[l].size(); ++o) {
+                    double acc = b[l][o];
+                    for (std::size_t i = 0; i < a.size(); ++i) acc += w[l][o][i] * a[i];
+                    next[o] = (l + 1 == w.size()) ? acc : std::max(acc, 0.0);
+                }
+                a.swap(next);
+            }
+            std::copy(a.begin(), a.end(), output.begin() + s * outputs);
+        }
+    }
+
+    double maxDiff(const std::vector<double>& a, const std::vector<double>& b) {
+        double d = 0;
+        for (std::size_t i = 0; i < a.size(); ++i) d = std::max(d, std::fabs(a[i] - b[i]));
+        return d;
+    }
+
+    void report(const BenchResult& r, std::size_t batch) {
+        printResult(r);
+        std::printf("%-40s %12.0f rows/s\n", "", batch * 1e9 / r.nsPerOp);
+    }
+
+}
+
+int main() {
+    const std::vector<int> layers = {256, 512, 512, 10};
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> dist(-0.1, 0.1);
+
+    Nested3 w;
+    Nested2 b;
+    for (std::size_t l = 0; l + 1 < layers.size(); ++l) {
+        w.emplace_back(layers[l + 1], std::vector<double>(layers[l]));
+        for (auto& row : w.back()) for (double& v : row) v = dist(rng);
+        b.emplace_back(layers[l + 1]);
+        for (double& v : b.back()) v = dist(rng);
+    }
+
+    model::NeuralNetworkConfig config(1, layers, 0.01, "sgd");
+    config.setWeights(w);
+    config.setBiases(b);
+
+    std::vector<double> input(kBatch * layers.front());
+    for (double& v : input) v = dist(rng);
+    std::vector<double> expected(kBatch * layers.back());
+    std::vector<double> output(expected.size());
+
+    report(runBench("forward/naive-nested", kIterations, [&] {
+        naiveForward(w, b, input, kBatch, expected);
+    }), kBatch);
+
+    const logic::InferenceKernel kernels[] = {
+        logic::InferenceKernel::Scalar, logic::InferenceKernel::Auto };
+    for (logic::InferenceKernel k : kernels) {
+        logic::InferenceOptions opts;
+        opts.kernel = k;
+        logic::InferenceEngine engine(config, opts);
+        const char* name = engine.kernel() == logic::InferenceKernel::Avx512 ? "forward/engine-avx512"
+                         : engine.kernel() == logic::InferenceKernel::Avx2 ? "forward/engine-avx2"
+                         : "forward/engine-scalar";
+        report(runBench(name, kIterations, [&] { engine.forward(input.data(), kBatch, output.data()); }), kBatch);
+        std::printf("%-40s max |diff| vs naive = %g\n", "", maxDiff(expected, output));
+    }
+
+    hexarch::utils::ThreadPool pool;
+    {
+        logic::InferenceEngine engine(config, logic::InferenceOptions(), &pool);
+        report(runBench("forward/engine-simd-pool", kIterations, [&] {
+            engine.forward(input.data(), kBatch, output.data());
+        }), kBatch);
+        std::printf("%-40s max |diff| vs naive = %g\n", "", maxDiff(expected, output));
+    }
+
+    config.setPrecision(model::WeightPrecision::Float32);
+    {
+        logic::InferenceEngine engine(config, logic::InferenceOptions(), &pool);
+        std::vector<float> inputF(input.begin(), input.end());
+        std::vector<float> outputF(output.size());
+        report(runBench("forward/engine-simd-pool-f32", kIterations, [&] {
+            engine.forward(inputF.data(), kBatch, outputF.data());
+        }), kBatch);
+        std::vector<double> widened(outputF.begin(), outputF.end());
+        std::printf("%-40s max |diff| vs naive = %g\n", "", maxDiff(expected, widened));
+    }
+
+    return 0;
+}
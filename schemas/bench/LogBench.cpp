@@ -0,0 +1,103 @@
+// Per-call cost of a log statement on the calling thread: std::cout with
+// std::endl (what User::activate and the adapters did) versus HEXARCH_LOG,
+// enabled and compiled out, from one thread and from several at once. Both
+// write to /dev/null. The writer thread is parked (long poll interval, rings
+// big enough for a run) while callers are timed, so the async rows show the
+// caller's cost even on one core; "writer-drain" is the formatting cost it
+// pays later, per record.
+//
+// Build: g++ -std=c++17 -O2 -pthread -I<component src> LogBench.cpp AllocCounter.cpp
+
+#include "BenchCommon.hpp"
+
+#include "utils/AsyncLog.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hexarch::bench;
+namespace log = hexarch::utils::log;
+
+namespace {
+
+    constexpr std::size_t kIterations = 100000;
+    constexpr std::size_t kThreads = 4;
+
+    // Wall time per call when kThreads threads each make `calls` calls. Each
+    // thread makes one untimed call first (ring allocation), then all start together.
+    template <typename Fn>
+    double contended(std::size_t calls, Fn fn) {
+        std::vector<std::thread> threads;
+        std::atomic<std::size_t> ready{ 0 };
+        std::atomic<bool> go{ false };
+        for (std::size_t t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&, t] {
+                fn(t, 0);
+                ready.fetch_add(1);
+                while (!go.load()) std::this_thread::yield();
+                for (std::size_t i = 0; i < calls; ++i) fn(t, i);
+            });
+        }
+        while (ready.load() != kThreads) std::this_thread::yield();
+        const auto start = std::chrono::steady_clock::now();
+        go.store(true);
+        for (std::thread& t : threads) t.join();
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        return ns / static_cast<double>(calls);
+    }
+
+}
+
+int main() {
+    log::configure({ "/dev/null", false, std::size_t(1) << 23, std::chrono::seconds(10) });
+    std::ofstream devNull("/dev/null");
+    std::streambuf* console = std::cout.rdbuf(devNull.rdbuf());
+    const std::string username = "alice";
+
+    // Touch every page of this thread's ring once, so page faults stay out of the timings.
+    for (std::size_t i = 0; i < kIterations; ++i) {
+        HEXARCH_LOG_INFO("warm-up {}", i);
+    }
+    log::flush();
+
+    printResult(runBench("cout-endl", kIterations, [&] {
+        std::cout << "User " << username << " activated." << std::endl;
+    }));
+    printResult(runBench("async-log", kIterations, [&] {
+        HEXARCH_LOG_INFO("User {} activated.", username);
+    }));
+    const auto drainStart = std::chrono::steady_clock::now();
+    log::flush();
+    const double drainNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - drainStart).count();
+    printResult(runBench("async-log-3-args", kIterations, [&] {
+        HEXARCH_LOG_INFO("order {} total {} items {}", username, 129.95, 3);
+    }));
+    log::flush();
+    printResult(runBench("async-log-compiled-out", kIterations, [&] {
+        HEXARCH_LOG_DEBUG("User {} activated.", username);
+    }));
+
+    const double coutThreads = contended(kIterations / kThreads, [&](std::size_t, std::size_t i) {
+        std::cout << "User " << username << " activated " << i << std::endl;
+    });
+    const double logThreads = contended(kIterations / kThreads, [&](std::size_t t, std::size_t i) {
+        HEXARCH_LOG_INFO("User {} activated {} on {}", username, i, t);
+    });
+    log::flush();
+    std::cout.rdbuf(console);
+    std::printf("%-40s %12.1f ns/call per thread\n", "cout-endl/4-threads", coutThreads);
+    std::printf("%-40s %12.1f ns/call per thread\n", "async-log/4-threads", logThreads);
+    std::printf("%-40s %12.1f ns/record\n", "writer-drain", drainNs / (kIterations + kIterations / 10 + 1));
+
+    const log::LogStats stats = log::stats();
+    std::printf("async records written %llu, dropped (ring full) %llu\n",
+                static_cast<unsigned long long>(stats.records), static_cast<unsigned long long>(stats.dropped));
+    return 0;
+}
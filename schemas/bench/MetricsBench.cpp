@@ -0,0 +1,121 @@
+// Cost of instrumenting a port call: an adapter-like send() (encode 64 bytes)
+// bare, wrapped in a ScopedTimer, and timed with steady_clock into one shared
+// mutex-guarded histogram (the obvious alternative). Also kThreads threads
+// recording into the same port at once, where per-thread shards avoid any
+// sharing, and the cost of one scrape.
+//
+// Build with -DHEXARCH_METRICS=0 to check that the instrumented row matches
+// the bare one.
+//
+// Build: g++ -std=c++17 -O2 -pthread -I<component src> MetricsBench.cpp AllocCounter.cpp
+
+#include "BenchCommon.hpp"
+
+#include "utils/PortMetrics.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace hexarch::bench;
+namespace metrics = hexarch::utils::metrics;
+
+namespace {
+
+    constexpr std::size_t kIterations = 1000000;
+    constexpr std::size_t kThreads = 4;
+
+    struct Message {
+        std::array<unsigned char, 64> payload{};
+    };
+
+    // What a generated outgoing adapter does per message before the transport.
+    inline std::size_t encode(const Message& m, unsigned char* out) {
+        std::memcpy(out, m.payload.data(), m.payload.size());
+        return m.payload.size();
+    }
+
+    // One histogram for everyone, keyed by microsecond.
+    class LockedHistogram {
+    public:
+        void record(std::chrono::nanoseconds elapsed, std::size_t bytes) {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++buckets[elapsed.count() / 1000];
+            ++calls;
+            totalBytes += bytes;
+        }
+
+    private:
+        std::mutex mutex;
+        std::map<std::int64_t, std::uint64_t> buckets;
+        std::uint64_t calls = 0;
+        std::uint64_t totalBytes = 0;
+    };
+
+    template <typename Fn>
+    double contended(std::size_t calls, Fn fn) {
+        std::vector<std::thread> threads;
+        std::atomic<bool> go{ false };
+        for (std::size_t t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&] {
+                unsigned char buffer[64];
+                fn(buffer);
+                while (!go.load()) std::this_thread::yield();
+                for (std::size_t i = 0; i < calls; ++i) fn(buffer);
+            });
+        }
+        const auto start = std::chrono::steady_clock::now();
+        go.store(true);
+        for (std::thread& t : threads) t.join();
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        return ns / static_cast<double>(calls * kThreads);
+    }
+
+}
+
+int main() {
+    metrics::PortMetrics& port = metrics::port("IBenchOutgoingPort", "BenchAdapter", metrics::Direction::Outgoing);
+    LockedHistogram locked;
+    Message message;
+    unsigned char buffer[64];
+
+    printResult(runBench("send/bare", kIterations, [&] {
+        doNotOptimize(encode(message, buffer));
+    }));
+    printResult(runBench("send/scoped-timer", kIterations, [&] {
+        metrics::ScopedTimer timer(port);
+        timer.addBytes(encode(message, buffer));
+    }));
+    printResult(runBench("send/steady-clock+mutex", kIterations, [&] {
+        const auto start = std::chrono::steady_clock::now();
+        const std::size_t bytes = encode(message, buffer);
+        locked.record(std::chrono::steady_clock::now() - start, bytes);
+    }));
+
+    const std::size_t perThread = kIterations / kThreads;
+    std::printf("%-40s %12.1f ns/op\n", "threads-4/scoped-timer", contended(perThread, [&](unsigned char* out) {
+        metrics::ScopedTimer timer(port);
+        timer.addBytes(encode(message, out));
+    }));
+    std::printf("%-40s %12.1f ns/op\n", "threads-4/steady-clock+mutex", contended(perThread, [&](unsigned char* out) {
+        const auto start = std::chrono::steady_clock::now();
+        const std::size_t bytes = encode(message, out);
+        locked.record(std::chrono::steady_clock::now() - start, bytes);
+    }));
+
+    printResult(runBench("scrape", 1000, [&] {
+        doNotOptimize(metrics::scrape().size());
+    }));
+
+    for (const metrics::PortSnapshot& s : metrics::Registry::instance().snapshot()) {
+        std::printf("%s: %llu calls, p50 %.0f ns, p99 %.0f ns, p99.9 %.0f ns\n", s.port.c_str(),
+                    static_cast<unsigned long long>(s.calls), s.p50Seconds * 1e9, s.p99Seconds * 1e9, s.p999Seconds * 1e9);
+    }
+    return 0;
+}
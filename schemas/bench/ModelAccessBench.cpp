@@ -0,0 +1,96 @@
+// Per-message model access cost: by-value copies (previous getter behaviour)
+// versus const-reference views, and copy-in versus move-in setters.
+//
+// Build: g++ -std=c++17 -O2 -I<component src> ModelAccessBench.cpp AllocCounter.cpp
+//        domain/model/{Customer,FinancialPortfolio,NeuralNetworkConfig,WarehouseLayout}.cpp
+
+#include "BenchCommon.hpp"
+
+#include "domain/model/Customer.hpp"
+#include "domain/model/FinancialPortfolio.hpp"
+#include "domain/model/NeuralNetworkConfig.hpp"
+#include "domain/model/WarehouseLayout.hpp"
+
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace c_hex::domain::model;
+using namespace hexarch::bench;
+
+namespace {
+
+    constexpr std::size_t kIterations = 200000;
+
+    WarehouseLayout makeLayout() {
+        Grid3D<int> grid(8, 8, 4, 1);
+        Grid2D<double> temps(8, 8, 4.0);
+        return WarehouseLayout(1, "zone-a", std::move(grid), std::move(temps), true, "manager", 256);
+    }
+
+    NeuralNetworkConfig makeConfig() {
+        NeuralNetworkConfig cfg(1, {16, 16, 4}, 0.01, "adam");
+        cfg.setWeights({ std::vector<std::vector<double>>(16, std::vector<double>(16, 0.5)),
+                         std::vector<std::vector<double>>(4, std::vector<double>(16, 0.5)) });
+        cfg.setBiases({ std::vector<double>(16, 0.1), std::vector<double>(4, 0.1) });
+        return cfg;
+    }
+
+    FinancialPortfolio makePortfolio() {
+        FinancialPortfolio p("pf-000000000000001", "owner name long enough", 1e6);
+        p.setHistoricalReturns(Grid2D<double>(32, 16, 0.001));
+        return p;
+    }
+
+}
+
+int main() {
+    const Customer customer(42, "Firstname-long-enough", "Lastname-long-enough", "someone@example-domain.com", 30);
+    const WarehouseLayout layout = makeLayout();
+    const NeuralNetworkConfig config = makeConfig();
+    const FinancialPortfolio portfolio = makePortfolio();
+
+    printResult(runBench("getters/by-value-copy", kIterations, [&] {
+        std::string email(customer.getEmail());
+        std::string first(customer.getFirstName());
+        Grid3D<int> grid = layout.getGrid();
+        NetworkTensorF64 weights = config.getParameters();
+        Grid2D<double> returns = portfolio.getHistoricalReturns();
+        doNotOptimize(email.size() + first.size() + grid.at(0, 0, 0) + weights.weights(0)(0, 0) + returns.at(0, 0));
+    }));
+
+    printResult(runBench("getters/const-ref-view", kIterations, [&] {
+        const std::string_view email = customer.getEmail();
+        const std::string_view first = customer.getFirstName();
+        const auto& grid = layout.getGrid();
+        const auto weights = config.getWeights(0);
+        const auto& returns = portfolio.getHistoricalReturns();
+        doNotOptimize(email.size() + first.size() + grid.at(0, 0, 0) + weights(0, 0) + returns.at(0, 0));
+    }));
+
+    // A decoded message owns its buffers; the setter either copies them or steals
+    // them. Customer::setEmail assigns in place either way.
+    Customer target;
+    FinancialPortfolio sink;
+    printResult(runBench("setters/copy-in", kIterations, [&] {
+        std::string email = "decoded-address@example-domain.com";
+        Grid2D<double> returns(4, 16, 0.002);
+        const std::string& emailRef = email;
+        const auto& returnsRef = returns;
+        target.setEmail(emailRef);
+        sink.setHistoricalReturns(returnsRef);
+        doNotOptimize(target.getEmail().size());
+    }));
+
+    printResult(runBench("setters/move-in", kIterations, [&] {
+        std::string email = "decoded-address@example-domain.com";
+        Grid2D<double> returns(4, 16, 0.002);
+        target.setEmail(std::move(email));
+        sink.setHistoricalReturns(std::move(returns));
+        doNotOptimize(target.getEmail().size());
+    }));
+
+    return 0;
+}
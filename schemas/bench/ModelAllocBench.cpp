@@ -0,0 +1,155 @@
+// Model allocation per poll batch: default heap construction (the previous
+// pattern) versus building the batch in a monotonic arena, and make_unique
+// versus ObjectPool for long-lived models. Reports heap allocations per batch
+// and the p50/p99 batch latency.
+//
+// Build: g++ -std=c++17 -O2 -I<component src> ModelAllocBench.cpp AllocCounter.cpp
+//        domain/model/{Order,Customer}.cpp
+
+#include "BenchCommon.hpp"
+
+#include "domain/model/Customer.hpp"
+#include "domain/model/Order.hpp"
+#include "utils/ObjectPool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace c_hex::domain::model;
+using namespace hexarch::bench;
+
+namespace {
+
+    constexpr std::size_t kBatch = 512;
+    constexpr std::size_t kBatches = 2000;
+    constexpr std::size_t kArenaBytes = 256 * 1024;
+
+    // Fields as a decoder hands them over: views into the received buffer, all
+    // longer than the small-string buffer.
+    struct Decoded {
+        std::string orderId;
+        std::string first;
+        std::string last;
+        std::string email;
+    };
+
+    std::vector<Decoded> makeInput() {
+        std::vector<Decoded> input(kBatch);
+        for (std::size_t i = 0; i < kBatch; ++i) {
+            input[i].orderId = "ORD-2026-10-16-" + std::to_string(100000 + i);
+            input[i].first = "Firstname-" + std::to_string(i) + "-long";
+            input[i].last = "Lastname-" + std::to_string(i) + "-longer";
+            input[i].email = "customer-" + std::to_string(i) + "@example-domain.com";
+        }
+        return input;
+    }
+
+    // Runs batch() kBatches times and prints allocations and latency percentiles.
+    template <typename Fn>
+    void measure(const char* name, Fn&& batch) {
+        for (std::size_t i = 0; i < kBatches / 10; ++i) batch();
+
+        std::vector<double> ns(kBatches);
+        const AllocStats before = allocSnapshot();
+        for (std::size_t i = 0; i < kBatches; ++i) {
+            const auto start = std::chrono::steady_clock::now();
+            batch();
+            ns[i] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        }
+        const AllocStats delta = allocDelta(before, allocSnapshot());
+        std::sort(ns.begin(), ns.end());
+        std::printf("%-32s %8.1f allocs/batch %10.0f B/batch   p50 %8.1f us  p99 %8.1f us\n", name,
+                    static_cast<double>(delta.allocations) / kBatches, static_cast<double>(delta.bytes) / kBatches,
+                    ns[kBatches / 2] / 1000.0, ns[kBatches * 99 / 100] / 1000.0);
+    }
+
+    template <typename Orders, typename Customers>
+    double process(const Orders& orders, const Customers& customers) {
+        double total = 0.0;
+        for (std::size_t i = 0; i < orders.size(); ++i) {
+            total += orders[i].getTotalAmount() + static_cast<double>(customers[i].getEmail().size());
+        }
+        return total;
+    }
+
+}
+
+int main() {
+    const std::vector<Decoded> input = makeInput();
+
+    measure("batch/heap", [&] {
+        std::vector<Order> orders;
+        std::vector<Customer> customers;
+        orders.reserve(kBatch);
+        customers.reserve(kBatch);
+        for (std::size_t i = 0; i < kBatch; ++i) {
+            const Decoded& d = input[i];
+            orders.emplace_back(d.orderId, 10.0 + i, static_cast<int>(i % 7));
+            customers.emplace_back(static_cast<long>(i), d.first, d.last, d.email, 30);
+        }
+        doNotOptimize(process(orders, customers));
+    });
+
+    // One buffer reused for every batch; the resource hands out bump-pointer
+    // slices of it and releases them all when it goes out of scope.
+    std::vector<std::byte> arenaBuffer(kArenaBytes);
+    measure("batch/monotonic-arena", [&] {
+        std::pmr::monotonic_buffer_resource arena(arenaBuffer.data(), arenaBuffer.size());
+        std::pmr::vector<Order> orders(&arena);
+        std::pmr::vector<Customer> customers(&arena);
+        orders.reserve(kBatch);
+        customers.reserve(kBatch);
+        for (std::size_t i = 0; i < kBatch; ++i) {
+            const Decoded& d = input[i];
+            orders.emplace_back(d.orderId, 10.0 + i, static_cast<int>(i % 7));
+            customers.emplace_back(static_cast<long>(i), d.first, d.last, d.email, 30);
+        }
+        doNotOptimize(process(orders, customers));
+    });
+
+    // Long-lived models: a cache that evicts and admits one batch worth of customers.
+    std::vector<std::unique_ptr<Customer>> heapCache(kBatch);
+    std::size_t heapCursor = 0;
+    measure("long-lived/make_unique", [&] {
+        for (std::size_t i = 0; i < kBatch; ++i) {
+            const Decoded& d = input[i];
+            heapCache[heapCursor] = std::make_unique<Customer>(static_cast<long>(i), d.first, d.last, d.email, 30);
+            heapCursor = (heapCursor + 1) % heapCache.size();
+        }
+        doNotOptimize(heapCache[0]->getAge());
+    });
+
+    hexarch::utils::ObjectPool<Customer> pool(kBatch);
+    std::vector<hexarch::utils::ObjectPool<Customer>::Handle> pooledCache(kBatch);
+    std::size_t poolCursor = 0;
+    measure("long-lived/object-pool", [&] {
+        for (std::size_t i = 0; i < kBatch; ++i) {
+            const Decoded& d = input[i];
+            pooledCache[poolCursor].reset();
+            pooledCache[poolCursor] = pool.acquire(static_cast<long>(i), d.first, d.last, d.email, 30);
+            poolCursor = (poolCursor + 1) % pooledCache.size();
+        }
+        doNotOptimize(pooledCache[0]->getAge());
+    });
+
+    hexarch::utils::ObjectPool<Customer, std::mutex> sharedPool(kBatch);
+    std::vector<hexarch::utils::ObjectPool<Customer, std::mutex>::Handle> sharedCache(kBatch);
+    std::size_t sharedCursor = 0;
+    measure("long-lived/object-pool-mutex", [&] {
+        for (std::size_t i = 0; i < kBatch; ++i) {
+            const Decoded& d = input[i];
+            sharedCache[sharedCursor].reset();
+            sharedCache[sharedCursor] = sharedPool.acquire(static_cast<long>(i), d.first, d.last, d.email, 30);
+            sharedCursor = (sharedCursor + 1) % sharedCache.size();
+        }
+        doNotOptimize(sharedCache[0]->getAge());
+    });
+
+    return 0;
+}
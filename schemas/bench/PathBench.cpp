@@ -0,0 +1,120 @@
+// Path queries per tick: A* over the nested terrain with per-query allocation
+// versus Pathfinder (A* and jump-point search) on a shared NavGrid with a
+// reused PathArena.
+//
+// Build: g++ -std=c++17 -O2 -pthread -I<component src> PathBench.cpp AllocCounter.cpp
+//        domain/model/GameMap.cpp domain/logic/Pathfinder.cpp
+
+#include "BenchCommon.hpp"
+
+#include "domain/logic/Pathfinder.hpp"
+#include "domain/model/GameMap.hpp"
+
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace c_hex::domain;
+using namespace hexarch::bench;
+
+namespace {
+
+    constexpr int kSize = 256;
+    constexpr std::size_t kQueries = 64;
+    constexpr std::size_t kIterations = 10;
+
+    using Nested2 = std::vector<std::vector<int>>;
+
+    // The search callers wrote against the nested terrain: fresh buffers per query.
+    double naiveAStar(const Nested2& terrain, logic::GridPoint s, logic::GridPoint g) {
+        const int h = static_cast<int>(terrain.size());
+        const int w = static_cast<int>(terrain[0].size());
+        auto ok = [&](int x, int y) { return x >= 0 && y >= 0 && x < w && y < h && terrain[y][x] >= 0; };
+        auto heur = [&](int x, int y) {
+            const int dx = std::abs(x - g.x), dy = std::abs(y - g.y);
+            return std::max(dx, dy) - std::min(dx, dy) + std::sqrt(2.0) * std::min(dx, dy);
+        };
+        std::vector<std::vector<double>> cost(h, std::vector<double>(w, 1e300));
+        std::vector<std::vector<bool>> closed(h, std::vector<bool>(w, false));
+        using Entry = std::pair<double, std::pair<int, int>>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+        cost[s.y][s.x] = 0;
+        open.push({ heur(s.x, s.y), { s.x, s.y } });
+        while (!open.empty()) {
+            const auto [x, y] = open.top().second;
+            open.pop();
+            if (closed[y][x]) continue;
+            closed[y][x] = true;
+            if (x == g.x && y == g.y) return cost[y][x];
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    if ((!dx && !dy) || !ok(x + dx, y + dy)) continue;
+                    if (dx && dy && (!ok(x + dx, y) || !ok(x, y + dy))) continue;
+                    const double c = cost[y][x] + (dx && dy ? std::sqrt(2.0) : 1.0);
+                    if (c < cost[y + dy][x + dx]) {
+                        cost[y + dy][x + dx] = c;
+                        open.push({ c + heur(x + dx, y + dy), { x + dx, y + dy } });
+                    }
+                }
+            }
+        }
+        return -1;
+    }
+
+}
+
+int main() {
+    std::mt19937 rng(3);
+    Nested2 terrain(kSize, std::vector<int>(kSize, 0));
+    std::uniform_int_distribution<int> coord(0, kSize - 1);
+    // Scattered wall segments, roughly an open arena map.
+    for (int wall = 0; wall < 300; ++wall) {
+        const int x = coord(rng), y = coord(rng), len = 4 + coord(rng) % 20;
+        const bool vertical = rng() & 1;
+        for (int i = 0; i < len; ++i) {
+            const int cx = vertical ? x : std::min(kSize - 1, x + i);
+            const int cy = vertical ? std::min(kSize - 1, y + i) : y;
+            terrain[cy][cx] = -1;
+        }
+    }
+
+    std::vector<std::pair<logic::GridPoint, logic::GridPoint>> queries;
+    while (queries.size() < kQueries) {
+        const logic::GridPoint s{ coord(rng), coord(rng) }, g{ coord(rng), coord(rng) };
+        if (terrain[s.y][s.x] >= 0 && terrain[g.y][g.x] >= 0) queries.push_back({ s, g });
+    }
+
+    const model::GameMap map(1, "arena", terrain, 1, 8, true);
+    const std::shared_ptr<const logic::NavGrid> nav = logic::NavGrid::build(map);
+
+    double naiveTotal = 0;
+    printResult(runBench("path/naive-nested-astar", kIterations, [&] {
+        naiveTotal = 0;
+        for (const auto& q : queries) naiveTotal += std::max(0.0, naiveAStar(terrain, q.first, q.second));
+    }));
+
+    const logic::PathAlgorithm algorithms[] = { logic::PathAlgorithm::AStar, logic::PathAlgorithm::JumpPoint };
+    for (logic::PathAlgorithm algorithm : algorithms) {
+        const logic::Pathfinder finder(nav, algorithm);
+        logic::PathArena arena;
+        std::vector<logic::GridPoint> path;
+        double total = 0;
+        std::size_t expanded = 0;
+        printResult(runBench(algorithm == logic::PathAlgorithm::AStar ? "path/engine-astar" : "path/engine-jps",
+                             kIterations, [&] {
+            total = 0;
+            expanded = 0;
+            for (const auto& q : queries) {
+                const logic::PathResult r = finder.findPath(q.first, q.second, arena, path);
+                total += r.cost;
+                expanded += r.expanded;
+            }
+        }));
+        std::printf("%-40s total cost %.3f (naive %.3f), %zu nodes expanded\n", "", total, naiveTotal, expanded);
+    }
+
+    return 0;
+}
@@ -0,0 +1,154 @@
+// Lookups an adapter previously answered with linear scans over a vector of
+// models, against IndexedRepository's hash, ordered and bitmap indexes:
+// Customer by email, Product by price range, unpaid Invoices. Also times
+// modify() through a setter, which re-indexes the row, and checks indexes
+// whose extractor returns its key by value.
+//
+// Build: g++ -std=c++17 -O2 -pthread -I<component src> RepositoryBench.cpp AllocCounter.cpp
+//        domain/model/{Customer,Product,Invoice}.cpp
+
+#include "BenchCommon.hpp"
+
+#include "domain/model/Customer.hpp"
+#include "domain/model/Invoice.hpp"
+#include "domain/model/Product.hpp"
+#include "utils/IndexedRepository.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace c_hex::domain::model;
+using namespace hexarch::bench;
+using hexarch::utils::IndexedRepository;
+using hexarch::utils::RowId;
+
+namespace {
+
+    constexpr std::size_t kRows = 200000;
+
+    std::string emailOf(std::size_t i) { return "customer-" + std::to_string(i) + "@example-domain.com"; }
+
+}
+
+int main() {
+    std::mt19937_64 rng(7);
+
+    std::vector<Customer> customerRows;
+    IndexedRepository<Customer> customers;
+    const auto& byEmail = customers.addHashIndex([](const Customer& c) { return c.getEmail(); });
+    customers.addHashIndex([](const Customer& c) { return c.getCustomerId(); });
+    for (std::size_t i = 0; i < kRows; ++i) {
+        customerRows.emplace_back(static_cast<long>(i), "First", "Last", emailOf(i), 20 + static_cast<int>(i % 60));
+        customers.insert(customerRows.back());
+    }
+
+    std::vector<std::string> probes;
+    for (std::size_t i = 0; i < 1024; ++i) probes.push_back(emailOf(rng() % kRows));
+    std::size_t next = 0;
+
+    printResult(runBench("customer-by-email/linear-scan", 200, [&] {
+        const std::string_view email = probes[next++ % probes.size()];
+        long id = -1;
+        for (const Customer& c : customerRows) {
+            if (c.getEmail() == email) {
+                id = c.getCustomerId();
+                break;
+            }
+        }
+        doNotOptimize(id);
+    }));
+
+    printResult(runBench("customer-by-email/hash-index", 1000000, [&] {
+        long id = -1;
+        customers.find(byEmail, probes[next++ % probes.size()], [&](RowId, const Customer& c) { id = c.getCustomerId(); });
+        doNotOptimize(id);
+    }));
+
+    // An extractor that builds its key (std::string by value) must not leave
+    // the index holding views of dead temporaries: run under ASan to check.
+    {
+        IndexedRepository<Customer> copies;
+        const auto& emailCopy = copies.addHashIndex([](const Customer& c) { return std::string(c.getEmail()); });
+        const auto& emailOrder = copies.addOrderedIndex([](const Customer& c) { return std::string(c.getEmail()); });
+        for (std::size_t i = 0; i < 1000; ++i) copies.insert(customerRows[i]);
+        const std::optional<Customer> hit = copies.findOne(emailCopy, emailOf(42));
+        const std::size_t band = copies.range(emailOrder, emailOf(100), emailOf(101), [](RowId, const Customer&) {});
+        if (!hit || hit->getCustomerId() != 42 || band != 1) {
+            std::fprintf(stderr, "by-value key index returned the wrong rows\n");
+            return 1;
+        }
+        printResult(runBench("customer-by-email/hash-index-by-value-key", 100000, [&] {
+            long id = -1;
+            copies.find(emailCopy, emailOf(next++ % 1000), [&](RowId, const Customer& c) { id = c.getCustomerId(); });
+            doNotOptimize(id);
+        }));
+    }
+
+    std::vector<Product> productRows;
+    IndexedRepository<Product> products;
+    const auto& byPrice = products.addOrderedIndex([](const Product& p) { return p.getPrice(); });
+    const auto& inStock = products.addBitmapIndex([](const Product& p) { return p.isInStock(); });
+    std::uniform_real_distribution<double> price(1.0, 1000.0);
+    for (std::size_t i = 0; i < kRows; ++i) {
+        productRows.emplace_back(static_cast<int>(i), "product", price(rng), rng() % 3 != 0);
+        products.insert(productRows.back());
+    }
+
+    // A narrow band: 0.1% of the catalogue.
+    printResult(runBench("product-price-range/linear-scan", 200, [&] {
+        double sum = 0.0;
+        for (const Product& p : productRows) {
+            if (p.getPrice() >= 500.0 && p.getPrice() < 501.0) sum += p.getPrice();
+        }
+        doNotOptimize(sum);
+    }));
+
+    printResult(runBench("product-price-range/ordered-index", 20000, [&] {
+        double sum = 0.0;
+        products.range(byPrice, 500.0, 501.0, [&](RowId, const Product& p) { sum += p.getPrice(); });
+        doNotOptimize(sum);
+    }));
+
+    printResult(runBench("product-in-stock-count/linear-scan", 200, [&] {
+        std::size_t n = 0;
+        for (const Product& p : productRows) n += p.isInStock();
+        doNotOptimize(n);
+    }));
+
+    printResult(runBench("product-in-stock-count/bitmap-index", 20000, [&] { doNotOptimize(products.count(inStock)); }));
+
+    std::vector<Invoice> invoiceRows;
+    IndexedRepository<Invoice> invoices;
+    const auto& byNumber = invoices.addHashIndex([](const Invoice& inv) { return inv.getInvoiceNumber(); });
+    const auto& unpaid = invoices.addBitmapIndex([](const Invoice& inv) { return !inv.getIsPaid(); });
+    for (std::size_t i = 0; i < kRows; ++i) {
+        invoiceRows.emplace_back("INV-2026-" + std::to_string(i), "2026-10-16", i % 50 != 0);
+        invoices.insert(invoiceRows.back());
+    }
+
+    printResult(runBench("unpaid-invoices/linear-scan", 200, [&] {
+        std::size_t n = 0;
+        for (const Invoice& inv : invoiceRows) n += inv.getInvoiceNumber().size() * !inv.getIsPaid();
+        doNotOptimize(n);
+    }));
+
+    printResult(runBench("unpaid-invoices/bitmap-index", 2000, [&] {
+        std::size_t n = 0;
+        invoices.forEach(unpaid, [&](RowId, const Invoice& inv) { n += inv.getInvoiceNumber().size(); });
+        doNotOptimize(n);
+    }));
+
+    bool paid = false;
+    printResult(runBench("invoice-set-paid/modify", 200000, [&] {
+        const std::string number = "INV-2026-" + std::to_string(next++ % kRows);
+        paid = !paid;
+        invoices.modify(byNumber, number, [&](Invoice& inv) { inv.setPaid(paid); });
+    }));
+
+    return 0;
+}
@@ -0,0 +1,187 @@
+// Adapter -> domain worker hand-off: mutex + condition_variable queue versus
+// SpscRing / MpmcRing under each wait strategy, single and batched, plus a
+// ping-pong round trip for latency percentiles.
+//
+// Spin strategies need a free core per waiting thread, so they are skipped on
+// single-core hosts where every hand-off would wait out a scheduler tick.
+//
+// Build: g++ -std=c++17 -O2 -pthread -I<component src> RingBench.cpp AllocCounter.cpp
+
+#include "BenchCommon.hpp"
+
+#include "utils/RingBuffer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hexarch::bench;
+using namespace hexarch::utils;
+
+namespace {
+
+    constexpr std::size_t kItems = 1 << 18;
+    constexpr std::size_t kCapacity = 1024;
+    constexpr std::size_t kBatch = 32;
+    constexpr std::size_t kRoundTrips = 20000;
+
+    // Roughly a small decoded model: a few scalars, no heap.
+    struct Message {
+        std::uint64_t id = 0;
+        double price = 0.0;
+        std::int32_t quantity = 0;
+        std::int32_t flags = 0;
+    };
+
+    // What an adapter would write without a ring.
+    class LockedQueue {
+    public:
+        void push(Message m) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                notFull.wait(lock, [&] { return items.size() < kCapacity; });
+                items.push_back(m);
+            }
+            notEmpty.notify_one();
+        }
+
+        Message pop() {
+            Message m;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                notEmpty.wait(lock, [&] { return !items.empty(); });
+                m = items.front();
+                items.pop_front();
+            }
+            notFull.notify_one();
+            return m;
+        }
+
+    private:
+        std::mutex mutex;
+        std::condition_variable notEmpty;
+        std::condition_variable notFull;
+        std::deque<Message> items;
+    };
+
+    void report(const BenchResult& r, std::size_t items) {
+        printResult(r);
+        std::printf("%-40s %12.2f M msgs/s\n", "", items * 1e3 / r.nsPerOp);
+    }
+
+    std::uint64_t transferLocked() {
+        LockedQueue queue;
+        std::uint64_t sum = 0;
+        std::thread consumer([&] {
+            for (std::size_t i = 0; i < kItems; ++i) sum += queue.pop().id;
+        });
+        for (std::size_t i = 0; i < kItems; ++i) {
+            Message m;
+            m.id = i;
+            queue.push(m);
+        }
+        consumer.join();
+        return sum;
+    }
+
+    template <typename Ring>
+    std::uint64_t transfer(std::size_t producers, std::size_t consumers, std::size_t batch) {
+        Ring ring(kCapacity);
+        std::vector<std::uint64_t> sums(consumers, 0);
+        std::vector<std::thread> threads;
+        for (std::size_t c = 0; c < consumers; ++c) {
+            threads.emplace_back([&, c] {
+                std::vector<Message> buffer(batch);
+                std::size_t n;
+                while ((n = ring.popBatch(buffer.data(), batch)) > 0) {
+                    for (std::size_t i = 0; i < n; ++i) sums[c] += buffer[i].id;
+                }
+            });
+        }
+        std::vector<std::thread> writers;
+        const std::size_t share = kItems / producers;
+        for (std::size_t p = 0; p < producers; ++p) {
+            writers.emplace_back([&, p] {
+                std::vector<Message> buffer(batch);
+                for (std::size_t i = 0; i < share; i += batch) {
+                    const std::size_t n = std::min(batch, share - i);
+                    for (std::size_t k = 0; k < n; ++k) buffer[k].id = p * share + i + k;
+                    ring.pushBatch(buffer.data(), n);
+                }
+            });
+        }
+        for (auto& w : writers) w.join();
+        ring.close();
+        for (auto& t : threads) t.join();
+        std::uint64_t total = 0;
+        for (std::uint64_t s : sums) total += s;
+        return total;
+    }
+
+    template <typename Ring>
+    void throughput(const std::string& name, std::size_t producers, std::size_t consumers, std::size_t batch) {
+        std::uint64_t sum = 0;
+        report(runBench(name, 3, [&] { sum = transfer<Ring>(producers, consumers, batch); }), kItems);
+        doNotOptimize(sum);
+    }
+
+    // One message out and back per iteration; reports the round-trip distribution.
+    template <typename Wait>
+    void latency(const std::string& name) {
+        SpscRing<Message, Wait> ping(kCapacity);
+        SpscRing<Message, Wait> pong(kCapacity);
+        std::thread echo([&] {
+            Message m;
+            while (ping.pop(m)) pong.push(m);
+        });
+
+        std::vector<double> samples;
+        samples.reserve(kRoundTrips);
+        Message m;
+        for (std::size_t i = 0; i < kRoundTrips; ++i) {
+            m.id = i;
+            const auto start = std::chrono::steady_clock::now();
+            ping.push(m);
+            pong.pop(m);
+            samples.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+        }
+        ping.close();
+        echo.join();
+
+        std::sort(samples.begin(), samples.end());
+        const auto pct = [&](double p) { return samples[static_cast<std::size_t>(p * (samples.size() - 1))]; };
+        std::printf("%-40s p50 %10.0f ns  p99 %10.0f ns  p99.9 %10.0f ns\n",
+                    name.c_str(), pct(0.50), pct(0.99), pct(0.999));
+    }
+
+}
+
+int main() {
+    const bool spin = std::thread::hardware_concurrency() > 1;
+    std::uint64_t sum = 0;
+    report(runBench("spsc/mutex-deque", 3, [&] { sum = transferLocked(); }), kItems);
+    doNotOptimize(sum);
+
+    if (spin) throughput<SpscRing<Message, SpinWait>>("spsc/spin", 1, 1, 1);
+    throughput<SpscRing<Message, YieldWait>>("spsc/yield", 1, 1, 1);
+    throughput<SpscRing<Message, FutexWait>>("spsc/futex", 1, 1, 1);
+    if (spin) throughput<SpscRing<Message, SpinWait>>("spsc/spin-batch32", 1, 1, kBatch);
+    throughput<SpscRing<Message, YieldWait>>("spsc/yield-batch32", 1, 1, kBatch);
+    throughput<SpscRing<Message, FutexWait>>("spsc/futex-batch32", 1, 1, kBatch);
+
+    throughput<MpmcRing<Message, YieldWait>>("mpmc-2x2/yield", 2, 2, 1);
+    throughput<MpmcRing<Message, FutexWait>>("mpmc-2x2/futex", 2, 2, 1);
+    throughput<MpmcRing<Message, FutexWait>>("mpmc-2x2/futex-batch32", 2, 2, kBatch);
+
+    if (spin) latency<SpinWait>("latency/spsc-spin");
+    latency<YieldWait>("latency/spsc-yield");
+    latency<FutexWait>("latency/spsc-futex");
+
+    return 0;
+}
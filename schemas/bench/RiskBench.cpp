@@ -0,0 +1,128 @@
+// End-of-day risk recomputation: naive nested-vector covariance versus
+// RiskEngine (scalar, SIMD, SIMD + pool across portfolios), and a full
+// recompute versus the incremental appendReturns() update.
+//
+// Build: g++ -std=c++17 -O2 -pthread -I<component src> RiskBench.cpp AllocCounter.cpp
+//        domain/model/FinancialPortfolio.cpp domain/logic/RiskEngine.cpp
+
+#include "BenchCommon.hpp"
+
+#include "domain/logic/RiskEngine.hpp"
+#include "domain/model/FinancialPortfolio.hpp"
+#include "utils/ThreadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace c_hex::domain;
+using namespace hexarch::bench;
+
+namespace {
+
+    constexpr std::size_t kPortfolios = 256;
+    constexpr std::size_t kAssets = 64;
+    constexpr std::size_t kPeriods = 252;
+    constexpr std::size_t kIterations = 5;
+
+    using Nested2 = std::vector<std::vector<double>>;
+
+    // The covariance loop callers wrote against the nested-vector model.
+    std::vector<std::vector<float>> naiveCovariance(const Nested2& returns) {
+        const std::size_t periods = returns.size();
+        const std::size_t assets = returns.front().size();
+        std::vector<double> means(assets, 0.0);
+        for (const auto& row : returns) {
+            for (std::size_t a = 0; a < assets; ++a) means[a] += row[a] / periods;
+        }
+        std::vector<std::vector<float>> cov(assets, std::vector<float>(assets));
+        for (std::size_t i = 0; i < assets; ++i) {
+            for (std::size_t j = 0; j < assets; ++j) {
+                double acc = 0.0;
+                for (std::size_t t = 0; t < periods; ++t) {
+                    acc += (returns[t][i] - means[i]) * (returns[t][j] - means[j]);
+                }
+                cov[i][j] = static_cast<float>(acc / (periods - 1));
+            }
+        }
+        return cov;
+    }
+
+    double maxDiff(const std::vector<std::vector<float>>& expected, const model::SymmetricMatrix<float>& actual) {
+        double d = 0;
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            for (std::size_t j = 0; j < expected.size(); ++j) {
+                d = std::max(d, std::fabs(double(expected[i][j]) - actual.at(i, j)));
+            }
+        }
+        return d;
+    }
+
+    void report(const BenchResult& r, std::size_t portfolios) {
+        printResult(r);
+        std::printf("%-40s %12.0f portfolios/s\n", "", portfolios * 1e9 / r.nsPerOp);
+    }
+
+}
+
+int main() {
+    std::mt19937 rng(11);
+    std::normal_distribution<double> dist(0.0005, 0.01);
+
+    std::vector<Nested2> nested(kPortfolios, Nested2(kPeriods, std::vector<double>(kAssets)));
+    std::vector<model::FinancialPortfolio> portfolios;
+    portfolios.reserve(kPortfolios);
+    for (std::size_t p = 0; p < kPortfolios; ++p) {
+        for (auto& row : nested[p]) for (double& v : row) v = dist(rng);
+        portfolios.emplace_back("pf-" + std::to_string(p), "owner", 1e6);
+        portfolios.back().setHistoricalReturns(nested[p]);
+        portfolios.back().setAssetAllocation(std::vector<double>(kAssets, 1.0 / kAssets));
+    }
+
+    std::vector<std::vector<std::vector<float>>> expected(kPortfolios);
+    report(runBench("risk/naive-nested", kIterations, [&] {
+        for (std::size_t p = 0; p < kPortfolios; ++p) expected[p] = naiveCovariance(nested[p]);
+    }), kPortfolios);
+
+    for (bool simd : { false, true }) {
+        logic::RiskOptions opts;
+        opts.simd = simd;
+        logic::RiskEngine engine(opts);
+        const char* name = engine.kernel() == hexarch::utils::DotKernel::Avx512 ? "risk/engine-avx512"
+                         : engine.kernel() == hexarch::utils::DotKernel::Avx2 ? "risk/engine-avx2"
+                         : "risk/engine-scalar";
+        report(runBench(name, kIterations, [&] { engine.recomputeAll(portfolios); }), kPortfolios);
+        std::printf("%-40s max |diff| vs naive = %g\n", "", maxDiff(expected[0], portfolios[0].getRiskMatrix()));
+    }
+
+    hexarch::utils::ThreadPool pool;
+    {
+        logic::RiskEngine engine(logic::RiskOptions(), &pool);
+        report(runBench("risk/engine-simd-pool", kIterations, [&] { engine.recomputeAll(portfolios); }), kPortfolios);
+        std::printf("%-40s max |diff| vs naive = %g\n", "", maxDiff(expected[0], portfolios[0].getRiskMatrix()));
+    }
+
+    // One new day of returns on a single portfolio.
+    std::vector<double> day(kAssets);
+    for (double& v : day) v = dist(rng);
+    logic::RiskEngine engine;
+    model::FinancialPortfolio full = portfolios[0];
+    model::FinancialPortfolio incremental = portfolios[0];
+    printResult(runBench("append/full-recompute", kIterations * 20, [&] {
+        model::Grid2D<double> history = full.getHistoricalReturns();
+        history.appendRow(day.data(), day.size());
+        full.setHistoricalReturns(std::move(history));
+        engine.recompute(full);
+        doNotOptimize(full.portfolioVariance());
+    }));
+    printResult(runBench("append/incremental", kIterations * 20, [&] {
+        incremental.appendReturns(day);
+        doNotOptimize(incremental.portfolioVariance());
+    }));
+    std::printf("%-40s variance full=%.10g incremental=%.10g\n", "",
+                full.portfolioVariance(), incremental.portfolioVariance());
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+// Sharing a large WarehouseLayout grid (200 x 100 x 8 bins) with reader
+// threads: taking a Versioned snapshot versus copying the grid under a mutex
+// and versus std::atomic_load of a shared_ptr; then the writer's side, one
+// setBin() alone, a batch of setBin() calls published with structural sharing
+// versus publishing a full copy, and a whole-grid setGrid() that changed one bin.
+//
+// Build: g++ -std=c++17 -O2 -pthread -I<component src> SnapshotBench.cpp AllocCounter.cpp
+//        domain/model/WarehouseLayout.cpp
+
+#include "BenchCommon.hpp"
+
+#include "domain/model/WarehouseLayout.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace c_hex::domain::model;
+using namespace hexarch::bench;
+
+namespace {
+
+    constexpr std::size_t kThreads = 4;
+
+    template <typename Fn>
+    double contended(std::size_t calls, Fn fn) {
+        std::vector<std::thread> threads;
+        std::atomic<bool> go{ false };
+        for (std::size_t t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&] {
+                fn();
+                while (!go.load()) std::this_thread::yield();
+                for (std::size_t i = 0; i < calls; ++i) fn();
+            });
+        }
+        const auto start = std::chrono::steady_clock::now();
+        go.store(true);
+        for (std::thread& t : threads) t.join();
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        return ns / static_cast<double>(calls * kThreads);
+    }
+
+}
+
+int main() {
+    WarehouseLayout layout(1, "Z1", Grid3D<int>(200, 100, 8), Grid2D<double>(200, 100, 4.0), true, "m", 160000);
+    std::mutex mutex;
+    auto shared = std::make_shared<const Grid3D<int>>(layout.getGrid());
+
+    printResult(runBench("read/snapshot", 1000000, [&] {
+        WarehouseLayout::GridSnapshot s = layout.gridSnapshot();
+        doNotOptimize(s->grid.at(10, 20, 3));
+    }));
+    printResult(runBench("read/shared_ptr-atomic_load", 1000000, [&] {
+        std::shared_ptr<const Grid3D<int>> s = std::atomic_load(&shared);
+        doNotOptimize(s->at(10, 20, 3));
+    }));
+    printResult(runBench("read/mutex+copy", 1000, [&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        Grid3D<int> copy = layout.getGrid();
+        doNotOptimize(copy.at(10, 20, 3));
+    }));
+
+    std::printf("%-40s %12.1f ns/op\n", "threads-4/snapshot", contended(250000, [&] {
+        WarehouseLayout::GridSnapshot s = layout.gridSnapshot();
+        doNotOptimize(s->grid.at(10, 20, 3));
+    }));
+    std::printf("%-40s %12.1f ns/op\n", "threads-4/shared_ptr-atomic_load", contended(250000, [&] {
+        std::shared_ptr<const Grid3D<int>> s = std::atomic_load(&shared);
+        doNotOptimize(s->at(10, 20, 3));
+    }));
+
+    int units = 0;
+    printResult(runBench("write/setBin", 100000, [&] {
+        layout.setBin({ 7, 11, 2 }, ++units & 15);
+    }));
+    printResult(runBench("write/setBin-x8+publish", 100000, [&] {
+        for (std::size_t i = 0; i < 8; ++i) {
+            layout.setBin({ 7 + i * 20, 11, 2 }, ++units & 15);
+        }
+        layout.publish();
+    }));
+    printResult(runBench("write/full-copy-publish", 1000, [&] {
+        auto next = std::make_shared<Grid3D<int>>(*shared);
+        next->at(7, 11, 2) = ++units & 15;
+        std::atomic_store(&shared, std::shared_ptr<const Grid3D<int>>(std::move(next)));
+    }));
+    Grid3D<int> replacement = layout.getGrid();
+    printResult(runBench("write/setGrid-one-bin-changed", 1000, [&] {
+        replacement.at(150, 50, 4) = ++units & 15;
+        layout.setGrid(replacement);
+        layout.publish();
+    }));
+
+    WarehouseLayout::GridSnapshot before = layout.gridSnapshot();
+    layout.setBin({ 0, 0, 0 }, 1);
+    layout.publish();
+    WarehouseLayout::GridSnapshot after = layout.gridSnapshot();
+    std::printf("setBin shares %zu of %zu blocks with the previous version\n",
+                after->grid.blocks().sharedBlockCount(before->grid.blocks()), after->grid.blocks().blockCount());
+    return 0;
+}
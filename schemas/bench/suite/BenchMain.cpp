@@ -0,0 +1,8 @@
+// Entry point of the component benchmark suite; the cases register themselves
+// from the other bench/*.cpp files. See BenchSuite.hpp for the options.
+
+#include "BenchSuite.hpp"
+
+int main(int argc, char** argv) {
+    return hexarch::bench::runSuite(argc, argv);
+}
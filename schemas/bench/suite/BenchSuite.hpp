@@ -0,0 +1,413 @@
+#pragma once
+
+#include "BenchCommon.hpp"
+
+#include "utils/Span.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Registers a block of benchmarks at static-initialisation time:
+//
+//   HEXARCH_BENCH_SUITE(registerQueueBenches) {
+//       addBench("queue/spsc/push-pop", [ring] { ... });
+//   }
+#define HEXARCH_BENCH_SUITE(name)                                             \
+    static void name();                                                       \
+    static const ::hexarch::bench::SuiteRegistrar name##Registrar(&name);     \
+    static void name()
+
+namespace hexarch {
+namespace bench {
+
+    // Benchmark suite behind `make bench`: every component links its bench/*.cpp
+    // into one binary whose cases register themselves, and BenchMain.cpp calls
+    // runSuite().
+    //
+    // Each case is calibrated to run for at least minTime, then timed
+    // `repetitions` times; the median ns/op is what gets compared. Results go
+    // to stdout and, with --json, to a file. With --baseline the run is checked
+    // against an earlier JSON file: a case whose median is more than
+    // --threshold percent slower (BENCH_THRESHOLD, default 10), or which
+    // allocates more per op, is a regression and the exit status is 1.
+
+    // The instance generated model, codec and port benches run against.
+    // Specialise it in a bench/*.cpp for a model without a default
+    // constructor, or to measure a populated object rather than an empty one:
+    //
+    //   template <> struct BenchSample<model::Order> {
+    //       static constexpr bool available = true;
+    //       static model::Order make() { ... }
+    //   };
+    template <typename T>
+    struct BenchSample {
+        static constexpr bool available = std::is_default_constructible_v<T>;
+        static T make() { return T(); }
+    };
+
+    // Hides a pointer's target from the optimiser so calls through it stay virtual.
+    template <typename T>
+    inline T* opaque(T* p) {
+        asm volatile("" : "+r"(p));
+        return p;
+    }
+
+    struct SuiteCase {
+        std::string name;
+        // Performs n operations.
+        std::function<void(std::size_t n)> run;
+    };
+
+    struct SuiteResult {
+        std::string name;
+        std::size_t iterations;
+        double nsPerOp;
+        double minNsPerOp;
+        double allocsPerOp;
+        double bytesPerOp;
+    };
+
+    struct SuiteOptions {
+        std::string label;
+        std::string commit;
+        std::string jsonPath;
+        std::string baselinePath;
+        // Only cases whose name contains this.
+        std::string filter;
+        double thresholdPercent = 10.0;
+        std::size_t repetitions = 5;
+        std::chrono::milliseconds minTime{ 20 };
+    };
+
+    inline std::vector<SuiteCase>& suiteCases() {
+        static std::vector<SuiteCase> cases;
+        return cases;
+    }
+
+    struct SuiteRegistrar {
+        explicit SuiteRegistrar(void (*registerCases)()) { registerCases(); }
+    };
+
+    // A case that runs n operations itself, e.g. n hand-offs between two threads.
+    inline void addBatchBench(std::string name, std::function<void(std::size_t)> run) {
+        suiteCases().push_back({ std::move(name), std::move(run) });
+    }
+
+    // A case whose operation is one call of fn.
+    template <typename Fn>
+    void addBench(std::string name, Fn fn) {
+        addBatchBench(std::move(name), [fn](std::size_t n) mutable {
+            for (std::size_t i = 0; i < n; ++i) {
+                fn();
+            }
+        });
+    }
+
+    // Construction, copy and const getters of a model. getters(model) calls each
+    // getter once and passes the results to doNotOptimize.
+    template <typename Model, typename Getters>
+    void addModelBenches(const std::string& name, Getters getters) {
+        if constexpr (BenchSample<Model>::available) {
+            const std::string prefix = "model/" + name + "/";
+            addBench(prefix + "construct", [] {
+                Model model = BenchSample<Model>::make();
+                doNotOptimize(model);
+            });
+            const auto sample = std::make_shared<const Model>(BenchSample<Model>::make());
+            if constexpr (std::is_copy_constructible_v<Model>) {
+                addBench(prefix + "copy", [sample] {
+                    Model copy(*sample);
+                    doNotOptimize(copy);
+                });
+            }
+            addBench(prefix + "getters", [sample, getters] {
+                getters(*opaque(sample.get()));
+            });
+        }
+    }
+
+    // encodeDelta/applyDelta of a change-tracking model, with every field dirty.
+    template <typename Model>
+    void addDeltaBenches(const std::string& name) {
+        if constexpr (BenchSample<Model>::available && std::is_copy_constructible_v<Model>) {
+            const std::string prefix = "model/" + name + "/";
+            auto source = std::make_shared<Model>(BenchSample<Model>::make());
+            source->markAllDirty();
+            auto record = std::make_shared<std::vector<unsigned char>>();
+            source->encodeDelta(*record);
+            addBench(prefix + "encodeDelta", [source, out = std::vector<unsigned char>()]() mutable {
+                out.clear();
+                source->encodeDelta(out);
+                doNotOptimize(out.data());
+            });
+            addBench(prefix + "applyDelta", [record, target = *source]() mutable {
+                doNotOptimize(target.applyDelta(record->data(), record->size()));
+            });
+        }
+    }
+
+    // Encode, header-only decode, and decode plus copying the fields out, for a
+    // generated datagram codec.
+    template <typename Codec, typename Message, typename View>
+    void addCodecBenches(const std::string& name) {
+        if constexpr (BenchSample<Message>::available) {
+            const std::string prefix = "codec/" + name + "/";
+            const auto message = std::make_shared<const Message>(BenchSample<Message>::make());
+            auto buffer = std::make_shared<std::vector<unsigned char>>(Codec::kWireSize);
+            Codec::encode(*message, buffer->data(), buffer->size());
+            addBench(prefix + "encode", [message, out = std::vector<unsigned char>(Codec::kWireSize)]() mutable {
+                doNotOptimize(Codec::encode(*message, out.data(), out.size()));
+                doNotOptimize(out.data());
+            });
+            addBench(prefix + "decode", [buffer] {
+                View view;
+                doNotOptimize(Codec::decode(buffer->data(), buffer->size(), view));
+                doNotOptimize(view);
+            });
+            addBench(prefix + "decode-fields", [buffer] {
+                View view;
+                Codec::decode(buffer->data(), buffer->size(), view);
+                const Message fields = view.fields();
+                doNotOptimize(fields);
+            });
+        }
+    }
+
+    constexpr std::size_t kPortBatch = 64;
+
+    // Virtual dispatch of one model, and of a kPortBatch batch through the
+    // port's default batch method, into Sink (a final implementation of
+    // Sink::Port that only counts). one(port, model) and batch(port, span)
+    // make the calls.
+    template <typename Sink, typename One, typename Batch>
+    void addPortBenches(const std::string& name, One one, Batch batch) {
+        using Port = typename Sink::Port;
+        using Model = typename Sink::Model;
+        if constexpr (BenchSample<Model>::available && std::is_copy_constructible_v<Model>) {
+            const std::string prefix = "port/" + name + "/";
+            auto sink = std::make_shared<Sink>();
+            auto models = std::make_shared<const std::vector<Model>>(kPortBatch, BenchSample<Model>::make());
+            addBench(prefix + "dispatch", [sink, models, one] {
+                Port* port = opaque(static_cast<Port*>(sink.get()));
+                one(*port, models->front());
+            });
+            addBatchBench(prefix + "dispatch-batch", [sink, models, batch](std::size_t n) {
+                Port* port = opaque(static_cast<Port*>(sink.get()));
+                for (std::size_t done = 0; done < n; done += kPortBatch) {
+                    batch(*port, utils::Span<const Model>(models->data(), std::min(kPortBatch, n - done)));
+                }
+            });
+        }
+    }
+
+    namespace detail {
+
+        inline SuiteResult measure(const SuiteCase& c, const SuiteOptions& options) {
+            using Clock = std::chrono::steady_clock;
+            const auto timeRun = [&](std::size_t n) {
+                const auto start = Clock::now();
+                c.run(n);
+                return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            };
+
+            // Grow n until one run takes minTime; that run doubles as warm-up.
+            const double minNs = std::chrono::duration<double, std::nano>(options.minTime).count();
+            std::size_t n = 1;
+            for (double ns = timeRun(n); ns < minNs && n < (std::size_t(1) << 40);) {
+                const double scale = ns > 0.0 ? std::min(minNs * 1.2 / ns, 100.0) : 100.0;
+                n = std::max(n + 1, static_cast<std::size_t>(static_cast<double>(n) * scale));
+                ns = timeRun(n);
+            }
+
+            std::vector<double> perOp;
+            const AllocStats before = allocSnapshot();
+            for (std::size_t r = 0; r < options.repetitions; ++r) {
+                perOp.push_back(timeRun(n) / static_cast<double>(n));
+            }
+            const AllocStats delta = allocDelta(before, allocSnapshot());
+            std::sort(perOp.begin(), perOp.end());
+
+            const double ops = static_cast<double>(n * options.repetitions);
+            return { c.name, n, perOp[perOp.size() / 2], perOp.front(),
+                     static_cast<double>(delta.allocations) / ops, static_cast<double>(delta.bytes) / ops };
+        }
+
+        inline std::string jsonString(const std::string& s) {
+            std::string out = "\"";
+            for (const char ch : s) {
+                if (ch == '"' || ch == '\\') {
+                    out += '\\';
+                    out += ch;
+                } else if (static_cast<unsigned char>(ch) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", ch);
+                    out += escaped;
+                } else {
+                    out += ch;
+                }
+            }
+            return out + "\"";
+        }
+
+        inline bool writeJson(const std::string& path, const SuiteOptions& options, const std::vector<SuiteResult>& results) {
+            std::FILE* file = std::fopen(path.c_str(), "w");
+            if (!file) {
+                return false;
+            }
+            std::fprintf(file, "{\n  \"label\": %s,\n  \"commit\": %s,\n  \"timestamp\": %lld,\n  \"results\": [\n",
+                         jsonString(options.label).c_str(), jsonString(options.commit).c_str(),
+                         static_cast<long long>(std::chrono::duration_cast<std::chrono::seconds>(
+                             std::chrono::system_clock::now().time_since_epoch()).count()));
+            for (std::size_t i = 0; i < results.size(); ++i) {
+                const SuiteResult& r = results[i];
+                std::fprintf(file,
+                             "    {\"name\": %s, \"iterations\": %zu, \"ns_per_op\": %.3f, \"min_ns_per_op\": %.3f, "
+                             "\"allocs_per_op\": %.4f, \"bytes_per_op\": %.2f}%s\n",
+                             jsonString(r.name).c_str(), r.iterations, r.nsPerOp, r.minNsPerOp,
+                             r.allocsPerOp, r.bytesPerOp, i + 1 < results.size() ? "," : "");
+            }
+            std::fprintf(file, "  ]\n}\n");
+            return std::fclose(file) == 0;
+        }
+
+        // Reads the results of a file written by writeJson(); not a general JSON parser.
+        inline std::map<std::string, SuiteResult> readJson(const std::string& path) {
+            std::ifstream file(path);
+            std::stringstream text;
+            text << file.rdbuf();
+            const std::string s = text.str();
+
+            const auto number = [&](std::size_t from, std::size_t to, const char* key) {
+                const std::size_t at = s.find(key, from);
+                return at < to ? std::strtod(s.c_str() + at + std::strlen(key), nullptr) : 0.0;
+            };
+
+            std::map<std::string, SuiteResult> out;
+            for (std::size_t at = s.find("{\"name\": \""); at != std::string::npos; at = s.find("{\"name\": \"", at + 1)) {
+                const std::size_t end = s.find('}', at);
+                std::string name;
+                for (std::size_t i = at + 10; i < s.size() && s[i] != '"'; ++i) {
+                    if (s[i] == '\\' && i + 1 < s.size()) ++i;
+                    name += s[i];
+                }
+                SuiteResult r{ name, 0, number(at, end, "\"ns_per_op\": "), number(at, end, "\"min_ns_per_op\": "),
+                               number(at, end, "\"allocs_per_op\": "), number(at, end, "\"bytes_per_op\": ") };
+                out[name] = r;
+            }
+            return out;
+        }
+
+        inline std::size_t compare(const std::vector<SuiteResult>& results, const std::map<std::string, SuiteResult>& baseline,
+                                   double thresholdPercent) {
+            std::size_t regressions = 0;
+            std::printf("\n%-48s %12s %12s %9s\n", "compared with baseline", "before", "after", "change");
+            for (const SuiteResult& r : results) {
+                const auto it = baseline.find(r.name);
+                if (it == baseline.end()) {
+                    std::printf("%-48s %12s %12.1f %9s\n", r.name.c_str(), "-", r.nsPerOp, "new");
+                    continue;
+                }
+                const SuiteResult& b = it->second;
+                const double change = b.nsPerOp > 0.0 ? (r.nsPerOp / b.nsPerOp - 1.0) * 100.0 : 0.0;
+                // Allocation counts are deterministic, so any growth beyond rounding counts.
+                const bool slower = change > thresholdPercent;
+                const bool allocates = r.allocsPerOp > b.allocsPerOp + 0.01;
+                const char* verdict = slower ? "  REGRESSION" : allocates ? "  REGRESSION (allocs/op)" : "";
+                std::printf("%-48s %12.1f %12.1f %+8.1f%%%s\n", r.name.c_str(), b.nsPerOp, r.nsPerOp, change, verdict);
+                if (slower || allocates) {
+                    ++regressions;
+                }
+            }
+            return regressions;
+        }
+
+        inline bool parseArgs(int argc, char** argv, SuiteOptions& options) {
+            if (const char* env = std::getenv("BENCH_THRESHOLD")) {
+                options.thresholdPercent = std::atof(env);
+            }
+            for (int i = 1; i < argc; ++i) {
+                const std::string arg = argv[i];
+                if (i + 1 >= argc) {
+                    std::fprintf(stderr, "BenchSuite: %s needs a value\n", arg.c_str());
+                    return false;
+                }
+                const char* value = argv[++i];
+                if (arg == "--label") options.label = value;
+                else if (arg == "--commit") options.commit = value;
+                else if (arg == "--json") options.jsonPath = value;
+                else if (arg == "--baseline") options.baselinePath = value;
+                else if (arg == "--filter") options.filter = value;
+                else if (arg == "--threshold") options.thresholdPercent = std::atof(value);
+                else if (arg == "--repetitions") options.repetitions = std::max<std::size_t>(1, std::strtoul(value, nullptr, 10));
+                else if (arg == "--min-time-ms") options.minTime = std::chrono::milliseconds(std::strtoul(value, nullptr, 10));
+                else {
+                    std::fprintf(stderr, "BenchSuite: unknown option %s\n", arg.c_str());
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    } // namespace detail
+
+    // Runs every registered case. Exit status: 0, 1 on a regression against
+    // the baseline, 2 on bad arguments or an unwritable/unreadable file.
+    inline int runSuite(int argc, char** argv) {
+        SuiteOptions options;
+        if (!detail::parseArgs(argc, argv, options)) {
+            std::fprintf(stderr, "usage: %s [--json out.json] [--baseline before.json] [--threshold percent]\n"
+                                 "       [--filter text] [--repetitions n] [--min-time-ms n] [--label name] [--commit id]\n",
+                         argv[0]);
+            return 2;
+        }
+
+        std::vector<SuiteCase> cases = suiteCases();
+        std::sort(cases.begin(), cases.end(), [](const SuiteCase& a, const SuiteCase& b) { return a.name < b.name; });
+
+        std::vector<SuiteResult> results;
+        for (const SuiteCase& c : cases) {
+            if (!options.filter.empty() && c.name.find(options.filter) == std::string::npos) {
+                continue;
+            }
+            results.push_back(detail::measure(c, options));
+            const SuiteResult& r = results.back();
+            std::printf("%-48s %12.1f ns/op %10.2f allocs/op %12.1f B/op\n",
+                        r.name.c_str(), r.nsPerOp, r.allocsPerOp, r.bytesPerOp);
+            std::fflush(stdout);
+        }
+
+        if (!options.jsonPath.empty() && !detail::writeJson(options.jsonPath, options, results)) {
+            std::fprintf(stderr, "BenchSuite: cannot write %s\n", options.jsonPath.c_str());
+            return 2;
+        }
+
+        if (options.baselinePath.empty()) {
+            return 0;
+        }
+        const std::map<std::string, SuiteResult> baseline = detail::readJson(options.baselinePath);
+        if (baseline.empty()) {
+            std::fprintf(stderr, "BenchSuite: no results in baseline %s\n", options.baselinePath.c_str());
+            return 2;
+        }
+        const std::size_t regressions = detail::compare(results, baseline, options.thresholdPercent);
+        if (regressions > 0) {
+            std::printf("\n%zu regression(s) beyond %.1f%%\n", regressions, options.thresholdPercent);
+            return 1;
+        }
+        return 0;
+    }
+
+} // namespace bench
+} // namespace hexarch
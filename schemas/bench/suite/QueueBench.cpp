@@ -0,0 +1,92 @@
+// Adapter -> domain worker hand-off through SpscRing / MpmcRing: the cost of
+// one push and pop on a single thread, and per message when a producer and
+// consumer thread pass n messages, singly and in batches of 32.
+//
+// Spin waits are left out: on a host with fewer free cores than waiting
+// threads their numbers measure the scheduler, not the ring.
+
+#include "BenchSuite.hpp"
+
+#include "utils/RingBuffer.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hexarch::bench;
+using namespace hexarch::utils;
+
+namespace {
+
+    constexpr std::size_t kCapacity = 1024;
+    constexpr std::size_t kBatch = 32;
+
+    // Roughly a small decoded model: a few scalars, no heap.
+    struct Message {
+        std::uint64_t id = 0;
+        double price = 0.0;
+        std::int32_t quantity = 0;
+        std::int32_t flags = 0;
+    };
+
+    template <typename Ring>
+    void addPushPop(const std::string& name) {
+        auto ring = std::make_shared<Ring>(kCapacity);
+        addBench(name, [ring] {
+            Message m;
+            ring->tryPush(m);
+            ring->tryPop(m);
+            doNotOptimize(m);
+        });
+    }
+
+    // n messages from `producers` threads to `consumers` threads, `batch` at a time.
+    template <typename Ring>
+    void addHandoff(const std::string& name, std::size_t producers, std::size_t consumers, std::size_t batch) {
+        addBatchBench(name, [=](std::size_t n) {
+            Ring ring(kCapacity);
+            std::vector<std::thread> threads;
+            for (std::size_t c = 0; c < consumers; ++c) {
+                threads.emplace_back([&] {
+                    std::vector<Message> buffer(batch);
+                    std::uint64_t sum = 0;
+                    std::size_t got;
+                    while ((got = ring.popBatch(buffer.data(), batch)) > 0) {
+                        for (std::size_t i = 0; i < got; ++i) sum += buffer[i].id;
+                    }
+                    doNotOptimize(sum);
+                });
+            }
+            std::vector<std::thread> writers;
+            for (std::size_t p = 0; p < producers; ++p) {
+                const std::size_t share = n / producers + (p < n % producers ? 1 : 0);
+                writers.emplace_back([&, share] {
+                    std::vector<Message> buffer(batch);
+                    for (std::size_t i = 0; i < share; i += batch) {
+                        const std::size_t count = std::min(batch, share - i);
+                        for (std::size_t k = 0; k < count; ++k) buffer[k].id = i + k;
+                        ring.pushBatch(buffer.data(), count);
+                    }
+                });
+            }
+            for (auto& w : writers) w.join();
+            ring.close();
+            for (auto& t : threads) t.join();
+        });
+    }
+
+}
+
+HEXARCH_BENCH_SUITE(registerQueueBenches) {
+    addPushPop<SpscRing<Message>>("queue/spsc/push-pop");
+    addPushPop<MpmcRing<Message>>("queue/mpmc/push-pop");
+
+    addHandoff<SpscRing<Message, YieldWait>>("queue/spsc/handoff-yield", 1, 1, 1);
+    addHandoff<SpscRing<Message, FutexWait>>("queue/spsc/handoff-futex", 1, 1, 1);
+    addHandoff<SpscRing<Message, FutexWait>>("queue/spsc/handoff-futex-batch32", 1, 1, kBatch);
+    addHandoff<MpmcRing<Message, FutexWait>>("queue/mpmc-2x2/handoff-futex", 2, 2, 1);
+    addHandoff<MpmcRing<Message, FutexWait>>("queue/mpmc-2x2/handoff-futex-batch32", 2, 2, kBatch);
+}
@@ -0,0 +1,47 @@
+# Benchmark suite, included by the component Makefile.
+#
+#   make bench                 build and run bench/*.cpp, write $(BENCH_JSON),
+#                              compare with $(BENCH_BASELINE) when it exists
+#   make bench-baseline        record the current numbers as the baseline
+#
+# The suite links bench/*.cpp with the component's own objects (everything
+# but main) of the current BUILD, release unless given, so it measures the
+# code exactly as make release ships it. A run fails when a case is more
+# than BENCH_THRESHOLD percent slower than the baseline. Regenerate
+# bench/GeneratedBench.cpp with "Generate Benchmarks" after changing models,
+# codecs or ports.
+
+BENCH_DIR = bench
+BENCH_SOURCES = $(wildcard $(BENCH_DIR)/*.cpp)
+BENCH_OBJECTS = $(BENCH_SOURCES:%.cpp=$(OBJ_DIR)/%.o) $(LIB_OBJECTS)
+BENCH_TARGET = $(BUILD_DIR)/$(PROJECT_NAME)_bench
+
+BENCH_COMMIT := $(shell git rev-parse --short HEAD 2>/dev/null)
+BENCH_JSON ?= $(BUILD_DIR)/bench-$(or $(BENCH_COMMIT),local).json
+BENCH_BASELINE ?= $(BENCH_DIR)/baseline.json
+BENCH_THRESHOLD ?= 10
+# Extra options, e.g. BENCH_ARGS="--filter queue/ --repetitions 9"
+BENCH_ARGS ?=
+BENCH_RUN = $(BENCH_TARGET) --label $(PROJECT_NAME) --commit "$(BENCH_COMMIT)" --threshold $(BENCH_THRESHOLD) $(BENCH_ARGS)
+
+bench: $(BENCH_TARGET)
+	@echo "Running benchmarks for $(PROJECT_NAME) ($(BUILD))..."
+	$(BENCH_RUN) --json $(BENCH_JSON) $(if $(wildcard $(BENCH_BASELINE)),--baseline $(BENCH_BASELINE))
+
+bench-baseline: $(BENCH_TARGET)
+	$(BENCH_RUN) --json $(BENCH_BASELINE)
+
+bench-build: $(BENCH_TARGET)
+
+$(BENCH_TARGET): $(BENCH_OBJECTS) $(LINK_STAMP)
+	@mkdir -p $(BUILD_DIR)
+	@echo "Linking $(PROJECT_NAME)_bench ($(BUILD))..."
+	$(CXX) $(BENCH_OBJECTS) -o $@ $(LDFLAGS)
+
+bench-clean:
+	@rm -rf obj/*/$(BENCH_DIR)
+	@rm -f $(BENCH_TARGET)
+
+clean: bench-clean
+
+.PHONY: bench bench-baseline bench-build bench-clean
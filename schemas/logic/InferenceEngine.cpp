@@ -0,0 +1,197 @@
+#include "InferenceEngine.hpp"
+#include "utils/SimdDot.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <new>
+#include <stdexcept>
+
+namespace c_hex {
+namespace domain {
+namespace logic {
+
+    namespace {
+
+        using hexarch::utils::DotKernel;
+        using hexarch::utils::DotTileFn;
+        using hexarch::utils::kDotTile;
+
+        DotKernel toDotKernel(InferenceKernel kernel) {
+            switch (kernel) {
+                case InferenceKernel::Avx512: return DotKernel::Avx512;
+                case InferenceKernel::Avx2: return DotKernel::Avx2;
+                default: return DotKernel::Scalar;
+            }
+        }
+
+        InferenceKernel resolveKernel(InferenceKernel requested) {
+            switch (requested) {
+                case InferenceKernel::Auto:
+                    switch (hexarch::utils::bestDotKernel()) {
+                        case DotKernel::Avx512: return InferenceKernel::Avx512;
+                        case DotKernel::Avx2: return InferenceKernel::Avx2;
+                        case DotKernel::Scalar: return InferenceKernel::Scalar;
+                    }
+                    return InferenceKernel::Scalar;
+                case InferenceKernel::Avx512:
+                    if (!hexarch::utils::dotKernelSupported(DotKernel::Avx512)) {
+                        throw std::runtime_error("InferenceEngine: AVX-512 not supported on this CPU");
+                    }
+                    return requested;
+                case InferenceKernel::Avx2:
+                    if (!hexarch::utils::dotKernelSupported(DotKernel::Avx2)) {
+                        throw std::runtime_error("InferenceEngine: AVX2/FMA not supported on this CPU");
+                    }
+                    return requested;
+                case InferenceKernel::Scalar:
+                    return requested;
+            }
+            return InferenceKernel::Scalar;
+        }
+
+        template <typename T>
+        void activate(Activation act, T* v, std::size_t n) {
+            switch (act) {
+                case Activation::Identity:
+                    break;
+                case Activation::Relu:
+                    for (std::size_t i = 0; i < n; ++i) v[i] = v[i] > T() ? v[i] : T();
+                    break;
+                case Activation::Sigmoid:
+                    for (std::size_t i = 0; i < n; ++i) v[i] = T(1) / (T(1) + std::exp(-v[i]));
+                    break;
+                case Activation::Tanh:
+                    for (std::size_t i = 0; i < n; ++i) v[i] = std::tanh(v[i]);
+                    break;
+            }
+        }
+
+        // Two ping-pong activation tiles of kDotTile rows, each row padded and 64-byte aligned.
+        template <typename T>
+        class Scratch {
+        public:
+            Scratch(std::size_t width) : width(width) {
+                const std::size_t elements = 2 * kDotTile * width;
+                data = static_cast<T*>(::operator new(elements * sizeof(T), std::align_val_t(64)));
+                std::fill(data, data + elements, T());
+            }
+            ~Scratch() { ::operator delete(data, std::align_val_t(64)); }
+            Scratch(const Scratch&) = delete;
+            Scratch& operator=(const Scratch&) = delete;
+
+            T* row(std::size_t buffer, std::size_t r) { return data + (buffer * kDotTile + r) * width; }
+
+        private:
+            std::size_t width;
+            T* data;
+        };
+
+    }
+
+    InferenceEngine::InferenceEngine(const model::NeuralNetworkConfig& config,
+                                     InferenceOptions options,
+                                     hexarch::utils::ThreadPool* pool)
+        : config(config), options(options), pool(pool), resolved(resolveKernel(options.kernel)) {
+        if (config.getLayerSizes().size() < 2) {
+            throw std::invalid_argument("InferenceEngine: config has no layers");
+        }
+    }
+
+    // From layerSizes, which holds for either stored precision
+    std::size_t InferenceEngine::inputSize() const { return static_cast<std::size_t>(config.getLayerSizes().front()); }
+
+    std::size_t InferenceEngine::outputSize() const { return static_cast<std::size_t>(config.getLayerSizes().back()); }
+
+    InferenceKernel InferenceEngine::kernel() const { return resolved; }
+
+    void InferenceEngine::forward(const double* input, std::size_t batch, double* output) const {
+        if (config.getPrecision() == model::WeightPrecision::Float32) {
+            run(config.getParametersF32(), input, batch, output);
+        } else {
+            run(config.getParameters(), input, batch, output);
+        }
+    }
+
+    void InferenceEngine::forward(const float* input, std::size_t batch, float* output) const {
+        if (config.getPrecision() == model::WeightPrecision::Float32) {
+            run(config.getParametersF32(), input, batch, output);
+        } else {
+            run(config.getParameters(), input, batch, output);
+        }
+    }
+
+    template <typename T, typename In, typename Out>
+    void InferenceEngine::run(const model::NetworkTensor<T>& tensor, const In* input, std::size_t batch, Out* output) const {
+        if (pool && batch > options.rowsPerTask) {
+            pool->parallelFor(0, batch, options.rowsPerTask, [&](std::size_t begin, std::size_t end) {
+                runRows(tensor, input, begin, end, output);
+            });
+        } else {
+            runRows(tensor, input, 0, batch, output);
+        }
+    }
+
+    template <typename T, typename In, typename Out>
+    void InferenceEngine::runRows(const model::NetworkTensor<T>& tensor, const In* input,
+                                  std::size_t begin, std::size_t end, Out* output) const {
+        const std::size_t layers = tensor.layerCount();
+        const std::size_t inputs = tensor.inputSize(0);
+        const std::size_t outputs = tensor.outputSize(layers - 1);
+
+        std::size_t width = tensor.weights(0).stride;
+        for (std::size_t l = 0; l < layers; ++l) {
+            width = std::max(width, tensor.weights(l).stride);
+            width = std::max(width, (tensor.outputSize(l) + model::NetworkTensor<T>::kLane - 1)
+                                    / model::NetworkTensor<T>::kLane * model::NetworkTensor<T>::kLane);
+        }
+        Scratch<T> scratch(width);
+        const DotTileFn<T> dot = hexarch::utils::selectDotTile<T>(toDotKernel(resolved));
+
+        for (std::size_t row = begin; row < end; row += kDotTile) {
+            const std::size_t count = std::min(kDotTile, end - row);
+            std::size_t cur = 0;
+
+            for (std::size_t j = 0; j < count; ++j) {
+                const In* src = input + (row + j) * inputs;
+                T* dst = scratch.row(cur, j);
+                std::fill(dst, dst + width, T());
+                std::transform(src, src + inputs, dst, [](In v) { return static_cast<T>(v); });
+            }
+
+            for (std::size_t l = 0; l < layers; ++l) {
+                const model::MatrixView<const T> w = tensor.weights(l);
+                const model::VectorView<const T> b = tensor.biases(l);
+                const std::size_t next = cur ^ 1;
+
+                const T* x[kDotTile];
+                for (std::size_t j = 0; j < count; ++j) {
+                    x[j] = scratch.row(cur, j);
+                    std::fill(scratch.row(next, j), scratch.row(next, j) + width, T());
+                }
+
+                T acc[kDotTile];
+                for (std::size_t o = 0; o < w.rows; ++o) {
+                    dot(w.row(o), x, w.stride, count, acc);
+                    for (std::size_t j = 0; j < count; ++j) {
+                        scratch.row(next, j)[o] = acc[j] + b[o];
+                    }
+                }
+
+                const Activation act = (l + 1 == layers) ? options.output : options.hidden;
+                for (std::size_t j = 0; j < count; ++j) {
+                    activate(act, scratch.row(next, j), w.rows);
+                }
+                cur = next;
+            }
+
+            for (std::size_t j = 0; j < count; ++j) {
+                const T* src = scratch.row(cur, j);
+                std::transform(src, src + outputs, output + (row + j) * outputs,
+                               [](T v) { return static_cast<Out>(v); });
+            }
+        }
+    }
+
+}
+}
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "domain/model/NeuralNetworkConfig.hpp"
+#include "utils/ThreadPool.hpp"
+
+#include <cstddef>
+
+namespace c_hex {
+namespace domain {
+namespace logic {
+
+    enum class Activation { Identity, Relu, Sigmoid, Tanh };
+
+    // Dot-product kernel family. Auto picks the widest one the CPU supports.
+    enum class InferenceKernel { Auto, Scalar, Avx2, Avx512 };
+
+    struct InferenceOptions {
+        Activation hidden = Activation::Relu;
+        Activation output = Activation::Identity;
+        InferenceKernel kernel = InferenceKernel::Auto;
+        // Batch rows per pool task; smaller batches run on the calling thread.
+        std::size_t rowsPerTask = 16;
+    };
+
+    // Batched forward pass over a NeuralNetworkConfig:
+    //   a[l + 1] = act(W[l] * a[l] + b[l])
+    // Inputs are batch x layerSizes.front() and outputs batch x layerSizes.back(),
+    // both dense row-major. The engine reads the config's tensor in place, in
+    // the precision the config stores, so the config must outlive it and must
+    // not be modified while forward() runs.
+    class InferenceEngine {
+    public:
+        InferenceEngine(const model::NeuralNetworkConfig& config,
+                        InferenceOptions options = InferenceOptions(),
+                        hexarch::utils::ThreadPool* pool = nullptr);
+
+        std::size_t inputSize() const;
+        std::size_t outputSize() const;
+        InferenceKernel kernel() const;
+
+        void forward(const double* input, std::size_t batch, double* output) const;
+        void forward(const float* input, std::size_t batch, float* output) const;
+
+    private:
+        template <typename T, typename In, typename Out>
+        void run(const model::NetworkTensor<T>& tensor, const In* input, std::size_t batch, Out* output) const;
+
+        template <typename T, typename In, typename Out>
+        void runRows(const model::NetworkTensor<T>& tensor, const In* input,
+                     std::size_t begin, std::size_t end, Out* output) const;
+
+        const model::NeuralNetworkConfig& config;
+        InferenceOptions options;
+        hexarch::utils::ThreadPool* pool;
+        InferenceKernel resolved;
+    };
+
+}
+}
+}
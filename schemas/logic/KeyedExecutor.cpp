@@ -0,0 +1,186 @@
+#include "KeyedExecutor.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace c_hex {
+namespace domain {
+namespace logic {
+
+    KeyedExecutor::KeyedExecutor(KeyedExecutorOptions options)
+        : burst(std::max<std::size_t>(options.burst, 1)), onError(std::move(options.onError)) {
+        const std::size_t workerCount = std::max<std::size_t>(options.workers, 1);
+        const std::size_t shardCount = std::max(options.shards, workerCount);
+        shards.reserve(shardCount);
+        for (std::size_t s = 0; s < shardCount; ++s) {
+            shards.push_back(std::make_unique<Shard>());
+        }
+        workers.reserve(workerCount);
+        for (std::size_t w = 0; w < workerCount; ++w) {
+            workers.push_back(std::make_unique<Worker>());
+        }
+        for (std::size_t w = 0; w < workerCount; ++w) {
+            workers[w]->thread = std::thread([this, w] { workerLoop(w); });
+        }
+    }
+
+    KeyedExecutor::~KeyedExecutor() {
+        waitIdle();
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        sleepCv.notify_all();
+        for (auto& worker : workers) {
+            worker->thread.join();
+        }
+    }
+
+    void KeyedExecutor::submit(std::uint64_t keyHash, Task task) {
+        pending.fetch_add(1, std::memory_order_relaxed);
+        const std::size_t index = static_cast<std::size_t>(mix(keyHash) % shards.size());
+        Shard& shard = *shards[index];
+        bool wasIdle;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.tasks.push_back(std::move(task));
+            wasIdle = !shard.scheduled;
+            shard.scheduled = true;
+        }
+        if (wasIdle) {
+            schedule(index, index % workers.size());
+        }
+    }
+
+    void KeyedExecutor::waitIdle() {
+        std::unique_lock<std::mutex> lock(idleMutex);
+        idleCv.wait(lock, [this] { return pending.load(std::memory_order_acquire) == 0; });
+    }
+
+    std::vector<WorkerStats> KeyedExecutor::stats() const {
+        std::vector<WorkerStats> out;
+        out.reserve(workers.size());
+        for (const auto& worker : workers) {
+            WorkerStats s{ 0, 0, worker->executed.load(std::memory_order_relaxed),
+                           worker->failed.load(std::memory_order_relaxed),
+                           worker->steals.load(std::memory_order_relaxed),
+                           worker->stolen.load(std::memory_order_relaxed) };
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            s.queuedKeys = worker->ready.size();
+            for (std::size_t index : worker->ready) {
+                std::lock_guard<std::mutex> shardLock(shards[index]->mutex);
+                s.queueDepth += shards[index]->tasks.size();
+            }
+            out.push_back(s);
+        }
+        return out;
+    }
+
+    // Counted before it is queued, so a taker can never drive readyKeys below zero.
+    void KeyedExecutor::schedule(std::size_t shard, std::size_t worker) {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            ++readyKeys;
+        }
+        {
+            std::lock_guard<std::mutex> lock(workers[worker]->mutex);
+            workers[worker]->ready.push_back(shard);
+        }
+        sleepCv.notify_one();
+    }
+
+    // Own run queue from the front (oldest first), then other workers' from the
+    // back, so a thief takes the key queue its owner would reach last.
+    bool KeyedExecutor::take(std::size_t self, std::size_t& shard) {
+        Worker& own = *workers[self];
+        {
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.ready.empty()) {
+                shard = own.ready.front();
+                own.ready.pop_front();
+                return true;
+            }
+        }
+        for (std::size_t i = 1; i < workers.size(); ++i) {
+            Worker& victim = *workers[(self + i) % workers.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.ready.empty()) {
+                shard = victim.ready.back();
+                victim.ready.pop_back();
+                victim.stolen.fetch_add(1, std::memory_order_relaxed);
+                own.steals.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void KeyedExecutor::runShard(std::size_t self, std::size_t index) {
+        Shard& shard = *shards[index];
+        std::vector<Task> batch;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            const std::size_t n = std::min(burst, shard.tasks.size());
+            batch.reserve(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                batch.push_back(std::move(shard.tasks.front()));
+                shard.tasks.pop_front();
+            }
+        }
+
+        // A throwing task must not take the worker down: pending would never
+        // reach zero and waitIdle() would hang.
+        for (Task& task : batch) {
+            try {
+                task();
+            } catch (...) {
+                workers[self]->failed.fetch_add(1, std::memory_order_relaxed);
+                if (onError) {
+                    try {
+                        onError(std::current_exception());
+                    } catch (...) {
+                    }
+                }
+            }
+        }
+        workers[self]->executed.fetch_add(batch.size(), std::memory_order_relaxed);
+
+        bool more;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            more = !shard.tasks.empty();
+            shard.scheduled = more;
+        }
+        // Still the only holder of the key queue, so requeueing keeps its order.
+        if (more) {
+            schedule(index, self);
+        }
+
+        if (pending.fetch_sub(batch.size(), std::memory_order_acq_rel) == batch.size()) {
+            std::lock_guard<std::mutex> lock(idleMutex);
+            idleCv.notify_all();
+        }
+    }
+
+    void KeyedExecutor::workerLoop(std::size_t self) {
+        for (;;) {
+            std::size_t shard;
+            if (take(self, shard)) {
+                {
+                    std::lock_guard<std::mutex> lock(sleepMutex);
+                    --readyKeys;
+                }
+                runShard(self, shard);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepCv.wait(lock, [this] { return stopping || readyKeys > 0; });
+            if (stopping && readyKeys == 0) {
+                return;
+            }
+        }
+    }
+
+}
+}
+}
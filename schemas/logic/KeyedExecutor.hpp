@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace c_hex {
+namespace domain {
+namespace logic {
+
+    struct KeyedExecutorOptions {
+        std::size_t workers = std::thread::hardware_concurrency();
+        // Key queues that key hashes fold onto. More queues mean finer-grained
+        // stealing and fewer unrelated keys serialised behind each other.
+        std::size_t shards = 256;
+        // Tasks run from one key queue before it goes back in line, so a hot
+        // key cannot monopolise its worker.
+        std::size_t burst = 64;
+        // Called on the worker thread with the exception of a task that threw;
+        // the key queue carries on with its next task. Without it the exception
+        // is only counted in WorkerStats::failed.
+        std::function<void(std::exception_ptr)> onError;
+    };
+
+    struct WorkerStats {
+        // Key queues waiting in this worker's run queue, and the tasks in them.
+        std::size_t queuedKeys;
+        std::size_t queueDepth;
+        std::uint64_t executed;
+        // Tasks among executed that threw.
+        std::uint64_t failed;
+        // Key queues this worker took from others / others took from it.
+        std::uint64_t steals;
+        std::uint64_t stolen;
+    };
+
+    // Runs domain work on all cores without reordering events of one entity.
+    //
+    // submit() hashes the message's key columns (see the keyHash() of the
+    // generated datagram codecs, or hashKeys()) onto a key queue. A key queue is
+    // run by at most one worker at a time, in submission order, so tasks with
+    // equal keys never overlap or reorder. Each key queue has a home worker; an
+    // idle worker steals whole key queues from the back of a busy worker's run
+    // queue, which moves load without ever splitting a key.
+    class KeyedExecutor {
+    public:
+        using Task = std::function<void()>;
+
+        explicit KeyedExecutor(KeyedExecutorOptions options = KeyedExecutorOptions());
+
+        // Runs everything already submitted, then joins the workers.
+        ~KeyedExecutor();
+
+        KeyedExecutor(const KeyedExecutor&) = delete;
+        KeyedExecutor& operator=(const KeyedExecutor&) = delete;
+
+        std::size_t workerCount() const { return workers.size(); }
+
+        void submit(std::uint64_t keyHash, Task task);
+
+        // Blocks until every task submitted so far has run.
+        void waitIdle();
+
+        std::vector<WorkerStats> stats() const;
+
+        // Combines key column values into one hash for submit(). Only needs to be
+        // stable within the process.
+        template <typename... Keys>
+        static std::uint64_t hashKeys(const Keys&... keys) {
+            std::uint64_t h = 0x9e3779b97f4a7c15ull;
+            const std::size_t parts[] = { std::hash<Keys>()(keys)... };
+            for (std::size_t part : parts) {
+                h = mix(h ^ part);
+            }
+            return h;
+        }
+
+    private:
+        struct Shard {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+            bool scheduled = false;
+        };
+
+        struct Worker {
+            mutable std::mutex mutex;
+            std::deque<std::size_t> ready;
+            std::atomic<std::uint64_t> executed{0};
+            std::atomic<std::uint64_t> failed{0};
+            std::atomic<std::uint64_t> steals{0};
+            std::atomic<std::uint64_t> stolen{0};
+            std::thread thread;
+        };
+
+        static std::uint64_t mix(std::uint64_t h) {
+            h ^= h >> 30;
+            h *= 0xbf58476d1ce4e5b9ull;
+            h ^= h >> 27;
+            h *= 0x94d049bb133111ebull;
+            return h ^ (h >> 31);
+        }
+
+        void schedule(std::size_t shard, std::size_t worker);
+        bool take(std::size_t self, std::size_t& shard);
+        void runShard(std::size_t self, std::size_t shard);
+        void workerLoop(std::size_t self);
+
+        const std::size_t burst;
+        const std::function<void(std::exception_ptr)> onError;
+        std::vector<std::unique_ptr<Shard>> shards;
+        std::vector<std::unique_ptr<Worker>> workers;
+
+        // Key queues sitting in run queues; workers sleep while it is zero.
+        std::mutex sleepMutex;
+        std::condition_variable sleepCv;
+        std::size_t readyKeys = 0;
+        bool stopping = false;
+
+        std::mutex idleMutex;
+        std::condition_variable idleCv;
+        std::atomic<std::uint64_t> pending{0};
+    };
+
+}
+}
+}
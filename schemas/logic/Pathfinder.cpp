@@ -0,0 +1,294 @@
+#include "Pathfinder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <utility>
+
+namespace c_hex {
+namespace domain {
+namespace logic {
+
+    namespace {
+
+        constexpr double kSqrt2 = 1.4142135623730951;
+
+        double octile(GridPoint a, GridPoint b) {
+            const int dx = std::abs(a.x - b.x);
+            const int dy = std::abs(a.y - b.y);
+            return std::max(dx, dy) - std::min(dx, dy) + kSqrt2 * std::min(dx, dy);
+        }
+
+        int sign(int v) { return (v > 0) - (v < 0); }
+
+        struct OpenGreater {
+            template <typename Entry>
+            bool operator()(const Entry& a, const Entry& b) const { return a.f > b.f; }
+        };
+
+    }
+
+    NavGrid::NavGrid(const model::GameMap& map)
+        : w(static_cast<int>(map.width())), h(static_cast<int>(map.height())),
+          stride(map.width() + 2), open((map.width() + 2) * (map.height() + 2), 0),
+          regionIds(open.size(), 0) {
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                open[index(x, y)] = map.isPassable(static_cast<std::size_t>(x), static_cast<std::size_t>(y)) ? 1 : 0;
+            }
+        }
+
+        // Diagonals may not cut corners, so 4-connectivity already decides reachability.
+        std::vector<std::size_t> stack;
+        for (std::size_t start = 0; start < open.size(); ++start) {
+            if (!open[start] || regionIds[start]) {
+                continue;
+            }
+            const std::uint32_t id = ++regions;
+            regionIds[start] = id;
+            stack.push_back(start);
+            while (!stack.empty()) {
+                const std::size_t cell = stack.back();
+                stack.pop_back();
+                const std::size_t neighbours[4] = { cell - 1, cell + 1, cell - stride, cell + stride };
+                for (std::size_t n : neighbours) {
+                    if (open[n] && !regionIds[n]) {
+                        regionIds[n] = id;
+                        stack.push_back(n);
+                    }
+                }
+            }
+        }
+    }
+
+    std::shared_ptr<const NavGrid> NavGrid::build(const model::GameMap& map) {
+        return std::make_shared<const NavGrid>(map);
+    }
+
+    std::uint32_t NavGrid::region(int x, int y) const {
+        return passable(x, y) ? regionIds[index(x, y)] : 0;
+    }
+
+    bool NavGrid::connected(GridPoint a, GridPoint b) const {
+        const std::uint32_t ra = region(a.x, a.y);
+        return ra != 0 && ra == region(b.x, b.y);
+    }
+
+    void PathArena::begin(std::size_t cells) {
+        if (seenAt.size() < cells) {
+            seenAt.assign(cells, 0);
+            closedAt.assign(cells, 0);
+            g.resize(cells);
+            parent.resize(cells);
+            generation = 0;
+        }
+        if (++generation == 0) {
+            std::fill(seenAt.begin(), seenAt.end(), 0);
+            std::fill(closedAt.begin(), closedAt.end(), 0);
+            generation = 1;
+        }
+        openList.clear();
+    }
+
+    Pathfinder::Pathfinder(std::shared_ptr<const NavGrid> grid, PathAlgorithm algorithm)
+        : nav(std::move(grid)), mode(algorithm) {
+        if (!nav) {
+            throw std::invalid_argument("Pathfinder: grid is null");
+        }
+    }
+
+    PathResult Pathfinder::findPath(GridPoint start, GridPoint goal, PathArena& arena, std::vector<GridPoint>& path) const {
+        path.clear();
+        PathResult result;
+        const NavGrid& grid = *nav;
+        if (!grid.passable(start.x, start.y) || !grid.passable(goal.x, goal.y)) {
+            result.status = PathStatus::InvalidEndpoint;
+            return result;
+        }
+        if (!grid.connected(start, goal)) {
+            return result;
+        }
+
+        arena.begin(grid.cellCount());
+        const std::uint32_t gen = arena.generation;
+        const auto startNode = static_cast<std::uint32_t>(grid.index(start.x, start.y));
+        const auto goalNode = static_cast<std::uint32_t>(grid.index(goal.x, goal.y));
+
+        arena.seenAt[startNode] = gen;
+        arena.g[startNode] = 0.0;
+        arena.parent[startNode] = startNode;
+        arena.openList.push_back({ octile(start, goal), startNode });
+
+        std::uint32_t next[8];
+        while (!arena.openList.empty()) {
+            std::pop_heap(arena.openList.begin(), arena.openList.end(), OpenGreater());
+            const std::uint32_t node = arena.openList.back().node;
+            arena.openList.pop_back();
+            if (arena.closedAt[node] == gen) {
+                continue;
+            }
+            arena.closedAt[node] = gen;
+            ++result.expanded;
+
+            if (node == goalNode) {
+                result.status = PathStatus::Found;
+                result.cost = arena.g[node];
+                break;
+            }
+
+            const GridPoint here = grid.point(node);
+            const int count = successors(node, arena.parent[node], goal, next);
+            for (int i = 0; i < count; ++i) {
+                const std::uint32_t succ = next[i];
+                if (arena.closedAt[succ] == gen) {
+                    continue;
+                }
+                const GridPoint there = grid.point(succ);
+                const double cost = arena.g[node] + octile(here, there);
+                if (arena.seenAt[succ] != gen || cost < arena.g[succ]) {
+                    arena.seenAt[succ] = gen;
+                    arena.g[succ] = cost;
+                    arena.parent[succ] = node;
+                    arena.openList.push_back({ cost + octile(there, goal), succ });
+                    std::push_heap(arena.openList.begin(), arena.openList.end(), OpenGreater());
+                }
+            }
+        }
+
+        if (result.status != PathStatus::Found) {
+            return result;
+        }
+
+        // Walk the parent chain, then fill in the straight or diagonal runs between jump points.
+        arena.corners.clear();
+        for (std::uint32_t node = goalNode;; node = arena.parent[node]) {
+            arena.corners.push_back(grid.point(node));
+            if (node == startNode) {
+                break;
+            }
+        }
+        std::reverse(arena.corners.begin(), arena.corners.end());
+        path.push_back(arena.corners.front());
+        for (std::size_t i = 1; i < arena.corners.size(); ++i) {
+            GridPoint p = arena.corners[i - 1];
+            const GridPoint to = arena.corners[i];
+            const int dx = sign(to.x - p.x);
+            const int dy = sign(to.y - p.y);
+            while (p != to) {
+                p.x += dx;
+                p.y += dy;
+                path.push_back(p);
+            }
+        }
+        return result;
+    }
+
+    int Pathfinder::successors(std::uint32_t node, std::uint32_t from, GridPoint goal, std::uint32_t* out) const {
+        const NavGrid& grid = *nav;
+        const GridPoint p = grid.point(node);
+        const int x = p.x;
+        const int y = p.y;
+
+        // Candidate directions: every legal move for the start node and for A*,
+        // otherwise the natural and forced neighbours of the travel direction.
+        int dirs[8][2];
+        int n = 0;
+        auto add = [&](int dx, int dy) { dirs[n][0] = dx; dirs[n][1] = dy; ++n; };
+        auto open = [&](int cx, int cy) { return grid.openAt(grid.index(cx, cy)); };
+
+        if (mode == PathAlgorithm::AStar || from == node) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    if ((dx || dy) && open(x + dx, y + dy) && (!dx || !dy || (open(x + dx, y) && open(x, y + dy)))) {
+                        add(dx, dy);
+                    }
+                }
+            }
+        } else {
+            const GridPoint q = grid.point(from);
+            const int dx = sign(x - q.x);
+            const int dy = sign(y - q.y);
+            if (dx && dy) {
+                if (open(x, y + dy)) add(0, dy);
+                if (open(x + dx, y)) add(dx, 0);
+                if (open(x, y + dy) && open(x + dx, y) && open(x + dx, y + dy)) add(dx, dy);
+            } else if (dx) {
+                const bool ahead = open(x + dx, y);
+                const bool up = open(x, y - 1);
+                const bool down = open(x, y + 1);
+                if (ahead) {
+                    add(dx, 0);
+                    if (up && open(x + dx, y - 1)) add(dx, -1);
+                    if (down && open(x + dx, y + 1)) add(dx, 1);
+                }
+                if (up) add(0, -1);
+                if (down) add(0, 1);
+            } else {
+                const bool ahead = open(x, y + dy);
+                const bool left = open(x - 1, y);
+                const bool right = open(x + 1, y);
+                if (ahead) {
+                    add(0, dy);
+                    if (left && open(x - 1, y + dy)) add(-1, dy);
+                    if (right && open(x + 1, y + dy)) add(1, dy);
+                }
+                if (left) add(-1, 0);
+                if (right) add(1, 0);
+            }
+        }
+
+        if (mode == PathAlgorithm::AStar) {
+            for (int i = 0; i < n; ++i) {
+                out[i] = static_cast<std::uint32_t>(grid.index(x + dirs[i][0], y + dirs[i][1]));
+            }
+            return n;
+        }
+
+        int count = 0;
+        for (int i = 0; i < n; ++i) {
+            const long jp = jump(x + dirs[i][0], y + dirs[i][1], dirs[i][0], dirs[i][1], goal);
+            if (jp >= 0) {
+                out[count++] = static_cast<std::uint32_t>(jp);
+            }
+        }
+        return count;
+    }
+
+    // Walks from (x, y) in direction (dx, dy) and returns the padded index of the
+    // first jump point (the goal, or a cell with a forced neighbour), or -1 when
+    // the run hits an obstacle. Straight runs are checked from every diagonal step.
+    long Pathfinder::jump(int x, int y, int dx, int dy, GridPoint goal) const {
+        const NavGrid& grid = *nav;
+        auto open = [&](int cx, int cy) { return grid.openAt(grid.index(cx, cy)); };
+        for (;;) {
+            if (!open(x, y)) {
+                return -1;
+            }
+            if (x == goal.x && y == goal.y) {
+                return static_cast<long>(grid.index(x, y));
+            }
+            if (dx && dy) {
+                if (jump(x + dx, y, dx, 0, goal) >= 0 || jump(x, y + dy, 0, dy, goal) >= 0) {
+                    return static_cast<long>(grid.index(x, y));
+                }
+                if (!open(x + dx, y) || !open(x, y + dy)) {
+                    return -1;
+                }
+            } else if (dx) {
+                if ((open(x, y - 1) && !open(x - dx, y - 1)) || (open(x, y + 1) && !open(x - dx, y + 1))) {
+                    return static_cast<long>(grid.index(x, y));
+                }
+            } else {
+                if ((open(x - 1, y) && !open(x - 1, y - dy)) || (open(x + 1, y) && !open(x + 1, y - dy))) {
+                    return static_cast<long>(grid.index(x, y));
+                }
+            }
+            x += dx;
+            y += dy;
+        }
+    }
+
+}
+}
+}
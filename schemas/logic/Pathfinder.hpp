@@ -0,0 +1,127 @@
+#pragma once
+
+#include "domain/model/GameMap.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace c_hex {
+namespace domain {
+namespace logic {
+
+    struct GridPoint {
+        int x;
+        int y;
+
+        bool operator==(const GridPoint& other) const { return x == other.x && y == other.y; }
+        bool operator!=(const GridPoint& other) const { return !(*this == other); }
+    };
+
+    // Read-only navigation data derived from a GameMap: a passability grid with a
+    // one-cell impassable border (so neighbour lookups need no bounds checks) and
+    // a precomputed region id per cell. Built once per map and shared between
+    // threads as shared_ptr<const NavGrid>.
+    class NavGrid {
+    public:
+        explicit NavGrid(const model::GameMap& map);
+
+        static std::shared_ptr<const NavGrid> build(const model::GameMap& map);
+
+        int width() const { return w; }
+        int height() const { return h; }
+        // Cells in the padded grid; the size a PathArena is sized to.
+        std::size_t cellCount() const { return open.size(); }
+
+        // False outside the map.
+        bool passable(int x, int y) const {
+            return x >= -1 && y >= -1 && x <= w && y <= h && open[index(x, y)] != 0;
+        }
+
+        // 0 for impassable cells; otherwise an id shared by exactly the cells reachable from (x, y).
+        std::uint32_t region(int x, int y) const;
+        std::uint32_t regionCount() const { return regions; }
+        bool connected(GridPoint a, GridPoint b) const;
+
+        std::size_t index(int x, int y) const { return static_cast<std::size_t>(y + 1) * stride + static_cast<std::size_t>(x + 1); }
+        GridPoint point(std::size_t index) const {
+            return { static_cast<int>(index % stride) - 1, static_cast<int>(index / stride) - 1 };
+        }
+        // Unchecked lookup by padded index.
+        bool openAt(std::size_t index) const { return open[index] != 0; }
+
+    private:
+        int w = 0;
+        int h = 0;
+        std::size_t stride = 0;
+        std::vector<std::uint8_t> open;
+        std::vector<std::uint32_t> regionIds;
+        std::uint32_t regions = 0;
+    };
+
+    enum class PathAlgorithm { AStar, JumpPoint };
+
+    enum class PathStatus { Found, NoPath, InvalidEndpoint };
+
+    struct PathResult {
+        PathStatus status = PathStatus::NoPath;
+        double cost = 0.0;
+        // Nodes taken off the open list.
+        std::size_t expanded = 0;
+    };
+
+    // Per-thread search scratch reused across queries. Node state is tagged with
+    // the query generation, so starting a search costs nothing per cell.
+    class PathArena {
+    public:
+        PathArena() = default;
+        PathArena(const PathArena&) = delete;
+        PathArena& operator=(const PathArena&) = delete;
+        PathArena(PathArena&&) noexcept = default;
+        PathArena& operator=(PathArena&&) noexcept = default;
+
+    private:
+        friend class Pathfinder;
+
+        struct OpenEntry {
+            double f;
+            std::uint32_t node;
+        };
+
+        void begin(std::size_t cells);
+
+        std::vector<std::uint32_t> seenAt;
+        std::vector<std::uint32_t> closedAt;
+        std::vector<double> g;
+        std::vector<std::uint32_t> parent;
+        std::vector<OpenEntry> openList;
+        std::vector<GridPoint> corners;
+        std::uint32_t generation = 0;
+    };
+
+    // Shortest paths on the octile grid: 8-way moves, diagonals cost sqrt(2) and
+    // may not cut past an impassable corner. JumpPoint prunes symmetric paths and
+    // returns the same costs as AStar while expanding far fewer nodes on open maps.
+    // findPath() is const and may run concurrently, one PathArena per thread.
+    class Pathfinder {
+    public:
+        explicit Pathfinder(std::shared_ptr<const NavGrid> grid, PathAlgorithm algorithm = PathAlgorithm::JumpPoint);
+
+        const NavGrid& grid() const { return *nav; }
+        PathAlgorithm algorithm() const { return mode; }
+
+        // path is cleared and receives every cell from start to goal inclusive.
+        PathResult findPath(GridPoint start, GridPoint goal, PathArena& arena, std::vector<GridPoint>& path) const;
+
+    private:
+        int successors(std::uint32_t node, std::uint32_t from, GridPoint goal, std::uint32_t* out) const;
+        long jump(int x, int y, int dx, int dy, GridPoint goal) const;
+
+        std::shared_ptr<const NavGrid> nav;
+        PathAlgorithm mode;
+    };
+
+}
+}
+}
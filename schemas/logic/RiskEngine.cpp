@@ -0,0 +1,140 @@
+#include "RiskEngine.hpp"
+#include "utils/AlignedAllocator.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace c_hex {
+namespace domain {
+namespace logic {
+
+    namespace {
+
+        using hexarch::utils::kDotTile;
+
+        constexpr std::size_t kLane = 64 / sizeof(double);
+
+        using AlignedVector = std::vector<double, hexarch::utils::AlignedAllocator<double>>;
+
+        // Co-moments for rows [i0, i1) against columns [j0, j1), upper triangle only.
+        void comomentTile(const hexarch::utils::DotTileFn<double> dot, const double* centred, std::size_t stride,
+                          std::size_t i0, std::size_t i1, std::size_t j0, std::size_t j1,
+                          model::SymmetricMatrix<double>& out) {
+            for (std::size_t i = i0; i < i1; ++i) {
+                double* tail = out.rowTail(i) - i;
+                const double* xi = centred + i * stride;
+                for (std::size_t j = std::max(j0, i); j < j1; j += kDotTile) {
+                    const std::size_t count = std::min(kDotTile, j1 - j);
+                    const double* xj[kDotTile];
+                    for (std::size_t k = 0; k < count; ++k) {
+                        xj[k] = centred + (j + k) * stride;
+                    }
+                    double acc[kDotTile];
+                    dot(xi, xj, stride, count, acc);
+                    for (std::size_t k = 0; k < count; ++k) {
+                        tail[j + k] = acc[k];
+                    }
+                }
+            }
+        }
+
+    }
+
+    RiskEngine::RiskEngine(RiskOptions options, hexarch::utils::ThreadPool* pool)
+        : options(options), pool(pool),
+          resolved(options.simd ? hexarch::utils::bestDotKernel() : hexarch::utils::DotKernel::Scalar) {
+        if (options.assetBlock == 0) {
+            throw std::invalid_argument("RiskEngine: assetBlock must be positive");
+        }
+    }
+
+    hexarch::utils::DotKernel RiskEngine::kernel() const { return resolved; }
+
+    model::ReturnMoments RiskEngine::computeMoments(const model::Grid2D<double>& returns) const {
+        return compute(returns, pool != nullptr);
+    }
+
+    void RiskEngine::recompute(model::FinancialPortfolio& portfolio) const {
+        portfolio.setReturnMoments(computeMoments(portfolio.getHistoricalReturns()));
+    }
+
+    void RiskEngine::recomputeAll(model::FinancialPortfolio* portfolios, std::size_t count) const {
+        auto run = [&](std::size_t begin, std::size_t end) {
+            for (std::size_t p = begin; p < end; ++p) {
+                portfolios[p].setReturnMoments(compute(portfolios[p].getHistoricalReturns(), false));
+            }
+        };
+        if (pool && count > pool->size()) {
+            pool->parallelFor(0, count, 1, run);
+        } else {
+            for (std::size_t p = 0; p < count; ++p) {
+                recompute(portfolios[p]);
+            }
+        }
+    }
+
+    void RiskEngine::recomputeAll(std::vector<model::FinancialPortfolio>& portfolios) const {
+        recomputeAll(portfolios.data(), portfolios.size());
+    }
+
+    model::ReturnMoments RiskEngine::compute(const model::Grid2D<double>& returns, bool parallel) const {
+        const std::size_t periods = returns.rows();
+        const std::size_t assets = returns.cols();
+
+        std::vector<double> means(assets, 0.0);
+        for (std::size_t t = 0; t < periods; ++t) {
+            const double* row = returns.row(t);
+            for (std::size_t a = 0; a < assets; ++a) {
+                means[a] += row[a];
+            }
+        }
+        if (periods) {
+            const double inv = 1.0 / static_cast<double>(periods);
+            for (double& m : means) m *= inv;
+        }
+
+        // Asset-major centred copy; the zero padding past `periods` adds nothing to the dots.
+        const std::size_t stride = std::max<std::size_t>(kLane, (periods + kLane - 1) / kLane * kLane);
+        AlignedVector centred(assets * stride, 0.0);
+        for (std::size_t t = 0; t < periods; ++t) {
+            const double* row = returns.row(t);
+            for (std::size_t a = 0; a < assets; ++a) {
+                centred[a * stride + t] = row[a] - means[a];
+            }
+        }
+
+        model::SymmetricMatrix<double> comoments(assets);
+        const hexarch::utils::DotTileFn<double> dot = hexarch::utils::selectDotTile<double>(resolved);
+        const std::size_t block = options.assetBlock;
+        const std::size_t blocks = (assets + block - 1) / block;
+
+        // Tile (bi, bj) with bi <= bj, enumerated row by row over the block triangle.
+        std::vector<std::pair<std::size_t, std::size_t>> tiles;
+        tiles.reserve(blocks * (blocks + 1) / 2);
+        for (std::size_t bi = 0; bi < blocks; ++bi) {
+            for (std::size_t bj = bi; bj < blocks; ++bj) {
+                tiles.emplace_back(bi, bj);
+            }
+        }
+
+        auto runTiles = [&](std::size_t begin, std::size_t end) {
+            for (std::size_t k = begin; k < end; ++k) {
+                const std::size_t i0 = tiles[k].first * block;
+                const std::size_t j0 = tiles[k].second * block;
+                comomentTile(dot, centred.data(), stride, i0, std::min(i0 + block, assets),
+                             j0, std::min(j0 + block, assets), comoments);
+            }
+        };
+        if (parallel && pool && tiles.size() > 1) {
+            pool->parallelFor(0, tiles.size(), 1, runTiles);
+        } else {
+            runTiles(0, tiles.size());
+        }
+
+        return model::ReturnMoments(periods, std::move(means), std::move(comoments));
+    }
+
+}
+}
+}
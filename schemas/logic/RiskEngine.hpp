@@ -0,0 +1,55 @@
+#pragma once
+
+#include "domain/model/FinancialPortfolio.hpp"
+#include "utils/SimdDot.hpp"
+#include "utils/ThreadPool.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace c_hex {
+namespace domain {
+namespace logic {
+
+    struct RiskOptions {
+        // Use the widest SIMD dot kernel the CPU supports; false forces scalar.
+        bool simd = true;
+        // Assets per block; one pool task covers a block x block tile of the triangle.
+        std::size_t assetBlock = 32;
+    };
+
+    // Rebuilds return moments (means and co-moments, hence covariance and
+    // correlation) from a portfolio's full history.
+    //
+    // The history is centred and transposed into an asset-major, 64-byte aligned
+    // buffer so each asset's series is one contiguous vector; the upper triangle
+    // of asset pairs is then cut into assetBlock x assetBlock tiles whose dot
+    // products run through the shared SIMD tile kernel. With a pool, tiles of one
+    // portfolio are spread over the workers; recomputeAll() instead gives each
+    // worker whole portfolios, which scales better for many small portfolios.
+    class RiskEngine {
+    public:
+        explicit RiskEngine(RiskOptions options = RiskOptions(), hexarch::utils::ThreadPool* pool = nullptr);
+
+        hexarch::utils::DotKernel kernel() const;
+
+        // returns is periods x assets.
+        model::ReturnMoments computeMoments(const model::Grid2D<double>& returns) const;
+
+        // Installs fresh moments, which also refreshes the portfolio's riskMatrix.
+        void recompute(model::FinancialPortfolio& portfolio) const;
+
+        void recomputeAll(model::FinancialPortfolio* portfolios, std::size_t count) const;
+        void recomputeAll(std::vector<model::FinancialPortfolio>& portfolios) const;
+
+    private:
+        model::ReturnMoments compute(const model::Grid2D<double>& returns, bool parallel) const;
+
+        RiskOptions options;
+        hexarch::utils::ThreadPool* pool;
+        hexarch::utils::DotKernel resolved;
+    };
+
+}
+}
+}
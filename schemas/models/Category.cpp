@@ -1,20 +1,29 @@
 #include "Category.hpp"
+#include <utility>
 
 namespace c_hex {
 namespace domain {
 namespace model {
 
-    Category::Category(int id, const std::string& title)
-        : id(id), title(title) {}
+    Category::Category(int id, std::string_view title, const allocator_type& alloc)
+        : id(id), title(title, alloc) {}
 
-    Category::Category() : id(0) {}
+    Category::Category(const allocator_type& alloc) : id(0), title(alloc) {}
+
+    Category::Category(const Category& other, const allocator_type& alloc)
+        : id(other.id), title(other.title, alloc) {}
+
+    Category::Category(Category&& other, const allocator_type& alloc)
+        : id(other.id), title(std::move(other.title), alloc) {}
 
     Category::~Category() = default;
 
+    Category::allocator_type Category::get_allocator() const { return title.get_allocator(); }
+
     int Category::getId() const { return id; }
-    std::string Category::getTitle() const { return title; }
+    std::string_view Category::getTitle() const { return title; }
 
-    void Category::setTitle(const std::string& newTitle) { title = newTitle; }
+    void Category::setTitle(std::string_view newTitle) { title.assign(newTitle.data(), newTitle.size()); }
 
 }
 }
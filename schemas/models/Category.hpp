@@ -1,25 +1,40 @@
 #pragma once
 
+#include <memory_resource>
 #include <string>
+#include <string_view>
 
 namespace c_hex {
 namespace domain {
 namespace model {
 
-    class Category {
+    // Allocator-aware like Order: construct it in a std::pmr container or with
+    // an explicit allocator to keep the title in an arena or pool.
+    class Category final {
     private:
         int id;
-        std::string title;
+        std::pmr::string title;
 
     public:
-        Category(int id, const std::string& title);
-        Category();
-        virtual ~Category();
+        using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+        Category(int id, std::string_view title, const allocator_type& alloc = {});
+        explicit Category(const allocator_type& alloc = {});
+        Category(const Category& other, const allocator_type& alloc);
+        Category(Category&& other, const allocator_type& alloc);
+        ~Category();
+        Category(const Category&) = default;
+        Category(Category&&) noexcept = default;
+        Category& operator=(const Category&) = default;
+        Category& operator=(Category&&) = default;
+
+        allocator_type get_allocator() const;
 
         int getId() const;
-        std::string getTitle() const;
+        std::string_view getTitle() const;
 
-        void setTitle(const std::string& title);
+        // Assigns in place, reusing the title's storage when it fits.
+        void setTitle(std::string_view title);
     };
 
 }
@@ -1,31 +1,69 @@
 #include "ComplexSignal.hpp"
+#include <stdexcept>
+#include <utility>
 
 namespace c_hex {
 namespace domain {
 namespace model {
 
-    ComplexSignal::ComplexSignal(const std::string& id, long time, 
-                               const std::vector<double>& wave,
+    ComplexSignal::ComplexSignal(std::string id, long time, 
+                               std::vector<double> wave,
+                               Grid2D<double> spec,
+                               std::vector<float> bands,
+                               bool valid, std::string device, double gain)
+        : signalId(std::move(id)), timestamp(time), rawWaveform(std::move(wave)), spectrogram(std::move(spec)),
+          frequencyBands(std::move(bands)), isValid(valid), sourceDevice(std::move(device)), gain(gain) {}
+
+    ComplexSignal::ComplexSignal(std::string id, long time, 
+                               std::vector<double> wave,
                                const std::vector<std::vector<double>>& spec,
-                               const std::vector<float>& bands,
-                               bool valid, const std::string& device, double gain)
-        : signalId(id), timestamp(time), rawWaveform(wave), spectrogram(spec),
-          frequencyBands(bands), isValid(valid), sourceDevice(device), gain(gain) {}
+                               std::vector<float> bands,
+                               bool valid, std::string device, double gain)
+        : ComplexSignal(std::move(id), time, std::move(wave), Grid2D<double>::fromNested(spec),
+                        std::move(bands), valid, std::move(device), gain) {}
 
     ComplexSignal::ComplexSignal() : timestamp(0), isValid(false), gain(0.0) {}
 
     ComplexSignal::~ComplexSignal() = default;
 
-    std::string ComplexSignal::getSignalId() const { return signalId; }
+    const std::string& ComplexSignal::getSignalId() const { return signalId; }
     long ComplexSignal::getTimestamp() const { return timestamp; }
-    std::vector<double> ComplexSignal::getRawWaveform() const { return rawWaveform; }
-    std::vector<std::vector<double>> ComplexSignal::getSpectrogram() const { return spectrogram; }
+    const std::vector<double>& ComplexSignal::getRawWaveform() const { return rawWaveform; }
+    const Grid2D<double>& ComplexSignal::getSpectrogram() const { return spectrogram; }
+    const std::vector<float>& ComplexSignal::getFrequencyBands() const { return frequencyBands; }
     bool ComplexSignal::getIsValid() const { return isValid; }
-    std::string ComplexSignal::getSourceDevice() const { return sourceDevice; }
+    const std::string& ComplexSignal::getSourceDevice() const { return sourceDevice; }
+    double ComplexSignal::getGain() const { return gain; }
 
-    void ComplexSignal::setSpectrogram(const std::vector<std::vector<double>>& spec) { spectrogram = spec; }
+    void ComplexSignal::setSpectrogram(Grid2D<double> spec) { spectrogram = std::move(spec); }
+    void ComplexSignal::setSpectrogram(const std::vector<std::vector<double>>& spec) { spectrogram = Grid2D<double>::fromNested(spec); }
     void ComplexSignal::setGain(double newGain) { gain = newGain; }
 
+    void ComplexSignal::enableStreaming(const SpectrogramConfig& config) {
+        stream.emplace(config);
+        frequencyBands.assign(config.bandCount, 0.0f);
+    }
+
+    void ComplexSignal::disableStreaming() { stream.reset(); }
+
+    bool ComplexSignal::isStreaming() const { return stream.has_value(); }
+
+    std::size_t ComplexSignal::appendSamples(const double* samples, std::size_t count) {
+        if (!stream) {
+            throw std::logic_error("ComplexSignal: appendSamples requires enableStreaming()");
+        }
+        const std::size_t frames = stream->append(samples, count, gain);
+        if (frames > 0) {
+            const std::vector<double>& energies = stream->getBandEnergies();
+            for (std::size_t b = 0; b < energies.size(); ++b) {
+                frequencyBands[b] = static_cast<float>(energies[b]);
+            }
+        }
+        return frames;
+    }
+
+    const StreamingSpectrogram* ComplexSignal::getStream() const { return stream ? &*stream : nullptr; }
+
 }
 }
 }
@@ -1,5 +1,9 @@
 #pragma once
 
+#include "Grid3D.hpp"
+#include "StreamingSpectrogram.hpp"
+
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -12,30 +16,53 @@ namespace model {
         std::string signalId;
         long timestamp;
         std::vector<double> rawWaveform;
-        std::vector<std::vector<double>> spectrogram;
+        Grid2D<double> spectrogram; // frames x bins, frame-major
         std::vector<float> frequencyBands;
         bool isValid;
         std::string sourceDevice;
         double gain;
+        std::optional<StreamingSpectrogram> stream;
 
     public:
-        ComplexSignal(const std::string& id, long time, 
-                     const std::vector<double>& wave,
+        ComplexSignal(std::string id, long time, 
+                     std::vector<double> wave,
+                     Grid2D<double> spec,
+                     std::vector<float> bands,
+                     bool valid, std::string device, double gain);
+        ComplexSignal(std::string id, long time, 
+                     std::vector<double> wave,
                      const std::vector<std::vector<double>>& spec,
-                     const std::vector<float>& bands,
-                     bool valid, const std::string& device, double gain);
+                     std::vector<float> bands,
+                     bool valid, std::string device, double gain);
         ComplexSignal();
         virtual ~ComplexSignal();
+        ComplexSignal(const ComplexSignal&) = default;
+        ComplexSignal(ComplexSignal&&) noexcept = default;
+        ComplexSignal& operator=(const ComplexSignal&) = default;
+        ComplexSignal& operator=(ComplexSignal&&) noexcept = default;
 
-        std::string getSignalId() const;
+        const std::string& getSignalId() const;
         long getTimestamp() const;
-        std::vector<double> getRawWaveform() const;
-        std::vector<std::vector<double>> getSpectrogram() const;
+        const std::vector<double>& getRawWaveform() const;
+        const Grid2D<double>& getSpectrogram() const;
+        const std::vector<float>& getFrequencyBands() const;
         bool getIsValid() const;
-        std::string getSourceDevice() const;
+        const std::string& getSourceDevice() const;
+        double getGain() const;
 
+        void setSpectrogram(Grid2D<double> spec);
         void setSpectrogram(const std::vector<std::vector<double>>& spec);
         void setGain(double newGain);
+
+        // Streaming mode: samples are appended in chunks and only new STFT frames
+        // are computed; memory stays bounded by the SpectrogramConfig. rawWaveform
+        // and spectrogram are not extended while streaming, frequencyBands is
+        // refreshed after every chunk.
+        void enableStreaming(const SpectrogramConfig& config);
+        void disableStreaming();
+        bool isStreaming() const;
+        std::size_t appendSamples(const double* samples, std::size_t count);
+        const StreamingSpectrogram* getStream() const;
     };
 
 }
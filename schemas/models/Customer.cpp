@@ -1,24 +1,82 @@
 #include "Customer.hpp"
+#include <utility>
 
 namespace c_hex {
 namespace domain {
 namespace model {
 
-    Customer::Customer(long id, const std::string& first, const std::string& last, const std::string& email, int age)
-        : customerId(id), firstName(first), lastName(last), email(email), age(age) {}
+    Customer::Customer(long id, std::string_view first, std::string_view last, std::string_view email, int age,
+                       const allocator_type& alloc)
+        : customerId(id), firstName(first, alloc), lastName(last, alloc), email(email, alloc), age(age) {}
 
-    Customer::Customer() : customerId(0), age(0) {}
+    Customer::Customer(const allocator_type& alloc)
+        : customerId(0), firstName(alloc), lastName(alloc), email(alloc), age(0) {}
+
+    Customer::Customer(const Customer& other, const allocator_type& alloc)
+        : customerId(other.customerId), firstName(other.firstName, alloc), lastName(other.lastName, alloc),
+          email(other.email, alloc), age(other.age), dirty(other.dirty) {}
+
+    Customer::Customer(Customer&& other, const allocator_type& alloc)
+        : customerId(other.customerId), firstName(std::move(other.firstName), alloc),
+          lastName(std::move(other.lastName), alloc), email(std::move(other.email), alloc), age(other.age),
+          dirty(other.dirty) {}
 
     Customer::~Customer() = default;
 
+    Customer::allocator_type Customer::get_allocator() const { return email.get_allocator(); }
+
     long Customer::getCustomerId() const { return customerId; }
-    std::string Customer::getFirstName() const { return firstName; }
-    std::string Customer::getLastName() const { return lastName; }
-    std::string Customer::getEmail() const { return email; }
+    std::string_view Customer::getFirstName() const { return firstName; }
+    std::string_view Customer::getLastName() const { return lastName; }
+    std::string_view Customer::getEmail() const { return email; }
     int Customer::getAge() const { return age; }
 
-    void Customer::setEmail(const std::string& newEmail) { email = newEmail; }
-    void Customer::setAge(int newAge) { age = newAge; }
+    void Customer::setEmail(std::string_view newEmail) {
+        email.assign(newEmail.data(), newEmail.size());
+        dirty.mark(Field::Email);
+    }
+
+    void Customer::setAge(int newAge) {
+        age = newAge;
+        dirty.mark(Field::Age);
+    }
+
+    std::uint64_t Customer::dirtyFields() const { return dirty.mask(); }
+    bool Customer::isDirty(Field field) const { return dirty.test(field); }
+    void Customer::clearDirty() { dirty.clear(); }
+    void Customer::markAllDirty() { dirty.markAll(); }
+
+    void Customer::encodeDelta(std::vector<unsigned char>& out) const {
+        hexarch::utils::delta::Writer w(out, dirty.mask());
+        if (dirty.test(Field::CustomerId)) w.value(static_cast<std::int64_t>(customerId));
+        if (dirty.test(Field::FirstName)) w.string(firstName);
+        if (dirty.test(Field::LastName)) w.string(lastName);
+        if (dirty.test(Field::Email)) w.string(email);
+        if (dirty.test(Field::Age)) w.value(static_cast<std::int32_t>(age));
+    }
+
+    bool Customer::applyDelta(const unsigned char* data, std::size_t size) {
+        hexarch::utils::delta::Reader r(data, size);
+        std::int64_t newId = 0;
+        std::string_view newFirst, newLast, newEmail;
+        std::int32_t newAge = 0;
+        if (r.has(Field::CustomerId)) r.value(newId);
+        if (r.has(Field::FirstName)) r.string(newFirst);
+        if (r.has(Field::LastName)) r.string(newLast);
+        if (r.has(Field::Email)) r.string(newEmail);
+        if (r.has(Field::Age)) r.value(newAge);
+        if (!r.finished() || !dirty.validMask(r.mask())) {
+            return false;
+        }
+
+        if (r.has(Field::CustomerId)) customerId = static_cast<long>(newId);
+        if (r.has(Field::FirstName)) firstName.assign(newFirst.data(), newFirst.size());
+        if (r.has(Field::LastName)) lastName.assign(newLast.data(), newLast.size());
+        if (r.has(Field::Email)) email.assign(newEmail.data(), newEmail.size());
+        if (r.has(Field::Age)) age = newAge;
+        dirty.markMask(r.mask());
+        return true;
+    }
 
 }
 }
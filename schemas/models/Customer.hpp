@@ -1,32 +1,70 @@
 #pragma once
 
+#include "utils/DeltaCodec.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace c_hex {
 namespace domain {
 namespace model {
 
-    class Customer {
+    // Allocator-aware like Order: all three strings live wherever the allocator
+    // passed at construction (or by a std::pmr container) points.
+    class Customer final {
+    public:
+        // Bit positions in dirtyFields() and in delta records.
+        enum class Field : std::uint8_t { CustomerId, FirstName, LastName, Email, Age, Count };
+
     private:
         long customerId;
-        std::string firstName;
-        std::string lastName;
-        std::string email;
+        std::pmr::string firstName;
+        std::pmr::string lastName;
+        std::pmr::string email;
         int age;
+        hexarch::utils::DirtyFields<Field> dirty;
 
     public:
-        Customer(long id, const std::string& first, const std::string& last, const std::string& email, int age);
-        Customer();
-        virtual ~Customer();
+        using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+        Customer(long id, std::string_view first, std::string_view last, std::string_view email, int age,
+                 const allocator_type& alloc = {});
+        explicit Customer(const allocator_type& alloc = {});
+        Customer(const Customer& other, const allocator_type& alloc);
+        Customer(Customer&& other, const allocator_type& alloc);
+        ~Customer();
+        Customer(const Customer&) = default;
+        Customer(Customer&&) noexcept = default;
+        Customer& operator=(const Customer&) = default;
+        Customer& operator=(Customer&&) = default;
+
+        allocator_type get_allocator() const;
 
         long getCustomerId() const;
-        std::string getFirstName() const;
-        std::string getLastName() const;
-        std::string getEmail() const;
+        std::string_view getFirstName() const;
+        std::string_view getLastName() const;
+        std::string_view getEmail() const;
         int getAge() const;
 
-        void setEmail(const std::string& email);
+        // Assigns in place, reusing the address's storage when it fits.
+        void setEmail(std::string_view email);
         void setAge(int age);
+
+        // Fields changed since the last clearDirty(); a new object is all dirty.
+        std::uint64_t dirtyFields() const;
+        bool isDirty(Field field) const;
+        void clearDirty();
+        void markAllDirty();
+
+        // Writes the dirty fields as a delta record (utils/DeltaCodec.hpp) into out.
+        void encodeDelta(std::vector<unsigned char>& out) const;
+        // Applies a record from encodeDelta and marks its fields dirty. A malformed
+        // record returns false and leaves the object unchanged.
+        bool applyDelta(const unsigned char* data, std::size_t size);
     };
 
 }
@@ -1,26 +1,227 @@
 #include "FinancialPortfolio.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
 
 namespace c_hex {
 namespace domain {
 namespace model {
 
-    FinancialPortfolio::FinancialPortfolio(const std::string& id, const std::string& owner, double value)
-        : portfolioId(id), ownerName(owner), totalValue(value), isManaged(true), currency("USD") {}
+    FinancialPortfolio::FinancialPortfolio(std::string id, std::string owner, double value)
+        : portfolioId(std::move(id)), ownerName(std::move(owner)), riskMeasure(RiskMeasure::Covariance),
+          totalValue(value), isManaged(true), currency("USD") {}
 
-    FinancialPortfolio::FinancialPortfolio() : totalValue(0.0), isManaged(false) {}
+    FinancialPortfolio::FinancialPortfolio() : riskMeasure(RiskMeasure::Covariance), totalValue(0.0), isManaged(false) {}
 
     FinancialPortfolio::~FinancialPortfolio() = default;
 
-    std::string FinancialPortfolio::getPortfolioId() const { return portfolioId; }
-    std::string FinancialPortfolio::getOwnerName() const { return ownerName; }
-    std::vector<std::vector<double>> FinancialPortfolio::getHistoricalReturns() const { return historicalReturns; }
-    std::vector<std::vector<float>> FinancialPortfolio::getRiskMatrix() const { return riskMatrix; }
+    const std::string& FinancialPortfolio::getPortfolioId() const { return portfolioId; }
+    const std::string& FinancialPortfolio::getOwnerName() const { return ownerName; }
+    const std::vector<double>& FinancialPortfolio::getAssetAllocation() const { return assetAllocation; }
+    const Grid2D<double>& FinancialPortfolio::getHistoricalReturns() const { return historicalReturns; }
+    const SymmetricMatrix<float>& FinancialPortfolio::getRiskMatrix() const { return riskMatrix; }
+    const ReturnMoments& FinancialPortfolio::getReturnMoments() const { return returnMoments; }
+    RiskMeasure FinancialPortfolio::getRiskMeasure() const { return riskMeasure; }
     double FinancialPortfolio::getTotalValue() const { return totalValue; }
-    std::string FinancialPortfolio::getCurrency() const { return currency; }
+    const std::string& FinancialPortfolio::getCurrency() const { return currency; }
 
-    void FinancialPortfolio::setHistoricalReturns(const std::vector<std::vector<double>>& returns) { historicalReturns = returns; }
-    void FinancialPortfolio::setRiskMatrix(const std::vector<std::vector<float>>& risk) { riskMatrix = risk; }
-    void FinancialPortfolio::setTotalValue(double value) { totalValue = value; }
+    void FinancialPortfolio::setAssetAllocation(std::vector<double> weights) {
+        assetAllocation = std::move(weights);
+        dirty.mark(Field::AssetAllocation);
+    }
+
+    void FinancialPortfolio::setHistoricalReturns(Grid2D<double> returns) {
+        if (returns.rows() == historicalReturns.rows() && returns.cols() == historicalReturns.cols()) {
+            returnRows.markChanged(historicalReturns.data(), returns.data(), returns.rows(), returns.cols());
+        } else {
+            returnRows.markAll();
+        }
+        if (returnRows.any()) {
+            dirty.mark(Field::HistoricalReturns);
+        }
+        historicalReturns = std::move(returns);
+        returnMoments = ReturnMoments();
+    }
+
+    void FinancialPortfolio::setHistoricalReturns(const std::vector<std::vector<double>>& returns) {
+        setHistoricalReturns(Grid2D<double>::fromNested(returns));
+    }
+
+    void FinancialPortfolio::setRiskMatrix(SymmetricMatrix<float> risk) {
+        riskMatrix = std::move(risk);
+        dirty.mark(Field::RiskMatrix);
+    }
+
+    void FinancialPortfolio::setRiskMatrix(const std::vector<std::vector<float>>& risk) {
+        setRiskMatrix(SymmetricMatrix<float>::fromNested(risk));
+    }
+
+    void FinancialPortfolio::setRiskMeasure(RiskMeasure measure) {
+        riskMeasure = measure;
+        dirty.mark(Field::RiskMeasure);
+        if (momentsCurrent() && returnMoments.count() >= 2) {
+            deriveRiskMatrix();
+        }
+    }
+
+    void FinancialPortfolio::setTotalValue(double value) {
+        totalValue = value;
+        dirty.mark(Field::TotalValue);
+    }
+
+    void FinancialPortfolio::setReturnMoments(ReturnMoments moments) {
+        if (moments.count() != historicalReturns.rows() || moments.assetCount() != historicalReturns.cols()) {
+            throw std::invalid_argument("FinancialPortfolio: moments do not match the return history");
+        }
+        returnMoments = std::move(moments);
+        if (returnMoments.count() >= 2) {
+            deriveRiskMatrix();
+        }
+    }
+
+    void FinancialPortfolio::appendReturns(const std::vector<double>& row) {
+        if (!historicalReturns.empty() && row.size() != historicalReturns.cols()) {
+            throw std::invalid_argument("FinancialPortfolio: return row has the wrong asset count");
+        }
+        if (historicalReturns.empty() || !momentsCurrent()) {
+            returnMoments = ReturnMoments(row.size());
+            for (std::size_t t = 0; t < historicalReturns.rows(); ++t) {
+                returnMoments.add(historicalReturns.row(t));
+            }
+        }
+        historicalReturns.appendRow(row.data(), row.size());
+        returnRows.mark(historicalReturns.rows() - 1, historicalReturns.rows());
+        dirty.mark(Field::HistoricalReturns);
+        returnMoments.add(row.data());
+        if (returnMoments.count() >= 2) {
+            deriveRiskMatrix();
+        }
+    }
+
+    double FinancialPortfolio::portfolioVariance() const {
+        if (!momentsCurrent()) {
+            throw std::logic_error("FinancialPortfolio: return moments are stale; recompute them first");
+        }
+        return returnMoments.variance(assetAllocation);
+    }
+
+    bool FinancialPortfolio::momentsCurrent() const {
+        return returnMoments.count() == historicalReturns.rows()
+            && returnMoments.assetCount() == historicalReturns.cols();
+    }
+
+    void FinancialPortfolio::deriveRiskMatrix() {
+        riskMatrix = riskMeasure == RiskMeasure::Correlation ? returnMoments.correlation<float>()
+                                                             : returnMoments.covariance<float>();
+        dirty.mark(Field::RiskMatrix);
+    }
+
+    std::uint64_t FinancialPortfolio::dirtyFields() const { return dirty.mask(); }
+    bool FinancialPortfolio::isDirty(Field field) const { return dirty.test(field); }
+
+    void FinancialPortfolio::clearDirty() {
+        dirty.clear();
+        returnRows.clear();
+    }
+
+    void FinancialPortfolio::markAllDirty() {
+        dirty.markAll();
+        returnRows.markAll();
+    }
+
+    void FinancialPortfolio::encodeDelta(std::vector<unsigned char>& out) const {
+        hexarch::utils::delta::Writer w(out, dirty.mask());
+        if (dirty.test(Field::PortfolioId)) w.string(portfolioId);
+        if (dirty.test(Field::OwnerName)) w.string(ownerName);
+        if (dirty.test(Field::AssetAllocation)) w.array(assetAllocation.data(), assetAllocation.size());
+        if (dirty.test(Field::HistoricalReturns)) {
+            w.grid({ historicalReturns.rows(), historicalReturns.cols() }, historicalReturns.data(),
+                   returnRows.selection(historicalReturns.rows()));
+        }
+        if (dirty.test(Field::RiskMatrix)) {
+            w.value(static_cast<std::uint32_t>(riskMatrix.size()));
+            w.array(riskMatrix.data(), riskMatrix.packedSize());
+        }
+        if (dirty.test(Field::RiskMeasure)) w.value(static_cast<std::uint8_t>(riskMeasure));
+        if (dirty.test(Field::TotalValue)) w.value(totalValue);
+        if (dirty.test(Field::LastUpdated)) w.string(lastUpdated);
+        if (dirty.test(Field::IsManaged)) w.value(isManaged);
+        if (dirty.test(Field::Currency)) w.string(currency);
+    }
+
+    bool FinancialPortfolio::applyDelta(const unsigned char* data, std::size_t size) {
+        using hexarch::utils::delta::GridKind;
+        hexarch::utils::delta::Reader r(data, size);
+        std::string_view newId, newOwner, newLastUpdated, newCurrency;
+        std::vector<double> newAllocation;
+        hexarch::utils::delta::GridPatch<double> returnsPatch;
+        std::uint32_t riskSize = 0;
+        std::vector<float> riskCells;
+        std::uint8_t newMeasure = 0;
+        double newValue = 0.0;
+        bool newManaged = false;
+        if (r.has(Field::PortfolioId)) r.string(newId);
+        if (r.has(Field::OwnerName)) r.string(newOwner);
+        if (r.has(Field::AssetAllocation)) r.array(newAllocation);
+        if (r.has(Field::HistoricalReturns)) r.grid(returnsPatch, 2);
+        if (r.has(Field::RiskMatrix)) {
+            r.value(riskSize);
+            r.array(riskCells);
+        }
+        if (r.has(Field::RiskMeasure)) r.value(newMeasure);
+        if (r.has(Field::TotalValue)) r.value(newValue);
+        if (r.has(Field::LastUpdated)) r.string(newLastUpdated);
+        if (r.has(Field::IsManaged)) r.value(newManaged);
+        if (r.has(Field::Currency)) r.string(newCurrency);
+        if (!r.finished() || !dirty.validMask(r.mask())
+            || riskCells.size() != SymmetricMatrix<float>::rowOffset(riskSize, riskSize)
+            || newMeasure > static_cast<std::uint8_t>(RiskMeasure::Correlation)) {
+            return false;
+        }
+
+        // A period patch may extend the history, but must then carry every new period.
+        const std::size_t oldRows = historicalReturns.rows();
+        if (r.has(Field::HistoricalReturns) && returnsPatch.kind == GridKind::Rows) {
+            std::size_t appended = 0;
+            returnsPatch.forEachRow([&](std::size_t row, const unsigned char*) { appended += row >= oldRows; });
+            const bool colsFit = oldRows == 0 || returnsPatch.dims[1] == historicalReturns.cols();
+            if (!colsFit || returnsPatch.dims[0] < oldRows || appended != returnsPatch.dims[0] - oldRows) {
+                return false;
+            }
+        }
+
+        if (r.has(Field::PortfolioId)) portfolioId.assign(newId.data(), newId.size());
+        if (r.has(Field::OwnerName)) ownerName.assign(newOwner.data(), newOwner.size());
+        if (r.has(Field::AssetAllocation)) assetAllocation = std::move(newAllocation);
+        if (r.has(Field::HistoricalReturns)) {
+            if (returnsPatch.kind == GridKind::Full) {
+                Grid2D<double> replacement(returnsPatch.dims[0], returnsPatch.dims[1]);
+                returnsPatch.applyTo(replacement.data());
+                historicalReturns = std::move(replacement);
+                returnRows.markAll();
+            } else {
+                const std::vector<double> zeros(returnsPatch.dims[1], 0.0);
+                for (std::size_t t = oldRows; t < returnsPatch.dims[0]; ++t) {
+                    historicalReturns.appendRow(zeros.data(), zeros.size());
+                }
+                returnsPatch.applyTo(historicalReturns.data());
+                returnsPatch.forEachRow([&](std::size_t row, const unsigned char*) { returnRows.mark(row, returnsPatch.rowCount); });
+            }
+            returnMoments = ReturnMoments();
+        }
+        if (r.has(Field::RiskMatrix)) {
+            SymmetricMatrix<float> risk(riskSize);
+            std::copy(riskCells.begin(), riskCells.end(), risk.data());
+            riskMatrix = std::move(risk);
+        }
+        if (r.has(Field::RiskMeasure)) riskMeasure = static_cast<RiskMeasure>(newMeasure);
+        if (r.has(Field::TotalValue)) totalValue = newValue;
+        if (r.has(Field::LastUpdated)) lastUpdated.assign(newLastUpdated.data(), newLastUpdated.size());
+        if (r.has(Field::IsManaged)) isManaged = newManaged;
+        if (r.has(Field::Currency)) currency.assign(newCurrency.data(), newCurrency.size());
+        dirty.markMask(r.mask());
+        return true;
+    }
 
 }
 }
@@ -1,5 +1,12 @@
 #pragma once
 
+#include "Grid3D.hpp"
+#include "ReturnMoments.hpp"
+#include "SymmetricMatrix.hpp"
+#include "utils/DeltaCodec.hpp"
+
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -7,33 +14,95 @@ namespace c_hex {
 namespace domain {
 namespace model {
 
+    // What riskMatrix holds when it is derived from the return history.
+    enum class RiskMeasure { Covariance, Correlation };
+
     class FinancialPortfolio {
+    public:
+        // Bit positions in dirtyFields() and in delta records. returnMoments is
+        // not a field: it is derived, and a receiver rebuilds it when needed.
+        enum class Field : std::uint8_t {
+            PortfolioId, OwnerName, AssetAllocation, HistoricalReturns, RiskMatrix,
+            RiskMeasure, TotalValue, LastUpdated, IsManaged, Currency, Count
+        };
+
     private:
         std::string portfolioId;
         std::string ownerName;
         std::vector<double> assetAllocation;
-        std::vector<std::vector<double>> historicalReturns; // 2D
-        std::vector<std::vector<float>> riskMatrix; // 2D
+        Grid2D<double> historicalReturns; // periods x assets
+        SymmetricMatrix<float> riskMatrix;
+        ReturnMoments returnMoments;
+        RiskMeasure riskMeasure;
         double totalValue;
         std::string lastUpdated;
         bool isManaged;
         std::string currency;
+        hexarch::utils::DirtyFields<Field> dirty;
+        // Changed periods of historicalReturns, including appended ones.
+        hexarch::utils::DirtyRows returnRows;
+
+        bool momentsCurrent() const;
+        void deriveRiskMatrix();
 
     public:
-        FinancialPortfolio(const std::string& id, const std::string& owner, double value);
+        FinancialPortfolio(std::string id, std::string owner, double value);
         FinancialPortfolio();
         virtual ~FinancialPortfolio();
+        FinancialPortfolio(const FinancialPortfolio&) = default;
+        FinancialPortfolio(FinancialPortfolio&&) noexcept = default;
+        FinancialPortfolio& operator=(const FinancialPortfolio&) = default;
+        FinancialPortfolio& operator=(FinancialPortfolio&&) noexcept = default;
 
-        std::string getPortfolioId() const;
-        std::string getOwnerName() const;
-        std::vector<std::vector<double>> getHistoricalReturns() const;
-        std::vector<std::vector<float>> getRiskMatrix() const;
+        const std::string& getPortfolioId() const;
+        const std::string& getOwnerName() const;
+        const std::vector<double>& getAssetAllocation() const;
+        const Grid2D<double>& getHistoricalReturns() const;
+        const SymmetricMatrix<float>& getRiskMatrix() const;
+        const ReturnMoments& getReturnMoments() const;
+        RiskMeasure getRiskMeasure() const;
         double getTotalValue() const;
-        std::string getCurrency() const;
+        const std::string& getCurrency() const;
 
+        void setAssetAllocation(std::vector<double> weights);
+        // Replacing the history drops the running moments; riskMatrix is left as
+        // is. A history of the same shape records only the periods that differ.
+        void setHistoricalReturns(Grid2D<double> returns);
         void setHistoricalReturns(const std::vector<std::vector<double>>& returns);
+        void setRiskMatrix(SymmetricMatrix<float> risk);
+        // Upper triangle of a square matrix.
         void setRiskMatrix(const std::vector<std::vector<float>>& risk);
+        void setRiskMeasure(RiskMeasure measure);
         void setTotalValue(double value);
+
+        // Installs moments computed over the whole history (see RiskEngine) and
+        // rebuilds riskMatrix from them.
+        void setReturnMoments(ReturnMoments moments);
+
+        // Appends one period (one return per asset). The moments and riskMatrix
+        // are updated in O(assets^2); if the moments are not current they are
+        // first rebuilt from the history.
+        void appendReturns(const std::vector<double>& row);
+
+        // assetAllocation' * Cov * assetAllocation from the running moments.
+        double portfolioVariance() const;
+
+        // Fields changed since the last clearDirty(); a new object is all dirty.
+        // A riskMatrix derived from the moments counts as changed.
+        std::uint64_t dirtyFields() const;
+        bool isDirty(Field field) const;
+        void clearDirty();
+        void markAllDirty();
+
+        // Writes the dirty fields as a delta record (utils/DeltaCodec.hpp) into
+        // out; historicalReturns goes as its changed or appended periods when few
+        // changed, riskMatrix always whole.
+        void encodeDelta(std::vector<unsigned char>& out) const;
+        // Applies a record from encodeDelta and marks what it changed dirty. A
+        // patched history drops the running moments, as setHistoricalReturns
+        // does. A malformed record, or a period patch that does not fit the
+        // history, returns false and leaves the object unchanged.
+        bool applyDelta(const unsigned char* data, std::size_t size);
     };
 
 }
@@ -1,28 +1,98 @@
 #include "GameMap.hpp"
+#include <stdexcept>
+#include <utility>
 
 namespace c_hex {
 namespace domain {
 namespace model {
 
-    GameMap::GameMap(long id, const std::string& name, 
+    GameMap::GameMap(long id, std::string name, 
+                   Grid2D<int> terrain,
+                   int diff, int maxP, bool ranked)
+        : mapId(id), name(std::move(name)), terrain(std::move(terrain)), 
+          difficulty(diff), maxPlayers(maxP), isRanked(ranked), publishedTerrain(SharedGrid2D<int>(this->terrain)) {}
+
+    GameMap::GameMap(long id, std::string name, 
                    const std::vector<std::vector<int>>& terrain,
                    int diff, int maxP, bool ranked)
-        : mapId(id), name(name), terrain(terrain), 
-          difficulty(diff), maxPlayers(maxP), isRanked(ranked) {}
+        : GameMap(id, std::move(name), Grid2D<int>::fromNested(terrain), diff, maxP, ranked) {}
 
     GameMap::GameMap() : mapId(0), difficulty(0), maxPlayers(0), isRanked(false) {}
 
     GameMap::~GameMap() = default;
 
     long GameMap::getMapId() const { return mapId; }
-    std::string GameMap::getName() const { return name; }
-    std::vector<std::vector<int>> GameMap::getTerrain() const { return terrain; }
-    std::vector<std::vector<std::string>> GameMap::getObjectPlacement() const { return objectPlacement; }
+    const std::string& GameMap::getName() const { return name; }
+    const Grid2D<int>& GameMap::getTerrain() const { return terrain; }
+    const Grid2D<ObjectId>& GameMap::getObjectPlacement() const { return objectPlacement; }
+    const StringDictionary& GameMap::getObjectNames() const { return objectNames; }
     int GameMap::getDifficulty() const { return difficulty; }
     bool GameMap::getIsRanked() const { return isRanked; }
 
-    void GameMap::setTerrain(const std::vector<std::vector<int>>& t) { terrain = t; }
-    void GameMap::setTags(const std::vector<std::string>& t) { tags = t; }
+    GameMap::TerrainSnapshot GameMap::terrainSnapshot() const { return publishedTerrain.read(); }
+
+    std::size_t GameMap::width() const { return terrain.cols(); }
+    std::size_t GameMap::height() const { return terrain.rows(); }
+
+    bool GameMap::isPassable(std::size_t x, std::size_t y) const {
+        return x < terrain.cols() && y < terrain.rows() && terrain.at(y, x) >= 0;
+    }
+
+    const std::string& GameMap::objectAt(std::size_t x, std::size_t y) const {
+        return objectNames.name(objectIdAt(x, y));
+    }
+
+    ObjectId GameMap::objectIdAt(std::size_t x, std::size_t y) const {
+        if (x >= objectPlacement.cols() || y >= objectPlacement.rows()) {
+            return StringDictionary::kNone;
+        }
+        return objectPlacement.at(y, x);
+    }
+
+    void GameMap::setTerrain(Grid2D<int> t) {
+        terrain = std::move(t);
+        publishedTerrain.update([&](const SharedGrid2D<int>& current) { return current.rebase(terrain); });
+    }
+
+    void GameMap::setTerrain(const std::vector<std::vector<int>>& t) { setTerrain(Grid2D<int>::fromNested(t)); }
+
+    void GameMap::setObjectPlacement(const std::vector<std::vector<std::string>>& placement) {
+        const std::size_t rows = placement.size();
+        const std::size_t cols = rows ? placement[0].size() : 0;
+        Grid2D<ObjectId> ids(rows, cols);
+        for (std::size_t y = 0; y < rows; ++y) {
+            if (placement[y].size() != cols) {
+                throw std::invalid_argument("GameMap: ragged object placement");
+            }
+            for (std::size_t x = 0; x < cols; ++x) {
+                ids.at(y, x) = objectNames.intern(placement[y][x]);
+            }
+        }
+        objectPlacement = std::move(ids);
+    }
+
+    void GameMap::placeObject(std::size_t x, std::size_t y, std::string_view object) {
+        if (objectPlacement.empty()) {
+            objectPlacement = Grid2D<ObjectId>(terrain.rows(), terrain.cols());
+        }
+        if (x >= objectPlacement.cols() || y >= objectPlacement.rows()) {
+            throw std::out_of_range("GameMap: object position outside the map");
+        }
+        objectPlacement.at(y, x) = objectNames.intern(object);
+    }
+
+    void GameMap::setTags(std::vector<std::string> t) { tags = std::move(t); }
+
+    std::vector<std::vector<std::string>> GameMap::objectPlacementNames() const {
+        std::vector<std::vector<std::string>> nested(objectPlacement.rows());
+        for (std::size_t y = 0; y < objectPlacement.rows(); ++y) {
+            nested[y].reserve(objectPlacement.cols());
+            for (std::size_t x = 0; x < objectPlacement.cols(); ++x) {
+                nested[y].push_back(objectNames.name(objectPlacement.at(y, x)));
+            }
+        }
+        return nested;
+    }
 
 }
 }
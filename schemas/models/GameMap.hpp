@@ -1,39 +1,80 @@
 #pragma once
 
+#include "Grid3D.hpp"
+#include "StringDictionary.hpp"
+#include "utils/Versioned.hpp"
+
+#include <cstddef>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace c_hex {
 namespace domain {
 namespace model {
 
+    using ObjectId = StringDictionary::Id;
+
     class GameMap {
     private:
         long mapId;
         std::string name;
-        std::vector<std::vector<int>> terrain;
-        std::vector<std::vector<std::string>> objectPlacement;
+        Grid2D<int> terrain; // rows = y, cols = x; < 0 = impassable
+        Grid2D<ObjectId> objectPlacement; // ids into objectNames, 0 = empty
+        StringDictionary objectNames;
         int difficulty;
         int maxPlayers;
         bool isRanked;
         std::vector<std::string> tags;
+        // terrain as of the last setTerrain(), for other threads.
+        hexarch::utils::Versioned<SharedGrid2D<int>> publishedTerrain;
 
     public:
-        GameMap(long id, const std::string& name, 
+        using TerrainSnapshot = hexarch::utils::Versioned<SharedGrid2D<int>>::Snapshot;
+
+        GameMap(long id, std::string name, 
+               Grid2D<int> terrain,
+               int diff, int maxP, bool ranked);
+        GameMap(long id, std::string name, 
                const std::vector<std::vector<int>>& terrain,
                int diff, int maxP, bool ranked);
         GameMap();
         virtual ~GameMap();
+        GameMap(const GameMap&) = default;
+        GameMap(GameMap&&) noexcept = default;
+        GameMap& operator=(const GameMap&) = default;
+        GameMap& operator=(GameMap&&) noexcept = default;
 
         long getMapId() const;
-        std::string getName() const;
-        std::vector<std::vector<int>> getTerrain() const;
-        std::vector<std::vector<std::string>> getObjectPlacement() const;
+        const std::string& getName() const;
+        const Grid2D<int>& getTerrain() const;
+        const Grid2D<ObjectId>& getObjectPlacement() const;
+        const StringDictionary& getObjectNames() const;
         int getDifficulty() const;
         bool getIsRanked() const;
 
+        // The terrain for readers on other threads (path finding, rendering):
+        // wait-free, and unchanged for as long as the snapshot is held.
+        // setTerrain() publishes the next version, sharing unchanged rows.
+        TerrainSnapshot terrainSnapshot() const;
+
+        std::size_t width() const;
+        std::size_t height() const;
+        bool isPassable(std::size_t x, std::size_t y) const;
+
+        // Empty string when nothing is placed at (x, y).
+        const std::string& objectAt(std::size_t x, std::size_t y) const;
+        ObjectId objectIdAt(std::size_t x, std::size_t y) const;
+
+        void setTerrain(Grid2D<int> t);
         void setTerrain(const std::vector<std::vector<int>>& t);
-        void setTags(const std::vector<std::string>& t);
+        // Interns every name; "" leaves the cell empty.
+        void setObjectPlacement(const std::vector<std::vector<std::string>>& placement);
+        // Sizes the placement grid to the terrain on first use.
+        void placeObject(std::size_t x, std::size_t y, std::string_view object);
+        void setTags(std::vector<std::string> t);
+
+        std::vector<std::vector<std::string>> objectPlacementNames() const;
     };
 
 }
@@ -0,0 +1,330 @@
+#pragma once
+
+#include "utils/SharedBlocks.hpp"
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace c_hex {
+namespace domain {
+namespace model {
+
+    // Dense x/y/z grid in one allocation. z is the fastest-moving axis, so a
+    // fixed x (one aisle) is a contiguous block of strideX() cells.
+    template <typename T>
+    class Grid3D {
+    public:
+        Grid3D() = default;
+
+        Grid3D(std::size_t sizeX, std::size_t sizeY, std::size_t sizeZ, T init = T())
+            : dimX(sizeX), dimY(sizeY), dimZ(sizeZ), cells(sizeX * sizeY * sizeZ, init) {}
+
+        // A moved-from grid is empty: its sizes drop to 0 with its cells, so
+        // bounds checks against them stay correct.
+        Grid3D(const Grid3D&) = default;
+        Grid3D& operator=(const Grid3D&) = default;
+        Grid3D(Grid3D&& other) noexcept
+            : dimX(std::exchange(other.dimX, 0)), dimY(std::exchange(other.dimY, 0)), dimZ(std::exchange(other.dimZ, 0)),
+              cells(std::move(other.cells)) {}
+        Grid3D& operator=(Grid3D&& other) noexcept {
+            if (this != &other) {
+                dimX = std::exchange(other.dimX, 0);
+                dimY = std::exchange(other.dimY, 0);
+                dimZ = std::exchange(other.dimZ, 0);
+                cells = std::move(other.cells);
+            }
+            return *this;
+        }
+
+        // Packs a nested [x][y][z] vector; every row must have the same length.
+        static Grid3D fromNested(const std::vector<std::vector<std::vector<T>>>& nested) {
+            const std::size_t sx = nested.size();
+            const std::size_t sy = sx ? nested[0].size() : 0;
+            const std::size_t sz = sy ? nested[0][0].size() : 0;
+            Grid3D grid(sx, sy, sz);
+            T* out = grid.cells.data();
+            for (const auto& plane : nested) {
+                if (plane.size() != sy) {
+                    throw std::invalid_argument("Grid3D: ragged y dimension");
+                }
+                for (const auto& row : plane) {
+                    if (row.size() != sz) {
+                        throw std::invalid_argument("Grid3D: ragged z dimension");
+                    }
+                    for (const T& v : row) {
+                        *out++ = v;
+                    }
+                }
+            }
+            return grid;
+        }
+
+        std::vector<std::vector<std::vector<T>>> toNested() const {
+            std::vector<std::vector<std::vector<T>>> nested(dimX, std::vector<std::vector<T>>(dimY));
+            for (std::size_t x = 0; x < dimX; ++x) {
+                for (std::size_t y = 0; y < dimY; ++y) {
+                    const T* row = cells.data() + x * strideX() + y * strideY();
+                    nested[x][y].assign(row, row + dimZ);
+                }
+            }
+            return nested;
+        }
+
+        std::size_t sizeX() const { return dimX; }
+        std::size_t sizeY() const { return dimY; }
+        std::size_t sizeZ() const { return dimZ; }
+        std::size_t size() const { return cells.size(); }
+        bool empty() const { return cells.empty(); }
+
+        std::size_t strideX() const { return dimY * dimZ; }
+        std::size_t strideY() const { return dimZ; }
+        static constexpr std::size_t strideZ() { return 1; }
+
+        std::size_t index(std::size_t x, std::size_t y, std::size_t z) const { return x * strideX() + y * strideY() + z; }
+
+        T& at(std::size_t x, std::size_t y, std::size_t z) { return cells[index(x, y, z)]; }
+        const T& at(std::size_t x, std::size_t y, std::size_t z) const { return cells[index(x, y, z)]; }
+
+        T* data() { return cells.data(); }
+        const T* data() const { return cells.data(); }
+
+        // Start of the contiguous y/z block for one x slice.
+        T* slice(std::size_t x) { return cells.data() + x * strideX(); }
+        const T* slice(std::size_t x) const { return cells.data() + x * strideX(); }
+
+    private:
+        std::size_t dimX = 0;
+        std::size_t dimY = 0;
+        std::size_t dimZ = 0;
+        std::vector<T> cells;
+    };
+
+    // Dense row-major 2D field.
+    template <typename T>
+    class Grid2D {
+    public:
+        Grid2D() = default;
+
+        Grid2D(std::size_t rows, std::size_t cols, T init = T())
+            : numRows(rows), numCols(cols), cells(rows * cols, init) {}
+
+        // Moves leave the source empty, sizes included; see Grid3D.
+        Grid2D(const Grid2D&) = default;
+        Grid2D& operator=(const Grid2D&) = default;
+        Grid2D(Grid2D&& other) noexcept
+            : numRows(std::exchange(other.numRows, 0)), numCols(std::exchange(other.numCols, 0)), cells(std::move(other.cells)) {}
+        Grid2D& operator=(Grid2D&& other) noexcept {
+            if (this != &other) {
+                numRows = std::exchange(other.numRows, 0);
+                numCols = std::exchange(other.numCols, 0);
+                cells = std::move(other.cells);
+            }
+            return *this;
+        }
+
+        static Grid2D fromNested(const std::vector<std::vector<T>>& nested) {
+            const std::size_t rows = nested.size();
+            const std::size_t cols = rows ? nested[0].size() : 0;
+            Grid2D grid(rows, cols);
+            T* out = grid.cells.data();
+            for (const auto& row : nested) {
+                if (row.size() != cols) {
+                    throw std::invalid_argument("Grid2D: ragged rows");
+                }
+                for (const T& v : row) {
+                    *out++ = v;
+                }
+            }
+            return grid;
+        }
+
+        std::vector<std::vector<T>> toNested() const {
+            std::vector<std::vector<T>> nested(numRows);
+            for (std::size_t r = 0; r < numRows; ++r) {
+                nested[r].assign(row(r), row(r) + numCols);
+            }
+            return nested;
+        }
+
+        std::size_t rows() const { return numRows; }
+        std::size_t cols() const { return numCols; }
+        std::size_t size() const { return cells.size(); }
+        bool empty() const { return cells.empty(); }
+
+        T& at(std::size_t r, std::size_t c) { return cells[r * numCols + c]; }
+        const T& at(std::size_t r, std::size_t c) const { return cells[r * numCols + c]; }
+
+        T* row(std::size_t r) { return cells.data() + r * numCols; }
+        const T* row(std::size_t r) const { return cells.data() + r * numCols; }
+
+        T* data() { return cells.data(); }
+        const T* data() const { return cells.data(); }
+
+        // Adds a row at the bottom; the first row of an empty grid sets cols().
+        void appendRow(const T* values, std::size_t count) {
+            if (numRows == 0) {
+                numCols = count;
+            } else if (count != numCols) {
+                throw std::invalid_argument("Grid2D: appended row has the wrong length");
+            }
+            cells.insert(cells.end(), values, values + count);
+            ++numRows;
+        }
+
+    private:
+        std::size_t numRows = 0;
+        std::size_t numCols = 0;
+        std::vector<T> cells;
+    };
+
+    // Read-only copy of a Grid3D for Versioned snapshots. Whole z runs are
+    // grouped into blocks, and rebase()/with() share every block that did not
+    // change with the previous version. Writers that track their changed z
+    // runs (row x * sizeY + y, as DirtyRows counts them) pass those to rebase()
+    // instead of having every block compared.
+    template <typename T>
+    class SharedGrid3D {
+    public:
+        SharedGrid3D() = default;
+
+        explicit SharedGrid3D(const Grid3D<T>& grid)
+            : dimX(grid.sizeX()), dimY(grid.sizeY()), dimZ(grid.sizeZ()),
+              cells(grid.data(), grid.size(), hexarch::utils::SharedBlocks<T>::blockSizeForRows(grid.sizeZ())) {}
+
+        // Moves leave the source empty, sizes included; see Grid3D.
+        SharedGrid3D(const SharedGrid3D&) = default;
+        SharedGrid3D& operator=(const SharedGrid3D&) = default;
+        SharedGrid3D(SharedGrid3D&& other) noexcept
+            : dimX(std::exchange(other.dimX, 0)), dimY(std::exchange(other.dimY, 0)), dimZ(std::exchange(other.dimZ, 0)),
+              cells(std::move(other.cells)) {}
+        SharedGrid3D& operator=(SharedGrid3D&& other) noexcept {
+            if (this != &other) {
+                dimX = std::exchange(other.dimX, 0);
+                dimY = std::exchange(other.dimY, 0);
+                dimZ = std::exchange(other.dimZ, 0);
+                cells = std::move(other.cells);
+            }
+            return *this;
+        }
+
+        // The next version after grid changed; a new shape copies everything.
+        SharedGrid3D rebase(const Grid3D<T>& grid) const {
+            if (grid.sizeX() != dimX || grid.sizeY() != dimY || grid.sizeZ() != dimZ || cells.empty()) {
+                return SharedGrid3D(grid);
+            }
+            return SharedGrid3D(dimX, dimY, dimZ, cells.rebase(grid.data(), grid.size()));
+        }
+
+        // Only the z runs marked in changedRows are copied; a new shape copies everything.
+        SharedGrid3D rebase(const Grid3D<T>& grid, const hexarch::utils::Bitmap& changedRows) const {
+            if (grid.sizeX() != dimX || grid.sizeY() != dimY || grid.sizeZ() != dimZ || cells.empty()) {
+                return SharedGrid3D(grid);
+            }
+            return SharedGrid3D(dimX, dimY, dimZ, cells.rebase(grid.data(), grid.size(), cells.blocksOfRows(changedRows, dimZ)));
+        }
+
+        SharedGrid3D with(std::size_t x, std::size_t y, std::size_t z, const T& value) const {
+            return SharedGrid3D(dimX, dimY, dimZ, cells.with(index(x, y, z), value));
+        }
+
+        std::size_t sizeX() const { return dimX; }
+        std::size_t sizeY() const { return dimY; }
+        std::size_t sizeZ() const { return dimZ; }
+        std::size_t size() const { return cells.size(); }
+        bool empty() const { return cells.empty(); }
+
+        std::size_t index(std::size_t x, std::size_t y, std::size_t z) const { return x * dimY * dimZ + y * dimZ + z; }
+        const T& at(std::size_t x, std::size_t y, std::size_t z) const { return cells[index(x, y, z)]; }
+
+        // In Grid3D order; see SharedBlocks::forEachBlock.
+        const hexarch::utils::SharedBlocks<T>& blocks() const { return cells; }
+
+        Grid3D<T> toGrid() const {
+            Grid3D<T> grid(dimX, dimY, dimZ);
+            cells.copyTo(grid.data());
+            return grid;
+        }
+
+    private:
+        SharedGrid3D(std::size_t sizeX, std::size_t sizeY, std::size_t sizeZ, hexarch::utils::SharedBlocks<T> cells)
+            : dimX(sizeX), dimY(sizeY), dimZ(sizeZ), cells(std::move(cells)) {}
+
+        std::size_t dimX = 0;
+        std::size_t dimY = 0;
+        std::size_t dimZ = 0;
+        hexarch::utils::SharedBlocks<T> cells;
+    };
+
+    // Read-only copy of a Grid2D for Versioned snapshots, in blocks of whole
+    // rows; see SharedGrid3D.
+    template <typename T>
+    class SharedGrid2D {
+    public:
+        SharedGrid2D() = default;
+
+        explicit SharedGrid2D(const Grid2D<T>& grid)
+            : numRows(grid.rows()), numCols(grid.cols()),
+              cells(grid.data(), grid.size(), hexarch::utils::SharedBlocks<T>::blockSizeForRows(grid.cols())) {}
+
+        // Moves leave the source empty, sizes included; see Grid3D.
+        SharedGrid2D(const SharedGrid2D&) = default;
+        SharedGrid2D& operator=(const SharedGrid2D&) = default;
+        SharedGrid2D(SharedGrid2D&& other) noexcept
+            : numRows(std::exchange(other.numRows, 0)), numCols(std::exchange(other.numCols, 0)),
+              cells(std::move(other.cells)) {}
+        SharedGrid2D& operator=(SharedGrid2D&& other) noexcept {
+            if (this != &other) {
+                numRows = std::exchange(other.numRows, 0);
+                numCols = std::exchange(other.numCols, 0);
+                cells = std::move(other.cells);
+            }
+            return *this;
+        }
+
+        SharedGrid2D rebase(const Grid2D<T>& grid) const {
+            if (grid.rows() != numRows || grid.cols() != numCols || cells.empty()) {
+                return SharedGrid2D(grid);
+            }
+            return SharedGrid2D(numRows, numCols, cells.rebase(grid.data(), grid.size()));
+        }
+
+        SharedGrid2D rebase(const Grid2D<T>& grid, const hexarch::utils::Bitmap& changedRows) const {
+            if (grid.rows() != numRows || grid.cols() != numCols || cells.empty()) {
+                return SharedGrid2D(grid);
+            }
+            return SharedGrid2D(numRows, numCols, cells.rebase(grid.data(), grid.size(), cells.blocksOfRows(changedRows, numCols)));
+        }
+
+        SharedGrid2D with(std::size_t r, std::size_t c, const T& value) const {
+            return SharedGrid2D(numRows, numCols, cells.with(r * numCols + c, value));
+        }
+
+        std::size_t rows() const { return numRows; }
+        std::size_t cols() const { return numCols; }
+        std::size_t size() const { return cells.size(); }
+        bool empty() const { return cells.empty(); }
+
+        const T& at(std::size_t r, std::size_t c) const { return cells[r * numCols + c]; }
+
+        const hexarch::utils::SharedBlocks<T>& blocks() const { return cells; }
+
+        Grid2D<T> toGrid() const {
+            Grid2D<T> grid(numRows, numCols);
+            cells.copyTo(grid.data());
+            return grid;
+        }
+
+    private:
+        SharedGrid2D(std::size_t rows, std::size_t cols, hexarch::utils::SharedBlocks<T> cells)
+            : numRows(rows), numCols(cols), cells(std::move(cells)) {}
+
+        std::size_t numRows = 0;
+        std::size_t numCols = 0;
+        hexarch::utils::SharedBlocks<T> cells;
+    };
+
+}
+}
+}
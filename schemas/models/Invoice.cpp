@@ -1,18 +1,27 @@
 #include "Invoice.hpp"
+#include <utility>
 
 namespace c_hex {
 namespace domain {
 namespace model {
 
-    Invoice::Invoice(const std::string& number, const std::string& date, bool paid)
-        : invoiceNumber(number), issueDate(date), isPaid(paid) {}
+    Invoice::Invoice(std::string_view number, std::string_view date, bool paid, const allocator_type& alloc)
+        : invoiceNumber(number, alloc), issueDate(date, alloc), isPaid(paid) {}
 
-    Invoice::Invoice() : isPaid(false) {}
+    Invoice::Invoice(const allocator_type& alloc) : invoiceNumber(alloc), issueDate(alloc), isPaid(false) {}
+
+    Invoice::Invoice(const Invoice& other, const allocator_type& alloc)
+        : invoiceNumber(other.invoiceNumber, alloc), issueDate(other.issueDate, alloc), isPaid(other.isPaid) {}
+
+    Invoice::Invoice(Invoice&& other, const allocator_type& alloc)
+        : invoiceNumber(std::move(other.invoiceNumber), alloc), issueDate(std::move(other.issueDate), alloc), isPaid(other.isPaid) {}
 
     Invoice::~Invoice() = default;
 
-    std::string Invoice::getInvoiceNumber() const { return invoiceNumber; }
-    std::string Invoice::getIssueDate() const { return issueDate; }
+    Invoice::allocator_type Invoice::get_allocator() const { return invoiceNumber.get_allocator(); }
+
+    std::string_view Invoice::getInvoiceNumber() const { return invoiceNumber; }
+    std::string_view Invoice::getIssueDate() const { return issueDate; }
     bool Invoice::getIsPaid() const { return isPaid; }
 
     void Invoice::setPaid(bool paid) { isPaid = paid; }
@@ -1,24 +1,38 @@
 #pragma once
 
+#include <memory_resource>
 #include <string>
+#include <string_view>
 
 namespace c_hex {
 namespace domain {
 namespace model {
 
-    class Invoice {
+    // Allocator-aware like Order: number and date live wherever the allocator
+    // passed at construction (or by a std::pmr container) points.
+    class Invoice final {
     private:
-        std::string invoiceNumber;
-        std::string issueDate;
+        std::pmr::string invoiceNumber;
+        std::pmr::string issueDate;
         bool isPaid;
 
     public:
-        Invoice(const std::string& number, const std::string& date, bool paid);
-        Invoice();
-        virtual ~Invoice();
+        using allocator_type = std::pmr::polymorphic_allocator<char>;
 
-        std::string getInvoiceNumber() const;
-        std::string getIssueDate() const;
+        Invoice(std::string_view number, std::string_view date, bool paid, const allocator_type& alloc = {});
+        explicit Invoice(const allocator_type& alloc = {});
+        Invoice(const Invoice& other, const allocator_type& alloc);
+        Invoice(Invoice&& other, const allocator_type& alloc);
+        ~Invoice();
+        Invoice(const Invoice&) = default;
+        Invoice(Invoice&&) noexcept = default;
+        Invoice& operator=(const Invoice&) = default;
+        Invoice& operator=(Invoice&&) = default;
+
+        allocator_type get_allocator() const;
+
+        std::string_view getInvoiceNumber() const;
+        std::string_view getIssueDate() const;
         bool getIsPaid() const;
 
         void setPaid(bool paid);
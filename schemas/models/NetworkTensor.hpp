@@ -0,0 +1,375 @@
+#pragma once
+
+#include "utils/SharedBlocks.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace c_hex {
+namespace domain {
+namespace model {
+
+    // Non-owning view over a row-major matrix whose rows start `stride` elements apart.
+    // `stride` is the BLAS leading dimension, so views can be handed to gemv/gemm as-is.
+    template <typename T>
+    struct MatrixView {
+        T* data = nullptr;
+        std::size_t rows = 0;
+        std::size_t cols = 0;
+        std::size_t stride = 0;
+
+        T* row(std::size_t r) const { return data + r * stride; }
+        T& operator()(std::size_t r, std::size_t c) const { return data[r * stride + c]; }
+    };
+
+    template <typename T>
+    struct VectorView {
+        T* data = nullptr;
+        std::size_t size = 0;
+
+        T* begin() const { return data; }
+        T* end() const { return data + size; }
+        T& operator[](std::size_t i) const { return data[i]; }
+    };
+
+    // Weights and biases of a fully connected network in one aligned allocation.
+    //
+    // For layer l (0 <= l < layerCount()) the weight matrix is
+    // layerSizes[l + 1] x layerSizes[l] (outputs x inputs) and the bias vector has
+    // layerSizes[l + 1] entries. Every matrix row and every bias vector starts on a
+    // kAlignment boundary; the padding between rows is kept zeroed.
+    template <typename T>
+    class NetworkTensor {
+    public:
+        static constexpr std::size_t kAlignment = 64;
+        static constexpr std::size_t kLane = kAlignment / sizeof(T);
+
+        NetworkTensor() = default;
+
+        explicit NetworkTensor(const std::vector<int>& layerSizes) {
+            if (layerSizes.size() < 2) {
+                return;
+            }
+            for (int size : layerSizes) {
+                if (size <= 0) {
+                    throw std::invalid_argument("NetworkTensor: layer sizes must be positive");
+                }
+            }
+            layers.reserve(layerSizes.size() - 1);
+            std::size_t offset = 0;
+            for (std::size_t l = 0; l + 1 < layerSizes.size(); ++l) {
+                Layer layer;
+                layer.inputs = static_cast<std::size_t>(layerSizes[l]);
+                layer.outputs = static_cast<std::size_t>(layerSizes[l + 1]);
+                layer.stride = padded(layer.inputs);
+                layer.weightOffset = offset;
+                offset += layer.outputs * layer.stride;
+                layer.biasOffset = offset;
+                offset += padded(layer.outputs);
+                layers.push_back(layer);
+            }
+            allocate(offset);
+        }
+
+        NetworkTensor(const NetworkTensor& other) : layers(other.layers) {
+            allocate(other.capacity);
+            if (capacity) {
+                std::memcpy(storage, other.storage, capacity * sizeof(T));
+            }
+        }
+
+        NetworkTensor(NetworkTensor&& other) noexcept
+            : layers(std::move(other.layers)),
+              storage(std::exchange(other.storage, nullptr)),
+              capacity(std::exchange(other.capacity, 0)) {}
+
+        NetworkTensor& operator=(const NetworkTensor& other) {
+            if (this != &other) {
+                NetworkTensor copy(other);
+                swap(copy);
+            }
+            return *this;
+        }
+
+        NetworkTensor& operator=(NetworkTensor&& other) noexcept {
+            NetworkTensor moved(std::move(other));
+            swap(moved);
+            return *this;
+        }
+
+        ~NetworkTensor() { release(); }
+
+        void swap(NetworkTensor& other) noexcept {
+            layers.swap(other.layers);
+            std::swap(storage, other.storage);
+            std::swap(capacity, other.capacity);
+        }
+
+        bool empty() const { return layers.empty(); }
+        std::size_t layerCount() const { return layers.size(); }
+        std::size_t inputSize(std::size_t l) const { return layers.at(l).inputs; }
+        std::size_t outputSize(std::size_t l) const { return layers.at(l).outputs; }
+
+        // Number of parameters excluding padding.
+        std::size_t parameterCount() const {
+            std::size_t n = 0;
+            for (const Layer& layer : layers) {
+                n += layer.outputs * layer.inputs + layer.outputs;
+            }
+            return n;
+        }
+
+        T* data() { return storage; }
+        const T* data() const { return storage; }
+        std::size_t sizeBytes() const { return capacity * sizeof(T); }
+
+        MatrixView<T> weights(std::size_t l) {
+            const Layer& layer = layers.at(l);
+            return { storage + layer.weightOffset, layer.outputs, layer.inputs, layer.stride };
+        }
+
+        MatrixView<const T> weights(std::size_t l) const {
+            const Layer& layer = layers.at(l);
+            return { storage + layer.weightOffset, layer.outputs, layer.inputs, layer.stride };
+        }
+
+        VectorView<T> biases(std::size_t l) {
+            const Layer& layer = layers.at(l);
+            return { storage + layer.biasOffset, layer.outputs };
+        }
+
+        VectorView<const T> biases(std::size_t l) const {
+            const Layer& layer = layers.at(l);
+            return { storage + layer.biasOffset, layer.outputs };
+        }
+
+        // Bulk load from a dense buffer laid out as W0, b0, W1, b1, ... with
+        // row-major, unpadded weight matrices (parameterCount() values in total).
+        template <typename U>
+        void load(const U* src, std::size_t count) {
+            if (count != parameterCount()) {
+                throw std::invalid_argument("NetworkTensor: parameter count mismatch");
+            }
+            for (std::size_t l = 0; l < layers.size(); ++l) {
+                MatrixView<T> w = weights(l);
+                for (std::size_t r = 0; r < w.rows; ++r, src += w.cols) {
+                    std::copy(src, src + w.cols, w.row(r));
+                }
+                VectorView<T> b = biases(l);
+                std::copy(src, src + b.size, b.data);
+                src += b.size;
+            }
+        }
+
+        // Inverse of load(): writes the dense W0, b0, W1, b1, ... layout into dst.
+        void store(T* dst) const {
+            for (std::size_t l = 0; l < layers.size(); ++l) {
+                MatrixView<const T> w = weights(l);
+                for (std::size_t r = 0; r < w.rows; ++r, dst += w.cols) {
+                    std::copy(w.row(r), w.row(r) + w.cols, dst);
+                }
+                VectorView<const T> b = biases(l);
+                dst = std::copy(b.begin(), b.end(), dst);
+            }
+        }
+
+        // Same shape, elements converted to U (e.g. float32 inference copy).
+        template <typename U>
+        NetworkTensor<U> convert() const {
+            NetworkTensor<U> out(layerSizes());
+            for (std::size_t l = 0; l < layers.size(); ++l) {
+                MatrixView<const T> src = weights(l);
+                MatrixView<U> dst = out.weights(l);
+                for (std::size_t r = 0; r < src.rows; ++r) {
+                    std::copy(src.row(r), src.row(r) + src.cols, dst.row(r));
+                }
+                VectorView<const T> b = biases(l);
+                std::copy(b.begin(), b.end(), out.biases(l).data);
+            }
+            return out;
+        }
+
+        std::vector<int> layerSizes() const {
+            std::vector<int> sizes;
+            if (!layers.empty()) {
+                sizes.push_back(static_cast<int>(layers.front().inputs));
+                for (const Layer& layer : layers) {
+                    sizes.push_back(static_cast<int>(layer.outputs));
+                }
+            }
+            return sizes;
+        }
+
+    private:
+        struct Layer {
+            std::size_t inputs;
+            std::size_t outputs;
+            std::size_t stride;
+            std::size_t weightOffset;
+            std::size_t biasOffset;
+        };
+
+        static std::size_t padded(std::size_t n) { return (n + kLane - 1) / kLane * kLane; }
+
+        void allocate(std::size_t elements) {
+            if (elements == 0) {
+                return;
+            }
+            storage = static_cast<T*>(::operator new(elements * sizeof(T), std::align_val_t(kAlignment)));
+            capacity = elements;
+            std::fill(storage, storage + capacity, T());
+        }
+
+        void release() {
+            if (storage) {
+                ::operator delete(storage, std::align_val_t(kAlignment));
+                storage = nullptr;
+                capacity = 0;
+            }
+        }
+
+        std::vector<Layer> layers;
+        T* storage = nullptr;
+        std::size_t capacity = 0;
+    };
+
+    using NetworkTensorF64 = NetworkTensor<double>;
+    using NetworkTensorF32 = NetworkTensor<float>;
+
+    // Read-only copy of a NetworkTensor for Versioned snapshots. Each layer's
+    // weights are stored as SharedBlocks of whole padded rows (about 4 KiB per
+    // block) and its biases as one more block, so a version shares with the
+    // previous one every block that did not change, not just whole layers.
+    // rebase() compares the blocks to find those; rebaseBiases() is for a
+    // writer that only touched the biases and shares every weight block unread.
+    template <typename T>
+    class SharedNetworkTensor {
+    public:
+        SharedNetworkTensor() = default;
+
+        explicit SharedNetworkTensor(const NetworkTensor<T>& tensor) : SharedNetworkTensor(SharedNetworkTensor().rebase(tensor)) {}
+
+        SharedNetworkTensor rebase(const NetworkTensor<T>& tensor) const {
+            SharedNetworkTensor next;
+            next.layers.reserve(tensor.layerCount());
+            for (std::size_t l = 0; l < tensor.layerCount(); ++l) {
+                const MatrixView<const T> w = tensor.weights(l);
+                const VectorView<const T> b = tensor.biases(l);
+                if (l < layers.size() && sameShape(layers[l], w)) {
+                    next.layers.push_back({ w.cols, w.stride, layers[l].weights.rebase(w.data, w.rows * w.stride),
+                                            layers[l].biases.rebase(b.data, b.size) });
+                } else {
+                    next.layers.push_back(copyLayer(w, b));
+                }
+            }
+            return next;
+        }
+
+        // As rebase(), for a tensor whose weights are unchanged since this version.
+        SharedNetworkTensor rebaseBiases(const NetworkTensor<T>& tensor) const {
+            if (tensor.layerCount() != layers.size()) {
+                return SharedNetworkTensor(tensor);
+            }
+            for (std::size_t l = 0; l < layers.size(); ++l) {
+                if (!sameShape(layers[l], tensor.weights(l))) {
+                    return SharedNetworkTensor(tensor);
+                }
+            }
+            SharedNetworkTensor next(*this);
+            for (std::size_t l = 0; l < layers.size(); ++l) {
+                const VectorView<const T> b = tensor.biases(l);
+                next.layers[l].biases = hexarch::utils::SharedBlocks<T>(b.data, b.size, std::max<std::size_t>(b.size, 1));
+            }
+            return next;
+        }
+
+        bool empty() const { return layers.empty(); }
+        std::size_t layerCount() const { return layers.size(); }
+        std::size_t inputSize(std::size_t l) const { return layers.at(l).inputs; }
+        std::size_t outputSize(std::size_t l) const { return layers.at(l).biases.size(); }
+
+        // Row r (output r) of layer l's weight matrix: inputSize(l) contiguous values.
+        const T* weightRow(std::size_t l, std::size_t r) const {
+            const Layer& layer = layers.at(l);
+            return &layer.weights[r * layer.stride];
+        }
+
+        VectorView<const T> biases(std::size_t l) const {
+            const Layer& layer = layers.at(l);
+            return { layer.biases.empty() ? nullptr : layer.biases.block(0), layer.biases.size() };
+        }
+
+        std::vector<int> layerSizes() const {
+            std::vector<int> sizes;
+            if (!layers.empty()) {
+                sizes.push_back(static_cast<int>(inputSize(0)));
+                for (const Layer& layer : layers) {
+                    sizes.push_back(static_cast<int>(layer.biases.size()));
+                }
+            }
+            return sizes;
+        }
+
+        NetworkTensor<T> toTensor() const {
+            NetworkTensor<T> out(layerSizes());
+            for (std::size_t l = 0; l < layers.size(); ++l) {
+                MatrixView<T> dst = out.weights(l);
+                for (std::size_t r = 0; r < dst.rows; ++r) {
+                    std::copy(weightRow(l, r), weightRow(l, r) + dst.cols, dst.row(r));
+                }
+                VectorView<const T> b = biases(l);
+                std::copy(b.begin(), b.end(), out.biases(l).data);
+            }
+            return out;
+        }
+
+        // Weight and bias blocks over all layers.
+        std::size_t blockCount() const {
+            std::size_t count = 0;
+            for (const Layer& layer : layers) {
+                count += layer.weights.blockCount() + layer.biases.blockCount();
+            }
+            return count;
+        }
+
+        // Blocks this and other have in common, i.e. were not copied between them.
+        std::size_t sharedBlockCount(const SharedNetworkTensor& other) const {
+            std::size_t shared = 0;
+            for (std::size_t l = 0; l < std::min(layers.size(), other.layers.size()); ++l) {
+                shared += layers[l].weights.sharedBlockCount(other.layers[l].weights);
+                shared += layers[l].biases.sharedBlockCount(other.layers[l].biases);
+            }
+            return shared;
+        }
+
+    private:
+        struct Layer {
+            std::size_t inputs = 0;
+            // Elements per stored row, padding included, as in the NetworkTensor.
+            std::size_t stride = 0;
+            hexarch::utils::SharedBlocks<T> weights;
+            hexarch::utils::SharedBlocks<T> biases;
+        };
+
+        static bool sameShape(const Layer& layer, const MatrixView<const T>& w) {
+            return layer.inputs == w.cols && layer.stride == w.stride && layer.biases.size() == w.rows;
+        }
+
+        static Layer copyLayer(const MatrixView<const T>& w, const VectorView<const T>& b) {
+            return { w.cols, w.stride,
+                     hexarch::utils::SharedBlocks<T>(w.data, w.rows * w.stride, hexarch::utils::SharedBlocks<T>::blockSizeForRows(w.stride)),
+                     hexarch::utils::SharedBlocks<T>(b.data, b.size, std::max<std::size_t>(b.size, 1)) };
+        }
+
+        std::vector<Layer> layers;
+    };
+
+}
+}
+}
@@ -1,27 +1,188 @@
 #include "NeuralNetworkConfig.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
 
 namespace c_hex {
 namespace domain {
 namespace model {
 
-    NeuralNetworkConfig::NeuralNetworkConfig(int id, const std::vector<int>& layers, double lr, const std::string& opt)
-        : configId(id), layerSizes(layers), learningRate(lr), optimizer(opt), epochs(100), isTraining(false) {}
+    namespace {
 
-    NeuralNetworkConfig::NeuralNetworkConfig() : configId(0), learningRate(0.01), epochs(0), isTraining(false) {}
+        // The validated weights w, packed as T. The same shape keeps current's
+        // biases; a new one starts them at zero.
+        template <typename T>
+        NetworkTensor<T> packWeights(const NetworkTensor<T>& current, bool sameShape, const std::vector<int>& shape,
+                                     const std::vector<std::vector<std::vector<double>>>& w) {
+            NetworkTensor<T> next = sameShape ? current : NetworkTensor<T>(shape);
+            for (std::size_t l = 0; l < w.size(); ++l) {
+                MatrixView<T> dst = next.weights(l);
+                for (std::size_t r = 0; r < dst.rows; ++r) {
+                    std::copy(w[l][r].begin(), w[l][r].end(), dst.row(r));
+                }
+            }
+            return next;
+        }
+
+        template <typename T>
+        void copyBiases(NetworkTensor<T>& tensor, const std::vector<std::vector<double>>& b) {
+            if (b.size() != tensor.layerCount()) {
+                throw std::invalid_argument("NeuralNetworkConfig: bias layer count mismatch");
+            }
+            for (std::size_t l = 0; l < b.size(); ++l) {
+                if (b[l].size() != tensor.outputSize(l)) {
+                    throw std::invalid_argument("NeuralNetworkConfig: bias size mismatch");
+                }
+            }
+            for (std::size_t l = 0; l < b.size(); ++l) {
+                std::copy(b[l].begin(), b[l].end(), tensor.biases(l).data);
+            }
+        }
+
+    }
+
+    NeuralNetworkConfig::NeuralNetworkConfig(int id, std::vector<int> layers, double lr, std::string opt)
+        : configId(id), layerSizes(std::move(layers)), parameters(layerSizes), precision(WeightPrecision::Float64),
+          learningRate(lr), optimizer(std::move(opt)), epochs(100), isTraining(false),
+          publishedParameters(SharedNetworkTensor<double>(parameters)) {}
+
+    NeuralNetworkConfig::NeuralNetworkConfig()
+        : configId(0), precision(WeightPrecision::Float64), learningRate(0.01), epochs(0), isTraining(false) {}
 
     NeuralNetworkConfig::~NeuralNetworkConfig() = default;
 
     int NeuralNetworkConfig::getConfigId() const { return configId; }
-    std::vector<std::vector<std::vector<double>>> NeuralNetworkConfig::getWeights() const { return weights; }
-    std::vector<std::vector<double>> NeuralNetworkConfig::getBiases() const { return biases; }
+    const std::vector<int>& NeuralNetworkConfig::getLayerSizes() const { return layerSizes; }
+    const NetworkTensorF64& NeuralNetworkConfig::getParameters() const { return parameters; }
+    const NetworkTensorF32& NeuralNetworkConfig::getParametersF32() const { return parametersF32; }
+
+    MatrixView<const double> NeuralNetworkConfig::getWeights(std::size_t layer) const {
+        if (precision == WeightPrecision::Float32) {
+            throw std::logic_error("NeuralNetworkConfig: weights are stored as float32; read getParametersF32()");
+        }
+        return parameters.weights(layer);
+    }
+
+    VectorView<const double> NeuralNetworkConfig::getBiases(std::size_t layer) const {
+        if (precision == WeightPrecision::Float32) {
+            throw std::logic_error("NeuralNetworkConfig: biases are stored as float32; read getParametersF32()");
+        }
+        return parameters.biases(layer);
+    }
+
+    WeightPrecision NeuralNetworkConfig::getPrecision() const { return precision; }
     double NeuralNetworkConfig::getLearningRate() const { return learningRate; }
-    std::string NeuralNetworkConfig::getOptimizer() const { return optimizer; }
+    const std::string& NeuralNetworkConfig::getOptimizer() const { return optimizer; }
     bool NeuralNetworkConfig::getIsTraining() const { return isTraining; }
 
-    void NeuralNetworkConfig::setWeights(const std::vector<std::vector<std::vector<double>>>& w) { weights = w; }
-    void NeuralNetworkConfig::setBiases(const std::vector<std::vector<double>>& b) { biases = b; }
+    NeuralNetworkConfig::ParametersSnapshot NeuralNetworkConfig::parametersSnapshot() const { return publishedParameters.read(); }
+    NeuralNetworkConfig::ParametersSnapshotF32 NeuralNetworkConfig::parametersSnapshotF32() const { return publishedParametersF32.read(); }
+
+    void NeuralNetworkConfig::setWeights(const std::vector<std::vector<std::vector<double>>>& w) {
+        // Validate everything before touching the tensor, so a bad input leaves
+        // the config as it was.
+        std::vector<int> shape;
+        for (std::size_t l = 0; l < w.size(); ++l) {
+            if (w[l].empty() || w[l].front().empty()) {
+                throw std::invalid_argument("NeuralNetworkConfig: empty weight matrix");
+            }
+            const std::size_t inputs = w[l].front().size();
+            if (l > 0 && inputs != w[l - 1].size()) {
+                throw std::invalid_argument("NeuralNetworkConfig: layer inputs do not match the previous layer's outputs");
+            }
+            for (const std::vector<double>& row : w[l]) {
+                if (row.size() != inputs) {
+                    throw std::invalid_argument("NeuralNetworkConfig: ragged weight matrix");
+                }
+            }
+            if (l == 0) {
+                shape.push_back(static_cast<int>(inputs));
+            }
+            shape.push_back(static_cast<int>(w[l].size()));
+        }
+
+        if (precision == WeightPrecision::Float32) {
+            parametersF32 = packWeights(parametersF32, shape == layerSizes, shape, w);
+        } else {
+            parameters = packWeights(parameters, shape == layerSizes, shape, w);
+        }
+        layerSizes = std::move(shape);
+        parametersChanged();
+    }
+
+    void NeuralNetworkConfig::setBiases(const std::vector<std::vector<double>>& b) {
+        if (precision == WeightPrecision::Float32) {
+            copyBiases(parametersF32, b);
+        } else {
+            copyBiases(parameters, b);
+        }
+        biasesChanged();
+    }
+
+    void NeuralNetworkConfig::setParameters(NetworkTensorF64 tensor) {
+        layerSizes = tensor.layerSizes();
+        if (precision == WeightPrecision::Float32) {
+            parametersF32 = tensor.convert<float>();
+        } else {
+            parameters = std::move(tensor);
+        }
+        parametersChanged();
+    }
+
+    void NeuralNetworkConfig::loadParameters(const double* src, std::size_t count) {
+        if (precision == WeightPrecision::Float32) {
+            parametersF32.load(src, count);
+        } else {
+            parameters.load(src, count);
+        }
+        parametersChanged();
+    }
+
+    void NeuralNetworkConfig::loadParameters(const float* src, std::size_t count) {
+        if (precision == WeightPrecision::Float32) {
+            parametersF32.load(src, count);
+        } else {
+            parameters.load(src, count);
+        }
+        parametersChanged();
+    }
+
+    void NeuralNetworkConfig::setPrecision(WeightPrecision p) {
+        if (p == precision) {
+            return;
+        }
+        precision = p;
+        if (precision == WeightPrecision::Float32) {
+            parametersF32 = parameters.convert<float>();
+            parameters = NetworkTensorF64();
+            publishedParameters.publish(SharedNetworkTensor<double>());
+            publishedParametersF32.publish(SharedNetworkTensor<float>(parametersF32));
+        } else {
+            parameters = parametersF32.convert<double>();
+            parametersF32 = NetworkTensorF32();
+            publishedParametersF32.publish(SharedNetworkTensor<float>());
+            publishedParameters.publish(SharedNetworkTensor<double>(parameters));
+        }
+    }
+
     void NeuralNetworkConfig::setIsTraining(bool training) { isTraining = training; }
 
+    void NeuralNetworkConfig::parametersChanged() {
+        if (precision == WeightPrecision::Float32) {
+            publishedParametersF32.update([&](const SharedNetworkTensor<float>& current) { return current.rebase(parametersF32); });
+        } else {
+            publishedParameters.update([&](const SharedNetworkTensor<double>& current) { return current.rebase(parameters); });
+        }
+    }
+
+    void NeuralNetworkConfig::biasesChanged() {
+        if (precision == WeightPrecision::Float32) {
+            publishedParametersF32.update([&](const SharedNetworkTensor<float>& current) { return current.rebaseBiases(parametersF32); });
+        } else {
+            publishedParameters.update([&](const SharedNetworkTensor<double>& current) { return current.rebaseBiases(parameters); });
+        }
+    }
+
 }
 }
 }
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "NetworkTensor.hpp"
+#include "utils/Versioned.hpp"
+
 #include <string>
 #include <vector>
 
@@ -7,31 +10,79 @@ namespace c_hex {
 namespace domain {
 namespace model {
 
+    enum class WeightPrecision { Float64, Float32 };
+
     class NeuralNetworkConfig {
     private:
         int configId;
         std::vector<int> layerSizes;
-        std::vector<std::vector<std::vector<double>>> weights; // 3D
-        std::vector<std::vector<double>> biases; // 2D
+        // Weights + biases, one aligned block, stored in the selected precision
+        // only: parameters for Float64, parametersF32 for Float32. The other is empty.
+        NetworkTensorF64 parameters;
+        NetworkTensorF32 parametersF32;
+        WeightPrecision precision;
         double learningRate;
         std::string optimizer;
         int epochs;
         bool isTraining;
+        // The stored tensor as of the last change, for other threads; the one of
+        // the other precision holds an empty tensor.
+        hexarch::utils::Versioned<SharedNetworkTensor<double>> publishedParameters;
+        hexarch::utils::Versioned<SharedNetworkTensor<float>> publishedParametersF32;
+
+        // After any change to the stored tensor: publishes it.
+        void parametersChanged();
+        // The same, after a change to the biases only; no weight is re-read.
+        void biasesChanged();
 
     public:
-        NeuralNetworkConfig(int id, const std::vector<int>& layers, double lr, const std::string& opt);
+        using ParametersSnapshot = hexarch::utils::Versioned<SharedNetworkTensor<double>>::Snapshot;
+        using ParametersSnapshotF32 = hexarch::utils::Versioned<SharedNetworkTensor<float>>::Snapshot;
+
+        NeuralNetworkConfig(int id, std::vector<int> layers, double lr, std::string opt);
         NeuralNetworkConfig();
         virtual ~NeuralNetworkConfig();
+        NeuralNetworkConfig(const NeuralNetworkConfig&) = default;
+        NeuralNetworkConfig(NeuralNetworkConfig&&) noexcept = default;
+        NeuralNetworkConfig& operator=(const NeuralNetworkConfig&) = default;
+        NeuralNetworkConfig& operator=(NeuralNetworkConfig&&) noexcept = default;
 
         int getConfigId() const;
-        std::vector<std::vector<std::vector<double>>> getWeights() const;
-        std::vector<std::vector<double>> getBiases() const;
+        const std::vector<int>& getLayerSizes() const;
+        // The stored tensor: getParameters() when the precision is Float64,
+        // getParametersF32() when it is Float32. The other one is empty.
+        const NetworkTensorF64& getParameters() const;
+        const NetworkTensorF32& getParametersF32() const;
+        // Views into getParameters(); throw std::logic_error under Float32.
+        MatrixView<const double> getWeights(std::size_t layer) const;
+        VectorView<const double> getBiases(std::size_t layer) const;
+        WeightPrecision getPrecision() const;
         double getLearningRate() const;
-        std::string getOptimizer() const;
+        const std::string& getOptimizer() const;
         bool getIsTraining() const;
 
+        // Weights and biases for inference threads while training or a reload
+        // writes this config: wait-free, and unchanged for as long as the
+        // snapshot is held. Each setter publishes a version that shares the
+        // layers it left alone. Like the getters, one per precision; the other
+        // holds an empty tensor.
+        ParametersSnapshot parametersSnapshot() const;
+        ParametersSnapshotF32 parametersSnapshotF32() const;
+
+        // Nested-vector import; packs into the contiguous tensor, converting to
+        // the stored precision. If the weight shapes disagree with layerSizes,
+        // layerSizes is re-derived from them.
         void setWeights(const std::vector<std::vector<std::vector<double>>>& w);
         void setBiases(const std::vector<std::vector<double>>& b);
+
+        // These convert to the stored precision as well.
+        void setParameters(NetworkTensorF64 tensor);
+        // Dense W0, b0, W1, b1, ... buffer; see NetworkTensor::load.
+        void loadParameters(const double* src, std::size_t count);
+        void loadParameters(const float* src, std::size_t count);
+        // Converts the stored tensor. Going to Float32 rounds every weight, and
+        // going back to Float64 does not restore the dropped bits.
+        void setPrecision(WeightPrecision p);
         void setIsTraining(bool training);
     };
 
@@ -1,17 +1,26 @@
 #include "Order.hpp"
+#include <utility>
 
 namespace c_hex {
 namespace domain {
 namespace model {
 
-    Order::Order(const std::string& orderId, double totalAmount, int itemCount)
-        : orderId(orderId), totalAmount(totalAmount), itemCount(itemCount) {}
+    Order::Order(std::string_view orderId, double totalAmount, int itemCount, const allocator_type& alloc)
+        : orderId(orderId, alloc), totalAmount(totalAmount), itemCount(itemCount) {}
 
-    Order::Order() : totalAmount(0.0), itemCount(0) {}
+    Order::Order(const allocator_type& alloc) : orderId(alloc), totalAmount(0.0), itemCount(0) {}
+
+    Order::Order(const Order& other, const allocator_type& alloc)
+        : orderId(other.orderId, alloc), totalAmount(other.totalAmount), itemCount(other.itemCount) {}
+
+    Order::Order(Order&& other, const allocator_type& alloc)
+        : orderId(std::move(other.orderId), alloc), totalAmount(other.totalAmount), itemCount(other.itemCount) {}
 
     Order::~Order() = default;
 
-    std::string Order::getOrderId() const { return orderId; }
+    Order::allocator_type Order::get_allocator() const { return orderId.get_allocator(); }
+
+    std::string_view Order::getOrderId() const { return orderId; }
     double Order::getTotalAmount() const { return totalAmount; }
     int Order::getItemCount() const { return itemCount; }
 
@@ -1,23 +1,42 @@
 #pragma once
 
+#include <memory_resource>
 #include <string>
+#include <string_view>
 
 namespace c_hex {
 namespace domain {
 namespace model {
 
-    class Order {
+    // Allocator-aware: strings come from the allocator passed at construction,
+    // so a whole poll batch can be built in one arena and dropped at once:
+    //   std::pmr::monotonic_buffer_resource arena;
+    //   std::pmr::vector<Order> batch(&arena);
+    //   batch.emplace_back("ord-1", 9.5, 2);   // element and its string in the arena
+    // The plain copy constructor goes back to the default resource, so a copy
+    // can safely outlive the arena.
+    class Order final {
     private:
-        std::string orderId;
+        std::pmr::string orderId;
         double totalAmount;
         int itemCount;
 
     public:
-        Order(const std::string& orderId, double totalAmount, int itemCount);
-        Order();
-        virtual ~Order();
+        using allocator_type = std::pmr::polymorphic_allocator<char>;
 
-        std::string getOrderId() const;
+        Order(std::string_view orderId, double totalAmount, int itemCount, const allocator_type& alloc = {});
+        explicit Order(const allocator_type& alloc = {});
+        Order(const Order& other, const allocator_type& alloc);
+        Order(Order&& other, const allocator_type& alloc);
+        ~Order();
+        Order(const Order&) = default;
+        Order(Order&&) noexcept = default;
+        Order& operator=(const Order&) = default;
+        Order& operator=(Order&&) = default;
+
+        allocator_type get_allocator() const;
+
+        std::string_view getOrderId() const;
         double getTotalAmount() const;
         int getItemCount() const;
 
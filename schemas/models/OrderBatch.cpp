@@ -0,0 +1,111 @@
+#include "OrderBatch.hpp"
+#include "utils/ColumnKernels.hpp"
+
+#include <stdexcept>
+
+namespace c_hex {
+namespace domain {
+namespace model {
+
+    OrderBatch::OrderBatch(hexarch::utils::Span<const Order> rows) { append(rows); }
+
+    OrderBatch OrderBatch::fromRows(hexarch::utils::Span<const Order> rows) { return OrderBatch(rows); }
+
+    void OrderBatch::reserve(std::size_t rows) {
+        orderIdCol.reserve(rows);
+        totalAmountCol.reserve(rows);
+        itemCountCol.reserve(rows);
+    }
+
+    void OrderBatch::clear() {
+        orderIdCol.clear();
+        totalAmountCol.clear();
+        itemCountCol.clear();
+        orderIds.clear();
+    }
+
+    void OrderBatch::append(std::string_view orderId, double totalAmount, int itemCount) {
+        orderIdCol.push_back(orderIds.intern(orderId));
+        totalAmountCol.push_back(totalAmount);
+        itemCountCol.push_back(static_cast<std::int32_t>(itemCount));
+    }
+
+    void OrderBatch::append(const Order& row) { append(row.getOrderId(), row.getTotalAmount(), row.getItemCount()); }
+
+    void OrderBatch::append(hexarch::utils::Span<const Order> rows) {
+        reserve(size() + rows.size());
+        for (const Order& row : rows) append(row);
+    }
+
+    std::size_t OrderBatch::size() const { return totalAmountCol.size(); }
+    bool OrderBatch::empty() const { return totalAmountCol.empty(); }
+
+    Order OrderBatch::row(std::size_t i, const Order::allocator_type& alloc) const {
+        return Order(orderId(i), totalAmount(i), itemCount(i), alloc);
+    }
+
+    std::vector<Order> OrderBatch::toRows() const {
+        std::vector<Order> out;
+        out.reserve(size());
+        for (std::size_t i = 0; i < size(); ++i) out.push_back(row(i));
+        return out;
+    }
+
+    void OrderBatch::toRows(std::pmr::vector<Order>& out) const {
+        out.reserve(out.size() + size());
+        for (std::size_t i = 0; i < size(); ++i) out.emplace_back(orderId(i), totalAmount(i), itemCount(i));
+    }
+
+    const std::string& OrderBatch::orderId(std::size_t i) const { return orderIds.name(orderIdCol.at(i)); }
+    double OrderBatch::totalAmount(std::size_t i) const { return totalAmountCol.at(i); }
+    int OrderBatch::itemCount(std::size_t i) const { return itemCountCol.at(i); }
+
+    const StringDictionary& OrderBatch::getOrderIdDictionary() const { return orderIds; }
+    hexarch::utils::Span<const OrderBatch::Id> OrderBatch::orderIdColumn() const { return orderIdCol; }
+    hexarch::utils::Span<const double> OrderBatch::totalAmountColumn() const { return totalAmountCol; }
+    hexarch::utils::Span<const std::int32_t> OrderBatch::itemCountColumn() const { return itemCountCol; }
+
+    double OrderBatch::sumTotalAmount() const {
+        return hexarch::utils::columnKernels().sumF64(totalAmountCol.data(), size());
+    }
+
+    double OrderBatch::minTotalAmount() const {
+        return hexarch::utils::columnKernels().minF64(totalAmountCol.data(), size());
+    }
+
+    double OrderBatch::maxTotalAmount() const {
+        return hexarch::utils::columnKernels().maxF64(totalAmountCol.data(), size());
+    }
+
+    std::int64_t OrderBatch::sumItemCount() const {
+        return hexarch::utils::columnKernels().sumI32(itemCountCol.data(), size());
+    }
+
+    int OrderBatch::minItemCount() const {
+        return hexarch::utils::columnKernels().minI32(itemCountCol.data(), size());
+    }
+
+    int OrderBatch::maxItemCount() const {
+        return hexarch::utils::columnKernels().maxI32(itemCountCol.data(), size());
+    }
+
+    hexarch::utils::Bitmap OrderBatch::filterTotalAmount(double lo, double hi) const {
+        hexarch::utils::Bitmap selection(size());
+        hexarch::utils::columnKernels().filterRangeF64(totalAmountCol.data(), size(), lo, hi, selection.data());
+        return selection;
+    }
+
+    double OrderBatch::sumTotalAmount(const hexarch::utils::Bitmap& selection) const {
+        requireSelection(selection);
+        return hexarch::utils::columnKernels().sumSelectedF64(totalAmountCol.data(), size(), selection.data());
+    }
+
+    void OrderBatch::requireSelection(const hexarch::utils::Bitmap& selection) const {
+        if (selection.size() != size()) {
+            throw std::invalid_argument("OrderBatch: selection size does not match the batch");
+        }
+    }
+
+}
+}
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Order.hpp"
+#include "StringDictionary.hpp"
+#include "utils/Bitmap.hpp"
+#include "utils/Span.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace c_hex {
+namespace domain {
+namespace model {
+
+    // Column-oriented batch of Orders: one contiguous array per field, with the
+    // order id dictionary-encoded. Aggregates and filters run the SIMD column
+    // kernels over totalAmount/itemCount without touching the ids.
+    //
+    // Fill it from row models (append/fromRows) or straight from decoded wire
+    // views, skipping the row objects entirely:
+    //   OrderBatch batch;
+    //   OrderCodec::decodeEach(data, size, [&](const OrderCodec::View& v) {
+    //       batch.append(v.orderId(), v.totalAmount(), v.itemCount());
+    //   });
+    //   const hexarch::utils::Bitmap large = batch.filterTotalAmount(1000.0, 1e12);
+    //   const double largeTotal = batch.sumTotalAmount(large);
+    class OrderBatch {
+    public:
+        using Id = StringDictionary::Id;
+
+        OrderBatch() = default;
+        explicit OrderBatch(hexarch::utils::Span<const Order> rows);
+
+        static OrderBatch fromRows(hexarch::utils::Span<const Order> rows);
+
+        void reserve(std::size_t rows);
+        // Drops the rows and their interned ids. Order ids are unique, so a
+        // reused batch would otherwise grow its dictionary without bound.
+        void clear();
+
+        void append(std::string_view orderId, double totalAmount, int itemCount);
+        void append(const Order& row);
+        void append(hexarch::utils::Span<const Order> rows);
+
+        std::size_t size() const;
+        bool empty() const;
+
+        Order row(std::size_t i, const Order::allocator_type& alloc = {}) const;
+        std::vector<Order> toRows() const;
+        // Appends to out, building each row with out's allocator.
+        void toRows(std::pmr::vector<Order>& out) const;
+
+        const std::string& orderId(std::size_t i) const;
+        double totalAmount(std::size_t i) const;
+        int itemCount(std::size_t i) const;
+
+        const StringDictionary& getOrderIdDictionary() const;
+        hexarch::utils::Span<const Id> orderIdColumn() const;
+        hexarch::utils::Span<const double> totalAmountColumn() const;
+        hexarch::utils::Span<const std::int32_t> itemCountColumn() const;
+
+        // Min/max of an empty batch return the identity (+inf/-inf, INT_MAX/INT_MIN).
+        double sumTotalAmount() const;
+        double minTotalAmount() const;
+        double maxTotalAmount() const;
+        std::int64_t sumItemCount() const;
+        int minItemCount() const;
+        int maxItemCount() const;
+
+        // Rows with lo <= totalAmount < hi.
+        hexarch::utils::Bitmap filterTotalAmount(double lo, double hi) const;
+        double sumTotalAmount(const hexarch::utils::Bitmap& selection) const;
+
+    private:
+        void requireSelection(const hexarch::utils::Bitmap& selection) const;
+
+        StringDictionary orderIds;
+        std::vector<Id> orderIdCol;
+        std::vector<double> totalAmountCol;
+        std::vector<std::int32_t> itemCountCol;
+    };
+
+}
+}
+}
@@ -1,24 +1,80 @@
 #include "Product.hpp"
+#include <utility>
 
 namespace c_hex {
 namespace domain {
 namespace model {
 
-    Product::Product(int id, const std::string& name, double price, bool inStock)
-        : id(id), name(name), price(price), inStock(inStock) {}
+    Product::Product(int id, std::string_view name, double price, bool inStock, const allocator_type& alloc)
+        : id(id), name(name, alloc), price(price), inStock(inStock) {}
 
-    Product::Product() : id(0), price(0.0), inStock(false) {}
+    Product::Product(const allocator_type& alloc) : id(0), name(alloc), price(0.0), inStock(false) {}
+
+    Product::Product(const Product& other, const allocator_type& alloc)
+        : id(other.id), name(other.name, alloc), price(other.price), inStock(other.inStock), dirty(other.dirty) {}
+
+    Product::Product(Product&& other, const allocator_type& alloc)
+        : id(other.id), name(std::move(other.name), alloc), price(other.price), inStock(other.inStock),
+          dirty(other.dirty) {}
 
     Product::~Product() = default;
 
+    Product::allocator_type Product::get_allocator() const { return name.get_allocator(); }
+
     int Product::getId() const { return id; }
-    std::string Product::getName() const { return name; }
+    std::string_view Product::getName() const { return name; }
     double Product::getPrice() const { return price; }
     bool Product::isInStock() const { return inStock; }
 
-    void Product::setName(const std::string& newName) { name = newName; }
-    void Product::setPrice(double newPrice) { price = newPrice; }
-    void Product::setInStock(bool newInStock) { inStock = newInStock; }
+    void Product::setName(std::string_view newName) {
+        name.assign(newName.data(), newName.size());
+        dirty.mark(Field::Name);
+    }
+
+    void Product::setPrice(double newPrice) {
+        price = newPrice;
+        dirty.mark(Field::Price);
+    }
+
+    void Product::setInStock(bool newInStock) {
+        inStock = newInStock;
+        dirty.mark(Field::InStock);
+    }
+
+    std::uint64_t Product::dirtyFields() const { return dirty.mask(); }
+    bool Product::isDirty(Field field) const { return dirty.test(field); }
+    void Product::clearDirty() { dirty.clear(); }
+    void Product::markAllDirty() { dirty.markAll(); }
+
+    void Product::encodeDelta(std::vector<unsigned char>& out) const {
+        hexarch::utils::delta::Writer w(out, dirty.mask());
+        if (dirty.test(Field::Id)) w.value(static_cast<std::int32_t>(id));
+        if (dirty.test(Field::Name)) w.string(name);
+        if (dirty.test(Field::Price)) w.value(price);
+        if (dirty.test(Field::InStock)) w.value(inStock);
+    }
+
+    bool Product::applyDelta(const unsigned char* data, std::size_t size) {
+        hexarch::utils::delta::Reader r(data, size);
+        std::int32_t newId = 0;
+        std::string_view newName;
+        double newPrice = 0.0;
+        bool newInStock = false;
+        if (r.has(Field::Id)) r.value(newId);
+        if (r.has(Field::Name)) r.string(newName);
+        if (r.has(Field::Price)) r.value(newPrice);
+        if (r.has(Field::InStock)) r.value(newInStock);
+        if (!r.finished() || !dirty.validMask(r.mask())) {
+            return false;
+        }
+
+        if (r.has(Field::Id)) id = newId;
+        if (r.has(Field::Name)) name.assign(newName.data(), newName.size());
+        if (r.has(Field::Price)) price = newPrice;
+        if (r.has(Field::InStock)) inStock = newInStock;
+        dirty.markMask(r.mask());
+        return true;
+    }
 
 }
 }
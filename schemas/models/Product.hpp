@@ -1,31 +1,68 @@
 #pragma once
 
+#include "utils/DeltaCodec.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace c_hex {
 namespace domain {
 namespace model {
 
-    class Product {
+    // Allocator-aware like Order: the name lives wherever the allocator passed
+    // at construction (or by a std::pmr container) points.
+    class Product final {
+    public:
+        // Bit positions in dirtyFields() and in delta records.
+        enum class Field : std::uint8_t { Id, Name, Price, InStock, Count };
+
     private:
         int id;
-        std::string name;
+        std::pmr::string name;
         double price;
         bool inStock;
+        hexarch::utils::DirtyFields<Field> dirty;
 
     public:
-        Product(int id, const std::string& name, double price, bool inStock);
-        Product();
-        virtual ~Product();
+        using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+        Product(int id, std::string_view name, double price, bool inStock, const allocator_type& alloc = {});
+        explicit Product(const allocator_type& alloc = {});
+        Product(const Product& other, const allocator_type& alloc);
+        Product(Product&& other, const allocator_type& alloc);
+        ~Product();
+        Product(const Product&) = default;
+        Product(Product&&) noexcept = default;
+        Product& operator=(const Product&) = default;
+        Product& operator=(Product&&) = default;
+
+        allocator_type get_allocator() const;
 
         int getId() const;
-        std::string getName() const;
+        std::string_view getName() const;
         double getPrice() const;
         bool isInStock() const;
 
-        void setName(const std::string& name);
+        // Assigns in place, reusing the name's storage when it fits.
+        void setName(std::string_view name);
         void setPrice(double price);
         void setInStock(bool inStock);
+
+        // Fields changed since the last clearDirty(); a new object is all dirty.
+        std::uint64_t dirtyFields() const;
+        bool isDirty(Field field) const;
+        void clearDirty();
+        void markAllDirty();
+
+        // Writes the dirty fields as a delta record (utils/DeltaCodec.hpp) into out.
+        void encodeDelta(std::vector<unsigned char>& out) const;
+        // Applies a record from encodeDelta and marks its fields dirty. A malformed
+        // record returns false and leaves the object unchanged.
+        bool applyDelta(const unsigned char* data, std::size_t size);
     };
 
 }
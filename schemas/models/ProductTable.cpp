@@ -0,0 +1,113 @@
+#include "ProductTable.hpp"
+#include "utils/ColumnKernels.hpp"
+
+#include <stdexcept>
+
+namespace c_hex {
+namespace domain {
+namespace model {
+
+    ProductTable::ProductTable(hexarch::utils::Span<const Product> rows) { append(rows); }
+
+    ProductTable ProductTable::fromRows(hexarch::utils::Span<const Product> rows) { return ProductTable(rows); }
+
+    void ProductTable::reserve(std::size_t rows) {
+        idCol.reserve(rows);
+        nameCol.reserve(rows);
+        priceCol.reserve(rows);
+        inStockCol.reserve(rows);
+    }
+
+    void ProductTable::clear() {
+        idCol.clear();
+        nameCol.clear();
+        priceCol.clear();
+        inStockCol.clear();
+    }
+
+    void ProductTable::append(int id, std::string_view name, double price, bool inStock) {
+        idCol.push_back(static_cast<std::int32_t>(id));
+        nameCol.push_back(names.intern(name));
+        priceCol.push_back(price);
+        inStockCol.pushBack(inStock);
+    }
+
+    void ProductTable::append(const Product& row) {
+        append(row.getId(), row.getName(), row.getPrice(), row.isInStock());
+    }
+
+    void ProductTable::append(hexarch::utils::Span<const Product> rows) {
+        reserve(size() + rows.size());
+        for (const Product& row : rows) append(row);
+    }
+
+    std::size_t ProductTable::size() const { return priceCol.size(); }
+    bool ProductTable::empty() const { return priceCol.empty(); }
+
+    Product ProductTable::row(std::size_t i, const Product::allocator_type& alloc) const {
+        return Product(id(i), name(i), price(i), inStock(i), alloc);
+    }
+
+    std::vector<Product> ProductTable::toRows() const {
+        std::vector<Product> out;
+        out.reserve(size());
+        for (std::size_t i = 0; i < size(); ++i) out.push_back(row(i));
+        return out;
+    }
+
+    void ProductTable::toRows(std::pmr::vector<Product>& out) const {
+        out.reserve(out.size() + size());
+        for (std::size_t i = 0; i < size(); ++i) out.emplace_back(id(i), name(i), price(i), inStock(i));
+    }
+
+    int ProductTable::id(std::size_t i) const { return idCol.at(i); }
+    const std::string& ProductTable::name(std::size_t i) const { return names.name(nameCol.at(i)); }
+    double ProductTable::price(std::size_t i) const { return priceCol.at(i); }
+
+    bool ProductTable::inStock(std::size_t i) const {
+        if (i >= size()) {
+            throw std::out_of_range("ProductTable: row out of range");
+        }
+        return inStockCol.test(i);
+    }
+
+    void ProductTable::setPrice(std::size_t i, double price) { priceCol.at(i) = price; }
+
+    void ProductTable::setInStock(std::size_t i, bool inStock) {
+        if (i >= size()) {
+            throw std::out_of_range("ProductTable: row out of range");
+        }
+        inStockCol.set(i, inStock);
+    }
+
+    const StringDictionary& ProductTable::getNameDictionary() const { return names; }
+    hexarch::utils::Span<const std::int32_t> ProductTable::idColumn() const { return idCol; }
+    hexarch::utils::Span<const ProductTable::Id> ProductTable::nameColumn() const { return nameCol; }
+    hexarch::utils::Span<const double> ProductTable::priceColumn() const { return priceCol; }
+    const hexarch::utils::Bitmap& ProductTable::getInStock() const { return inStockCol; }
+
+    double ProductTable::sumPrice() const { return hexarch::utils::columnKernels().sumF64(priceCol.data(), size()); }
+    double ProductTable::minPrice() const { return hexarch::utils::columnKernels().minF64(priceCol.data(), size()); }
+    double ProductTable::maxPrice() const { return hexarch::utils::columnKernels().maxF64(priceCol.data(), size()); }
+    std::size_t ProductTable::countInStock() const { return inStockCol.count(); }
+
+    hexarch::utils::Bitmap ProductTable::filterPrice(double lo, double hi) const {
+        hexarch::utils::Bitmap selection(size());
+        hexarch::utils::columnKernels().filterRangeF64(priceCol.data(), size(), lo, hi, selection.data());
+        return selection;
+    }
+
+    double ProductTable::sumPrice(const hexarch::utils::Bitmap& selection) const {
+        requireSelection(selection);
+        return hexarch::utils::columnKernels().sumSelectedF64(priceCol.data(), size(), selection.data());
+    }
+
+    void ProductTable::requireSelection(const hexarch::utils::Bitmap& selection) const {
+        if (selection.size() != size()) {
+            throw std::invalid_argument("ProductTable: selection size does not match the table");
+        }
+    }
+
+}
+}
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Product.hpp"
+#include "StringDictionary.hpp"
+#include "utils/Bitmap.hpp"
+#include "utils/Span.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace c_hex {
+namespace domain {
+namespace model {
+
+    // Column-oriented Product catalogue: ids and prices in contiguous arrays,
+    // names dictionary-encoded, inStock packed one bit per row. Filters return
+    // Bitmaps that combine with the stock column before aggregating:
+    //   hexarch::utils::Bitmap pick = table.filterPrice(10.0, 50.0);
+    //   pick &= table.getInStock();
+    //   const double value = table.sumPrice(pick);
+    class ProductTable {
+    public:
+        using Id = StringDictionary::Id;
+
+        ProductTable() = default;
+        explicit ProductTable(hexarch::utils::Span<const Product> rows);
+
+        static ProductTable fromRows(hexarch::utils::Span<const Product> rows);
+
+        void reserve(std::size_t rows);
+        // Drops the rows; interned names are kept.
+        void clear();
+
+        void append(int id, std::string_view name, double price, bool inStock);
+        void append(const Product& row);
+        void append(hexarch::utils::Span<const Product> rows);
+
+        std::size_t size() const;
+        bool empty() const;
+
+        Product row(std::size_t i, const Product::allocator_type& alloc = {}) const;
+        std::vector<Product> toRows() const;
+        // Appends to out, building each row with out's allocator.
+        void toRows(std::pmr::vector<Product>& out) const;
+
+        int id(std::size_t i) const;
+        const std::string& name(std::size_t i) const;
+        double price(std::size_t i) const;
+        bool inStock(std::size_t i) const;
+
+        void setPrice(std::size_t i, double price);
+        void setInStock(std::size_t i, bool inStock);
+
+        const StringDictionary& getNameDictionary() const;
+        hexarch::utils::Span<const std::int32_t> idColumn() const;
+        hexarch::utils::Span<const Id> nameColumn() const;
+        hexarch::utils::Span<const double> priceColumn() const;
+        const hexarch::utils::Bitmap& getInStock() const;
+
+        // Min/max of an empty table return +inf/-inf.
+        double sumPrice() const;
+        double minPrice() const;
+        double maxPrice() const;
+        std::size_t countInStock() const;
+
+        // Rows with lo <= price < hi.
+        hexarch::utils::Bitmap filterPrice(double lo, double hi) const;
+        double sumPrice(const hexarch::utils::Bitmap& selection) const;
+
+    private:
+        void requireSelection(const hexarch::utils::Bitmap& selection) const;
+
+        StringDictionary names;
+        std::vector<std::int32_t> idCol;
+        std::vector<Id> nameCol;
+        std::vector<double> priceCol;
+        hexarch::utils::Bitmap inStockCol;
+    };
+
+}
+}
+}
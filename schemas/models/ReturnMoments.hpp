@@ -0,0 +1,119 @@
+#pragma once
+
+#include "SymmetricMatrix.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace c_hex {
+namespace domain {
+namespace model {
+
+    // Running statistics of a periods x assets return series: the per-asset
+    // means and the packed co-moments
+    //   C(i, j) = sum_t (r[t][i] - mean[i]) * (r[t][j] - mean[j]).
+    // add() folds in one more period in O(assets^2) (Welford's update), so a
+    // covariance matrix can follow an append without rescanning history.
+    class ReturnMoments {
+    public:
+        ReturnMoments() = default;
+
+        explicit ReturnMoments(std::size_t assets) : means(assets, 0.0), comoments(assets) {}
+
+        ReturnMoments(std::size_t periods, std::vector<double> means, SymmetricMatrix<double> comoments)
+            : periods(periods), means(std::move(means)), comoments(std::move(comoments)) {
+            if (this->means.size() != this->comoments.size()) {
+                throw std::invalid_argument("ReturnMoments: means and co-moments disagree on asset count");
+            }
+        }
+
+        std::size_t assetCount() const { return means.size(); }
+        std::size_t count() const { return periods; }
+        const std::vector<double>& getMeans() const { return means; }
+        const SymmetricMatrix<double>& getComoments() const { return comoments; }
+
+        // row holds assetCount() returns for the next period.
+        void add(const double* row) {
+            const std::size_t n = means.size();
+            delta.resize(n);
+            ++periods;
+            const double inv = 1.0 / static_cast<double>(periods);
+            for (std::size_t i = 0; i < n; ++i) {
+                delta[i] = row[i] - means[i];
+                means[i] += delta[i] * inv;
+            }
+            // (x - mean_old)(y - mean_new) == (n - 1)/n * dx * dy keeps the update symmetric.
+            const double scale = static_cast<double>(periods - 1) * inv;
+            for (std::size_t i = 0; i < n; ++i) {
+                const double di = delta[i] * scale;
+                double* tail = comoments.rowTail(i) - i;
+                for (std::size_t j = i; j < n; ++j) {
+                    tail[j] += di * delta[j];
+                }
+            }
+        }
+
+        // Sample covariance, C / (count() - 1).
+        template <typename U = double>
+        SymmetricMatrix<U> covariance() const {
+            requireTwoPeriods();
+            const double inv = 1.0 / static_cast<double>(periods - 1);
+            SymmetricMatrix<U> out(comoments.size());
+            const double* src = comoments.data();
+            U* dst = out.data();
+            for (std::size_t k = 0; k < comoments.packedSize(); ++k) {
+                dst[k] = static_cast<U>(src[k] * inv);
+            }
+            return out;
+        }
+
+        // Pearson correlation; assets with zero variance get 0 off the diagonal.
+        template <typename U = double>
+        SymmetricMatrix<U> correlation() const {
+            requireTwoPeriods();
+            const std::size_t n = comoments.size();
+            std::vector<double> invStd(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                const double c = comoments.rowTail(i)[0];
+                invStd[i] = c > 0.0 ? 1.0 / std::sqrt(c) : 0.0;
+            }
+            SymmetricMatrix<U> out(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                const double* src = comoments.rowTail(i) - i;
+                U* dst = out.rowTail(i) - i;
+                dst[i] = U(1);
+                for (std::size_t j = i + 1; j < n; ++j) {
+                    dst[j] = static_cast<U>(src[j] * invStd[i] * invStd[j]);
+                }
+            }
+            return out;
+        }
+
+        // w' * Cov * w without materialising the covariance matrix.
+        double variance(const std::vector<double>& weights) const {
+            requireTwoPeriods();
+            if (weights.size() != means.size()) {
+                throw std::invalid_argument("ReturnMoments: weight count does not match asset count");
+            }
+            return quadraticForm(comoments, weights.data()) / static_cast<double>(periods - 1);
+        }
+
+    private:
+        void requireTwoPeriods() const {
+            if (periods < 2) {
+                throw std::logic_error("ReturnMoments: at least two periods are required");
+            }
+        }
+
+        std::size_t periods = 0;
+        std::vector<double> means;
+        SymmetricMatrix<double> comoments;
+        std::vector<double> delta;
+    };
+
+}
+}
+}
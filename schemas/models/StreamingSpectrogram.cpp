@@ -0,0 +1,136 @@
+#include "StreamingSpectrogram.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace c_hex {
+namespace domain {
+namespace model {
+
+    StreamingSpectrogram::StreamingSpectrogram(const SpectrogramConfig& cfg)
+        : config(cfg), fft(cfg.windowSize), window(cfg.windowSize), ring(cfg.windowSize, 0.0),
+          frameInput(cfg.windowSize), frames(cfg.maxFrames, cfg.windowSize / 2 + 1),
+          frameBands(cfg.maxFrames, cfg.bandCount), bandEnergies(cfg.bandCount, 0.0),
+          ringPos(0), totalSamples(0), nextFrameStart(0), head(0), retained(0), produced(0) {
+        if (cfg.hopSize == 0 || cfg.maxFrames == 0 || cfg.bandCount == 0) {
+            throw std::invalid_argument("StreamingSpectrogram: hop, frame and band counts must be positive");
+        }
+        const double pi = std::acos(-1.0);
+        for (std::size_t i = 0; i < window.size(); ++i) {
+            window[i] = 0.5 - 0.5 * std::cos(2.0 * pi * i / window.size());
+        }
+        const std::size_t bins = binCount();
+        if (cfg.bandCount > bins) {
+            throw std::invalid_argument("StreamingSpectrogram: more bands than bins");
+        }
+        bandEdges.resize(cfg.bandCount + 1);
+        for (std::size_t b = 0; b <= cfg.bandCount; ++b) {
+            bandEdges[b] = b * bins / cfg.bandCount;
+        }
+    }
+
+    std::size_t StreamingSpectrogram::append(const double* samples, std::size_t count, double gain) {
+        const std::size_t before = produced;
+        const long long windowSize = static_cast<long long>(config.windowSize);
+        while (count > 0) {
+            const long long needed = nextFrameStart + windowSize - totalSamples;
+            // Samples falling in a gap between frames (hop > window) are skipped outright.
+            const long long gap = nextFrameStart - totalSamples;
+            if (gap > 0) {
+                const std::size_t skip = static_cast<std::size_t>(std::min<long long>(gap, static_cast<long long>(count)));
+                samples += skip;
+                count -= skip;
+                totalSamples += static_cast<long long>(skip);
+                continue;
+            }
+            const std::size_t take = static_cast<std::size_t>(std::min<long long>(needed, static_cast<long long>(count)));
+            pushSamples(samples, take, gain);
+            samples += take;
+            count -= take;
+            if (totalSamples == nextFrameStart + windowSize) {
+                computeFrame();
+                nextFrameStart += static_cast<long long>(config.hopSize);
+            }
+        }
+        return produced - before;
+    }
+
+    const SpectrogramConfig& StreamingSpectrogram::getConfig() const { return config; }
+    std::size_t StreamingSpectrogram::binCount() const { return config.windowSize / 2 + 1; }
+    std::size_t StreamingSpectrogram::frameCount() const { return retained; }
+    std::size_t StreamingSpectrogram::framesProduced() const { return produced; }
+    long long StreamingSpectrogram::samplesConsumed() const { return totalSamples; }
+
+    const double* StreamingSpectrogram::frame(std::size_t i) const {
+        const std::size_t oldest = (head + config.maxFrames - retained) % config.maxFrames;
+        return frames.row((oldest + i) % config.maxFrames);
+    }
+
+    const double* StreamingSpectrogram::latestFrame() const {
+        return retained ? frame(retained - 1) : nullptr;
+    }
+
+    const std::vector<double>& StreamingSpectrogram::getBandEnergies() const { return bandEnergies; }
+
+    Grid2D<double> StreamingSpectrogram::snapshot() const {
+        Grid2D<double> out(retained, binCount());
+        for (std::size_t i = 0; i < retained; ++i) {
+            std::copy(frame(i), frame(i) + binCount(), out.row(i));
+        }
+        return out;
+    }
+
+    void StreamingSpectrogram::pushSamples(const double* samples, std::size_t count, double gain) {
+        while (count > 0) {
+            const std::size_t run = std::min(count, ring.size() - ringPos);
+            double* dst = ring.data() + ringPos;
+            for (std::size_t i = 0; i < run; ++i) {
+                dst[i] = samples[i] * gain;
+            }
+            ringPos = (ringPos + run) % ring.size();
+            samples += run;
+            count -= run;
+            totalSamples += static_cast<long long>(run);
+        }
+    }
+
+    void StreamingSpectrogram::computeFrame() {
+        // The ring holds exactly the last windowSize samples; ringPos is the oldest.
+        const std::size_t n = ring.size();
+        const std::size_t tail = n - ringPos;
+        const double* w = window.data();
+        double* in = frameInput.data();
+        for (std::size_t i = 0; i < tail; ++i) {
+            in[i] = ring[ringPos + i] * w[i];
+        }
+        for (std::size_t i = 0; i < ringPos; ++i) {
+            in[tail + i] = ring[i] * w[tail + i];
+        }
+
+        double* bands = frameBands.row(head);
+        if (retained == config.maxFrames) {
+            for (std::size_t b = 0; b < config.bandCount; ++b) {
+                bandEnergies[b] -= bands[b];
+            }
+        } else {
+            ++retained;
+        }
+
+        double* power = frames.row(head);
+        fft.power(in, power);
+        for (std::size_t b = 0; b < config.bandCount; ++b) {
+            double sum = 0.0;
+            for (std::size_t k = bandEdges[b]; k < bandEdges[b + 1]; ++k) {
+                sum += power[k];
+            }
+            bands[b] = sum;
+            bandEnergies[b] += sum;
+        }
+
+        head = (head + 1) % config.maxFrames;
+        ++produced;
+    }
+
+}
+}
+}
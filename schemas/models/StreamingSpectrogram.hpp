@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Grid3D.hpp"
+#include "utils/RealFft.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace c_hex {
+namespace domain {
+namespace model {
+
+    struct SpectrogramConfig {
+        std::size_t windowSize = 256; // power of two
+        std::size_t hopSize = 128;
+        std::size_t maxFrames = 512;  // frames retained; older ones are evicted
+        std::size_t bandCount = 8;
+    };
+
+    // Incremental STFT over an unbounded sample stream in bounded memory.
+    //
+    // Samples are scaled by the gain and written to a windowSize ring; each time
+    // a full window is available a Hann-windowed power spectrum (|X|^2, windowSize/2 + 1
+    // bins) is appended to a frame-major ring of maxFrames rows. Band energies are
+    // running sums over the retained frames: a new frame adds its per-band power and
+    // the evicted frame's contribution is subtracted.
+    class StreamingSpectrogram {
+    public:
+        explicit StreamingSpectrogram(const SpectrogramConfig& config);
+
+        // Returns the number of new frames produced by this chunk.
+        std::size_t append(const double* samples, std::size_t count, double gain);
+
+        const SpectrogramConfig& getConfig() const;
+        std::size_t binCount() const;
+        std::size_t frameCount() const;
+        // Total frames produced since construction (including evicted ones).
+        std::size_t framesProduced() const;
+        long long samplesConsumed() const;
+
+        // i-th retained frame, 0 = oldest; binCount() values.
+        const double* frame(std::size_t i) const;
+        const double* latestFrame() const;
+        const std::vector<double>& getBandEnergies() const;
+
+        // Copies the retained frames, oldest first, into a frameCount() x binCount() grid.
+        Grid2D<double> snapshot() const;
+
+    private:
+        void pushSamples(const double* samples, std::size_t count, double gain);
+        void computeFrame();
+
+        SpectrogramConfig config;
+        hexarch::utils::RealFft fft;
+        std::vector<double> window;
+        std::vector<double> ring;
+        std::vector<double> frameInput;
+        Grid2D<double> frames;
+        Grid2D<double> frameBands;
+        std::vector<double> bandEnergies;
+        std::vector<std::size_t> bandEdges;
+        std::size_t ringPos;
+        long long totalSamples;
+        long long nextFrameStart;
+        std::size_t head;
+        std::size_t retained;
+        std::size_t produced;
+    };
+
+}
+}
+}
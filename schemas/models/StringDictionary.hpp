@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace c_hex {
+namespace domain {
+namespace model {
+
+    // Interns strings as dense 32-bit ids so grids and columns store ids instead
+    // of strings. Id 0 is reserved for "none" and maps to the empty string.
+    //
+    // The index keys are views into `names`; a deque never relocates its
+    // elements, so they stay valid as names are added and across moves. Copies
+    // rebuild the index against their own storage.
+    class StringDictionary {
+    public:
+        using Id = std::uint32_t;
+        static constexpr Id kNone = 0;
+
+        StringDictionary() { names.emplace_back(); }
+
+        StringDictionary(const StringDictionary& other) : names(other.names) { reindex(); }
+        StringDictionary(StringDictionary&&) noexcept = default;
+
+        StringDictionary& operator=(const StringDictionary& other) {
+            if (this != &other) {
+                names = other.names;
+                reindex();
+            }
+            return *this;
+        }
+
+        StringDictionary& operator=(StringDictionary&&) noexcept = default;
+
+        // Returns the existing id for value, or assigns the next one.
+        Id intern(std::string_view value) {
+            if (value.empty()) {
+                return kNone;
+            }
+            auto it = index.find(value);
+            if (it != index.end()) {
+                return it->second;
+            }
+            const Id id = static_cast<Id>(names.size());
+            names.emplace_back(value);
+            index.emplace(names.back(), id);
+            return id;
+        }
+
+        // kNone when value was never interned.
+        Id find(std::string_view value) const {
+            auto it = index.find(value);
+            return it == index.end() ? kNone : it->second;
+        }
+
+        const std::string& name(Id id) const {
+            if (id >= names.size()) {
+                throw std::out_of_range("StringDictionary: unknown id");
+            }
+            return names[id];
+        }
+
+        // Number of ids in use, including kNone.
+        std::size_t size() const { return names.size(); }
+
+        // Forgets every name but kNone; ids handed out before are invalid.
+        void clear() {
+            index.clear();
+            names.resize(1);
+        }
+
+    private:
+        void reindex() {
+            index.clear();
+            for (std::size_t i = 1; i < names.size(); ++i) {
+                index.emplace(names[i], static_cast<Id>(i));
+            }
+        }
+
+        std::deque<std::string> names;
+        std::unordered_map<std::string_view, Id> index;
+    };
+
+}
+}
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace c_hex {
+namespace domain {
+namespace model {
+
+    // n x n symmetric matrix storing only the upper triangle, row by row:
+    // row i holds (i, i), (i, i + 1), ..., (i, n - 1) contiguously, n(n + 1)/2
+    // values in total.
+    template <typename T>
+    class SymmetricMatrix {
+    public:
+        SymmetricMatrix() = default;
+
+        explicit SymmetricMatrix(std::size_t n, T init = T())
+            : dim(n), cells(n * (n + 1) / 2, init) {}
+
+        // Takes the upper triangle of a square nested matrix; the lower half is ignored.
+        static SymmetricMatrix fromNested(const std::vector<std::vector<T>>& nested) {
+            SymmetricMatrix m(nested.size());
+            for (std::size_t i = 0; i < m.dim; ++i) {
+                if (nested[i].size() != m.dim) {
+                    throw std::invalid_argument("SymmetricMatrix: matrix must be square");
+                }
+                std::copy(nested[i].begin() + i, nested[i].end(), m.rowTail(i));
+            }
+            return m;
+        }
+
+        std::vector<std::vector<T>> toNested() const {
+            std::vector<std::vector<T>> nested(dim, std::vector<T>(dim));
+            for (std::size_t i = 0; i < dim; ++i) {
+                const T* tail = rowTail(i);
+                for (std::size_t j = i; j < dim; ++j) {
+                    nested[i][j] = tail[j - i];
+                    nested[j][i] = tail[j - i];
+                }
+            }
+            return nested;
+        }
+
+        template <typename U>
+        SymmetricMatrix<U> convert() const {
+            SymmetricMatrix<U> out(dim);
+            std::transform(cells.begin(), cells.end(), out.data(), [](const T& v) { return static_cast<U>(v); });
+            return out;
+        }
+
+        std::size_t size() const { return dim; }
+        std::size_t packedSize() const { return cells.size(); }
+        bool empty() const { return cells.empty(); }
+
+        static std::size_t rowOffset(std::size_t i, std::size_t n) { return i * (2 * n - i + 1) / 2; }
+
+        std::size_t index(std::size_t i, std::size_t j) const {
+            if (i > j) std::swap(i, j);
+            return rowOffset(i, dim) + (j - i);
+        }
+
+        T& at(std::size_t i, std::size_t j) { return cells[index(i, j)]; }
+        const T& at(std::size_t i, std::size_t j) const { return cells[index(i, j)]; }
+
+        // Elements (i, i) .. (i, size() - 1).
+        T* rowTail(std::size_t i) { return cells.data() + rowOffset(i, dim); }
+        const T* rowTail(std::size_t i) const { return cells.data() + rowOffset(i, dim); }
+
+        T* data() { return cells.data(); }
+        const T* data() const { return cells.data(); }
+
+    private:
+        std::size_t dim = 0;
+        std::vector<T> cells;
+    };
+
+    // w' * M * w for a weight vector of m.size() entries, read from the packed
+    // triangle: off-diagonal terms are counted twice.
+    template <typename T>
+    double quadraticForm(const SymmetricMatrix<T>& m, const double* w) {
+        double total = 0.0;
+        for (std::size_t i = 0; i < m.size(); ++i) {
+            const T* tail = m.rowTail(i);
+            double cross = 0.0;
+            for (std::size_t j = i + 1; j < m.size(); ++j) {
+                cross += static_cast<double>(tail[j - i]) * w[j];
+            }
+            total += w[i] * (static_cast<double>(tail[0]) * w[i] + 2.0 * cross);
+        }
+        return total;
+    }
+
+}
+}
+}
@@ -1,13 +1,14 @@
 #include "User.h"
-#include <iostream>
+#include "utils/AsyncLog.hpp"
+#include <utility>
 
 namespace d_hexagon {
 namespace domain {
 namespace model {
 
     // Constructors
-    User::User(int id, const std::string& username, const std::string& email)
-        : id(id), username(username), email(email), active(true) {}
+    User::User(int id, std::string username, std::string email)
+        : id(id), username(std::move(username)), email(std::move(email)), active(true) {}
 
     User::User() : id(0), active(false) {}
 
@@ -16,23 +17,23 @@ namespace model {
 
     // Getters
     int User::getId() const { return id; }
-    std::string User::getUsername() const { return username; }
-    std::string User::getEmail() const { return email; }
+    const std::string& User::getUsername() const { return username; }
+    const std::string& User::getEmail() const { return email; }
     bool User::isActive() const { return active; }
 
     // Setters
-    void User::setUsername(const std::string& newUsername) { username = newUsername; }
-    void User::setEmail(const std::string& newEmail) { email = newEmail; }
+    void User::setUsername(std::string newUsername) { username = std::move(newUsername); }
+    void User::setEmail(std::string newEmail) { email = std::move(newEmail); }
     
     // Domain Logic
     void User::activate() {
         active = true;
-        std::cout << "User " << username << " activated." << std::endl;
+        HEXARCH_LOG_INFO("User {} activated.", username);
     }
 
     void User::deactivate() {
         active = false;
-        std::cout << "User " << username << " deactivated." << std::endl;
+        HEXARCH_LOG_INFO("User {} deactivated.", username);
     }
 
     // Utilities
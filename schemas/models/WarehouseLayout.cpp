@@ -1,31 +1,330 @@
 #include "WarehouseLayout.hpp"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
 
 namespace c_hex {
 namespace domain {
 namespace model {
 
-    WarehouseLayout::WarehouseLayout(int id, const std::string& zoneName, 
+    namespace {
+
+        // Cells scanned per block in findFreeSlots before looking for positions.
+        constexpr std::size_t kScanBlock = 64;
+
+        std::size_t countZeros(const int* p, std::size_t n) {
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                count += (p[i] == 0);
+            }
+            return count;
+        }
+
+        bool sameShape(const Grid3D<int>& a, const Grid3D<int>& b) {
+            return a.sizeX() == b.sizeX() && a.sizeY() == b.sizeY() && a.sizeZ() == b.sizeZ();
+        }
+
+        bool sameShape(const Grid2D<double>& a, const Grid2D<double>& b) {
+            return a.rows() == b.rows() && a.cols() == b.cols();
+        }
+
+        // Calls fn(row) for each row of rowWidth cells that differs between two
+        // grids of the same shape.
+        template <typename T, typename Fn>
+        void forEachChangedRow(const T* before, const T* after, std::size_t rowCount, std::size_t rowWidth, Fn&& fn) {
+            for (std::size_t r = 0; r < rowCount; ++r) {
+                if (!std::equal(before + r * rowWidth, before + (r + 1) * rowWidth, after + r * rowWidth)) {
+                    fn(r);
+                }
+            }
+        }
+
+    }
+
+    WarehouseLayout::WarehouseLayout(int id, std::string zoneName, 
+                                   Grid3D<int> grid,
+                                   Grid2D<double> temperatureMap,
+                                   bool isActive, std::string managerName, long capacity)
+        : id(id), zoneName(std::move(zoneName)), grid(std::move(grid)), temperatureMap(std::move(temperatureMap)),
+          isActive(isActive), managerName(std::move(managerName)), capacity(capacity),
+          published(Grids{ SharedGrid3D<int>(this->grid), SharedGrid2D<double>(this->temperatureMap) }) {
+        unpublishedGridRows.clear();
+        unpublishedTemperatureRows.clear();
+    }
+
+    WarehouseLayout::WarehouseLayout(int id, std::string zoneName, 
                                    const std::vector<std::vector<std::vector<int>>>& grid,
                                    const std::vector<std::vector<double>>& temperatureMap,
-                                   bool isActive, const std::string& managerName, long capacity)
-        : id(id), zoneName(zoneName), grid(grid), temperatureMap(temperatureMap),
-          isActive(isActive), managerName(managerName), capacity(capacity) {}
+                                   bool isActive, std::string managerName, long capacity)
+        : WarehouseLayout(id, std::move(zoneName), Grid3D<int>::fromNested(grid), Grid2D<double>::fromNested(temperatureMap),
+                          isActive, std::move(managerName), capacity) {}
 
     WarehouseLayout::WarehouseLayout() : id(0), isActive(false), capacity(0) {}
 
     WarehouseLayout::~WarehouseLayout() = default;
 
     int WarehouseLayout::getId() const { return id; }
-    std::string WarehouseLayout::getZoneName() const { return zoneName; }
-    std::vector<std::vector<std::vector<int>>> WarehouseLayout::getGrid() const { return grid; }
-    std::vector<std::vector<double>> WarehouseLayout::getTemperatureMap() const { return temperatureMap; }
+    const std::string& WarehouseLayout::getZoneName() const { return zoneName; }
+    const Grid3D<int>& WarehouseLayout::getGrid() const { return grid; }
+    const Grid2D<double>& WarehouseLayout::getTemperatureMap() const { return temperatureMap; }
     bool WarehouseLayout::getIsActive() const { return isActive; }
-    std::string WarehouseLayout::getManagerName() const { return managerName; }
+    const std::string& WarehouseLayout::getManagerName() const { return managerName; }
     long WarehouseLayout::getCapacity() const { return capacity; }
 
-    void WarehouseLayout::setZoneName(const std::string& name) { zoneName = name; }
-    void WarehouseLayout::setGrid(const std::vector<std::vector<std::vector<int>>>& newGrid) { grid = newGrid; }
-    void WarehouseLayout::setTemperatureMap(const std::vector<std::vector<double>>& map) { temperatureMap = map; }
+    WarehouseLayout::GridSnapshot WarehouseLayout::gridSnapshot() const { return published.read(); }
+
+    void WarehouseLayout::publish() {
+        const bool gridChanged = unpublishedGridRows.any();
+        const bool temperatureChanged = unpublishedTemperatureRows.any();
+        if (!gridChanged && !temperatureChanged) {
+            return;
+        }
+        // A null selection (a new shape, or everything marked) copies the grid whole
+        const hexarch::utils::Bitmap* gridSelection = unpublishedGridRows.selection(grid.sizeX() * grid.sizeY());
+        const hexarch::utils::Bitmap* temperatureSelection = unpublishedTemperatureRows.selection(temperatureMap.rows());
+        published.update([&](const Grids& current) {
+            Grids next = current;
+            if (gridChanged) {
+                next.grid = gridSelection ? current.grid.rebase(grid, *gridSelection) : SharedGrid3D<int>(grid);
+            }
+            if (temperatureChanged) {
+                next.temperatureMap = temperatureSelection ? current.temperatureMap.rebase(temperatureMap, *temperatureSelection)
+                                                           : SharedGrid2D<double>(temperatureMap);
+            }
+            return next;
+        });
+        unpublishedGridRows.clear();
+        unpublishedTemperatureRows.clear();
+    }
+
+    void WarehouseLayout::setZoneName(std::string name) {
+        zoneName = std::move(name);
+        dirty.mark(Field::ZoneName);
+    }
+
+    void WarehouseLayout::setGrid(Grid3D<int> newGrid) {
+        // One comparison serves both the delta rows and the next publish()
+        if (sameShape(grid, newGrid)) {
+            const std::size_t rowCount = grid.sizeX() * grid.sizeY();
+            forEachChangedRow(grid.data(), newGrid.data(), rowCount, grid.sizeZ(), [&](std::size_t row) {
+                gridRows.mark(row, rowCount);
+                unpublishedGridRows.mark(row, rowCount);
+            });
+        } else {
+            gridRows.markAll();
+            unpublishedGridRows.markAll();
+        }
+        if (gridRows.any()) {
+            dirty.mark(Field::Grid);
+        }
+        grid = std::move(newGrid);
+    }
+
+    void WarehouseLayout::setGrid(const std::vector<std::vector<std::vector<int>>>& newGrid) { setGrid(Grid3D<int>::fromNested(newGrid)); }
+
+    void WarehouseLayout::setTemperatureMap(Grid2D<double> map) {
+        if (sameShape(temperatureMap, map)) {
+            forEachChangedRow(temperatureMap.data(), map.data(), map.rows(), map.cols(), [&](std::size_t row) {
+                temperatureRows.mark(row, map.rows());
+                unpublishedTemperatureRows.mark(row, map.rows());
+            });
+        } else {
+            temperatureRows.markAll();
+            unpublishedTemperatureRows.markAll();
+        }
+        if (temperatureRows.any()) {
+            dirty.mark(Field::TemperatureMap);
+        }
+        temperatureMap = std::move(map);
+    }
+
+    void WarehouseLayout::setTemperatureMap(const std::vector<std::vector<double>>& map) { setTemperatureMap(Grid2D<double>::fromNested(map)); }
+
+    void WarehouseLayout::setBin(const BinSlot& slot, int units) {
+        if (slot.aisle >= grid.sizeX() || slot.bay >= grid.sizeY() || slot.level >= grid.sizeZ()) {
+            throw std::out_of_range("WarehouseLayout: bin slot out of range");
+        }
+        grid.at(slot.aisle, slot.bay, slot.level) = units;
+        const std::size_t row = slot.aisle * grid.sizeY() + slot.bay;
+        gridRows.mark(row, grid.sizeX() * grid.sizeY());
+        unpublishedGridRows.mark(row, grid.sizeX() * grid.sizeY());
+        dirty.mark(Field::Grid);
+    }
+
+    std::uint64_t WarehouseLayout::dirtyFields() const { return dirty.mask(); }
+    bool WarehouseLayout::isDirty(Field field) const { return dirty.test(field); }
+
+    void WarehouseLayout::clearDirty() {
+        dirty.clear();
+        gridRows.clear();
+        temperatureRows.clear();
+    }
+
+    void WarehouseLayout::markAllDirty() {
+        dirty.markAll();
+        gridRows.markAll();
+        temperatureRows.markAll();
+    }
+
+    void WarehouseLayout::encodeDelta(std::vector<unsigned char>& out) const {
+        hexarch::utils::delta::Writer w(out, dirty.mask());
+        if (dirty.test(Field::Id)) w.value(static_cast<std::int32_t>(id));
+        if (dirty.test(Field::ZoneName)) w.string(zoneName);
+        if (dirty.test(Field::Grid)) {
+            w.grid({ grid.sizeX(), grid.sizeY(), grid.sizeZ() }, grid.data(), gridRows.selection(grid.sizeX() * grid.sizeY()));
+        }
+        if (dirty.test(Field::TemperatureMap)) {
+            w.grid({ temperatureMap.rows(), temperatureMap.cols() }, temperatureMap.data(), temperatureRows.selection(temperatureMap.rows()));
+        }
+        if (dirty.test(Field::IsActive)) w.value(isActive);
+        if (dirty.test(Field::ManagerName)) w.string(managerName);
+        if (dirty.test(Field::Capacity)) w.value(static_cast<std::int64_t>(capacity));
+    }
+
+    bool WarehouseLayout::applyDelta(const unsigned char* data, std::size_t size) {
+        using hexarch::utils::delta::GridKind;
+        hexarch::utils::delta::Reader r(data, size);
+        std::int32_t newId = 0;
+        std::string_view newZone, newManager;
+        hexarch::utils::delta::GridPatch<int> gridPatch;
+        hexarch::utils::delta::GridPatch<double> temperaturePatch;
+        bool newActive = false;
+        std::int64_t newCapacity = 0;
+        if (r.has(Field::Id)) r.value(newId);
+        if (r.has(Field::ZoneName)) r.string(newZone);
+        if (r.has(Field::Grid)) r.grid(gridPatch, 3);
+        if (r.has(Field::TemperatureMap)) r.grid(temperaturePatch, 2);
+        if (r.has(Field::IsActive)) r.value(newActive);
+        if (r.has(Field::ManagerName)) r.string(newManager);
+        if (r.has(Field::Capacity)) r.value(newCapacity);
+        if (!r.finished() || !dirty.validMask(r.mask())) {
+            return false;
+        }
+        const bool gridRowsFit = !r.has(Field::Grid) || gridPatch.kind == GridKind::Full
+            || (gridPatch.dims[0] == grid.sizeX() && gridPatch.dims[1] == grid.sizeY() && gridPatch.dims[2] == grid.sizeZ());
+        const bool temperatureRowsFit = !r.has(Field::TemperatureMap) || temperaturePatch.kind == GridKind::Full
+            || (temperaturePatch.dims[0] == temperatureMap.rows() && temperaturePatch.dims[1] == temperatureMap.cols());
+        if (!gridRowsFit || !temperatureRowsFit) {
+            return false;
+        }
+
+        if (r.has(Field::Id)) id = newId;
+        if (r.has(Field::ZoneName)) zoneName.assign(newZone.data(), newZone.size());
+        if (r.has(Field::Grid)) {
+            if (gridPatch.kind == GridKind::Full) {
+                Grid3D<int> replacement(gridPatch.dims[0], gridPatch.dims[1], gridPatch.dims[2]);
+                gridPatch.applyTo(replacement.data());
+                grid = std::move(replacement);
+                gridRows.markAll();
+                unpublishedGridRows.markAll();
+            } else {
+                gridPatch.applyTo(grid.data());
+                gridPatch.forEachRow([&](std::size_t row, const unsigned char*) {
+                    gridRows.mark(row, gridPatch.rowCount);
+                    unpublishedGridRows.mark(row, gridPatch.rowCount);
+                });
+            }
+        }
+        if (r.has(Field::TemperatureMap)) {
+            if (temperaturePatch.kind == GridKind::Full) {
+                Grid2D<double> replacement(temperaturePatch.dims[0], temperaturePatch.dims[1]);
+                temperaturePatch.applyTo(replacement.data());
+                temperatureMap = std::move(replacement);
+                temperatureRows.markAll();
+                unpublishedTemperatureRows.markAll();
+            } else {
+                temperaturePatch.applyTo(temperatureMap.data());
+                temperaturePatch.forEachRow([&](std::size_t row, const unsigned char*) {
+                    temperatureRows.mark(row, temperaturePatch.rowCount);
+                    unpublishedTemperatureRows.mark(row, temperaturePatch.rowCount);
+                });
+            }
+        }
+        if (r.has(Field::IsActive)) isActive = newActive;
+        if (r.has(Field::ManagerName)) managerName.assign(newManager.data(), newManager.size());
+        if (r.has(Field::Capacity)) capacity = static_cast<long>(newCapacity);
+        dirty.markMask(r.mask());
+        return true;
+    }
+
+    std::size_t WarehouseLayout::countFreeBins() const {
+        return countZeros(grid.data(), grid.size());
+    }
+
+    std::size_t WarehouseLayout::countFreeBinsInAisle(std::size_t aisle) const {
+        if (aisle >= grid.sizeX()) {
+            throw std::out_of_range("WarehouseLayout: aisle out of range");
+        }
+        return countZeros(grid.slice(aisle), grid.strideX());
+    }
+
+    std::size_t WarehouseLayout::findFreeSlots(std::size_t aisle, std::size_t n, std::vector<BinSlot>& out) const {
+        if (aisle >= grid.sizeX()) {
+            throw std::out_of_range("WarehouseLayout: aisle out of range");
+        }
+        const int* cells = grid.slice(aisle);
+        const std::size_t total = grid.strideX();
+        const std::size_t levels = grid.sizeZ();
+        std::size_t found = 0;
+
+        for (std::size_t begin = 0; begin < total && found < n; begin += kScanBlock) {
+            const std::size_t end = std::min(total, begin + kScanBlock);
+            if (countZeros(cells + begin, end - begin) == 0) {
+                continue;
+            }
+            for (std::size_t i = begin; i < end && found < n; ++i) {
+                if (cells[i] == 0) {
+                    out.push_back({ aisle, i / levels, i % levels });
+                    ++found;
+                }
+            }
+        }
+        return found;
+    }
+
+    std::vector<long> WarehouseLayout::occupancyPerLevel() const {
+        std::vector<long> levels(grid.sizeZ(), 0);
+        const std::size_t columns = grid.sizeX() * grid.sizeY();
+        const std::size_t dz = grid.sizeZ();
+        const int* cells = grid.data();
+        long* sums = levels.data();
+        for (std::size_t c = 0; c < columns; ++c, cells += dz) {
+            for (std::size_t z = 0; z < dz; ++z) {
+                sums[z] += cells[z] > 0 ? cells[z] : 0;
+            }
+        }
+        return levels;
+    }
+
+    TemperatureRange WarehouseLayout::temperatureRange() const {
+        double lo = std::numeric_limits<double>::infinity();
+        double hi = -std::numeric_limits<double>::infinity();
+        const double* t = temperatureMap.data();
+        for (std::size_t i = 0; i < temperatureMap.size(); ++i) {
+            lo = std::min(lo, t[i]);
+            hi = std::max(hi, t[i]);
+        }
+        return { lo, hi };
+    }
+
+    std::size_t WarehouseLayout::countTemperatureAbove(double threshold) const {
+        std::size_t count = 0;
+        const double* t = temperatureMap.data();
+        for (std::size_t i = 0; i < temperatureMap.size(); ++i) {
+            count += (t[i] > threshold);
+        }
+        return count;
+    }
+
+    std::size_t WarehouseLayout::countTemperatureOutside(double low, double high) const {
+        std::size_t count = 0;
+        const double* t = temperatureMap.data();
+        for (std::size_t i = 0; i < temperatureMap.size(); ++i) {
+            count += (t[i] < low) | (t[i] > high);
+        }
+        return count;
+    }
 
 }
 }
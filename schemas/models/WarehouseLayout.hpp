@@ -1,5 +1,11 @@
 #pragma once
 
+#include "Grid3D.hpp"
+#include "utils/DeltaCodec.hpp"
+#include "utils/Versioned.hpp"
+
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -7,35 +13,119 @@ namespace c_hex {
 namespace domain {
 namespace model {
 
+    // Grid cell coordinates: x = aisle, y = bay along the aisle, z = shelf level.
+    struct BinSlot {
+        std::size_t aisle;
+        std::size_t bay;
+        std::size_t level;
+    };
+
+    struct TemperatureRange {
+        double min;
+        double max;
+    };
+
     class WarehouseLayout {
+    public:
+        // Bit positions in dirtyFields() and in delta records.
+        enum class Field : std::uint8_t { Id, ZoneName, Grid, TemperatureMap, IsActive, ManagerName, Capacity, Count };
+
+        // What gridSnapshot() returns: one published version of both grids.
+        struct Grids {
+            SharedGrid3D<int> grid;
+            SharedGrid2D<double> temperatureMap;
+        };
+        using GridSnapshot = hexarch::utils::Versioned<Grids>::Snapshot;
+
     private:
         int id;
         std::string zoneName;
-        std::vector<std::vector<std::vector<int>>> grid; // 3D array for shelves/bins
-        std::vector<std::vector<double>> temperatureMap; // 2D array
+        Grid3D<int> grid; // bins: 0 = free, > 0 = occupied units, < 0 = unusable
+        Grid2D<double> temperatureMap;
         bool isActive;
         std::string managerName;
         long capacity;
+        hexarch::utils::DirtyFields<Field> dirty;
+        // Changed z runs of grid (row = aisle * sizeY + bay) and rows of temperatureMap.
+        hexarch::utils::DirtyRows gridRows;
+        hexarch::utils::DirtyRows temperatureRows;
+        // grid and temperatureMap as of the last publish(), for other threads.
+        hexarch::utils::Versioned<Grids> published;
+        // Rows changed since the last publish(); unlike gridRows and
+        // temperatureRows, clearDirty() leaves them alone.
+        hexarch::utils::DirtyRows unpublishedGridRows;
+        hexarch::utils::DirtyRows unpublishedTemperatureRows;
 
     public:
-        WarehouseLayout(int id, const std::string& zoneName, 
+        WarehouseLayout(int id, std::string zoneName, 
+                       Grid3D<int> grid,
+                       Grid2D<double> temperatureMap,
+                       bool isActive, std::string managerName, long capacity);
+        WarehouseLayout(int id, std::string zoneName, 
                        const std::vector<std::vector<std::vector<int>>>& grid,
                        const std::vector<std::vector<double>>& temperatureMap,
-                       bool isActive, const std::string& managerName, long capacity);
+                       bool isActive, std::string managerName, long capacity);
         WarehouseLayout();
         virtual ~WarehouseLayout();
+        WarehouseLayout(const WarehouseLayout&) = default;
+        WarehouseLayout(WarehouseLayout&&) noexcept = default;
+        WarehouseLayout& operator=(const WarehouseLayout&) = default;
+        WarehouseLayout& operator=(WarehouseLayout&&) noexcept = default;
 
         int getId() const;
-        std::string getZoneName() const;
-        std::vector<std::vector<std::vector<int>>> getGrid() const;
-        std::vector<std::vector<double>> getTemperatureMap() const;
+        const std::string& getZoneName() const;
+        const Grid3D<int>& getGrid() const;
+        const Grid2D<double>& getTemperatureMap() const;
         bool getIsActive() const;
-        std::string getManagerName() const;
+        const std::string& getManagerName() const;
         long getCapacity() const;
 
-        void setZoneName(const std::string& name);
+        // The grids for readers on other threads, without locking or copying:
+        // wait-free, and unchanged for as long as the snapshot is held, while
+        // this object keeps being written. Shows the grids as of the last
+        // publish() (or construction).
+        GridSnapshot gridSnapshot() const;
+
+        // Makes the grid changes since the last publish() visible to
+        // gridSnapshot(), copying only the blocks holding changed rows. Setters
+        // and applyDelta() only write locally; call this once per batch of
+        // writes, on the writing thread. Does nothing when nothing changed.
+        void publish();
+
+        void setZoneName(std::string name);
+        // Replacing a grid with one of the same shape records only the rows that differ.
+        void setGrid(Grid3D<int> newGrid);
         void setGrid(const std::vector<std::vector<std::vector<int>>>& newGrid);
+        void setTemperatureMap(Grid2D<double> map);
         void setTemperatureMap(const std::vector<std::vector<double>>& map);
+        // Throws std::out_of_range, changing nothing, when slot is outside the grid.
+        void setBin(const BinSlot& slot, int units);
+
+        // Fields changed since the last clearDirty(); a new object is all dirty.
+        std::uint64_t dirtyFields() const;
+        bool isDirty(Field field) const;
+        void clearDirty();
+        void markAllDirty();
+
+        // Writes the dirty fields as a delta record (utils/DeltaCodec.hpp) into
+        // out; grid and temperatureMap go as their changed rows when few changed.
+        void encodeDelta(std::vector<unsigned char>& out) const;
+        // Applies a record from encodeDelta and marks what it changed dirty. A
+        // malformed record, or a row patch for a grid of another shape, returns
+        // false and leaves the object unchanged.
+        bool applyDelta(const unsigned char* data, std::size_t size);
+
+        // Occupancy queries; the scans are branch-free so they vectorize.
+        std::size_t countFreeBins() const;
+        std::size_t countFreeBinsInAisle(std::size_t aisle) const;
+        // Appends up to n free slots of the aisle to out in bay/level order; returns how many were found.
+        std::size_t findFreeSlots(std::size_t aisle, std::size_t n, std::vector<BinSlot>& out) const;
+        // Occupied units per shelf level (index = z).
+        std::vector<long> occupancyPerLevel() const;
+
+        TemperatureRange temperatureRange() const;
+        std::size_t countTemperatureAbove(double threshold) const;
+        std::size_t countTemperatureOutside(double low, double high) const;
     };
 
 }
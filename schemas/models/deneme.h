@@ -15,21 +15,27 @@ namespace model {
 
     public:
         // Constructors
-        User(int id, const std::string& username, const std::string& email);
+        User(int id, std::string username, std::string email);
         User();
 
         // Destructor
         virtual ~User();
 
+        // Copy / Move
+        User(const User&) = default;
+        User(User&&) noexcept = default;
+        User& operator=(const User&) = default;
+        User& operator=(User&&) noexcept = default;
+
         // Getters
         int getId() const;
-        std::string getUsername() const;
-        std::string getEmail() const;
+        const std::string& getUsername() const;
+        const std::string& getEmail() const;
         bool isActive() const;
 
         // Setters
-        void setUsername(const std::string& newUsername);
-        void setEmail(const std::string& newEmail);
+        void setUsername(std::string newUsername);
+        void setEmail(std::string newEmail);
         
         // Domain Logic
         void activate();
@@ -0,0 +1,41 @@
+#pragma once
+
+// Incoming adapters the replay driver can feed, by the channel they capture.
+//
+// "Add Incoming Adapter" writes replay/<Adapter>Replay.cpp next to this file
+// for every adapter it generates; each registers itself here at static
+// initialisation, so replay/ReplayMain.cpp finds it through the channel name
+// given on its command line.
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+
+namespace hexarch {
+namespace replay {
+
+    // Hands one captured record to an incoming adapter's receive().
+    using Handler = std::function<void(const unsigned char* bytes, std::size_t size)>;
+
+    // Builds the adapter, and the port it delivers to, for one replay run.
+    using HandlerFactory = std::function<Handler()>;
+
+    // channel -> adapter class name -> factory
+    using ChannelMap = std::map<std::string, std::map<std::string, HandlerFactory>>;
+
+    inline ChannelMap& channels() {
+        static ChannelMap registry;
+        return registry;
+    }
+
+    // Define one at namespace scope to register an adapter.
+    struct ChannelRegistration {
+        ChannelRegistration(const std::string& channel, const std::string& adapter, HandlerFactory factory) {
+            channels()[channel][adapter] = std::move(factory);
+        }
+    };
+
+} // namespace replay
+} // namespace hexarch
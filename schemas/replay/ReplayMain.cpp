@@ -0,0 +1,103 @@
+// Replays traffic captured by this component's incoming adapters through the
+// same adapter and domain logic, without a broker:
+//
+//   HEXARCH_CAPTURE_DIR=captures bin/<component>        (records <channel>-NNNNNN.hxtl)
+//   make replay REPLAY_ARGS="captures Customer --speed 10"
+//
+// --speed 1 (default) keeps the recorded gaps, 10 plays ten times faster and
+// max as fast as the adapter keeps up. Prints throughput and latency
+// percentiles; compare them before and after a domain/logic change.
+//
+// The channel picks the incoming adapter registered for it by its generated
+// replay/<Adapter>Replay.cpp (see ReplayChannels.hpp); --adapter chooses
+// between several adapters capturing the same channel.
+
+#include "ReplayChannels.hpp"
+#include "utils/TrafficLog.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+    int usage(const char* program) {
+        std::fprintf(stderr, "usage: %s <capture dir> <channel> [--adapter <name>] [--speed <x>|max] [--limit <n>]\n", program);
+        return 2;
+    }
+
+    template <typename Map>
+    std::string keys(const Map& map) {
+        std::string out;
+        for (const auto& entry : map) {
+            out += out.empty() ? entry.first : ", " + entry.first;
+        }
+        return out.empty() ? "none" : out;
+    }
+
+    // The handler of the adapter registered for channel (the named one when
+    // several are).
+    hexarch::replay::Handler makeHandler(const std::string& channel, const std::string& adapter) {
+        const hexarch::replay::ChannelMap& registry = hexarch::replay::channels();
+        const auto found = registry.find(channel);
+        if (found == registry.end()) {
+            throw std::runtime_error("no incoming adapter registered for channel '" + channel
+                                     + "' (registered: " + keys(registry) + ")");
+        }
+        const auto& adapters = found->second;
+        if (adapter.empty() && adapters.size() > 1) {
+            throw std::runtime_error("several adapters capture channel '" + channel + "', pick one with --adapter: " + keys(adapters));
+        }
+        const auto chosen = adapter.empty() ? adapters.begin() : adapters.find(adapter);
+        if (chosen == adapters.end()) {
+            throw std::runtime_error("adapter '" + adapter + "' is not registered for channel '" + channel + "'");
+        }
+        return chosen->second();
+    }
+
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        return usage(argv[0]);
+    }
+    hexarch::utils::ReplayOptions options;
+    std::string adapter;
+    for (int i = 3; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--adapter" && i + 1 < argc) {
+            adapter = argv[++i];
+        } else if (arg == "--speed" && i + 1 < argc) {
+            const std::string value = argv[++i];
+            options.speed = value == "max" ? 0.0 : std::atof(value.c_str());
+            if (options.speed <= 0.0 && value != "max") {
+                return usage(argv[0]);
+            }
+        } else if (arg == "--limit" && i + 1 < argc) {
+            options.limit = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+    // Replayed traffic must not be captured again
+    ::unsetenv(hexarch::utils::kCaptureDirEnv);
+
+    try {
+        const hexarch::replay::Handler handle = makeHandler(argv[2], adapter);
+        hexarch::utils::TrafficReader reader(argv[1], argv[2]);
+        const hexarch::utils::ReplayReport report = hexarch::utils::replayTraffic(reader, options, handle);
+        char speed[32] = "max";
+        if (options.speed > 0.0) {
+            std::snprintf(speed, sizeof(speed), "%gx", options.speed);
+        }
+        std::printf("replay %s/%s, %zu segments, speed %s\n", argv[1], argv[2], reader.segmentCount(), speed);
+        hexarch::utils::printReplayReport(stdout, report);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "replay: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,38 @@
+# Traffic replay driver, included by the component Makefile.
+#
+#   make replay REPLAY_ARGS="<capture dir> <channel> [--adapter <name>] [--speed <x>|max] [--limit <n>]"
+#
+# Capture first by running the component with HEXARCH_CAPTURE_DIR=<dir>; its
+# incoming adapters then log every datagram they receive. The driver links
+# replay/*.cpp with the component's own objects (everything but main) of the
+# current BUILD, release unless given, and feeds the log back through the
+# incoming adapter registered for <channel> by its replay/<Adapter>Replay.cpp,
+# which "Add Incoming Adapter" writes along with the adapter.
+
+REPLAY_DIR = replay
+REPLAY_SOURCES = $(wildcard $(REPLAY_DIR)/*.cpp)
+REPLAY_OBJECTS = $(REPLAY_SOURCES:%.cpp=$(OBJ_DIR)/%.o) $(LIB_OBJECTS)
+REPLAY_TARGET = $(BUILD_DIR)/$(PROJECT_NAME)_replay
+REPLAY_ARGS ?=
+
+replay: $(REPLAY_TARGET)
+	@if [ -z "$(REPLAY_ARGS)" ]; then \
+		echo 'Usage: make replay REPLAY_ARGS="<capture dir> <channel> [--adapter <name>] [--speed <x>|max] [--limit <n>]"'; \
+		exit 2; \
+	fi
+	$(REPLAY_TARGET) $(REPLAY_ARGS)
+
+replay-build: $(REPLAY_TARGET)
+
+$(REPLAY_TARGET): $(REPLAY_OBJECTS) $(LINK_STAMP)
+	@mkdir -p $(BUILD_DIR)
+	@echo "Linking $(PROJECT_NAME)_replay ($(BUILD))..."
+	$(CXX) $(REPLAY_OBJECTS) -o $@ $(LDFLAGS)
+
+replay-clean:
+	@rm -rf obj/*/$(REPLAY_DIR)
+	@rm -f $(REPLAY_TARGET)
+
+clean: replay-clean
+
+.PHONY: replay replay-build replay-clean
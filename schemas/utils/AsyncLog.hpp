@@ -0,0 +1,681 @@
+#pragma once
+
+#include "utils/RingBuffer.hpp"
+#include "utils/WireCodec.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Lowest level compiled in: 0 trace, 1 debug, 2 info, 3 warn, 4 error, 5 off.
+// Statements below it compile to nothing and do not evaluate their arguments.
+#ifndef HEXARCH_LOG_LEVEL
+#define HEXARCH_LOG_LEVEL 2
+#endif
+
+// HEXARCH_LOG_INFO("user {} activated", username);
+// The format must be a string literal; each {} takes the next argument.
+#define HEXARCH_LOG(level, format, ...)                                                                           \
+    do {                                                                                                          \
+        if constexpr (static_cast<int>(::hexarch::utils::log::Level::level) >= HEXARCH_LOG_LEVEL) {               \
+            static constexpr ::hexarch::utils::log::Site hexarchLogSite{ ::hexarch::utils::log::Level::level,     \
+                                                                         __FILE__, __LINE__, format };            \
+            ::hexarch::utils::log::Logger::instance()                                                             \
+                .write<::hexarch::utils::log::countPlaceholders(format)>(hexarchLogSite, ##__VA_ARGS__);          \
+        }                                                                                                         \
+    } while (0)
+
+#define HEXARCH_LOG_TRACE(...) HEXARCH_LOG(Trace, __VA_ARGS__)
+#define HEXARCH_LOG_DEBUG(...) HEXARCH_LOG(Debug, __VA_ARGS__)
+#define HEXARCH_LOG_INFO(...) HEXARCH_LOG(Info, __VA_ARGS__)
+#define HEXARCH_LOG_WARN(...) HEXARCH_LOG(Warn, __VA_ARGS__)
+#define HEXARCH_LOG_ERROR(...) HEXARCH_LOG(Error, __VA_ARGS__)
+
+namespace hexarch {
+namespace utils {
+namespace log {
+
+    // Asynchronous logger for models and adapters.
+    //
+    // A log statement copies its arguments, unformatted, into a byte ring owned
+    // by the calling thread (single producer, no lock, no allocation) and
+    // returns. A writer thread drains every ring each pollInterval, formats
+    // and writes. A record that does not fit its ring is dropped and counted
+    // rather than blocking the caller.
+    //
+    // In binary mode the writer stores the raw records plus each call site's
+    // format once; decodeBinary() turns the file into text offline.
+    //
+    // Arguments: bool, char, integers, enums, floating point, pointers, and
+    // anything convertible to std::string_view (copied at the call).
+
+    enum class Level : std::uint8_t { Trace, Debug, Info, Warn, Error, Off };
+
+    inline const char* toString(Level level) {
+        switch (level) {
+            case Level::Trace: return "TRACE";
+            case Level::Debug: return "DEBUG";
+            case Level::Info: return "INFO";
+            case Level::Warn: return "WARN";
+            case Level::Error: return "ERROR";
+            case Level::Off: return "OFF";
+        }
+        return "?";
+    }
+
+    // One log statement; lives in static storage at the call site.
+    struct Site {
+        Level level;
+        const char* file;
+        int line;
+        const char* format;
+    };
+
+    constexpr std::size_t countPlaceholders(const char* format) {
+        std::size_t n = 0;
+        for (; *format; ++format) {
+            if (format[0] == '{' && format[1] == '}') {
+                ++n;
+                ++format;
+            }
+        }
+        return n;
+    }
+
+    struct LogOptions {
+        // Empty writes to stderr.
+        std::string path;
+        // Raw records for decodeBinary() instead of text.
+        bool binary = false;
+        // Ring size per logging thread, rounded up to a power of two.
+        std::size_t threadBufferBytes = std::size_t(1) << 20;
+        // How often the writer thread drains the rings.
+        std::chrono::microseconds pollInterval{ 1000 };
+    };
+
+    struct LogStats {
+        std::uint64_t records;
+        // Records lost to a full ring.
+        std::uint64_t dropped;
+        std::size_t threads;
+    };
+
+    enum class ArgTag : std::uint8_t { Bool, Char, Int, UInt, Double, String, Pointer };
+
+    namespace detail {
+
+        // Record: uint32 size (whole record), uint64 Site address, uint64 clock
+        // reading, then per argument a tag byte and its payload.
+        constexpr std::size_t kRecordHeader = 20;
+
+        inline std::int64_t wallNs() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+
+        // The caller stamps records with the TSC (a few ns, against ~40 for
+        // system_clock under some hypervisors); the writer maps it to wall time.
+        // Assumes an invariant TSC, as on any x86 server of the last decade.
+        inline std::uint64_t readClock() {
+#if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#else
+            return static_cast<std::uint64_t>(wallNs());
+#endif
+        }
+
+        // Writer-side readClock() -> ns since the epoch. The rate is re-measured
+        // against system_clock on every pass, over a baseline that keeps growing.
+        class ClockMap {
+        public:
+            void anchor() {
+                tick0 = readClock();
+                ns0 = wallNs();
+            }
+
+            void refresh() {
+#if defined(__x86_64__) || defined(__i386__)
+                const std::uint64_t tick = readClock();
+                const std::int64_t ns = wallNs();
+                if (tick > tick0 && ns > ns0) {
+                    nsPerTick = static_cast<double>(ns - ns0) / static_cast<double>(tick - tick0);
+                }
+#endif
+            }
+
+            std::int64_t toNs(std::uint64_t tick) const {
+                const double delta = static_cast<double>(static_cast<std::int64_t>(tick - tick0));
+                return ns0 + static_cast<std::int64_t>(delta * nsPerTick);
+            }
+
+        private:
+            std::uint64_t tick0 = 0;
+            std::int64_t ns0 = 0;
+            double nsPerTick = 1.0;
+        };
+
+        // Binary file: "HXLG", uint16 version, then entries starting with a type byte.
+        //   1 site   uint32 id, uint8 level, uint32 line, uint32 + file, uint32 + format
+        //   2 record uint32 site id, int64 ns, uint32 thread, uint32 n, n argument bytes
+        constexpr char kBinaryMagic[4] = { 'H', 'X', 'L', 'G' };
+        constexpr std::uint16_t kBinaryVersion = 1;
+
+        template <typename T>
+        struct Unsupported : std::false_type {};
+
+        template <typename T>
+        constexpr ArgTag tagOf() {
+            using U = typename std::decay<T>::type;
+            if constexpr (std::is_same<U, bool>::value) {
+                return ArgTag::Bool;
+            } else if constexpr (std::is_same<U, char>::value) {
+                return ArgTag::Char;
+            } else if constexpr (std::is_enum<U>::value) {
+                return std::is_signed<typename std::underlying_type<U>::type>::value ? ArgTag::Int : ArgTag::UInt;
+            } else if constexpr (std::is_integral<U>::value) {
+                return std::is_signed<U>::value ? ArgTag::Int : ArgTag::UInt;
+            } else if constexpr (std::is_floating_point<U>::value) {
+                return ArgTag::Double;
+            } else if constexpr (std::is_convertible<const U&, std::string_view>::value) {
+                return ArgTag::String;
+            } else if constexpr (std::is_pointer<U>::value) {
+                return ArgTag::Pointer;
+            } else {
+                static_assert(Unsupported<U>::value, "HEXARCH_LOG: unsupported argument type");
+                return ArgTag::Pointer;
+            }
+        }
+
+        template <typename T>
+        inline std::string_view asString(const T& value) {
+            if constexpr (std::is_pointer<typename std::decay<T>::type>::value) {
+                if (value == nullptr) return "(null)";
+            }
+            return std::string_view(value);
+        }
+
+        template <typename T>
+        inline std::size_t argSize(const T& value) {
+            constexpr ArgTag tag = tagOf<T>();
+            if constexpr (tag == ArgTag::String) {
+                return 5 + asString(value).size();
+            } else if constexpr (tag == ArgTag::Bool || tag == ArgTag::Char) {
+                return 2;
+            } else {
+                return 9;
+            }
+        }
+
+        // Producer side of one thread's ring.
+        struct ThreadBuffer {
+            ThreadBuffer(std::size_t bytes, std::uint32_t id) : ring(utils::detail::roundUpPow2(bytes)), mask(ring.size() - 1), threadId(id) {}
+
+            alignas(kCacheLine) std::atomic<std::uint64_t> head{ 0 };
+            std::uint64_t cachedTail = 0;
+            alignas(kCacheLine) std::atomic<std::uint64_t> tail{ 0 };
+            std::atomic<std::uint64_t> dropped{ 0 };
+            // Set when the thread exits; the writer frees the ring once drained.
+            std::atomic<bool> retired{ false };
+            std::vector<unsigned char> ring;
+            const std::size_t mask;
+            const std::uint32_t threadId;
+            // Producer only: records that wrap are encoded here, then copied in.
+            std::vector<unsigned char> scratch;
+
+            void copyIn(std::uint64_t pos, const void* src, std::size_t n) {
+                const std::size_t at = static_cast<std::size_t>(pos) & mask;
+                const std::size_t first = std::min(n, ring.size() - at);
+                std::memcpy(ring.data() + at, src, first);
+                std::memcpy(ring.data(), static_cast<const unsigned char*>(src) + first, n - first);
+            }
+
+            void copyOut(std::uint64_t pos, void* dst, std::size_t n) const {
+                const std::size_t at = static_cast<std::size_t>(pos) & mask;
+                const std::size_t first = std::min(n, ring.size() - at);
+                std::memcpy(dst, ring.data() + at, first);
+                std::memcpy(static_cast<unsigned char*>(dst) + first, ring.data(), n - first);
+            }
+        };
+
+        // Encodes a record into contiguous memory: the ring itself, or the
+        // thread's scratch when the record would wrap.
+        struct RecordWriter {
+            unsigned char* p;
+
+            void bytes(const void* src, std::size_t n) {
+                std::memcpy(p, src, n);
+                p += n;
+            }
+
+            template <typename T>
+            void value(T v) {
+                wire::store(p, v);
+                p += sizeof(T);
+            }
+
+            template <typename T>
+            void arg(const T& v) {
+                constexpr ArgTag tag = tagOf<T>();
+                value(static_cast<std::uint8_t>(tag));
+                if constexpr (tag == ArgTag::Bool) {
+                    value(static_cast<bool>(v));
+                } else if constexpr (tag == ArgTag::Char) {
+                    value(static_cast<std::uint8_t>(v));
+                } else if constexpr (tag == ArgTag::Int) {
+                    value(static_cast<std::int64_t>(v));
+                } else if constexpr (tag == ArgTag::UInt) {
+                    value(static_cast<std::uint64_t>(v));
+                } else if constexpr (tag == ArgTag::Double) {
+                    value(static_cast<double>(v));
+                } else if constexpr (tag == ArgTag::String) {
+                    const std::string_view s = asString(v);
+                    value(static_cast<std::uint32_t>(s.size()));
+                    bytes(s.data(), s.size());
+                } else {
+                    value(static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(v)));
+                }
+            }
+        };
+
+        inline void appendNumber(std::string& out, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+        inline void appendNumber(std::string& out, const char* format, ...) {
+            char text[64];
+            va_list args;
+            va_start(args, format);
+            const int n = std::vsnprintf(text, sizeof(text), format, args);
+            va_end(args);
+            if (n > 0) out.append(text, static_cast<std::size_t>(std::min<int>(n, sizeof(text) - 1)));
+        }
+
+        // Appends one encoded argument; false if it runs past end.
+        inline bool appendArg(std::string& out, const unsigned char*& p, const unsigned char* end) {
+            if (p >= end) return false;
+            const ArgTag tag = static_cast<ArgTag>(*p++);
+            const std::size_t left = static_cast<std::size_t>(end - p);
+            switch (tag) {
+                case ArgTag::Bool:
+                    if (left < 1) return false;
+                    out += *p++ ? "true" : "false";
+                    return true;
+                case ArgTag::Char:
+                    if (left < 1) return false;
+                    out += static_cast<char>(*p++);
+                    return true;
+                case ArgTag::Int:
+                case ArgTag::UInt:
+                case ArgTag::Double:
+                case ArgTag::Pointer:
+                    if (left < 8) return false;
+                    if (tag == ArgTag::Int) appendNumber(out, "%lld", static_cast<long long>(wire::load<std::int64_t>(p)));
+                    if (tag == ArgTag::UInt) appendNumber(out, "%llu", static_cast<unsigned long long>(wire::load<std::uint64_t>(p)));
+                    if (tag == ArgTag::Double) appendNumber(out, "%g", wire::load<double>(p));
+                    if (tag == ArgTag::Pointer) appendNumber(out, "0x%llx", static_cast<unsigned long long>(wire::load<std::uint64_t>(p)));
+                    p += 8;
+                    return true;
+                case ArgTag::String: {
+                    if (left < 4) return false;
+                    const std::uint32_t n = wire::load<std::uint32_t>(p);
+                    if (n > left - 4) return false;
+                    out.append(reinterpret_cast<const char*>(p + 4), n);
+                    p += 4 + n;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // "2026-10-16 07:05:01.123456 INFO  [t1] User.cpp:31 message\n"
+        inline void appendLine(std::string& out, std::int64_t ns, Level level, std::uint32_t thread, const char* file,
+                               std::uint32_t line, const char* format, const unsigned char* args, std::size_t argBytes) {
+            const std::time_t seconds = static_cast<std::time_t>(ns / 1000000000);
+            std::tm utc{};
+            gmtime_r(&seconds, &utc);
+            char stamp[32];
+            const std::size_t n = std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &utc);
+            out.append(stamp, n);
+            appendNumber(out, ".%06lld %-5s [t%u] ", static_cast<long long>(ns % 1000000000 / 1000), toString(level), thread);
+            const char* slash = std::strrchr(file, '/');
+            out += slash ? slash + 1 : file;
+            appendNumber(out, ":%u ", line);
+
+            const unsigned char* p = args;
+            const unsigned char* end = args + argBytes;
+            for (const char* f = format; *f; ++f) {
+                if (f[0] == '{' && f[1] == '}') {
+                    if (!appendArg(out, p, end)) out += "{?}";
+                    ++f;
+                } else {
+                    out += *f;
+                }
+            }
+            out += '\n';
+        }
+
+    }
+
+    class Logger {
+    public:
+        // The process-wide logger the HEXARCH_LOG macros write to.
+        static Logger& instance() {
+            static Logger logger;
+            return logger;
+        }
+
+        Logger(const Logger&) = delete;
+        Logger& operator=(const Logger&) = delete;
+
+        // Drains every ring and stops the writer.
+        ~Logger() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            if (writer.joinable()) writer.join();
+            if (out && out != stderr) std::fclose(out);
+        }
+
+        // Must run before the first record; the writer starts with it.
+        void configure(LogOptions newOptions) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (writer.joinable()) {
+                throw std::logic_error("Logger: configure() after the first record");
+            }
+            options = std::move(newOptions);
+        }
+
+        template <std::size_t Placeholders, typename... Args>
+        void write(const Site& site, const Args&... args) {
+            static_assert(Placeholders == sizeof...(Args), "HEXARCH_LOG: the format's {} count does not match the arguments");
+            detail::ThreadBuffer& buffer = local();
+            const std::size_t size = detail::kRecordHeader + (std::size_t(0) + ... + detail::argSize(args));
+            const std::uint64_t head = buffer.head.load(std::memory_order_relaxed);
+            if (head + size - buffer.cachedTail > buffer.ring.size()) {
+                buffer.cachedTail = buffer.tail.load(std::memory_order_acquire);
+                if (head + size - buffer.cachedTail > buffer.ring.size()) {
+                    buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+            }
+            const std::size_t at = static_cast<std::size_t>(head) & buffer.mask;
+            const bool wraps = at + size > buffer.ring.size();
+            if (wraps) buffer.scratch.resize(size);
+            detail::RecordWriter w{ wraps ? buffer.scratch.data() : buffer.ring.data() + at };
+            w.value(static_cast<std::uint32_t>(size));
+            w.value(static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(&site)));
+            w.value(detail::readClock());
+            (w.arg(args), ...);
+            if (wraps) buffer.copyIn(head, buffer.scratch.data(), size);
+            buffer.head.store(head + size, std::memory_order_release);
+        }
+
+        // Blocks until everything this thread logged so far is written.
+        void flush() {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!writer.joinable()) return;
+            const std::uint64_t ticket = ++flushRequested;
+            wake.notify_all();
+            flushed.wait(lock, [&] { return flushDone >= ticket || !writer.joinable(); });
+        }
+
+        LogStats stats() const {
+            std::lock_guard<std::mutex> lock(mutex);
+            LogStats out{ records, droppedRetired, buffers.size() };
+            for (const auto& b : buffers) out.dropped += b->dropped.load(std::memory_order_relaxed);
+            return out;
+        }
+
+    private:
+        Logger() = default;
+
+        // Registers the calling thread's ring on its first record.
+        struct ThreadSlot {
+            std::shared_ptr<detail::ThreadBuffer> buffer;
+            ~ThreadSlot() {
+                if (buffer) buffer->retired.store(true, std::memory_order_release);
+            }
+        };
+
+        detail::ThreadBuffer& local() {
+            thread_local ThreadSlot slot;
+            if (!slot.buffer) slot.buffer = attach();
+            return *slot.buffer;
+        }
+
+        std::shared_ptr<detail::ThreadBuffer> attach() {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!writer.joinable()) {
+                open();
+                writer = std::thread([this] { run(); });
+            }
+            auto buffer = std::make_shared<detail::ThreadBuffer>(options.threadBufferBytes, nextThreadId++);
+            buffers.push_back(buffer);
+            return buffer;
+        }
+
+        void open() {
+            clock.anchor();
+            out = stderr;
+            if (!options.path.empty()) {
+                out = std::fopen(options.path.c_str(), options.binary ? "wb" : "a");
+                if (!out) {
+                    out = stderr;
+                    std::fprintf(stderr, "Logger: cannot open %s, logging to stderr\n", options.path.c_str());
+                }
+            }
+            if (options.binary) {
+                pending.append(detail::kBinaryMagic, sizeof(detail::kBinaryMagic));
+                appendValue(detail::kBinaryVersion);
+            }
+        }
+
+        void run() {
+            std::unique_lock<std::mutex> lock(mutex);
+            for (;;) {
+                const bool last = stopping;
+                const std::uint64_t ticket = flushRequested;
+                std::vector<std::shared_ptr<detail::ThreadBuffer>> snapshot = buffers;
+                lock.unlock();
+
+                clock.refresh();
+                std::uint64_t written = 0;
+                for (const auto& buffer : snapshot) written += drain(*buffer);
+                if (!pending.empty()) {
+                    std::fwrite(pending.data(), 1, pending.size(), out);
+                    std::fflush(out);
+                    pending.clear();
+                }
+
+                lock.lock();
+                records += written;
+                for (auto it = buffers.begin(); it != buffers.end();) {
+                    detail::ThreadBuffer& b = **it;
+                    if (b.retired.load(std::memory_order_acquire)
+                        && b.tail.load(std::memory_order_relaxed) == b.head.load(std::memory_order_acquire)) {
+                        droppedRetired += b.dropped.load(std::memory_order_relaxed);
+                        it = buffers.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+                flushDone = ticket;
+                flushed.notify_all();
+                if (last) return;
+                wake.wait_for(lock, options.pollInterval, [&] { return stopping || flushRequested != ticket; });
+            }
+        }
+
+        std::uint64_t drain(detail::ThreadBuffer& buffer) {
+            std::uint64_t tail = buffer.tail.load(std::memory_order_relaxed);
+            const std::uint64_t head = buffer.head.load(std::memory_order_acquire);
+            std::uint64_t count = 0;
+            while (tail != head) {
+                unsigned char sizeBytes[4];
+                buffer.copyOut(tail, sizeBytes, sizeof(sizeBytes));
+                const std::uint32_t size = wire::load<std::uint32_t>(sizeBytes);
+                record.resize(size);
+                buffer.copyOut(tail, record.data(), size);
+                emit(buffer.threadId, record.data(), size);
+                tail += size;
+                ++count;
+                // Hand space back as we go so a busy thread is not starved.
+                if ((count & 63) == 0) buffer.tail.store(tail, std::memory_order_release);
+                if (pending.size() >= 1 << 16) {
+                    std::fwrite(pending.data(), 1, pending.size(), out);
+                    pending.clear();
+                }
+            }
+            buffer.tail.store(tail, std::memory_order_release);
+            return count;
+        }
+
+        void emit(std::uint32_t thread, const unsigned char* p, std::size_t size) {
+            const Site* site = reinterpret_cast<const Site*>(static_cast<std::uintptr_t>(wire::load<std::uint64_t>(p + 4)));
+            const std::int64_t ns = clock.toNs(wire::load<std::uint64_t>(p + 12));
+            const unsigned char* args = p + detail::kRecordHeader;
+            const std::size_t argBytes = size - detail::kRecordHeader;
+            if (!options.binary) {
+                detail::appendLine(pending, ns, site->level, thread, site->file, static_cast<std::uint32_t>(site->line),
+                                   site->format, args, argBytes);
+                return;
+            }
+            auto known = siteIds.find(site);
+            if (known == siteIds.end()) {
+                known = siteIds.emplace(site, static_cast<std::uint32_t>(siteIds.size())).first;
+                appendValue(std::uint8_t(1));
+                appendValue(known->second);
+                appendValue(static_cast<std::uint8_t>(site->level));
+                appendValue(static_cast<std::uint32_t>(site->line));
+                appendString(site->file);
+                appendString(site->format);
+            }
+            appendValue(std::uint8_t(2));
+            appendValue(known->second);
+            appendValue(ns);
+            appendValue(thread);
+            appendValue(static_cast<std::uint32_t>(argBytes));
+            pending.append(reinterpret_cast<const char*>(args), argBytes);
+        }
+
+        template <typename T>
+        void appendValue(T v) {
+            unsigned char raw[sizeof(T)];
+            wire::store(raw, v);
+            pending.append(reinterpret_cast<const char*>(raw), sizeof(T));
+        }
+
+        void appendString(std::string_view s) {
+            appendValue(static_cast<std::uint32_t>(s.size()));
+            pending.append(s.data(), s.size());
+        }
+
+        LogOptions options;
+        mutable std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable flushed;
+        std::vector<std::shared_ptr<detail::ThreadBuffer>> buffers;
+        std::uint32_t nextThreadId = 1;
+        std::uint64_t flushRequested = 0;
+        std::uint64_t flushDone = 0;
+        std::uint64_t records = 0;
+        std::uint64_t droppedRetired = 0;
+        bool stopping = false;
+        std::thread writer;
+
+        // Writer thread only.
+        std::FILE* out = nullptr;
+        detail::ClockMap clock;
+        std::string pending;
+        std::vector<unsigned char> record;
+        std::unordered_map<const Site*, std::uint32_t> siteIds;
+    };
+
+    // Offline decoder for LogOptions::binary files: writes the text the logger
+    // would have written. Returns false on a foreign or truncated file.
+    inline bool decodeBinary(std::FILE* in, std::FILE* out) {
+        struct DecodedSite {
+            Level level;
+            std::uint32_t line;
+            std::string file;
+            std::string format;
+        };
+        std::vector<DecodedSite> sites;
+        std::vector<unsigned char> bytes;
+        std::string text;
+
+        auto read = [&](std::size_t n) {
+            bytes.resize(n);
+            return n == 0 || std::fread(bytes.data(), 1, n, in) == n;
+        };
+        auto readU32 = [&](std::uint32_t& v) {
+            if (!read(4)) return false;
+            v = wire::load<std::uint32_t>(bytes.data());
+            return true;
+        };
+        auto readString = [&](std::string& s) {
+            std::uint32_t n = 0;
+            if (!readU32(n) || !read(n)) return false;
+            s.assign(reinterpret_cast<const char*>(bytes.data()), n);
+            return true;
+        };
+
+        if (!read(6) || std::memcmp(bytes.data(), detail::kBinaryMagic, 4) != 0
+            || wire::load<std::uint16_t>(bytes.data() + 4) != detail::kBinaryVersion) {
+            return false;
+        }
+        for (;;) {
+            unsigned char type = 0;
+            if (std::fread(&type, 1, 1, in) != 1) return true;
+            if (type == 1) {
+                DecodedSite site;
+                std::uint32_t id = 0;
+                if (!readU32(id) || !read(1)) return false;
+                site.level = static_cast<Level>(bytes[0]);
+                if (!readU32(site.line) || !readString(site.file) || !readString(site.format) || id != sites.size()) return false;
+                sites.push_back(std::move(site));
+            } else if (type == 2) {
+                std::uint32_t id = 0;
+                std::uint32_t thread = 0;
+                std::uint32_t argBytes = 0;
+                if (!readU32(id) || !read(8)) return false;
+                const std::int64_t ns = wire::load<std::int64_t>(bytes.data());
+                if (!readU32(thread) || !readU32(argBytes) || id >= sites.size() || !read(argBytes)) return false;
+                const DecodedSite& site = sites[id];
+                text.clear();
+                detail::appendLine(text, ns, site.level, thread, site.file.c_str(), site.line, site.format.c_str(),
+                                   bytes.data(), bytes.size());
+                std::fwrite(text.data(), 1, text.size(), out);
+            } else {
+                return false;
+            }
+        }
+    }
+
+    inline void configure(LogOptions options) { Logger::instance().configure(std::move(options)); }
+    inline void flush() { Logger::instance().flush(); }
+    inline LogStats stats() { return Logger::instance().stats(); }
+
+} // namespace log
+} // namespace utils
+} // namespace hexarch
@@ -0,0 +1,379 @@
+#pragma once
+
+#include "utils/LzBlock.hpp"
+#include "utils/WireCodec.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace hexarch {
+namespace utils {
+
+    // Batching, asynchronous producer for outgoing middleware adapters.
+    //
+    // send() appends an encoded record to the open batch of its partition and
+    // returns. A batch is sealed once it reaches batchBytes or has been open for
+    // linger; a background sender compresses sealed batches and hands them to a
+    // BatchTransport, keeping at most maxInFlight unacknowledged. Each record's
+    // callback runs once its batch is acknowledged (or fails), on the thread the
+    // transport completes on. send() blocks while bufferBytes are unacknowledged.
+
+    enum class Compression : std::uint8_t { None = 0, Lz = 1 };
+
+    struct ProducerConfig {
+        std::string topic;
+        std::uint32_t partitions = 1;
+        std::size_t batchBytes = 64 * 1024;
+        std::chrono::microseconds linger{ 5000 };
+        std::size_t maxInFlight = 5;
+        std::size_t bufferBytes = 32 * 1024 * 1024;
+        Compression compression = Compression::Lz;
+    };
+
+    struct DeliveryReport {
+        bool delivered;
+        std::uint32_t partition;
+        // Broker-assigned offset of the record; meaningful only when delivered.
+        std::uint64_t offset;
+    };
+
+    using DeliveryCallback = std::function<void(const DeliveryReport&)>;
+
+    // One sealed, encoded batch as it goes on the wire:
+    //   +0  uint16  magic "XB"
+    //   +2  uint8   format version
+    //   +3  uint8   Compression
+    //   +4  uint32  record count
+    //   +8  uint32  uncompressed record bytes
+    //   +12 uint32  stored record bytes
+    //   +16 records: uint16 key length, key, uint32 value length, value
+    struct RecordBatch {
+        std::string topic;
+        std::uint32_t partition = 0;
+        std::uint32_t records = 0;
+        std::vector<unsigned char> bytes;
+    };
+
+    namespace batch {
+
+        constexpr std::uint16_t kMagic = 0x4258;
+        constexpr std::uint8_t kVersion = 1;
+        constexpr std::size_t kHeaderSize = 16;
+        constexpr std::size_t kRecordOverhead = 6;
+
+        inline void appendRecord(std::vector<unsigned char>& raw, std::string_view key, const unsigned char* value, std::size_t size) {
+            if (key.size() > 0xffff || size > 0xffffffffu) {
+                throw std::length_error("BatchProducer: record key or value too large");
+            }
+            const std::size_t at = raw.size();
+            raw.resize(at + kRecordOverhead + key.size() + size);
+            unsigned char* p = raw.data() + at;
+            wire::store(p, static_cast<std::uint16_t>(key.size()));
+            if (!key.empty()) {
+                std::memcpy(p + 2, key.data(), key.size());
+            }
+            wire::store(p + 2 + key.size(), static_cast<std::uint32_t>(size));
+            if (size) {
+                std::memcpy(p + kRecordOverhead + key.size(), value, size);
+            }
+        }
+
+        // Header plus raw records, compressed when that actually saves space.
+        inline std::vector<unsigned char> seal(const std::vector<unsigned char>& raw, std::uint32_t records, Compression compression) {
+            std::vector<unsigned char> out(kHeaderSize + (compression == Compression::Lz ? lz::maxCompressedSize(raw.size()) : raw.size()));
+            std::size_t stored = raw.size();
+            if (compression == Compression::Lz) {
+                stored = lz::compress(raw.data(), raw.size(), out.data() + kHeaderSize);
+                if (stored >= raw.size()) {
+                    compression = Compression::None;
+                    stored = raw.size();
+                }
+            }
+            if (compression == Compression::None && stored) {
+                std::memcpy(out.data() + kHeaderSize, raw.data(), stored);
+            }
+            out.resize(kHeaderSize + stored);
+            wire::store(out.data(), kMagic);
+            wire::store(out.data() + 2, kVersion);
+            wire::store(out.data() + 3, static_cast<std::uint8_t>(compression));
+            wire::store(out.data() + 4, records);
+            wire::store(out.data() + 8, static_cast<std::uint32_t>(raw.size()));
+            wire::store(out.data() + 12, static_cast<std::uint32_t>(stored));
+            return out;
+        }
+
+        // Calls visit(key, value, valueSize) per record. scratch holds the
+        // decompressed records, so the views are valid until it is reused.
+        // Returns false on any malformed or truncated input.
+        template <typename Visit>
+        bool decode(const unsigned char* data, std::size_t size, std::vector<unsigned char>& scratch, Visit&& visit) {
+            if (size < kHeaderSize || wire::load<std::uint16_t>(data) != kMagic || data[2] != kVersion) {
+                return false;
+            }
+            const std::uint8_t compression = data[3];
+            const std::uint32_t records = wire::load<std::uint32_t>(data + 4);
+            const std::size_t rawSize = wire::load<std::uint32_t>(data + 8);
+            const std::size_t stored = wire::load<std::uint32_t>(data + 12);
+            if (size - kHeaderSize < stored) {
+                return false;
+            }
+
+            const unsigned char* raw = data + kHeaderSize;
+            if (compression == static_cast<std::uint8_t>(Compression::Lz)) {
+                scratch.resize(rawSize);
+                if (!lz::decompress(raw, stored, scratch.data(), rawSize)) return false;
+                raw = scratch.data();
+            } else if (compression != static_cast<std::uint8_t>(Compression::None) || stored != rawSize) {
+                return false;
+            }
+
+            std::size_t at = 0;
+            for (std::uint32_t r = 0; r < records; ++r) {
+                if (rawSize - at < kRecordOverhead) return false;
+                const std::size_t keySize = wire::load<std::uint16_t>(raw + at);
+                if (rawSize - at - kRecordOverhead < keySize) return false;
+                const std::size_t valueSize = wire::load<std::uint32_t>(raw + at + 2 + keySize);
+                const std::size_t body = at + kRecordOverhead + keySize;
+                if (rawSize - body < valueSize) return false;
+                visit(std::string_view(reinterpret_cast<const char*>(raw + at + 2), keySize), raw + body, valueSize);
+                at = body + valueSize;
+            }
+            return at == rawSize;
+        }
+
+    }
+
+    // The middleware client behind the producer. sendBatch() must call done
+    // exactly once, from any thread and possibly before returning, with the
+    // offset the broker assigned to the batch's first record.
+    class BatchTransport {
+    public:
+        using Completion = std::function<void(bool ok, std::uint64_t baseOffset)>;
+
+        virtual ~BatchTransport() = default;
+        virtual void sendBatch(RecordBatch batch, Completion done) = 0;
+    };
+
+    struct ProducerStats {
+        std::uint64_t delivered;
+        std::uint64_t failed;
+        std::uint64_t batches;
+        std::uint64_t rawBytes;
+        std::uint64_t wireBytes;
+        std::size_t inFlight;
+        std::size_t bufferedBytes;
+    };
+
+    class BatchProducer {
+    public:
+        BatchProducer(BatchTransport& transport, ProducerConfig config)
+            : transport(transport), config(std::move(config)) {
+            if (this->config.partitions == 0 || this->config.maxInFlight == 0) {
+                throw std::invalid_argument("BatchProducer: partitions and maxInFlight must be positive");
+            }
+            open.resize(this->config.partitions);
+            sender = std::thread([this] { run(); });
+        }
+
+        // Delivers everything accepted so far, then stops the sender.
+        ~BatchProducer() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            sender.join();
+        }
+
+        BatchProducer(const BatchProducer&) = delete;
+        BatchProducer& operator=(const BatchProducer&) = delete;
+
+        const ProducerConfig& getConfig() const { return config; }
+
+        // Records with the same non-empty key go to the same partition, in send
+        // order. Keyless records fill one partition's batch at a time.
+        void send(std::string_view key, const unsigned char* value, std::size_t size, DeliveryCallback callback = {}) {
+            const std::size_t recordBytes = batch::kRecordOverhead + key.size() + size;
+            std::unique_lock<std::mutex> lock(mutex);
+            if (stopping) {
+                throw std::logic_error("BatchProducer: send() after shutdown");
+            }
+            drained.wait(lock, [&] { return bufferedBytes == 0 || bufferedBytes + recordBytes <= config.bufferBytes; });
+
+            const std::uint32_t partition = key.empty() ? stickyPartition : partitionFor(key);
+            Pending& pending = open[partition];
+            const bool opened = pending.records == 0;
+            if (opened) {
+                pending.partition = partition;
+                pending.opened = Clock::now();
+            }
+            batch::appendRecord(pending.raw, key, value, size);
+            pending.callbacks.push_back(std::move(callback));
+            ++pending.records;
+            bufferedBytes += recordBytes;
+            ++unacknowledged;
+
+            if (pending.raw.size() >= config.batchBytes) {
+                sealLocked(partition);
+                lock.unlock();
+                wake.notify_one();
+            } else if (opened) {
+                lock.unlock();
+                wake.notify_one();
+            }
+        }
+
+        void send(std::string_view key, const std::vector<unsigned char>& value, DeliveryCallback callback = {}) {
+            send(key, value.data(), value.size(), std::move(callback));
+        }
+
+        // Seals every open batch and waits until each record sent so far has
+        // a delivery report.
+        void flush() {
+            std::unique_lock<std::mutex> lock(mutex);
+            ++flushers;
+            wake.notify_one();
+            drained.wait(lock, [&] { return unacknowledged == 0; });
+            --flushers;
+        }
+
+        ProducerStats stats() const {
+            std::lock_guard<std::mutex> lock(mutex);
+            return { delivered, failed, batches, rawBytes, wireBytes, inFlight, bufferedBytes };
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Pending {
+            std::uint32_t partition = 0;
+            std::uint32_t records = 0;
+            Clock::time_point opened;
+            std::vector<unsigned char> raw;
+            std::vector<DeliveryCallback> callbacks;
+        };
+
+        std::uint32_t partitionFor(std::string_view key) const {
+            // FNV-1a: stable across runs and platforms, unlike std::hash.
+            std::uint32_t h = 0x811c9dc5u;
+            for (unsigned char c : key) {
+                h = (h ^ c) * 0x01000193u;
+            }
+            return h % config.partitions;
+        }
+
+        void sealLocked(std::uint32_t partition) {
+            Pending& pending = open[partition];
+            ready.push_back(std::make_shared<Pending>(std::move(pending)));
+            pending = Pending();
+            if (partition == stickyPartition) {
+                stickyPartition = (stickyPartition + 1) % config.partitions;
+            }
+        }
+
+        void run() {
+            std::unique_lock<std::mutex> lock(mutex);
+            for (;;) {
+                const Clock::time_point now = Clock::now();
+                Clock::time_point deadline = Clock::time_point::max();
+                for (std::uint32_t p = 0; p < config.partitions; ++p) {
+                    if (open[p].records == 0) continue;
+                    const Clock::time_point due = open[p].opened + config.linger;
+                    if (due <= now || flushers > 0 || stopping) {
+                        sealLocked(p);
+                    } else if (due < deadline) {
+                        deadline = due;
+                    }
+                }
+
+                while (!ready.empty() && inFlight < config.maxInFlight) {
+                    std::shared_ptr<Pending> pending = std::move(ready.front());
+                    ready.pop_front();
+                    ++inFlight;
+                    lock.unlock();
+                    dispatch(std::move(pending));
+                    lock.lock();
+                }
+
+                if (stopping && ready.empty() && inFlight == 0 && unacknowledged == 0) {
+                    return;
+                }
+                if (!ready.empty() || deadline == Clock::time_point::max()) {
+                    // Waiting for an acknowledgement, a new batch or a flush.
+                    wake.wait(lock);
+                } else {
+                    wake.wait_until(lock, deadline);
+                }
+            }
+        }
+
+        void dispatch(std::shared_ptr<Pending> pending) {
+            RecordBatch out;
+            out.topic = config.topic;
+            out.partition = pending->partition;
+            out.records = pending->records;
+            out.bytes = batch::seal(pending->raw, pending->records, config.compression);
+            const std::size_t wireSize = out.bytes.size();
+            transport.sendBatch(std::move(out), [this, pending, wireSize](bool ok, std::uint64_t baseOffset) {
+                complete(*pending, wireSize, ok, baseOffset);
+            });
+        }
+
+        void complete(Pending& pending, std::size_t wireSize, bool ok, std::uint64_t baseOffset) {
+            for (std::size_t i = 0; i < pending.callbacks.size(); ++i) {
+                if (pending.callbacks[i]) {
+                    pending.callbacks[i](DeliveryReport{ ok, pending.partition, baseOffset + i });
+                }
+            }
+            // Notify under the lock: once it is released the destructor may run.
+            std::lock_guard<std::mutex> lock(mutex);
+            --inFlight;
+            bufferedBytes -= pending.raw.size();
+            unacknowledged -= pending.records;
+            (ok ? delivered : failed) += pending.records;
+            ++batches;
+            rawBytes += pending.raw.size();
+            wireBytes += wireSize;
+            wake.notify_one();
+            drained.notify_all();
+        }
+
+        BatchTransport& transport;
+        const ProducerConfig config;
+
+        mutable std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable drained;
+        std::vector<Pending> open;
+        std::deque<std::shared_ptr<Pending>> ready;
+        std::uint32_t stickyPartition = 0;
+        std::size_t inFlight = 0;
+        std::size_t bufferedBytes = 0;
+        std::uint64_t unacknowledged = 0;
+        std::size_t flushers = 0;
+        bool stopping = false;
+
+        std::uint64_t delivered = 0;
+        std::uint64_t failed = 0;
+        std::uint64_t batches = 0;
+        std::uint64_t rawBytes = 0;
+        std::uint64_t wireBytes = 0;
+
+        std::thread sender;
+    };
+
+} // namespace utils
+} // namespace hexarch
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace hexarch {
+namespace utils {
+
+    // Packed bit vector for boolean columns and row selections. Bit i lives in
+    // word i / 64 at position i % 64; bits past size() are always zero, so word
+    // loops (count, and, or) need no tail handling.
+    class Bitmap {
+    public:
+        Bitmap() = default;
+        explicit Bitmap(std::size_t bits, bool value = false) { resize(bits, value); }
+
+        // Moves leave the source empty, size() included.
+        Bitmap(const Bitmap&) = default;
+        Bitmap& operator=(const Bitmap&) = default;
+        Bitmap(Bitmap&& other) noexcept : words(std::move(other.words)), bits(std::exchange(other.bits, 0)) {}
+        Bitmap& operator=(Bitmap&& other) noexcept {
+            if (this != &other) {
+                words = std::move(other.words);
+                bits = std::exchange(other.bits, 0);
+            }
+            return *this;
+        }
+
+        std::size_t size() const { return bits; }
+        bool empty() const { return bits == 0; }
+        std::size_t wordCount() const { return words.size(); }
+
+        std::uint64_t* data() { return words.data(); }
+        const std::uint64_t* data() const { return words.data(); }
+
+        bool test(std::size_t i) const { return (words[i >> 6] >> (i & 63)) & 1u; }
+
+        void set(std::size_t i, bool value = true) {
+            const std::uint64_t bit = std::uint64_t(1) << (i & 63);
+            if (value) {
+                words[i >> 6] |= bit;
+            } else {
+                words[i >> 6] &= ~bit;
+            }
+        }
+
+        void pushBack(bool value) {
+            if ((bits & 63) == 0) {
+                words.push_back(0);
+            }
+            ++bits;
+            set(bits - 1, value);
+        }
+
+        void resize(std::size_t n, bool value = false) {
+            const std::size_t old = bits;
+            words.resize((n + 63) / 64, 0);
+            bits = n;
+            if (value) {
+                for (std::size_t i = old; i < n; ++i) set(i);
+            }
+            clearTail();
+        }
+
+        void reserve(std::size_t n) { words.reserve((n + 63) / 64); }
+
+        void clear() {
+            words.clear();
+            bits = 0;
+        }
+
+        std::size_t count() const {
+            std::size_t total = 0;
+            for (std::uint64_t w : words) {
+                total += static_cast<std::size_t>(__builtin_popcountll(w));
+            }
+            return total;
+        }
+
+        Bitmap& operator&=(const Bitmap& other) {
+            requireSameSize(other);
+            for (std::size_t i = 0; i < words.size(); ++i) words[i] &= other.words[i];
+            return *this;
+        }
+
+        Bitmap& operator|=(const Bitmap& other) {
+            requireSameSize(other);
+            for (std::size_t i = 0; i < words.size(); ++i) words[i] |= other.words[i];
+            return *this;
+        }
+
+        Bitmap& flip() {
+            for (std::uint64_t& w : words) w = ~w;
+            clearTail();
+            return *this;
+        }
+
+        // Calls fn(i) for every set bit, in increasing order.
+        template <typename Fn>
+        void forEachSet(Fn&& fn) const {
+            for (std::size_t w = 0; w < words.size(); ++w) {
+                std::uint64_t word = words[w];
+                while (word) {
+                    fn(w * 64 + static_cast<std::size_t>(__builtin_ctzll(word)));
+                    word &= word - 1;
+                }
+            }
+        }
+
+        // Restores the zero-tail invariant after writing whole words through data().
+        void clearTail() {
+            if (bits & 63) {
+                words.back() &= (std::uint64_t(1) << (bits & 63)) - 1;
+            }
+        }
+
+        friend bool operator==(const Bitmap& a, const Bitmap& b) { return a.bits == b.bits && a.words == b.words; }
+        friend bool operator!=(const Bitmap& a, const Bitmap& b) { return !(a == b); }
+
+    private:
+        void requireSameSize(const Bitmap& other) const {
+            if (other.bits != bits) {
+                throw std::invalid_argument("Bitmap: size mismatch");
+            }
+        }
+
+        std::vector<std::uint64_t> words;
+        std::size_t bits = 0;
+    };
+
+} // namespace utils
+} // namespace hexarch
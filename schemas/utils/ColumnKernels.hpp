@@ -0,0 +1,278 @@
+#pragma once
+
+#include "utils/SimdDot.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace hexarch {
+namespace utils {
+
+    // Aggregation and filter kernels over one contiguous column, for the
+    // columnar batch models. Loads are unaligned, so any vector's data() works;
+    // columns are assumed NaN-free. Selections are packed bitmaps (Bitmap::data()):
+    // bit i of word i / 64 selects row i, and filters write every word covering n.
+    struct ColumnKernelSet {
+        double (*sumF64)(const double* v, std::size_t n);
+        double (*minF64)(const double* v, std::size_t n);
+        double (*maxF64)(const double* v, std::size_t n);
+        std::int64_t (*sumI32)(const std::int32_t* v, std::size_t n);
+        std::int32_t (*minI32)(const std::int32_t* v, std::size_t n);
+        std::int32_t (*maxI32)(const std::int32_t* v, std::size_t n);
+        // Sets bit i when lo <= v[i] < hi, clears it otherwise.
+        void (*filterRangeF64)(const double* v, std::size_t n, double lo, double hi, std::uint64_t* bits);
+        // Sum of v[i] over the selected rows.
+        double (*sumSelectedF64)(const double* v, std::size_t n, const std::uint64_t* bits);
+    };
+
+    namespace detail {
+
+        inline double columnSumScalar(const double* v, std::size_t n) {
+            double acc[4] = { 0.0, 0.0, 0.0, 0.0 };
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4) {
+                for (std::size_t k = 0; k < 4; ++k) acc[k] += v[i + k];
+            }
+            for (; i < n; ++i) acc[0] += v[i];
+            return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+        }
+
+        inline double columnMinScalar(const double* v, std::size_t n) {
+            double m = std::numeric_limits<double>::infinity();
+            for (std::size_t i = 0; i < n; ++i) m = v[i] < m ? v[i] : m;
+            return m;
+        }
+
+        inline double columnMaxScalar(const double* v, std::size_t n) {
+            double m = -std::numeric_limits<double>::infinity();
+            for (std::size_t i = 0; i < n; ++i) m = v[i] > m ? v[i] : m;
+            return m;
+        }
+
+        inline std::int64_t columnSumScalar(const std::int32_t* v, std::size_t n) {
+            std::int64_t acc = 0;
+            for (std::size_t i = 0; i < n; ++i) acc += v[i];
+            return acc;
+        }
+
+        inline std::int32_t columnMinScalar(const std::int32_t* v, std::size_t n) {
+            std::int32_t m = std::numeric_limits<std::int32_t>::max();
+            for (std::size_t i = 0; i < n; ++i) m = v[i] < m ? v[i] : m;
+            return m;
+        }
+
+        inline std::int32_t columnMaxScalar(const std::int32_t* v, std::size_t n) {
+            std::int32_t m = std::numeric_limits<std::int32_t>::min();
+            for (std::size_t i = 0; i < n; ++i) m = v[i] > m ? v[i] : m;
+            return m;
+        }
+
+        inline void columnFilterScalar(const double* v, std::size_t n, double lo, double hi, std::uint64_t* bits) {
+            for (std::size_t w = 0; w * 64 < n; ++w) {
+                const std::size_t end = n - w * 64 < 64 ? n - w * 64 : 64;
+                std::uint64_t word = 0;
+                for (std::size_t b = 0; b < end; ++b) {
+                    const double x = v[w * 64 + b];
+                    word |= std::uint64_t(x >= lo && x < hi) << b;
+                }
+                bits[w] = word;
+            }
+        }
+
+        inline double columnSumSelectedScalar(const double* v, std::size_t n, const std::uint64_t* bits) {
+            double acc = 0.0;
+            for (std::size_t w = 0; w * 64 < n; ++w) {
+                std::uint64_t word = bits[w];
+                while (word) {
+                    acc += v[w * 64 + static_cast<std::size_t>(__builtin_ctzll(word))];
+                    word &= word - 1;
+                }
+            }
+            return acc;
+        }
+
+#ifdef HEXARCH_X86_KERNELS
+
+        __attribute__((target("avx2")))
+        inline double hmin(__m256d v) {
+            __m128d lo = _mm_min_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+            return _mm_cvtsd_f64(_mm_min_sd(lo, _mm_unpackhi_pd(lo, lo)));
+        }
+
+        __attribute__((target("avx2")))
+        inline double hmax(__m256d v) {
+            __m128d lo = _mm_max_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+            return _mm_cvtsd_f64(_mm_max_sd(lo, _mm_unpackhi_pd(lo, lo)));
+        }
+
+        __attribute__((target("avx2,fma")))
+        inline double columnSumAvx2(const double* v, std::size_t n) {
+            __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+            __m256d a2 = _mm256_setzero_pd(), a3 = _mm256_setzero_pd();
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                a0 = _mm256_add_pd(a0, _mm256_loadu_pd(v + i));
+                a1 = _mm256_add_pd(a1, _mm256_loadu_pd(v + i + 4));
+                a2 = _mm256_add_pd(a2, _mm256_loadu_pd(v + i + 8));
+                a3 = _mm256_add_pd(a3, _mm256_loadu_pd(v + i + 12));
+            }
+            for (; i + 4 <= n; i += 4) a0 = _mm256_add_pd(a0, _mm256_loadu_pd(v + i));
+            double acc = hsum(_mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3)));
+            for (; i < n; ++i) acc += v[i];
+            return acc;
+        }
+
+        __attribute__((target("avx2")))
+        inline double columnMinAvx2(const double* v, std::size_t n) {
+            __m256d a0 = _mm256_set1_pd(std::numeric_limits<double>::infinity()), a1 = a0;
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                a0 = _mm256_min_pd(a0, _mm256_loadu_pd(v + i));
+                a1 = _mm256_min_pd(a1, _mm256_loadu_pd(v + i + 4));
+            }
+            double m = hmin(_mm256_min_pd(a0, a1));
+            for (; i < n; ++i) m = v[i] < m ? v[i] : m;
+            return m;
+        }
+
+        __attribute__((target("avx2")))
+        inline double columnMaxAvx2(const double* v, std::size_t n) {
+            __m256d a0 = _mm256_set1_pd(-std::numeric_limits<double>::infinity()), a1 = a0;
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                a0 = _mm256_max_pd(a0, _mm256_loadu_pd(v + i));
+                a1 = _mm256_max_pd(a1, _mm256_loadu_pd(v + i + 4));
+            }
+            double m = hmax(_mm256_max_pd(a0, a1));
+            for (; i < n; ++i) m = v[i] > m ? v[i] : m;
+            return m;
+        }
+
+        // Widens to 64-bit lanes so the sum cannot overflow.
+        __attribute__((target("avx2")))
+        inline std::int64_t columnSumAvx2(const std::int32_t* v, std::size_t n) {
+            __m256i a0 = _mm256_setzero_si256(), a1 = _mm256_setzero_si256();
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + i));
+                a0 = _mm256_add_epi64(a0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(x)));
+                a1 = _mm256_add_epi64(a1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1)));
+            }
+            alignas(32) std::int64_t lanes[4];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi64(a0, a1));
+            std::int64_t acc = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+            for (; i < n; ++i) acc += v[i];
+            return acc;
+        }
+
+        __attribute__((target("avx2")))
+        inline std::int32_t columnMinAvx2(const std::int32_t* v, std::size_t n) {
+            __m256i a = _mm256_set1_epi32(std::numeric_limits<std::int32_t>::max());
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                a = _mm256_min_epi32(a, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + i)));
+            }
+            alignas(32) std::int32_t lanes[8];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), a);
+            std::int32_t m = columnMinScalar(lanes, 8);
+            for (; i < n; ++i) m = v[i] < m ? v[i] : m;
+            return m;
+        }
+
+        __attribute__((target("avx2")))
+        inline std::int32_t columnMaxAvx2(const std::int32_t* v, std::size_t n) {
+            __m256i a = _mm256_set1_epi32(std::numeric_limits<std::int32_t>::min());
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                a = _mm256_max_epi32(a, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + i)));
+            }
+            alignas(32) std::int32_t lanes[8];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), a);
+            std::int32_t m = columnMaxScalar(lanes, 8);
+            for (; i < n; ++i) m = v[i] > m ? v[i] : m;
+            return m;
+        }
+
+        // Four rows per compare; movemask yields their bits, sixteen groups per word.
+        __attribute__((target("avx2")))
+        inline void columnFilterAvx2(const double* v, std::size_t n, double lo, double hi, std::uint64_t* bits) {
+            const __m256d vlo = _mm256_set1_pd(lo);
+            const __m256d vhi = _mm256_set1_pd(hi);
+            std::size_t w = 0;
+            for (; (w + 1) * 64 <= n; ++w) {
+                const double* base = v + w * 64;
+                std::uint64_t word = 0;
+                for (std::size_t g = 0; g < 16; ++g) {
+                    const __m256d x = _mm256_loadu_pd(base + g * 4);
+                    const __m256d in = _mm256_and_pd(_mm256_cmp_pd(x, vlo, _CMP_GE_OQ), _mm256_cmp_pd(x, vhi, _CMP_LT_OQ));
+                    word |= static_cast<std::uint64_t>(_mm256_movemask_pd(in)) << (g * 4);
+                }
+                bits[w] = word;
+            }
+            if (w * 64 < n) {
+                columnFilterScalar(v + w * 64, n - w * 64, lo, hi, bits + w);
+            }
+        }
+
+        // Expands each nibble of the selection into a lane mask and adds under it;
+        // all-zero and all-one words take the cheap paths.
+        __attribute__((target("avx2,fma")))
+        inline double columnSumSelectedAvx2(const double* v, std::size_t n, const std::uint64_t* bits) {
+            const __m256i lane = _mm256_setr_epi64x(1, 2, 4, 8);
+            __m256d acc = _mm256_setzero_pd();
+            std::size_t w = 0;
+            for (; (w + 1) * 64 <= n; ++w) {
+                const std::uint64_t word = bits[w];
+                if (word == 0) {
+                    continue;
+                }
+                const double* base = v + w * 64;
+                if (word == ~std::uint64_t(0)) {
+                    for (std::size_t g = 0; g < 16; ++g) acc = _mm256_add_pd(acc, _mm256_loadu_pd(base + g * 4));
+                    continue;
+                }
+                for (std::size_t g = 0; g < 16; ++g) {
+                    const long long nibble = static_cast<long long>((word >> (g * 4)) & 0xF);
+                    const __m256i mask = _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_set1_epi64x(nibble), lane), lane);
+                    acc = _mm256_add_pd(acc, _mm256_and_pd(_mm256_loadu_pd(base + g * 4), _mm256_castsi256_pd(mask)));
+                }
+            }
+            double sum = hsum(acc);
+            if (w * 64 < n) {
+                sum += columnSumSelectedScalar(v + w * 64, n - w * 64, bits + w);
+            }
+            return sum;
+        }
+
+#endif
+
+    }
+
+    // Always the portable kernels; for benchmarks and cross-checking.
+    inline const ColumnKernelSet& scalarColumnKernels() {
+        static const ColumnKernelSet scalar = {
+            &detail::columnSumScalar, &detail::columnMinScalar, &detail::columnMaxScalar,
+            &detail::columnSumScalar, &detail::columnMinScalar, &detail::columnMaxScalar,
+            &detail::columnFilterScalar, &detail::columnSumSelectedScalar,
+        };
+        return scalar;
+    }
+
+    // The best kernel set this CPU supports, chosen on first use.
+    inline const ColumnKernelSet& columnKernels() {
+#ifdef HEXARCH_X86_KERNELS
+        static const ColumnKernelSet avx2 = {
+            &detail::columnSumAvx2, &detail::columnMinAvx2, &detail::columnMaxAvx2,
+            &detail::columnSumAvx2, &detail::columnMinAvx2, &detail::columnMaxAvx2,
+            &detail::columnFilterAvx2, &detail::columnSumSelectedAvx2,
+        };
+        static const ColumnKernelSet& best = dotKernelSupported(DotKernel::Avx2) ? avx2 : scalarColumnKernels();
+        return best;
+#else
+        return scalarColumnKernels();
+#endif
+    }
+
+} // namespace utils
+} // namespace hexarch
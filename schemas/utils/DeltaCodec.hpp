@@ -0,0 +1,365 @@
+#pragma once
+
+#include "utils/Bitmap.hpp"
+#include "utils/WireCodec.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace hexarch {
+namespace utils {
+
+    // Fields changed since the last clear(), one bit per enumerator of Field
+    // (an enum class whose last enumerator is Count). A new object starts with
+    // every field dirty, so its first delta carries the whole object.
+    template <typename Field>
+    class DirtyFields {
+    public:
+        static constexpr std::size_t kFieldCount = static_cast<std::size_t>(Field::Count);
+        static_assert(kFieldCount > 0 && kFieldCount <= 64, "DirtyFields: 1 to 64 fields");
+        static constexpr std::uint64_t kAll = kFieldCount == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << kFieldCount) - 1;
+
+        void mark(Field field) { bits |= bit(field); }
+        bool test(Field field) const { return (bits & bit(field)) != 0; }
+        bool any() const { return bits != 0; }
+        std::uint64_t mask() const { return bits; }
+        void clear() { bits = 0; }
+        void markAll() { bits = kAll; }
+        // Marks the fields of a delta record; false if it names fields this type lacks.
+        bool markMask(std::uint64_t mask) {
+            if (mask & ~kAll) return false;
+            bits |= mask;
+            return true;
+        }
+        static bool validMask(std::uint64_t mask) { return (mask & ~kAll) == 0; }
+
+    private:
+        static std::uint64_t bit(Field field) { return std::uint64_t(1) << static_cast<unsigned>(field); }
+
+        std::uint64_t bits = kAll;
+    };
+
+    // Changed rows of one grid field. "All" stands for a replaced or reshaped
+    // grid, which is sent whole; otherwise only the marked rows are sent.
+    // Rows are the innermost dimension (a z run of a Grid3D, a Grid2D row).
+    class DirtyRows {
+    public:
+        bool all() const { return whole; }
+        bool any() const { return whole || rows.count() != 0; }
+
+        void markAll() {
+            whole = true;
+            rows.clear();
+        }
+
+        void clear() {
+            whole = false;
+            rows.clear();
+        }
+
+        // rowCount is the grid's current row count; a grown grid keeps its marks.
+        void mark(std::size_t row, std::size_t rowCount) {
+            if (whole) return;
+            if (rows.size() > rowCount) {
+                markAll();
+                return;
+            }
+            rows.resize(rowCount);
+            rows.set(row);
+        }
+
+        // Marks the rows that differ between two grids of the same shape.
+        template <typename T>
+        void markChanged(const T* before, const T* after, std::size_t rowCount, std::size_t rowWidth) {
+            for (std::size_t r = 0; r < rowCount && !whole; ++r) {
+                if (!std::equal(before + r * rowWidth, before + (r + 1) * rowWidth, after + r * rowWidth)) {
+                    mark(r, rowCount);
+                }
+            }
+        }
+
+        // The rows to send, or nullptr to send the grid whole.
+        const Bitmap* selection(std::size_t rowCount) const {
+            return whole || rows.size() != rowCount ? nullptr : &rows;
+        }
+
+    private:
+        bool whole = true;
+        Bitmap rows;
+    };
+
+namespace delta {
+
+    // Field-level patch records for the sample models' encodeDelta/applyDelta.
+    // All values are little-endian:
+    //   +0  uint16  magic "HD"
+    //   +2  uint64  field mask (bit i = field i)
+    // then every field in the mask, in bit order:
+    //   arithmetic  its wire representation (bool as one byte)
+    //   string      uint32 length, bytes
+    //   array       uint32 count, elements
+    //   grid        uint8 kind, uint8 rank, rank x uint32 dims, then
+    //                 Full: every cell
+    //                 Rows: uint32 n, then n x (uint32 row index, one row of cells)
+    // A record only makes sense against the state the previous record left
+    // behind; after a lost record the sender must markAllDirty() and resend.
+
+    constexpr std::uint16_t kMagic = 0x4448;
+    constexpr std::size_t kHeaderSize = 10;
+    constexpr std::size_t kMaxRank = 4;
+
+    enum class GridKind : std::uint8_t { Full = 0, Rows = 1 };
+
+    namespace detail {
+
+        template <typename T>
+        inline void storeCells(unsigned char* p, const T* cells, std::size_t n) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            if constexpr (!std::is_same<T, bool>::value) {
+                std::memcpy(p, cells, n * sizeof(T));
+                return;
+            }
+#endif
+            for (std::size_t i = 0; i < n; ++i) wire::store(p + i * sizeof(T), cells[i]);
+        }
+
+        template <typename T>
+        inline void loadCells(T* cells, const unsigned char* p, std::size_t n) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            if constexpr (!std::is_same<T, bool>::value) {
+                std::memcpy(cells, p, n * sizeof(T));
+                return;
+            }
+#endif
+            for (std::size_t i = 0; i < n; ++i) cells[i] = wire::load<T>(p + i * sizeof(T));
+        }
+
+    }
+
+    class Writer {
+    public:
+        // Replaces the contents of out with a record header for mask.
+        Writer(std::vector<unsigned char>& out, std::uint64_t mask) : out(out) {
+            out.clear();
+            value(kMagic);
+            value(mask);
+        }
+
+        template <typename T>
+        void value(T v) {
+            const std::size_t at = grow(sizeof(T));
+            wire::store(out.data() + at, v);
+        }
+
+        void string(std::string_view s) {
+            value(static_cast<std::uint32_t>(s.size()));
+            const std::size_t at = grow(s.size());
+            if (!s.empty()) std::memcpy(out.data() + at, s.data(), s.size());
+        }
+
+        template <typename T>
+        void cells(const T* p, std::size_t n) {
+            const std::size_t at = grow(n * sizeof(T));
+            if (n) detail::storeCells(out.data() + at, p, n);
+        }
+
+        template <typename T>
+        void array(const T* p, std::size_t n) {
+            value(static_cast<std::uint32_t>(n));
+            cells(p, n);
+        }
+
+        // A row-major grid of the given dims; a row is dims.back() cells. Only
+        // the rows in dirtyRows are written, unless it is null or more than
+        // half of them are dirty, where the whole grid is cheaper.
+        template <typename T>
+        void grid(std::initializer_list<std::size_t> dims, const T* p, const Bitmap* dirtyRows) {
+            std::size_t total = 1;
+            for (std::size_t d : dims) total *= d;
+            const std::size_t width = dims.size() ? *(dims.end() - 1) : 0;
+            const std::size_t rowCount = width ? total / width : 0;
+            const std::size_t dirty = dirtyRows && dirtyRows->size() == rowCount ? dirtyRows->count() : rowCount;
+            const bool byRows = rowCount > 0 && dirty * 2 <= rowCount;
+
+            value(static_cast<std::uint8_t>(byRows ? GridKind::Rows : GridKind::Full));
+            value(static_cast<std::uint8_t>(dims.size()));
+            for (std::size_t d : dims) value(static_cast<std::uint32_t>(d));
+            if (!byRows) {
+                cells(p, total);
+                return;
+            }
+            value(static_cast<std::uint32_t>(dirty));
+            out.reserve(out.size() + dirty * (4 + width * sizeof(T)));
+            dirtyRows->forEachSet([&](std::size_t r) {
+                value(static_cast<std::uint32_t>(r));
+                cells(p + r * width, width);
+            });
+        }
+
+    private:
+        std::size_t grow(std::size_t n) {
+            const std::size_t at = out.size();
+            out.resize(at + n);
+            return at;
+        }
+
+        std::vector<unsigned char>& out;
+    };
+
+    // A validated grid field, applied once the whole record has parsed.
+    template <typename T>
+    struct GridPatch {
+        GridKind kind = GridKind::Full;
+        std::size_t rank = 0;
+        std::size_t dims[kMaxRank] = {};
+        std::size_t rowCount = 0;
+        std::size_t rowWidth = 0;
+        // Rows in the patch (every row for Full).
+        std::size_t patchedRows = 0;
+        const unsigned char* body = nullptr;
+
+        std::size_t cellCount() const { return rowCount * rowWidth; }
+
+        // Writes the patched cells into a grid of exactly dims.
+        void applyTo(T* cells) const {
+            if (kind == GridKind::Full) {
+                if (cellCount()) detail::loadCells(cells, body, cellCount());
+                return;
+            }
+            forEachRow([&](std::size_t r, const unsigned char* p) { detail::loadCells(cells + r * rowWidth, p, rowWidth); });
+        }
+
+        // fn(row index, encoded cells) for every row in the patch.
+        template <typename Fn>
+        void forEachRow(Fn&& fn) const {
+            const std::size_t rowBytes = rowWidth * sizeof(T);
+            if (kind == GridKind::Full) {
+                for (std::size_t r = 0; r < rowCount; ++r) fn(r, body + r * rowBytes);
+                return;
+            }
+            const unsigned char* p = body;
+            for (std::size_t i = 0; i < patchedRows; ++i, p += 4 + rowBytes) {
+                fn(static_cast<std::size_t>(wire::load<std::uint32_t>(p)), p + 4);
+            }
+        }
+    };
+
+    // Bounds-checked cursor over a record. Every read returns false once the
+    // record is found malformed, and stays false.
+    class Reader {
+    public:
+        Reader(const unsigned char* data, std::size_t size) : p(data), end(data + size) {
+            std::uint16_t magic = 0;
+            good = value(magic) && magic == kMagic && value(fieldMask);
+        }
+
+        bool ok() const { return good; }
+        std::uint64_t mask() const { return fieldMask; }
+        template <typename Field>
+        bool has(Field field) const { return (fieldMask >> static_cast<unsigned>(field)) & 1u; }
+        // The record parsed and nothing trails it.
+        bool finished() const { return good && p == end; }
+
+        template <typename T>
+        bool value(T& v) {
+            if (!take(sizeof(T))) return false;
+            v = wire::load<T>(p - sizeof(T));
+            return true;
+        }
+
+        // The view points into the record buffer.
+        bool string(std::string_view& s) {
+            std::uint32_t n = 0;
+            if (!value(n) || !take(n)) return false;
+            s = std::string_view(reinterpret_cast<const char*>(p - n), n);
+            return true;
+        }
+
+        template <typename T>
+        bool cells(T* out, std::size_t n) {
+            if (!fits(n, sizeof(T)) || !take(n * sizeof(T))) return false;
+            if (n) detail::loadCells(out, p - n * sizeof(T), n);
+            return true;
+        }
+
+        template <typename T, typename Alloc>
+        bool array(std::vector<T, Alloc>& out) {
+            std::uint32_t n = 0;
+            if (!value(n) || !fits(n, sizeof(T))) return false;
+            out.resize(n);
+            return cells(out.data(), n);
+        }
+
+        template <typename T>
+        bool grid(GridPatch<T>& patch, std::size_t rank) {
+            std::uint8_t kind = 0;
+            std::uint8_t wireRank = 0;
+            if (!value(kind) || !value(wireRank) || wireRank != rank || rank == 0 || rank > kMaxRank
+                || kind > static_cast<std::uint8_t>(GridKind::Rows)) {
+                return fail();
+            }
+            patch.kind = static_cast<GridKind>(kind);
+            patch.rank = rank;
+            std::size_t total = 1;
+            for (std::size_t i = 0; i < rank; ++i) {
+                std::uint32_t d = 0;
+                if (!value(d)) return false;
+                patch.dims[i] = d;
+                if (d && total > std::numeric_limits<std::size_t>::max() / d) return fail();
+                total *= d;
+            }
+            patch.rowWidth = patch.dims[rank - 1];
+            patch.rowCount = patch.rowWidth ? total / patch.rowWidth : 0;
+            const std::size_t rowBytes = patch.rowWidth * sizeof(T);
+
+            if (patch.kind == GridKind::Full) {
+                if (!fits(total, sizeof(T))) return fail();
+                patch.patchedRows = patch.rowCount;
+                patch.body = p;
+                return take(total * sizeof(T));
+            }
+            std::uint32_t n = 0;
+            if (!value(n) || n > patch.rowCount || !fits(n, 4 + rowBytes)) return fail();
+            patch.patchedRows = n;
+            patch.body = p;
+            if (!take(n * (4 + rowBytes))) return false;
+            // Indices strictly increase, so every row appears at most once.
+            std::size_t next = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                const std::size_t row = wire::load<std::uint32_t>(patch.body + i * (4 + rowBytes));
+                if (row < next || row >= patch.rowCount) return fail();
+                next = row + 1;
+            }
+            return true;
+        }
+
+    private:
+        // n * size stays inside the rest of the record (and does not overflow).
+        bool fits(std::size_t n, std::size_t size) const {
+            return size == 0 || n <= static_cast<std::size_t>(end - p) / size;
+        }
+
+        bool take(std::size_t n) {
+            if (!good || n > static_cast<std::size_t>(end - p)) return fail();
+            p += n;
+            return true;
+        }
+
+        bool fail() { return good = false; }
+
+        const unsigned char* p;
+        const unsigned char* end;
+        std::uint64_t fieldMask = 0;
+        bool good = true;
+    };
+
+} // namespace delta
+} // namespace utils
+} // namespace hexarch
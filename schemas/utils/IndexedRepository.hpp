@@ -0,0 +1,444 @@
+#pragma once
+
+#include "utils/Bitmap.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hexarch {
+namespace utils {
+
+    using RowId = std::uint32_t;
+
+    namespace detail {
+
+        // String-like keys are indexed and looked up as string_view, so an index
+        // over a std::pmr::string field accepts "literal", std::string and views
+        // without building a temporary string.
+        template <typename K>
+        auto indexKey(const K& key) {
+            if constexpr (std::is_convertible<const K&, std::string_view>::value) {
+                return std::string_view(key);
+            } else {
+                return key;
+            }
+        }
+
+        template <typename T, typename Extract>
+        using ExtractResult = decltype(std::declval<Extract&>()(std::declval<const T&>()));
+
+        template <typename T, typename Extract>
+        using IndexKeyOf = std::decay_t<decltype(indexKey(std::declval<ExtractResult<T, Extract>>()))>;
+
+        // True when Extract returns an owning string by value (a getter that
+        // builds a std::string). A view of it dies with the full expression, so
+        // such keys are only compared within one, or stored as std::string.
+        template <typename T, typename Extract>
+        constexpr bool kReturnsOwnedString = !std::is_reference<ExtractResult<T, Extract>>::value
+            && std::is_convertible<ExtractResult<T, Extract>, std::string_view>::value
+            && !std::is_same<std::decay_t<ExtractResult<T, Extract>>, std::string_view>::value
+            && !std::is_pointer<std::decay_t<ExtractResult<T, Extract>>>::value;
+
+        // What an index keeps per row: the key itself, except that an owned
+        // string is stored as std::string instead of a dangling view.
+        template <typename T, typename Extract>
+        using StoredKeyOf = std::conditional_t<kReturnsOwnedString<T, Extract>, std::string, IndexKeyOf<T, Extract>>;
+
+        // std::hash is the identity for integers; the finaliser spreads ids over
+        // the low bits that pick the slot.
+        template <typename K>
+        std::uint64_t indexHash(const K& key) {
+            std::uint64_t h = static_cast<std::uint64_t>(std::hash<K>()(key));
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdull;
+            h ^= h >> 33;
+            return h;
+        }
+
+        // What the repository needs from every index to keep it in step with the rows.
+        template <typename T>
+        class RepositoryIndex {
+        public:
+            virtual ~RepositoryIndex() = default;
+            virtual void insert(RowId id, const T& row) = 0;
+            virtual void erase(RowId id, const T& row) = 0;
+            // True when row, stored as id, would break a uniqueness constraint.
+            virtual bool conflicts(RowId id, const T& row) const { (void)id; (void)row; return false; }
+
+            void attach(const std::deque<T>* store) { rows = store; }
+
+        protected:
+            const std::deque<T>* rows = nullptr;
+        };
+
+    }
+
+    // Open-addressing (linear probing) hash index over one key field. Slots hold
+    // the row id and the key hash only; keys are re-read from the row on a hash
+    // match, so string keys are never copied. Deletion shifts the probe run back
+    // instead of leaving tombstones. unique indexes reject duplicate keys.
+    template <typename T, typename Extract>
+    class HashIndex final : public detail::RepositoryIndex<T> {
+    public:
+        using Key = detail::IndexKeyOf<T, Extract>;
+
+        HashIndex(Extract extract, bool unique) : extract(std::move(extract)), unique(unique), slots(16) {}
+
+        bool isUnique() const { return unique; }
+
+        // Calls fn(id) for every row whose key equals key.
+        template <typename Fn>
+        std::size_t forEachMatch(const Key& key, Fn&& fn) const {
+            const std::uint64_t h = detail::indexHash(key);
+            std::size_t found = 0;
+            for (std::size_t i = h & mask(); slots[i].row != kEmpty; i = (i + 1) & mask()) {
+                if (slots[i].hash == h && keyEquals(slots[i].row, key)) {
+                    fn(slots[i].row);
+                    ++found;
+                    if (unique) break;
+                }
+            }
+            return found;
+        }
+
+        void insert(RowId id, const T& row) override {
+            if ((used + 1) * 2 > slots.size()) {
+                grow();
+            }
+            place({ detail::indexHash(detail::indexKey(extract(row))), id });
+            ++used;
+        }
+
+        void erase(RowId id, const T& row) override {
+            const std::uint64_t h = detail::indexHash(detail::indexKey(extract(row)));
+            std::size_t i = h & mask();
+            while (slots[i].row != id) {
+                if (slots[i].row == kEmpty) return;
+                i = (i + 1) & mask();
+            }
+            for (std::size_t j = (i + 1) & mask(); slots[j].row != kEmpty; j = (j + 1) & mask()) {
+                const std::size_t home = slots[j].hash & mask();
+                const bool stays = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+                if (!stays) {
+                    slots[i] = slots[j];
+                    i = j;
+                }
+            }
+            slots[i].row = kEmpty;
+            --used;
+        }
+
+        bool conflicts(RowId id, const T& row) const override {
+            if (!unique) return false;
+            bool clash = false;
+            forEachMatch(detail::indexKey(extract(row)), [&](RowId other) { clash = clash || other != id; });
+            return clash;
+        }
+
+    private:
+        static constexpr RowId kEmpty = ~RowId(0);
+
+        struct Slot {
+            std::uint64_t hash = 0;
+            RowId row = kEmpty;
+        };
+
+        std::size_t mask() const { return slots.size() - 1; }
+
+        // One full expression, so a key extract() returns by value is still
+        // alive while it is compared.
+        bool keyEquals(RowId id, const Key& key) const { return detail::indexKey(extract((*this->rows)[id])) == key; }
+
+        void place(Slot slot) {
+            std::size_t i = slot.hash & mask();
+            while (slots[i].row != kEmpty) i = (i + 1) & mask();
+            slots[i] = slot;
+        }
+
+        void grow() {
+            std::vector<Slot> old(slots.size() * 2);
+            old.swap(slots);
+            for (const Slot& slot : old) {
+                if (slot.row != kEmpty) place(slot);
+            }
+        }
+
+        Extract extract;
+        const bool unique;
+        std::vector<Slot> slots;
+        std::size_t used = 0;
+    };
+
+    // Ordered index over a numeric field for range queries; a balanced tree of
+    // (key, row) pairs, so inserts, erases and range starts are O(log n).
+    template <typename T, typename Extract>
+    class OrderedIndex final : public detail::RepositoryIndex<T> {
+    public:
+        using Key = detail::StoredKeyOf<T, Extract>;
+
+        explicit OrderedIndex(Extract extract) : extract(std::move(extract)) {}
+
+        // Calls fn(id) for rows with lo <= key < hi, in key order.
+        template <typename Fn>
+        std::size_t forEachInRange(const Key& lo, const Key& hi, Fn&& fn) const {
+            std::size_t found = 0;
+            for (auto it = entries.lower_bound({ lo, RowId(0) }); it != entries.end() && it->first < hi; ++it) {
+                fn(it->second);
+                ++found;
+            }
+            return found;
+        }
+
+        void insert(RowId id, const T& row) override { entries.emplace(Key(detail::indexKey(extract(row))), id); }
+        void erase(RowId id, const T& row) override { entries.erase({ Key(detail::indexKey(extract(row))), id }); }
+
+    private:
+        Extract extract;
+        std::set<std::pair<Key, RowId>> entries;
+    };
+
+    // One bit per row for a boolean predicate (isPaid, inStock, !isPaid ...).
+    template <typename T, typename Pred>
+    class BitmapIndex final : public detail::RepositoryIndex<T> {
+    public:
+        explicit BitmapIndex(Pred pred) : pred(std::move(pred)) {}
+
+        const Bitmap& bits() const { return flags; }
+
+        void insert(RowId id, const T& row) override {
+            if (id >= flags.size()) flags.resize(id + 1);
+            flags.set(id, pred(row));
+        }
+
+        void erase(RowId id, const T& row) override {
+            (void)row;
+            flags.set(id, false);
+        }
+
+    private:
+        Pred pred;
+        Bitmap flags;
+    };
+
+    // In-memory table of T with secondary indexes, for repositories behind
+    // outgoing ports. Register indexes with addHashIndex / addOrderedIndex /
+    // addBitmapIndex (they index existing rows immediately), then query through
+    // the repository:
+    //   IndexedRepository<model::Customer> customers;
+    //   const auto& byEmail = customers.addHashIndex([](const model::Customer& c) { return c.getEmail(); });
+    //   customers.insert(model::Customer(7, "Ada", "Lovelace", "ada@example.com", 36));
+    //   std::optional<model::Customer> ada = customers.findOne(byEmail, "ada@example.com");
+    //   customers.modify(byEmail, "ada@example.com", [](model::Customer& c) { c.setEmail("ada@lovelace.org"); });
+    //
+    // Rows change only through insert / modify / erase, which re-index them, so
+    // setters called inside modify() keep every index current. Readers share a
+    // lock and may run concurrently; writers are exclusive. Visitors passed to
+    // read / find / range / forEach run under the shared lock and must not call
+    // back into the repository's writers.
+    template <typename T>
+    class IndexedRepository {
+    public:
+        IndexedRepository() = default;
+        IndexedRepository(const IndexedRepository&) = delete;
+        IndexedRepository& operator=(const IndexedRepository&) = delete;
+
+        // Extract returns the key (or a reference to it) for a row.
+        template <typename Extract>
+        const HashIndex<T, Extract>& addHashIndex(Extract extract, bool unique = true) {
+            return addIndex(std::make_unique<HashIndex<T, Extract>>(std::move(extract), unique));
+        }
+
+        template <typename Extract>
+        const OrderedIndex<T, Extract>& addOrderedIndex(Extract extract) {
+            return addIndex(std::make_unique<OrderedIndex<T, Extract>>(std::move(extract)));
+        }
+
+        template <typename Pred>
+        const BitmapIndex<T, Pred>& addBitmapIndex(Pred pred) {
+            return addIndex(std::make_unique<BitmapIndex<T, Pred>>(std::move(pred)));
+        }
+
+        // Throws std::invalid_argument when a unique index already has the key.
+        RowId insert(T row) {
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            const RowId id = freeRows.empty() ? static_cast<RowId>(rows.size()) : freeRows.back();
+            for (const auto& index : indexes) {
+                if (index->conflicts(id, row)) {
+                    throw std::invalid_argument("IndexedRepository: duplicate key");
+                }
+            }
+            if (freeRows.empty()) {
+                rows.push_back(std::move(row));
+                live.pushBack(true);
+            } else {
+                freeRows.pop_back();
+                rows[id] = std::move(row);
+                live.set(id);
+            }
+            for (const auto& index : indexes) index->insert(id, rows[id]);
+            ++liveCount;
+            return id;
+        }
+
+        // Applies fn(T&) to a copy of the row and swaps it in only if no unique
+        // index would conflict; on a conflict the row is left untouched and
+        // std::invalid_argument is thrown. Returns false for an unknown id.
+        template <typename Fn>
+        bool modify(RowId id, Fn&& fn) {
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            return modifyLocked(id, fn);
+        }
+
+        // modify() for the first row whose key in index equals key.
+        template <typename Index, typename K, typename Fn>
+        bool modify(const Index& index, const K& key, Fn&& fn) {
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            std::optional<RowId> id = firstMatch(index, key);
+            return id && modifyLocked(*id, fn);
+        }
+
+        bool erase(RowId id) {
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            if (!isLive(id)) return false;
+            for (const auto& index : indexes) index->erase(id, rows[id]);
+            live.set(id, false);
+            freeRows.push_back(id);
+            --liveCount;
+            return true;
+        }
+
+        std::size_t size() const {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            return liveCount;
+        }
+
+        // Calls fn(const T&) if id is a live row.
+        template <typename Fn>
+        bool read(RowId id, Fn&& fn) const {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            if (!isLive(id)) return false;
+            fn(rows[id]);
+            return true;
+        }
+
+        std::optional<T> get(RowId id) const {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            return isLive(id) ? std::optional<T>(rows[id]) : std::nullopt;
+        }
+
+        // Calls fn(RowId, const T&) for every row whose key in index equals key.
+        template <typename Extract, typename K, typename Fn>
+        std::size_t find(const HashIndex<T, Extract>& index, const K& key, Fn&& fn) const {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            return index.forEachMatch(detail::indexKey(key), [&](RowId id) { fn(id, rows[id]); });
+        }
+
+        template <typename Extract, typename K>
+        std::optional<T> findOne(const HashIndex<T, Extract>& index, const K& key) const {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            std::optional<RowId> id = firstMatch(index, key);
+            return id ? std::optional<T>(rows[*id]) : std::nullopt;
+        }
+
+        // Calls fn(RowId, const T&) for rows with lo <= key < hi, in key order.
+        template <typename Extract, typename Fn>
+        std::size_t range(const OrderedIndex<T, Extract>& index, const typename OrderedIndex<T, Extract>::Key& lo,
+                          const typename OrderedIndex<T, Extract>::Key& hi, Fn&& fn) const {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            return index.forEachInRange(lo, hi, [&](RowId id) { fn(id, rows[id]); });
+        }
+
+        // Calls fn(RowId, const T&) for every row the predicate holds for.
+        template <typename Pred, typename Fn>
+        std::size_t forEach(const BitmapIndex<T, Pred>& index, Fn&& fn) const {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            std::size_t found = 0;
+            index.bits().forEachSet([&](std::size_t id) {
+                fn(static_cast<RowId>(id), rows[id]);
+                ++found;
+            });
+            return found;
+        }
+
+        template <typename Pred>
+        std::size_t count(const BitmapIndex<T, Pred>& index) const {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            return index.bits().count();
+        }
+
+        // Copy of the predicate's bits, sized to every row slot, for combining
+        // several flags with & and | before visiting rows.
+        template <typename Pred>
+        Bitmap selection(const BitmapIndex<T, Pred>& index) const {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            Bitmap bits = index.bits();
+            bits.resize(rows.size());
+            return bits;
+        }
+
+    private:
+        template <typename Index>
+        const Index& addIndex(std::unique_ptr<Index> index) {
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            index->attach(&rows);
+            live.forEachSet([&](std::size_t id) {
+                if (index->conflicts(static_cast<RowId>(id), rows[id])) {
+                    throw std::invalid_argument("IndexedRepository: existing rows have duplicate keys");
+                }
+                index->insert(static_cast<RowId>(id), rows[id]);
+            });
+            const Index& ref = *index;
+            indexes.push_back(std::move(index));
+            return ref;
+        }
+
+        bool isLive(RowId id) const { return id < rows.size() && live.test(id); }
+
+        template <typename Index, typename K>
+        std::optional<RowId> firstMatch(const Index& index, const K& key) const {
+            std::optional<RowId> first;
+            index.forEachMatch(detail::indexKey(key), [&](RowId id) {
+                if (!first) first = id;
+            });
+            return first;
+        }
+
+        template <typename Fn>
+        bool modifyLocked(RowId id, Fn& fn) {
+            if (!isLive(id)) return false;
+            T next(rows[id]);
+            fn(next);
+            for (const auto& index : indexes) {
+                if (index->conflicts(id, next)) {
+                    throw std::invalid_argument("IndexedRepository: duplicate key");
+                }
+            }
+            for (const auto& index : indexes) index->erase(id, rows[id]);
+            rows[id] = std::move(next);
+            for (const auto& index : indexes) index->insert(id, rows[id]);
+            return true;
+        }
+
+        mutable std::shared_mutex mutex;
+        std::deque<T> rows;
+        Bitmap live;
+        std::vector<RowId> freeRows;
+        std::size_t liveCount = 0;
+        std::vector<std::unique_ptr<detail::RepositoryIndex<T>>> indexes;
+    };
+
+} // namespace utils
+} // namespace hexarch
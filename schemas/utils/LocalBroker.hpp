@@ -0,0 +1,237 @@
+#pragma once
+
+#include "utils/BatchProducer.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace hexarch {
+namespace utils {
+
+    // In-process stand-in for a broker, so outgoing adapters and BatchProducer
+    // can be exercised without a cluster.
+    //
+    // Batches are acknowledged in arrival order, each ackDelay after it arrived,
+    // from a broker thread: pipelined like a real round trip, so maxInFlight
+    // matters. Accepted records are kept per topic/partition and readable with
+    // fetch(). With a directory set, every batch is also appended to
+    // <directory>/<topic>-<partition>.log and replayed by the next LocalBroker
+    // opened on that directory.
+
+    struct LocalBrokerOptions {
+        std::chrono::microseconds ackDelay{ 0 };
+        std::string directory;
+        // Keep decoded records for fetch(); benchmarks can switch this off.
+        bool retainRecords = true;
+    };
+
+    struct StoredRecord {
+        std::uint64_t offset;
+        std::string key;
+        std::vector<unsigned char> value;
+    };
+
+    class LocalBroker : public BatchTransport {
+    public:
+        explicit LocalBroker(LocalBrokerOptions options = LocalBrokerOptions())
+            : options(std::move(options)) {
+            loadDirectory();
+            worker = std::thread([this] { run(); });
+        }
+
+        ~LocalBroker() override {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            worker.join();
+        }
+
+        LocalBroker(const LocalBroker&) = delete;
+        LocalBroker& operator=(const LocalBroker&) = delete;
+
+        void sendBatch(RecordBatch batch, Completion done) override {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                queue.push_back({ Clock::now() + options.ackDelay, std::move(batch), std::move(done) });
+            }
+            wake.notify_one();
+        }
+
+        // Up to maxRecords records of topic/partition starting at offset.
+        std::vector<StoredRecord> fetch(const std::string& topic, std::uint32_t partition,
+                                        std::uint64_t offset, std::size_t maxRecords) const {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::vector<StoredRecord> out;
+            const auto it = logs.find({ topic, partition });
+            if (it == logs.end()) {
+                return out;
+            }
+            const std::vector<StoredRecord>& records = it->second.records;
+            std::size_t i = offset > it->second.firstRetained ? static_cast<std::size_t>(offset - it->second.firstRetained) : 0;
+            for (; i < records.size() && out.size() < maxRecords; ++i) {
+                out.push_back(records[i]);
+            }
+            return out;
+        }
+
+        // Offset the next accepted record of topic/partition will get.
+        std::uint64_t endOffset(const std::string& topic, std::uint32_t partition) const {
+            std::lock_guard<std::mutex> lock(mutex);
+            const auto it = logs.find({ topic, partition });
+            return it == logs.end() ? 0 : it->second.nextOffset;
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+        using LogKey = std::pair<std::string, std::uint32_t>;
+
+        struct Queued {
+            Clock::time_point due;
+            RecordBatch batch;
+            Completion done;
+        };
+
+        struct Log {
+            std::uint64_t nextOffset = 0;
+            std::uint64_t firstRetained = 0;
+            std::vector<StoredRecord> records;
+        };
+
+        void run() {
+            std::unique_lock<std::mutex> lock(mutex);
+            std::vector<unsigned char> scratch;
+            for (;;) {
+                if (queue.empty()) {
+                    if (stopping) return;
+                    wake.wait(lock);
+                    continue;
+                }
+                if (Clock::now() < queue.front().due) {
+                    wake.wait_until(lock, queue.front().due);
+                    continue;
+                }
+                Queued item = std::move(queue.front());
+                queue.pop_front();
+
+                std::uint64_t baseOffset = 0;
+                const bool ok = append(item.batch, scratch, baseOffset);
+                lock.unlock();
+                item.done(ok, baseOffset);
+                lock.lock();
+            }
+        }
+
+        // Called with the mutex held.
+        bool append(const RecordBatch& batch, std::vector<unsigned char>& scratch, std::uint64_t& baseOffset) {
+            Log& log = logs[{ batch.topic, batch.partition }];
+            std::vector<StoredRecord> decoded;
+            const bool valid = batch::decode(batch.bytes.data(), batch.bytes.size(), scratch,
+                [&](std::string_view key, const unsigned char* value, std::size_t size) {
+                    decoded.push_back({ 0, std::string(key), std::vector<unsigned char>(value, value + size) });
+                });
+            if (!valid || decoded.size() != batch.records) {
+                return false;
+            }
+            if (!options.directory.empty()) {
+                std::ofstream file(pathFor(batch.topic, batch.partition), std::ios::binary | std::ios::app);
+                unsigned char size[4];
+                wire::store(size, static_cast<std::uint32_t>(batch.bytes.size()));
+                file.write(reinterpret_cast<const char*>(size), sizeof(size));
+                file.write(reinterpret_cast<const char*>(batch.bytes.data()), static_cast<std::streamsize>(batch.bytes.size()));
+                if (!file) {
+                    return false;
+                }
+            }
+            baseOffset = log.nextOffset;
+            retain(log, decoded);
+            return true;
+        }
+
+        void retain(Log& log, std::vector<StoredRecord>& decoded) {
+            for (StoredRecord& record : decoded) {
+                record.offset = log.nextOffset++;
+                if (options.retainRecords) {
+                    log.records.push_back(std::move(record));
+                }
+            }
+            if (!options.retainRecords) {
+                log.firstRetained = log.nextOffset;
+            }
+        }
+
+        std::string pathFor(const std::string& topic, std::uint32_t partition) const {
+            return options.directory + "/" + topic + "-" + std::to_string(partition) + ".log";
+        }
+
+        // Replays every <topic>-<partition>.log already in the directory.
+        void loadDirectory() {
+            namespace fs = std::filesystem;
+            if (options.directory.empty()) {
+                return;
+            }
+            fs::create_directories(options.directory);
+            std::vector<unsigned char> bytes;
+            std::vector<unsigned char> scratch;
+            for (const fs::directory_entry& entry : fs::directory_iterator(options.directory)) {
+                const std::string name = entry.path().filename().string();
+                const std::size_t dash = name.rfind('-');
+                if (!entry.is_regular_file() || entry.path().extension() != ".log" || dash == std::string::npos) {
+                    continue;
+                }
+                // Not ours unless the part after the dash is a partition number
+                const std::string_view number = std::string_view(name).substr(dash + 1, name.size() - dash - 1 - 4);
+                std::uint32_t partition = 0;
+                const auto parsed = std::from_chars(number.data(), number.data() + number.size(), partition);
+                if (number.empty() || parsed.ec != std::errc() || parsed.ptr != number.data() + number.size()) {
+                    continue;
+                }
+                const std::string topic = name.substr(0, dash);
+                Log& log = logs[{ topic, partition }];
+
+                std::ifstream file(entry.path(), std::ios::binary);
+                unsigned char size[4];
+                while (file.read(reinterpret_cast<char*>(size), sizeof(size))) {
+                    bytes.resize(wire::load<std::uint32_t>(size));
+                    // A torn final write is dropped, as a broker truncates its log on recovery.
+                    if (!file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) {
+                        break;
+                    }
+                    std::vector<StoredRecord> decoded;
+                    const bool valid = batch::decode(bytes.data(), bytes.size(), scratch,
+                        [&](std::string_view key, const unsigned char* value, std::size_t n) {
+                            decoded.push_back({ 0, std::string(key), std::vector<unsigned char>(value, value + n) });
+                        });
+                    if (!valid) {
+                        throw std::runtime_error("LocalBroker: corrupt log " + entry.path().string());
+                    }
+                    retain(log, decoded);
+                }
+            }
+        }
+
+        const LocalBrokerOptions options;
+        mutable std::mutex mutex;
+        std::condition_variable wake;
+        std::deque<Queued> queue;
+        std::map<LogKey, Log> logs;
+        bool stopping = false;
+        std::thread worker;
+    };
+
+} // namespace utils
+} // namespace hexarch
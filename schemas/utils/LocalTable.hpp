@@ -0,0 +1,144 @@
+#pragma once
+
+#include "utils/WireCodec.hpp"
+#include "utils/WriteBehindCache.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace hexarch {
+namespace utils {
+
+    // File-backed stand-in for the ${DB} table behind a persistence adapter, so
+    // WriteBehindCache and the generated adapters can be exercised without a
+    // database server.
+    //
+    // Every write is one "statement": it sleeps roundTrip (the network and
+    // commit cost a real round trip pays), then appends all its rows to
+    // <path> in one write. Rows are u32 key length, key, u32 value length,
+    // value; opening a table replays the file, the last row per key winning.
+
+    struct LocalTableOptions {
+        // Empty keeps the table in memory only.
+        std::string path;
+        std::chrono::microseconds roundTrip{ 0 };
+        // Fail the next n statements, for exercising retries.
+        std::size_t failStatements = 0;
+    };
+
+    class LocalTable : public WriteBehindSink<std::string, std::string> {
+    public:
+        explicit LocalTable(LocalTableOptions options = LocalTableOptions()) : options(std::move(options)) {
+            replay();
+        }
+
+        LocalTable(const LocalTable&) = delete;
+        LocalTable& operator=(const LocalTable&) = delete;
+
+        void writeBatch(Span<const std::pair<std::string, std::string>> rows) override {
+            if (options.roundTrip.count() > 0) {
+                std::this_thread::sleep_for(options.roundTrip);
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            ++statementCount;
+            if (options.failStatements > 0) {
+                --options.failStatements;
+                throw std::runtime_error("LocalTable: statement failed");
+            }
+            if (!options.path.empty()) {
+                std::string buffer;
+                for (const auto& row : rows) {
+                    appendField(buffer, row.first);
+                    appendField(buffer, row.second);
+                }
+                std::ofstream file(options.path, std::ios::binary | std::ios::app);
+                file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                if (!file) {
+                    throw std::runtime_error("LocalTable: cannot append to " + options.path);
+                }
+            }
+            for (const auto& row : rows) {
+                table[row.first] = row.second;
+            }
+            rowCount += rows.size();
+        }
+
+        // One synchronous single-row statement: what an adapter without a cache does per write.
+        void write(const std::string& key, const std::string& value) {
+            const std::pair<std::string, std::string> row(key, value);
+            writeBatch(Span<const std::pair<std::string, std::string>>(&row, 1));
+        }
+
+        std::optional<std::string> load(const std::string& key) override {
+            if (options.roundTrip.count() > 0) {
+                std::this_thread::sleep_for(options.roundTrip);
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            const auto it = table.find(key);
+            return it == table.end() ? std::nullopt : std::optional<std::string>(it->second);
+        }
+
+        std::size_t size() const {
+            std::lock_guard<std::mutex> lock(mutex);
+            return table.size();
+        }
+
+        std::uint64_t statements() const {
+            std::lock_guard<std::mutex> lock(mutex);
+            return statementCount;
+        }
+
+        std::uint64_t rowsWritten() const {
+            std::lock_guard<std::mutex> lock(mutex);
+            return rowCount;
+        }
+
+    private:
+        static void appendField(std::string& out, const std::string& field) {
+            unsigned char size[4];
+            wire::store(size, static_cast<std::uint32_t>(field.size()));
+            out.append(reinterpret_cast<const char*>(size), sizeof(size));
+            out.append(field);
+        }
+
+        static bool readField(std::ifstream& file, std::string& field) {
+            unsigned char size[4];
+            if (!file.read(reinterpret_cast<char*>(size), sizeof(size))) {
+                return false;
+            }
+            field.resize(wire::load<std::uint32_t>(size));
+            return static_cast<bool>(file.read(&field[0], static_cast<std::streamsize>(field.size())));
+        }
+
+        void replay() {
+            if (options.path.empty() || !std::filesystem::exists(options.path)) {
+                return;
+            }
+            std::ifstream file(options.path, std::ios::binary);
+            std::string key;
+            std::string value;
+            // A torn last row (crash mid-append) is ignored.
+            while (readField(file, key) && readField(file, value)) {
+                table[key] = value;
+            }
+        }
+
+        LocalTableOptions options;
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, std::string> table;
+        std::uint64_t statementCount = 0;
+        std::uint64_t rowCount = 0;
+    };
+
+} // namespace utils
+} // namespace hexarch
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace hexarch {
+namespace utils {
+namespace lz {
+
+    // Dependency-free LZ77 block compressor in the LZ4 block layout:
+    //   token (literal length << 4 | match length - 4), length extension bytes
+    //   of 255, literals, 16-bit little-endian match offset, match extension.
+    // The last 5 bytes are always literals and no match starts in the last 12.
+    //
+    // Greedy single-probe matching: fast enough to run per batch on the send
+    // path, and very effective on the repetitive fixed-layout records the
+    // datagram codecs produce.
+
+    constexpr std::size_t kMinMatch = 4;
+    constexpr std::size_t kLastLiterals = 5;
+    constexpr std::size_t kMatchSearchLimit = 12;
+    constexpr std::size_t kMaxOffset = 65535;
+    constexpr unsigned kHashBits = 12;
+
+    inline std::size_t maxCompressedSize(std::size_t n) { return n + n / 255 + 16; }
+
+    namespace detail {
+
+        inline std::uint32_t read32(const unsigned char* p) {
+            std::uint32_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        inline std::uint32_t hash(std::uint32_t sequence) {
+            return (sequence * 2654435761u) >> (32 - kHashBits);
+        }
+
+        inline unsigned char* writeLength(unsigned char* op, std::size_t length) {
+            while (length >= 255) {
+                *op++ = 255;
+                length -= 255;
+            }
+            *op++ = static_cast<unsigned char>(length);
+            return op;
+        }
+
+        inline unsigned char* writeLiterals(unsigned char* op, unsigned char* token, const unsigned char* literals, std::size_t count) {
+            if (count >= 15) {
+                *token = 15 << 4;
+                op = writeLength(op, count - 15);
+            } else {
+                *token = static_cast<unsigned char>(count << 4);
+            }
+            std::memcpy(op, literals, count);
+            return op + count;
+        }
+
+        // Reads a 255-continued length extension; false if it runs off the input.
+        inline bool readLength(const unsigned char*& ip, const unsigned char* end, std::size_t& length) {
+            unsigned char b;
+            do {
+                if (ip >= end) return false;
+                b = *ip++;
+                length += b;
+            } while (b == 255);
+            return true;
+        }
+
+    }
+
+    // Compresses n bytes into dst, which must hold maxCompressedSize(n).
+    // Returns the compressed size.
+    inline std::size_t compress(const unsigned char* src, std::size_t n, unsigned char* dst) {
+        unsigned char* op = dst;
+        std::size_t anchor = 0;
+
+        if (n > kMatchSearchLimit) {
+            std::uint32_t table[1u << kHashBits] = {};
+            const std::size_t matchEnd = n - kLastLiterals;
+            const std::size_t searchEnd = n - kMatchSearchLimit;
+            std::size_t ip = 1;
+            while (ip <= searchEnd) {
+                const std::uint32_t sequence = detail::read32(src + ip);
+                const std::uint32_t h = detail::hash(sequence);
+                const std::size_t candidate = table[h];
+                table[h] = static_cast<std::uint32_t>(ip);
+
+                if (candidate >= ip || ip - candidate > kMaxOffset || detail::read32(src + candidate) != sequence) {
+                    // Skip faster through data that keeps failing to match.
+                    ip += 1 + ((ip - anchor) >> 6);
+                    continue;
+                }
+
+                std::size_t length = kMinMatch;
+                while (ip + length < matchEnd && src[candidate + length] == src[ip + length]) {
+                    ++length;
+                }
+
+                unsigned char* token = op++;
+                op = detail::writeLiterals(op, token, src + anchor, ip - anchor);
+                const std::size_t offset = ip - candidate;
+                *op++ = static_cast<unsigned char>(offset & 0xff);
+                *op++ = static_cast<unsigned char>(offset >> 8);
+                const std::size_t extra = length - kMinMatch;
+                if (extra >= 15) {
+                    *token |= 15;
+                    op = detail::writeLength(op, extra - 15);
+                } else {
+                    *token |= static_cast<unsigned char>(extra);
+                }
+
+                ip += length;
+                anchor = ip;
+                if (ip - 2 <= searchEnd) {
+                    table[detail::hash(detail::read32(src + ip - 2))] = static_cast<std::uint32_t>(ip - 2);
+                }
+            }
+        }
+
+        unsigned char* token = op++;
+        op = detail::writeLiterals(op, token, src + anchor, n - anchor);
+        return static_cast<std::size_t>(op - dst);
+    }
+
+    // Decompresses into exactly dstSize bytes. Returns false on malformed
+    // input instead of reading or writing out of bounds.
+    inline bool decompress(const unsigned char* src, std::size_t n, unsigned char* dst, std::size_t dstSize) {
+        const unsigned char* ip = src;
+        const unsigned char* const end = src + n;
+        unsigned char* op = dst;
+        unsigned char* const outEnd = dst + dstSize;
+
+        while (ip < end) {
+            const unsigned token = *ip++;
+            std::size_t literals = token >> 4;
+            if (literals == 15 && !detail::readLength(ip, end, literals)) return false;
+            if (literals > static_cast<std::size_t>(end - ip) || literals > static_cast<std::size_t>(outEnd - op)) return false;
+            std::memcpy(op, ip, literals);
+            ip += literals;
+            op += literals;
+            if (ip == end) {
+                break;
+            }
+
+            if (end - ip < 2) return false;
+            const std::size_t offset = ip[0] | (static_cast<std::size_t>(ip[1]) << 8);
+            ip += 2;
+            if (offset == 0 || offset > static_cast<std::size_t>(op - dst)) return false;
+            std::size_t length = token & 15;
+            if (length == 15 && !detail::readLength(ip, end, length)) return false;
+            length += kMinMatch;
+            if (length > static_cast<std::size_t>(outEnd - op)) return false;
+            const unsigned char* match = op - offset;
+            for (std::size_t i = 0; i < length; ++i) {
+                op[i] = match[i];
+            }
+            op += length;
+        }
+        return op == outEnd;
+    }
+
+    inline void compress(const unsigned char* src, std::size_t n, std::vector<unsigned char>& out) {
+        out.resize(maxCompressedSize(n));
+        out.resize(compress(src, n, out.data()));
+    }
+
+} // namespace lz
+} // namespace utils
+} // namespace hexarch
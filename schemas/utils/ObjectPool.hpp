@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hexarch {
+namespace utils {
+
+    // Typed pool for long-lived models (caches, repositories, open sessions).
+    //
+    // Objects live in fixed-size chunks that are never returned to the heap while
+    // the pool exists; released slots go on a free list and are reused first. For
+    // allocator-aware models (std::pmr allocator_type) the pool also passes its own
+    // pool resource at construction, so member strings are recycled by size class
+    // instead of going through malloc on every acquire/release.
+    //
+    // acquire() returns a unique_ptr whose deleter hands the slot back; handles
+    // must not outlive the pool. The default pool belongs to one thread; use
+    // ObjectPool<T, std::mutex> when handles are acquired, modified or released
+    // on several.
+    struct NullMutex {
+        void lock() {}
+        void unlock() {}
+    };
+
+    template <typename T, typename Mutex = NullMutex>
+    class ObjectPool {
+        union Slot {
+            Slot* next;
+            alignas(T) unsigned char storage[sizeof(T)];
+        };
+
+    public:
+        class Releaser {
+        public:
+            Releaser() = default;
+            explicit Releaser(ObjectPool* pool) : pool(pool) {}
+            void operator()(T* object) const { pool->release(object); }
+
+        private:
+            ObjectPool* pool = nullptr;
+        };
+
+        using Handle = std::unique_ptr<T, Releaser>;
+
+        explicit ObjectPool(std::size_t chunkSize = 256) : chunkSize(chunkSize ? chunkSize : 1) {}
+
+        ObjectPool(const ObjectPool&) = delete;
+        ObjectPool& operator=(const ObjectPool&) = delete;
+
+        template <typename... Args>
+        Handle acquire(Args&&... args) {
+            Slot* slot;
+            {
+                std::lock_guard<Mutex> lock(mutex);
+                if (!freeList) {
+                    grow();
+                }
+                slot = freeList;
+                freeList = slot->next;
+                ++live;
+            }
+            try {
+                T* object;
+                if constexpr (std::uses_allocator<T, std::pmr::polymorphic_allocator<char>>::value) {
+                    object = ::new (slot->storage) T(std::forward<Args>(args)..., std::pmr::polymorphic_allocator<char>(&members));
+                } else {
+                    object = ::new (slot->storage) T(std::forward<Args>(args)...);
+                }
+                return Handle(object, Releaser(this));
+            } catch (...) {
+                std::lock_guard<Mutex> lock(mutex);
+                slot->next = freeList;
+                freeList = slot;
+                --live;
+                throw;
+            }
+        }
+
+        std::size_t inUse() const {
+            std::lock_guard<Mutex> lock(mutex);
+            return live;
+        }
+
+        std::size_t capacity() const {
+            std::lock_guard<Mutex> lock(mutex);
+            return chunks.size() * chunkSize;
+        }
+
+    private:
+        void grow() {
+            chunks.push_back(std::make_unique<Slot[]>(chunkSize));
+            Slot* chunk = chunks.back().get();
+            for (std::size_t i = chunkSize; i-- > 0;) {
+                chunk[i].next = freeList;
+                freeList = &chunk[i];
+            }
+        }
+
+        void release(T* object) {
+            object->~T();
+            Slot* slot = reinterpret_cast<Slot*>(object);
+            std::lock_guard<Mutex> lock(mutex);
+            slot->next = freeList;
+            freeList = slot;
+            --live;
+        }
+
+        const std::size_t chunkSize;
+        using MemberResource = std::conditional_t<std::is_same<Mutex, NullMutex>::value,
+                                                  std::pmr::unsynchronized_pool_resource,
+                                                  std::pmr::synchronized_pool_resource>;
+
+        mutable Mutex mutex;
+        std::vector<std::unique_ptr<Slot[]>> chunks;
+        Slot* freeList = nullptr;
+        std::size_t live = 0;
+        MemberResource members;
+    };
+
+} // namespace utils
+} // namespace hexarch
@@ -0,0 +1,595 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// 1 (default) records per-port latency and traffic; 0 compiles PortMetrics,
+// ScopedTimer and HealthServer to empty inline stubs, so instrumented code
+// carries no cost at all.
+#ifndef HEXARCH_METRICS
+#define HEXARCH_METRICS 1
+#endif
+
+#if HEXARCH_METRICS
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace hexarch {
+namespace utils {
+namespace metrics {
+
+    // Handle latency and message/byte/error counters per port, for the
+    // pack.xml health check.
+    //
+    // Generated adapters get their PortMetrics from port() once and wrap each
+    // send()/deliver() in a ScopedTimer. Every thread records into its own
+    // shard of each port (plain stores, no locked instructions, no sharing);
+    // a scrape sums the shards. Latency goes into an HDR-style histogram: exact
+    // up to 16 clock ticks, then 16 buckets per power of two, so any quantile
+    // is within 6.25%. HealthServer serves scrape() in Prometheus text format.
+    //
+    //   auto& m = metrics::port("ICustomerOutgoingPort", "CustomerKafkaOutgoingAdapter", Direction::Outgoing);
+    //   { metrics::ScopedTimer timer(m); ...; timer.addBytes(n); }   // an exception counts as an error
+
+    enum class Direction : std::uint8_t { Incoming, Outgoing };
+
+    inline const char* toString(Direction direction) {
+        return direction == Direction::Incoming ? "incoming" : "outgoing";
+    }
+
+    struct PortSnapshot {
+        std::string port;
+        std::string adapter;
+        Direction direction;
+        std::uint64_t calls;
+        std::uint64_t messages;
+        std::uint64_t bytes;
+        std::uint64_t errors;
+        // Handle latency of one call.
+        double totalSeconds;
+        double p50Seconds;
+        double p99Seconds;
+        double p999Seconds;
+        double maxSeconds;
+    };
+
+    struct HealthOptions {
+        std::string address = "127.0.0.1";
+        // 0 picks a free port; see HealthServer::port().
+        std::uint16_t port = 9464;
+        // Also answered on /metrics.
+        std::string path = "/health";
+    };
+
+#if HEXARCH_METRICS
+
+    namespace detail {
+
+        // Raw clock for latency: the TSC where there is one (a few ns, against
+        // tens for steady_clock under some hypervisors); converted at scrape time.
+        inline std::uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#else
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+        }
+
+        constexpr unsigned kSubBits = 4;
+        constexpr std::uint64_t kSub = std::uint64_t(1) << kSubBits;
+        // Durations are clamped to 2^44 ticks (well over an hour).
+        constexpr unsigned kMaxBits = 44;
+        constexpr std::size_t kBuckets = (kMaxBits - kSubBits + 1) * kSub;
+
+        inline std::size_t bucketOf(std::uint64_t v) {
+            if (v < kSub) return static_cast<std::size_t>(v);
+            v = std::min(v, (std::uint64_t(1) << kMaxBits) - 1);
+            const unsigned msb = 63 - static_cast<unsigned>(__builtin_clzll(v));
+            return (msb - kSubBits + 1) * kSub + ((v >> (msb - kSubBits)) & (kSub - 1));
+        }
+
+        // [bucketLow(i), bucketLow(i + 1)) is bucket i.
+        inline std::uint64_t bucketLow(std::size_t i) {
+            if (i < kSub) return i;
+            const std::size_t group = i / kSub;
+            return (kSub + i % kSub) << (group - 1);
+        }
+
+        inline void bump(std::atomic<std::uint64_t>& counter, std::uint64_t n) {
+            counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        // Merged shards of one port at one scrape.
+        struct Totals {
+            std::uint64_t calls = 0;
+            std::uint64_t messages = 0;
+            std::uint64_t bytes = 0;
+            std::uint64_t errors = 0;
+            std::uint64_t ticks = 0;
+            std::vector<std::uint64_t> histogram = std::vector<std::uint64_t>(kBuckets, 0);
+
+            // Middle of the bucket holding the q-th call; exact below kSub.
+            double quantileTicks(double q) const {
+                std::uint64_t counted = 0;
+                for (std::uint64_t c : histogram) counted += c;
+                if (counted == 0) return 0.0;
+                const std::uint64_t rank = static_cast<std::uint64_t>(q * static_cast<double>(counted - 1)) + 1;
+                std::uint64_t seen = 0;
+                for (std::size_t i = 0; i < kBuckets; ++i) {
+                    seen += histogram[i];
+                    if (seen >= rank) {
+                        return i < kSub ? static_cast<double>(i)
+                                        : (static_cast<double>(bucketLow(i)) + static_cast<double>(bucketLow(i + 1))) / 2.0;
+                    }
+                }
+                return 0.0;
+            }
+
+            // Calls whose bucket lies entirely at or below `limit` ticks.
+            std::uint64_t countAtMost(double limit) const {
+                std::uint64_t n = 0;
+                for (std::size_t i = 0; i < kBuckets && static_cast<double>(bucketLow(i + 1)) <= limit + 1.0; ++i) {
+                    n += histogram[i];
+                }
+                return n;
+            }
+        };
+
+        // One thread's counters for one port. Only that thread writes; scrapes read.
+        struct alignas(64) Shard {
+            std::atomic<std::uint64_t> calls{0};
+            std::atomic<std::uint64_t> messages{0};
+            std::atomic<std::uint64_t> bytes{0};
+            std::atomic<std::uint64_t> errors{0};
+            std::atomic<std::uint64_t> ticks{0};
+            std::atomic<std::uint64_t> buckets[kBuckets] = {};
+            // Cleared when the thread exits; a later thread adopts the shard and
+            // keeps adding to it, so totals never go down.
+            std::atomic<bool> owned{true};
+        };
+
+        // The calling thread's shard pointers, indexed by PortMetrics id.
+        struct ThreadShards {
+            std::vector<Shard*> byPort;
+            ~ThreadShards() {
+                for (Shard* shard : byPort) {
+                    if (shard) shard->owned.store(false, std::memory_order_release);
+                }
+            }
+        };
+
+        inline ThreadShards& threadShards() {
+            thread_local ThreadShards shards;
+            return shards;
+        }
+
+        // Tick -> ns rate, measured against steady_clock since the registry started.
+        class TickRate {
+        public:
+            TickRate() : tick0(ticks()), ns0(steadyNs()) {}
+
+            double nsPerTick() const {
+#if defined(__x86_64__) || defined(__i386__)
+                if (steadyNs() - ns0 < 2000000) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                }
+                const std::uint64_t tick = ticks();
+                const std::int64_t ns = steadyNs();
+                return tick > tick0 ? static_cast<double>(ns - ns0) / static_cast<double>(tick - tick0) : 1.0;
+#else
+                return 1.0;
+#endif
+            }
+
+        private:
+            static std::int64_t steadyNs() {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            }
+
+            std::uint64_t tick0;
+            std::int64_t ns0;
+        };
+
+    }
+
+    class PortMetrics {
+    public:
+        PortMetrics(std::string port, std::string adapter, Direction direction, std::size_t id)
+            : port(std::move(port)), adapter(std::move(adapter)), direction(direction), id(id) {}
+
+        PortMetrics(const PortMetrics&) = delete;
+        PortMetrics& operator=(const PortMetrics&) = delete;
+
+        // One call that handled `messages` messages, `bytes` bytes in total.
+        void record(std::uint64_t elapsedTicks, std::size_t messages, std::size_t bytes, bool failed) {
+            detail::Shard& shard = local();
+            detail::bump(shard.calls, 1);
+            detail::bump(shard.messages, messages);
+            detail::bump(shard.bytes, bytes);
+            detail::bump(shard.ticks, elapsedTicks);
+            detail::bump(shard.buckets[detail::bucketOf(elapsedTicks)], 1);
+            if (failed) detail::bump(shard.errors, 1);
+        }
+
+        // A failure reported outside the call, e.g. a delivery report.
+        void error(std::size_t n = 1) { detail::bump(local().errors, n); }
+
+        // Sum of every thread's shard.
+        detail::Totals totals() const {
+            detail::Totals out;
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& shard : shards) {
+                out.calls += shard->calls.load(std::memory_order_relaxed);
+                out.messages += shard->messages.load(std::memory_order_relaxed);
+                out.bytes += shard->bytes.load(std::memory_order_relaxed);
+                out.errors += shard->errors.load(std::memory_order_relaxed);
+                out.ticks += shard->ticks.load(std::memory_order_relaxed);
+                for (std::size_t i = 0; i < detail::kBuckets; ++i) {
+                    out.histogram[i] += shard->buckets[i].load(std::memory_order_relaxed);
+                }
+            }
+            return out;
+        }
+
+        PortSnapshot snapshot(const detail::Totals& t, double nsPerTick) const {
+            const double secondsPerTick = nsPerTick * 1e-9;
+            return { port, adapter, direction, t.calls, t.messages, t.bytes, t.errors,
+                     static_cast<double>(t.ticks) * secondsPerTick,
+                     t.quantileTicks(0.50) * secondsPerTick, t.quantileTicks(0.99) * secondsPerTick,
+                     t.quantileTicks(0.999) * secondsPerTick, t.quantileTicks(1.0) * secondsPerTick };
+        }
+
+        const std::string& getPort() const { return port; }
+        const std::string& getAdapter() const { return adapter; }
+        Direction getDirection() const { return direction; }
+
+    private:
+        detail::Shard& local() {
+            std::vector<detail::Shard*>& byPort = detail::threadShards().byPort;
+            if (id < byPort.size() && byPort[id]) {
+                return *byPort[id];
+            }
+            if (id >= byPort.size()) byPort.resize(id + 1, nullptr);
+            byPort[id] = attach();
+            return *byPort[id];
+        }
+
+        detail::Shard* attach() {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& shard : shards) {
+                bool expected = false;
+                if (shard->owned.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                    return shard.get();
+                }
+            }
+            shards.push_back(std::make_unique<detail::Shard>());
+            return shards.back().get();
+        }
+
+        const std::string port;
+        const std::string adapter;
+        const Direction direction;
+        const std::size_t id;
+        mutable std::mutex mutex;
+        std::vector<std::unique_ptr<detail::Shard>> shards;
+    };
+
+    class Registry {
+    public:
+        static Registry& instance() {
+            static Registry registry;
+            return registry;
+        }
+
+        Registry(const Registry&) = delete;
+        Registry& operator=(const Registry&) = delete;
+
+        // The metrics of one port/adapter pair, created on first use. The
+        // reference stays valid for the life of the process.
+        PortMetrics& port(std::string_view port, std::string_view adapter, Direction direction) {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& p : ports) {
+                if (p->getPort() == port && p->getAdapter() == adapter) return *p;
+            }
+            ports.push_back(std::make_unique<PortMetrics>(std::string(port), std::string(adapter), direction, ports.size()));
+            return *ports.back();
+        }
+
+        std::vector<PortSnapshot> snapshot() const {
+            const double nsPerTick = rate.nsPerTick();
+            std::vector<PortSnapshot> out;
+            for (const PortMetrics* p : list()) out.push_back(p->snapshot(p->totals(), nsPerTick));
+            return out;
+        }
+
+        // Prometheus text exposition format, version 0.0.4.
+        std::string scrape() const {
+            static constexpr double kBounds[] = { 1e-6, 2.5e-6, 5e-6, 1e-5, 2.5e-5, 5e-5, 1e-4, 2.5e-4, 5e-4, 1e-3,
+                                                  2.5e-3, 5e-3, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0 };
+            const double nsPerTick = rate.nsPerTick();
+            std::vector<detail::Totals> totals;
+            std::vector<PortSnapshot> snaps;
+            for (const PortMetrics* p : list()) {
+                totals.push_back(p->totals());
+                snaps.push_back(p->snapshot(totals.back(), nsPerTick));
+            }
+
+            std::string out;
+            const auto header = [&](const char* name, const char* type, const char* help) {
+                out += "# HELP "; out += name; out += ' '; out += help; out += '\n';
+                out += "# TYPE "; out += name; out += ' '; out += type; out += '\n';
+            };
+            const auto sample = [&](const char* name, const PortSnapshot& s, const char* extra, double value) {
+                char number[64];
+                std::snprintf(number, sizeof(number), "%.9g", value);
+                out += name;
+                out += "{port=\""; appendEscaped(out, s.port);
+                out += "\",adapter=\""; appendEscaped(out, s.adapter);
+                out += "\",direction=\""; out += toString(s.direction); out += '"';
+                out += extra;
+                out += "} "; out += number; out += '\n';
+            };
+
+            header("hexarch_up", "gauge", "1 while the component serves its health endpoint.");
+            out += "hexarch_up 1\n";
+            header("hexarch_uptime_seconds", "gauge", "Seconds since the metrics registry started.");
+            char uptime[64];
+            std::snprintf(uptime, sizeof(uptime), "hexarch_uptime_seconds %.3f\n",
+                          std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count());
+            out += uptime;
+
+            header("hexarch_port_calls_total", "counter", "Instrumented port calls.");
+            for (const auto& s : snaps) sample("hexarch_port_calls_total", s, "", static_cast<double>(s.calls));
+            header("hexarch_port_messages_total", "counter", "Messages handled by the port.");
+            for (const auto& s : snaps) sample("hexarch_port_messages_total", s, "", static_cast<double>(s.messages));
+            header("hexarch_port_bytes_total", "counter", "Encoded bytes handled by the port.");
+            for (const auto& s : snaps) sample("hexarch_port_bytes_total", s, "", static_cast<double>(s.bytes));
+            header("hexarch_port_errors_total", "counter", "Failed calls and failed deliveries.");
+            for (const auto& s : snaps) sample("hexarch_port_errors_total", s, "", static_cast<double>(s.errors));
+
+            header("hexarch_port_handle_seconds", "histogram", "Latency of one port call.");
+            for (std::size_t i = 0; i < snaps.size(); ++i) {
+                const PortSnapshot& s = snaps[i];
+                for (double bound : kBounds) {
+                    char le[48];
+                    std::snprintf(le, sizeof(le), ",le=\"%g\"", bound);
+                    // A call racing the scrape may be in the histogram but not yet in calls
+                    sample("hexarch_port_handle_seconds_bucket", s, le,
+                           static_cast<double>(std::min(totals[i].countAtMost(bound * 1e9 / nsPerTick), s.calls)));
+                }
+                sample("hexarch_port_handle_seconds_bucket", s, ",le=\"+Inf\"", static_cast<double>(s.calls));
+                sample("hexarch_port_handle_seconds_sum", s, "", s.totalSeconds);
+                sample("hexarch_port_handle_seconds_count", s, "", static_cast<double>(s.calls));
+            }
+
+            header("hexarch_port_handle_quantile_seconds", "gauge", "Latency quantiles of one port call since start.");
+            for (const auto& s : snaps) {
+                sample("hexarch_port_handle_quantile_seconds", s, ",quantile=\"0.5\"", s.p50Seconds);
+                sample("hexarch_port_handle_quantile_seconds", s, ",quantile=\"0.99\"", s.p99Seconds);
+                sample("hexarch_port_handle_quantile_seconds", s, ",quantile=\"0.999\"", s.p999Seconds);
+                sample("hexarch_port_handle_quantile_seconds", s, ",quantile=\"1\"", s.maxSeconds);
+            }
+            return out;
+        }
+
+    private:
+        Registry() : started(std::chrono::steady_clock::now()) {}
+
+        std::vector<const PortMetrics*> list() const {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::vector<const PortMetrics*> out;
+            for (const auto& p : ports) out.push_back(p.get());
+            return out;
+        }
+
+        static void appendEscaped(std::string& out, const std::string& value) {
+            for (const char ch : value) {
+                if (ch == '\\' || ch == '"') out += '\\';
+                if (ch == '\n') {
+                    out += "\\n";
+                    continue;
+                }
+                out += ch;
+            }
+        }
+
+        const std::chrono::steady_clock::time_point started;
+        const detail::TickRate rate;
+        mutable std::mutex mutex;
+        std::deque<std::unique_ptr<PortMetrics>> ports;
+    };
+
+    // Times one port call from construction to destruction and records it,
+    // as an error if fail() was called or an exception thrown after its
+    // construction is unwinding it. A timer created inside a destructor that
+    // runs during unwinding is not failed by the outer exception.
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(PortMetrics& metrics, std::size_t messages = 1)
+            : metrics(metrics), messages(messages), start(detail::ticks()), exceptionsAtStart(std::uncaught_exceptions()) {}
+
+        ~ScopedTimer() {
+            metrics.record(detail::ticks() - start, messages, bytes, failed || std::uncaught_exceptions() > exceptionsAtStart);
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        void addBytes(std::size_t n) { bytes += n; }
+        void fail() { failed = true; }
+
+    private:
+        PortMetrics& metrics;
+        const std::size_t messages;
+        std::size_t bytes = 0;
+        bool failed = false;
+        const std::uint64_t start;
+        const int exceptionsAtStart;
+    };
+
+    // Minimal HTTP/1.0 server for the health check: GET options.path (and
+    // /metrics) returns Registry::scrape(), anything else 404. One connection
+    // at a time on its own thread; scrapes are rare and small. A bind failure
+    // is reported on stderr and leaves the server idle rather than stopping
+    // the component.
+    class HealthServer {
+    public:
+        explicit HealthServer(HealthOptions options = HealthOptions()) : options(std::move(options)) {
+            listenFd = ::socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(this->options.port);
+            const int yes = 1;
+            if (listenFd < 0
+                || ::inet_pton(AF_INET, this->options.address.c_str(), &addr.sin_addr) != 1
+                || ::setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes)) != 0
+                || ::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0
+                || ::listen(listenFd, 16) != 0) {
+                std::fprintf(stderr, "HealthServer: cannot listen on %s:%u: %s\n", this->options.address.c_str(),
+                             static_cast<unsigned>(this->options.port), std::strerror(errno));
+                if (listenFd >= 0) ::close(listenFd);
+                listenFd = -1;
+                return;
+            }
+            socklen_t length = sizeof(addr);
+            ::getsockname(listenFd, reinterpret_cast<sockaddr*>(&addr), &length);
+            boundPort = ntohs(addr.sin_port);
+            server = std::thread([this] { run(); });
+        }
+
+        ~HealthServer() {
+            stopping.store(true, std::memory_order_release);
+            if (server.joinable()) server.join();
+            if (listenFd >= 0) ::close(listenFd);
+        }
+
+        HealthServer(const HealthServer&) = delete;
+        HealthServer& operator=(const HealthServer&) = delete;
+
+        bool listening() const { return listenFd >= 0; }
+        std::uint16_t port() const { return boundPort; }
+
+    private:
+        void run() {
+            while (!stopping.load(std::memory_order_acquire)) {
+                pollfd pfd{ listenFd, POLLIN, 0 };
+                if (::poll(&pfd, 1, 200) <= 0) continue;
+                const int fd = ::accept(listenFd, nullptr, nullptr);
+                if (fd < 0) continue;
+                timeval timeout{ 1, 0 };
+                ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+                ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+                serve(fd);
+                ::close(fd);
+            }
+        }
+
+        void serve(int fd) {
+            std::string request;
+            char buffer[1024];
+            while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+                const ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+                if (n <= 0) break;
+                request.append(buffer, static_cast<std::size_t>(n));
+            }
+            const std::size_t lineEnd = request.find("\r\n");
+            const std::string line = request.substr(0, lineEnd);
+            const std::size_t pathStart = line.find(' ');
+            const std::size_t pathEnd = pathStart == std::string::npos ? std::string::npos : line.find(' ', pathStart + 1);
+            std::string path = pathEnd == std::string::npos ? std::string() : line.substr(pathStart + 1, pathEnd - pathStart - 1);
+            path = path.substr(0, path.find('?'));
+
+            std::string status = "200 OK";
+            std::string body;
+            if (line.compare(0, 4, "GET ") != 0) {
+                status = "405 Method Not Allowed";
+            } else if (path == options.path || path == "/metrics") {
+                body = Registry::instance().scrape();
+            } else {
+                status = "404 Not Found";
+            }
+            std::string response = "HTTP/1.0 " + status + "\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                                   "Content-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+            for (std::size_t sent = 0; sent < response.size();) {
+                const ssize_t n = ::send(fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+                if (n <= 0) return;
+                sent += static_cast<std::size_t>(n);
+            }
+        }
+
+        const HealthOptions options;
+        int listenFd = -1;
+        std::uint16_t boundPort = 0;
+        std::atomic<bool> stopping{false};
+        std::thread server;
+    };
+
+#else
+
+    class PortMetrics {
+    public:
+        void record(std::uint64_t, std::size_t, std::size_t, bool) {}
+        void error(std::size_t = 1) {}
+    };
+
+    class Registry {
+    public:
+        static Registry& instance() {
+            static Registry registry;
+            return registry;
+        }
+        PortMetrics& port(std::string_view, std::string_view, Direction) { return metrics; }
+        std::vector<PortSnapshot> snapshot() const { return {}; }
+        std::string scrape() const { return {}; }
+
+    private:
+        PortMetrics metrics;
+    };
+
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(PortMetrics&, std::size_t = 1) {}
+        void addBytes(std::size_t) {}
+        void fail() {}
+    };
+
+    class HealthServer {
+    public:
+        explicit HealthServer(HealthOptions = HealthOptions()) {}
+        bool listening() const { return false; }
+        std::uint16_t port() const { return 0; }
+    };
+
+#endif
+
+    inline PortMetrics& port(std::string_view port, std::string_view adapter, Direction direction) {
+        return Registry::instance().port(port, adapter, direction);
+    }
+
+    inline std::string scrape() { return Registry::instance().scrape(); }
+
+} // namespace metrics
+} // namespace utils
+} // namespace hexarch
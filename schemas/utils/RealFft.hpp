@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace hexarch {
+namespace utils {
+
+    // Real-input FFT of a fixed power-of-two size N. The N real samples are packed
+    // into an N/2-point complex FFT and split afterwards, so one transform costs
+    // about half of a full complex FFT. Output is the N/2 + 1 non-negative bins.
+    class RealFft {
+    public:
+        explicit RealFft(std::size_t n) : n(n), half(n / 2) {
+            if (n < 4 || (n & (n - 1)) != 0) {
+                throw std::invalid_argument("RealFft: size must be a power of two >= 4");
+            }
+            const double pi = std::acos(-1.0);
+
+            bitReverse.resize(half);
+            std::size_t bits = 0;
+            while ((std::size_t(1) << bits) < half) ++bits;
+            for (std::size_t i = 0; i < half; ++i) {
+                std::size_t r = 0;
+                for (std::size_t b = 0; b < bits; ++b) {
+                    r |= ((i >> b) & 1) << (bits - 1 - b);
+                }
+                bitReverse[i] = r;
+            }
+
+            twiddles.resize(half / 2 ? half / 2 : 1);
+            for (std::size_t k = 0; k < twiddles.size(); ++k) {
+                twiddles[k] = std::polar(1.0, -2.0 * pi * k / half);
+            }
+            splitTwiddles.resize(half);
+            for (std::size_t k = 0; k < half; ++k) {
+                splitTwiddles[k] = std::polar(1.0, -2.0 * pi * k / n);
+            }
+            work.resize(half);
+        }
+
+        std::size_t size() const { return n; }
+        std::size_t bins() const { return half + 1; }
+
+        // out must hold bins() values.
+        void forward(const double* in, std::complex<double>* out) {
+            for (std::size_t i = 0; i < half; ++i) {
+                const std::size_t r = bitReverse[i];
+                work[r] = std::complex<double>(in[2 * i], in[2 * i + 1]);
+            }
+
+            for (std::size_t len = 2; len <= half; len <<= 1) {
+                const std::size_t step = half / len;
+                for (std::size_t base = 0; base < half; base += len) {
+                    for (std::size_t j = 0; j < len / 2; ++j) {
+                        const std::complex<double> t = twiddles[j * step] * work[base + j + len / 2];
+                        const std::complex<double> u = work[base + j];
+                        work[base + j] = u + t;
+                        work[base + j + len / 2] = u - t;
+                    }
+                }
+            }
+
+            const std::complex<double> z0 = work[0];
+            out[0] = std::complex<double>(z0.real() + z0.imag(), 0.0);
+            out[half] = std::complex<double>(z0.real() - z0.imag(), 0.0);
+            for (std::size_t k = 1; k < half; ++k) {
+                const std::complex<double> a = work[k];
+                const std::complex<double> b = std::conj(work[half - k]);
+                const std::complex<double> even = 0.5 * (a + b);
+                const std::complex<double> odd = std::complex<double>(0.0, -0.5) * (a - b);
+                out[k] = even + splitTwiddles[k] * odd;
+            }
+        }
+
+        // |X[k]|^2 for each of the bins() outputs.
+        void power(const double* in, double* out) {
+            spectrum.resize(bins());
+            forward(in, spectrum.data());
+            for (std::size_t k = 0; k < spectrum.size(); ++k) {
+                out[k] = std::norm(spectrum[k]);
+            }
+        }
+
+    private:
+        std::size_t n;
+        std::size_t half;
+        std::vector<std::size_t> bitReverse;
+        std::vector<std::complex<double>> twiddles;
+        std::vector<std::complex<double>> splitTwiddles;
+        std::vector<std::complex<double>> work;
+        std::vector<std::complex<double>> spectrum;
+    };
+
+} // namespace utils
+} // namespace hexarch
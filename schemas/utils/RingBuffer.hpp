@@ -0,0 +1,472 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace hexarch {
+namespace utils {
+
+    // Bounded rings for handing models from adapter threads to domain workers.
+    //
+    //   SpscRing<T, Wait>  one producer thread, one consumer thread
+    //   MpmcRing<T, Wait>  any number of each (Vyukov's per-slot sequence queue)
+    //
+    // try* calls never block. push/pop/pushBatch/popBatch block through the Wait
+    // strategy (SpinWait, YieldWait or FutexWait) until they can make progress;
+    // after close() blocked consumers drain what is left and then return empty.
+    // T must be default-constructible and move-assignable; slots are reused.
+
+    constexpr std::size_t kCacheLine = 64;
+
+    inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+
+    // Busy-waits. Lowest hand-off latency; needs a core per waiting thread.
+    struct SpinWait {
+        template <typename Ready>
+        void waitUntil(Ready&& ready) {
+            while (!ready()) {
+                cpuRelax();
+            }
+        }
+        void notify() {}
+    };
+
+    // Gives the core away between checks; for oversubscribed hosts.
+    struct YieldWait {
+        template <typename Ready>
+        void waitUntil(Ready&& ready) {
+            while (!ready()) {
+                std::this_thread::yield();
+            }
+        }
+        void notify() {}
+    };
+
+    // Spins briefly, then sleeps in the kernel. notify() is a fence and a load
+    // unless someone is actually asleep. Falls back to yielding off Linux.
+    class FutexWait {
+    public:
+        static constexpr int kSpins = 128;
+
+        template <typename Ready>
+        void waitUntil(Ready&& ready) {
+            for (int i = 0; i < kSpins; ++i) {
+                if (ready()) {
+                    return;
+                }
+                cpuRelax();
+            }
+            for (;;) {
+                sleepers.fetch_add(1, std::memory_order_seq_cst);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                const std::uint32_t seen = epoch.load(std::memory_order_acquire);
+                if (ready()) {
+                    sleepers.fetch_sub(1, std::memory_order_relaxed);
+                    return;
+                }
+                sleep(seen);
+                sleepers.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+
+        void notify() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (sleepers.load(std::memory_order_seq_cst) == 0) {
+                return;
+            }
+            epoch.fetch_add(1, std::memory_order_release);
+            wakeAll();
+        }
+
+    private:
+        void sleep(std::uint32_t seen) {
+#ifdef __linux__
+            syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&epoch), FUTEX_WAIT_PRIVATE, seen, nullptr, nullptr, 0);
+#else
+            (void)seen;
+            std::this_thread::yield();
+#endif
+        }
+
+        void wakeAll() {
+#ifdef __linux__
+            syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&epoch), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#endif
+        }
+
+        static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "futex word must be 32 bits");
+
+        std::atomic<std::uint32_t> epoch{0};
+        std::atomic<std::uint32_t> sleepers{0};
+    };
+
+    // Occupancy counters, readable from any thread while the ring is in use.
+    struct RingStats {
+        std::uint64_t pushed;
+        std::uint64_t popped;
+        // Blocking calls that found the ring full / empty and had to wait.
+        std::uint64_t fullWaits;
+        std::uint64_t emptyWaits;
+    };
+
+    namespace detail {
+
+        inline std::size_t roundUpPow2(std::size_t n) {
+            if (n < 2) {
+                throw std::invalid_argument("RingBuffer: capacity must be at least 2");
+            }
+            std::size_t p = 1;
+            while (p < n) p <<= 1;
+            return p;
+        }
+
+        // Blocking push/pop built on the try* primitives of Ring.
+        template <typename Ring, typename T, typename Wait>
+        class BlockingOps {
+        public:
+            bool push(T value) {
+                Ring& ring = self();
+                if (ring.tryPush(std::move(value))) {
+                    return true;
+                }
+                ring.fullWaitCount.fetch_add(1, std::memory_order_relaxed);
+                bool pushed = false;
+                notFull.waitUntil([&] {
+                    if (ring.isClosed()) return true;
+                    pushed = ring.tryPush(std::move(value));
+                    return pushed;
+                });
+                return pushed;
+            }
+
+            // Moves all n items in, waiting for space as needed; false if closed first.
+            bool pushBatch(T* items, std::size_t n) {
+                Ring& ring = self();
+                std::size_t done = ring.tryPushBatch(items, n);
+                if (done == n) {
+                    return true;
+                }
+                ring.fullWaitCount.fetch_add(1, std::memory_order_relaxed);
+                notFull.waitUntil([&] {
+                    if (ring.isClosed()) return true;
+                    done += ring.tryPushBatch(items + done, n - done);
+                    return done == n;
+                });
+                return done == n;
+            }
+
+            // False once the ring is closed and drained.
+            bool pop(T& out) {
+                Ring& ring = self();
+                if (ring.tryPop(out)) {
+                    return true;
+                }
+                ring.emptyWaitCount.fetch_add(1, std::memory_order_relaxed);
+                bool popped = false;
+                notEmpty.waitUntil([&] {
+                    popped = ring.tryPop(out);
+                    return popped || ring.isClosed();
+                });
+                return popped || ring.tryPop(out);
+            }
+
+            // Waits for at least one item, then takes up to max; 0 once closed and drained.
+            std::size_t popBatch(T* out, std::size_t max) {
+                Ring& ring = self();
+                std::size_t n = ring.tryPopBatch(out, max);
+                if (n > 0 || max == 0) {
+                    return n;
+                }
+                ring.emptyWaitCount.fetch_add(1, std::memory_order_relaxed);
+                notEmpty.waitUntil([&] {
+                    n = ring.tryPopBatch(out, max);
+                    return n > 0 || ring.isClosed();
+                });
+                return n > 0 ? n : ring.tryPopBatch(out, max);
+            }
+
+            // Wakes every blocked caller; pushes fail from now on.
+            void close() {
+                Ring& ring = self();
+                ring.closed.store(true, std::memory_order_release);
+                notEmpty.notify();
+                notFull.notify();
+            }
+
+        protected:
+            void signalNotEmpty() { notEmpty.notify(); }
+            void signalNotFull() { notFull.notify(); }
+
+        private:
+            Ring& self() { return static_cast<Ring&>(*this); }
+
+            Wait notEmpty;
+            Wait notFull;
+        };
+
+    }
+
+    template <typename T, typename Wait = SpinWait>
+    class SpscRing : public detail::BlockingOps<SpscRing<T, Wait>, T, Wait> {
+        friend class detail::BlockingOps<SpscRing<T, Wait>, T, Wait>;
+
+    public:
+        // Capacity is rounded up to a power of two.
+        explicit SpscRing(std::size_t capacity)
+            : mask(detail::roundUpPow2(capacity) - 1), slots(mask + 1) {}
+
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+
+        std::size_t capacity() const { return mask + 1; }
+
+        // Approximate when called while both sides are running.
+        std::size_t size() const {
+            // head first: tail can only have moved further ahead by the time it is read
+            const std::size_t h = head.load(std::memory_order_acquire);
+            const std::size_t t = tail.load(std::memory_order_acquire);
+            return t - h;
+        }
+
+        bool isClosed() const { return closed.load(std::memory_order_acquire); }
+
+        RingStats stats() const {
+            return { pushCount.load(std::memory_order_relaxed), popCount.load(std::memory_order_relaxed),
+                     fullWaitCount.load(std::memory_order_relaxed), emptyWaitCount.load(std::memory_order_relaxed) };
+        }
+
+        // Producer side.
+        bool tryPush(T&& value) { return tryPushBatch(&value, 1) == 1; }
+        bool tryPush(const T& value) {
+            T copy(value);
+            return tryPush(std::move(copy));
+        }
+
+        // Moves up to n items in with one index publish; returns how many fit.
+        std::size_t tryPushBatch(T* items, std::size_t n) {
+            if (isClosed()) {
+                return 0;
+            }
+            const std::size_t t = tail.load(std::memory_order_relaxed);
+            std::size_t free = capacity() - (t - cachedHead);
+            if (free < n) {
+                cachedHead = head.load(std::memory_order_acquire);
+                free = capacity() - (t - cachedHead);
+            }
+            const std::size_t count = n < free ? n : free;
+            if (count == 0) {
+                return 0;
+            }
+            for (std::size_t i = 0; i < count; ++i) {
+                slots[(t + i) & mask] = std::move(items[i]);
+            }
+            tail.store(t + count, std::memory_order_release);
+            pushCount.store(pushCount.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+            this->signalNotEmpty();
+            return count;
+        }
+
+        // Consumer side.
+        bool tryPop(T& out) { return tryPopBatch(&out, 1) == 1; }
+
+        std::size_t tryPopBatch(T* out, std::size_t max) {
+            const std::size_t h = head.load(std::memory_order_relaxed);
+            std::size_t available = cachedTail - h;
+            if (available < max) {
+                cachedTail = tail.load(std::memory_order_acquire);
+                available = cachedTail - h;
+            }
+            const std::size_t count = max < available ? max : available;
+            if (count == 0) {
+                return 0;
+            }
+            for (std::size_t i = 0; i < count; ++i) {
+                out[i] = std::move(slots[(h + i) & mask]);
+            }
+            head.store(h + count, std::memory_order_release);
+            popCount.store(popCount.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+            this->signalNotFull();
+            return count;
+        }
+
+    private:
+        const std::size_t mask;
+        std::vector<T> slots;
+        std::atomic<bool> closed{false};
+
+        // Producer-owned line: write index, its view of head and its counters.
+        alignas(kCacheLine) std::atomic<std::size_t> tail{0};
+        std::size_t cachedHead = 0;
+        std::atomic<std::uint64_t> pushCount{0};
+        std::atomic<std::uint64_t> fullWaitCount{0};
+
+        // Consumer-owned line.
+        alignas(kCacheLine) std::atomic<std::size_t> head{0};
+        std::size_t cachedTail = 0;
+        std::atomic<std::uint64_t> popCount{0};
+        std::atomic<std::uint64_t> emptyWaitCount{0};
+
+        alignas(kCacheLine) char tailPadding[1] = {};
+    };
+
+    template <typename T, typename Wait = SpinWait>
+    class MpmcRing : public detail::BlockingOps<MpmcRing<T, Wait>, T, Wait> {
+        friend class detail::BlockingOps<MpmcRing<T, Wait>, T, Wait>;
+
+    public:
+        explicit MpmcRing(std::size_t capacity)
+            : mask(detail::roundUpPow2(capacity) - 1), slots(mask + 1) {
+            for (std::size_t i = 0; i <= mask; ++i) {
+                slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        MpmcRing(const MpmcRing&) = delete;
+        MpmcRing& operator=(const MpmcRing&) = delete;
+
+        std::size_t capacity() const { return mask + 1; }
+
+        std::size_t size() const {
+            const std::size_t t = tail.load(std::memory_order_acquire);
+            const std::size_t h = head.load(std::memory_order_acquire);
+            return t > h ? t - h : 0;
+        }
+
+        bool isClosed() const { return closed.load(std::memory_order_acquire); }
+
+        RingStats stats() const {
+            return { pushCount.load(std::memory_order_relaxed), popCount.load(std::memory_order_relaxed),
+                     fullWaitCount.load(std::memory_order_relaxed), emptyWaitCount.load(std::memory_order_relaxed) };
+        }
+
+        bool tryPush(T&& value) {
+            if (!claimPush(value)) {
+                return false;
+            }
+            pushCount.fetch_add(1, std::memory_order_relaxed);
+            this->signalNotEmpty();
+            return true;
+        }
+
+        bool tryPush(const T& value) {
+            T copy(value);
+            return tryPush(std::move(copy));
+        }
+
+        // Slots are claimed one by one (other producers may interleave), but the
+        // counters and the wake-up are paid once per batch.
+        std::size_t tryPushBatch(T* items, std::size_t n) {
+            std::size_t count = 0;
+            while (count < n && claimPush(items[count])) {
+                ++count;
+            }
+            if (count) {
+                pushCount.fetch_add(count, std::memory_order_relaxed);
+                this->signalNotEmpty();
+            }
+            return count;
+        }
+
+        bool tryPop(T& out) {
+            if (!claimPop(out)) {
+                return false;
+            }
+            popCount.fetch_add(1, std::memory_order_relaxed);
+            this->signalNotFull();
+            return true;
+        }
+
+        std::size_t tryPopBatch(T* out, std::size_t max) {
+            std::size_t count = 0;
+            while (count < max && claimPop(out[count])) {
+                ++count;
+            }
+            if (count) {
+                popCount.fetch_add(count, std::memory_order_relaxed);
+                this->signalNotFull();
+            }
+            return count;
+        }
+
+    private:
+        struct Slot {
+            std::atomic<std::size_t> sequence;
+            T value;
+        };
+
+        bool claimPush(T& value) {
+            if (isClosed()) {
+                return false;
+            }
+            std::size_t pos = tail.load(std::memory_order_relaxed);
+            for (;;) {
+                Slot& slot = slots[pos & mask];
+                const std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+                const std::intptr_t diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+                if (diff == 0) {
+                    if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        slot.value = std::move(value);
+                        slot.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = tail.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool claimPop(T& out) {
+            std::size_t pos = head.load(std::memory_order_relaxed);
+            for (;;) {
+                Slot& slot = slots[pos & mask];
+                const std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+                const std::intptr_t diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+                if (diff == 0) {
+                    if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        out = std::move(slot.value);
+                        slot.sequence.store(pos + mask + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = head.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        const std::size_t mask;
+        std::vector<Slot> slots;
+        std::atomic<bool> closed{false};
+
+        alignas(kCacheLine) std::atomic<std::size_t> tail{0};
+        std::atomic<std::uint64_t> pushCount{0};
+        std::atomic<std::uint64_t> fullWaitCount{0};
+
+        alignas(kCacheLine) std::atomic<std::size_t> head{0};
+        std::atomic<std::uint64_t> popCount{0};
+        std::atomic<std::uint64_t> emptyWaitCount{0};
+
+        alignas(kCacheLine) char tailPadding[1] = {};
+    };
+
+} // namespace utils
+} // namespace hexarch
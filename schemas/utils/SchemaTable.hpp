@@ -0,0 +1,128 @@
+#pragma once
+
+#include "utils/WireCodec.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace hexarch {
+namespace utils {
+namespace schema {
+
+    // Compile-time description of a component's datagram set, for the
+    // DatagramSchema header that "Generate Datagram Codecs" writes next to the
+    // codecs from the program XML and the datagram definitions.
+    //
+    // Everything here is constexpr data: field layouts, keys and pub/sub roles
+    // are tables in .rodata, a datagram name resolves through a perfect hash
+    // (two hashes and one string compare), and dispatch on a received record
+    // is a switch over layout fingerprints. Nothing is parsed at startup.
+
+    enum class FieldType : std::uint8_t { Bool, Int8, UInt8, Int16, UInt16, Int32, UInt32, Int64, UInt64, Float, Double, String };
+
+    constexpr const char* toString(FieldType type) {
+        switch (type) {
+            case FieldType::Bool: return "bool";
+            case FieldType::Int8: return "int8";
+            case FieldType::UInt8: return "uint8";
+            case FieldType::Int16: return "int16";
+            case FieldType::UInt16: return "uint16";
+            case FieldType::Int32: return "int32";
+            case FieldType::UInt32: return "uint32";
+            case FieldType::Int64: return "int64";
+            case FieldType::UInt64: return "uint64";
+            case FieldType::Float: return "float";
+            case FieldType::Double: return "double";
+            case FieldType::String: return "string";
+        }
+        return "unknown";
+    }
+
+    // The component's role for a datagram, from the program XML.
+    enum class Role : std::uint8_t { None = 0, Pub = 1, Sub = 2, PubSub = 3 };
+
+    constexpr bool publishes(Role role) { return (static_cast<unsigned>(role) & 1u) != 0; }
+    constexpr bool subscribes(Role role) { return (static_cast<unsigned>(role) & 2u) != 0; }
+
+    struct FieldInfo {
+        std::string_view name;
+        FieldType type;
+        // Offset in the payload (after the wire header) and size on the wire;
+        // strings take a 2-byte length plus their fixed capacity.
+        std::uint32_t offset;
+        std::uint32_t size;
+        bool key;
+    };
+
+    struct DatagramInfo {
+        std::string_view name;
+        std::uint16_t version;
+        std::uint32_t fingerprint;
+        std::uint32_t payloadSize;
+        Role role;
+        const FieldInfo* fields;
+        std::size_t fieldCount;
+
+        constexpr const FieldInfo* begin() const { return fields; }
+        constexpr const FieldInfo* end() const { return fields + fieldCount; }
+
+        // nullptr when there is no such field.
+        constexpr const FieldInfo* field(std::string_view fieldName) const {
+            for (std::size_t i = 0; i < fieldCount; ++i) {
+                if (fields[i].name == fieldName) {
+                    return &fields[i];
+                }
+            }
+            return nullptr;
+        }
+    };
+
+    // Seeded FNV-1a with a murmur finaliser. The generator searches seeds with
+    // the same function, so both sides must stay in step.
+    constexpr std::uint32_t nameHash(std::string_view name, std::uint32_t seed) {
+        std::uint32_t h = 0x811c9dc5u ^ seed;
+        for (char c : name) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 0x01000193u;
+        }
+        h ^= h >> 16;
+        h *= 0x85ebca6bu;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35u;
+        h ^= h >> 16;
+        return h;
+    }
+
+    // Hash-and-displace lookup: the name's bucket picks a seed that sends
+    // every name of that bucket to its own slot. Returns the index into
+    // datagrams, or -1 for an unknown name.
+    template <std::size_t Buckets, std::size_t Slots, std::size_t Count>
+    constexpr int perfectHashFind(std::string_view name, const std::uint32_t (&seeds)[Buckets],
+                                  const std::int16_t (&slots)[Slots], const DatagramInfo (&datagrams)[Count]) {
+        static_assert((Slots & (Slots - 1)) == 0, "slot count must be a power of two");
+        const std::uint32_t seed = seeds[nameHash(name, 0) % Buckets];
+        const int index = slots[nameHash(name, seed) & (Slots - 1)];
+        return index >= 0 && datagrams[index].name == name ? index : -1;
+    }
+
+    // Layout fingerprint of an encoded record, without decoding it. False if
+    // the buffer is too short or is not a datagram.
+    inline bool peekFingerprint(const unsigned char* bytes, std::size_t size, std::uint32_t& fingerprint) {
+        if (size < wire::kHeaderSize || wire::load<std::uint16_t>(bytes) != wire::kMagic) {
+            return false;
+        }
+        fingerprint = wire::load<std::uint32_t>(bytes + 4);
+        return true;
+    }
+
+    // Passed to visit() callbacks so they can name the datagram's codec:
+    //   visit(id, [&](auto tag) { using Codec = typename decltype(tag)::type; ... });
+    template <typename Codec>
+    struct CodecTag {
+        using type = Codec;
+    };
+
+} // namespace schema
+} // namespace utils
+} // namespace hexarch
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "utils/Bitmap.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace hexarch {
+namespace utils {
+
+    // Immutable array stored as fixed-size blocks that copies share.
+    //
+    // Meant as the value of a Versioned<T>: the next version is built with
+    // rebase() or with(), which copy only the blocks that differ and point at
+    // the previous version's blocks for the rest, so a small edit of a large
+    // grid costs one block plus the block table. A writer that tracks what it
+    // changed passes those blocks to rebase() and nothing else is read; without
+    // them rebase() compares every block. Blocks are never written after they
+    // are built; readers need no synchronisation of their own.
+    template <typename T>
+    class SharedBlocks {
+    public:
+        // Target block size for blockSizeForRows().
+        static constexpr std::size_t kBlockBytes = 4096;
+
+        SharedBlocks() = default;
+
+        // Moves leave the source empty, size() included.
+        SharedBlocks(const SharedBlocks&) = default;
+        SharedBlocks& operator=(const SharedBlocks&) = default;
+        SharedBlocks(SharedBlocks&& other) noexcept
+            : blocks(std::move(other.blocks)), total(std::exchange(other.total, 0)), blockLen(std::exchange(other.blockLen, 0)) {}
+        SharedBlocks& operator=(SharedBlocks&& other) noexcept {
+            if (this != &other) {
+                blocks = std::move(other.blocks);
+                total = std::exchange(other.total, 0);
+                blockLen = std::exchange(other.blockLen, 0);
+            }
+            return *this;
+        }
+
+        // Copies count values into blocks of blockSize elements (the last one
+        // may be shorter).
+        SharedBlocks(const T* values, std::size_t count, std::size_t blockSize)
+            : total(count), blockLen(blockSize) {
+            if (blockSize == 0) {
+                throw std::invalid_argument("SharedBlocks: block size must be positive");
+            }
+            blocks.reserve((count + blockSize - 1) / blockSize);
+            for (std::size_t first = 0; first < count; first += blockSize) {
+                blocks.push_back(makeBlock(values + first, std::min(blockSize, count - first)));
+            }
+        }
+
+        // Elements per block for rows of rowLength elements: whole rows, about
+        // kBlockBytes per block, at least one row.
+        static std::size_t blockSizeForRows(std::size_t rowLength) {
+            if (rowLength == 0) {
+                return 1;
+            }
+            return std::max<std::size_t>(1, kBlockBytes / (rowLength * sizeof(T))) * rowLength;
+        }
+
+        std::size_t size() const { return total; }
+        bool empty() const { return total == 0; }
+        std::size_t blockSize() const { return blockLen; }
+        std::size_t blockCount() const { return blocks.size(); }
+
+        const T& operator[](std::size_t i) const { return (*blocks[i / blockLen])[i % blockLen]; }
+
+        const T& at(std::size_t i) const {
+            if (i >= total) {
+                throw std::out_of_range("SharedBlocks: index out of range");
+            }
+            return (*this)[i];
+        }
+
+        const T* block(std::size_t b) const { return blocks[b]->data(); }
+        // Block holding element i.
+        std::size_t blockOf(std::size_t i) const { return i / blockLen; }
+        std::size_t blockLength(std::size_t b) const { return blocks[b]->size(); }
+
+        // fn(const T* values, std::size_t first, std::size_t count) per block,
+        // in order; scan loops over each block vectorize as over a flat array.
+        template <typename Fn>
+        void forEachBlock(Fn&& fn) const {
+            for (std::size_t b = 0; b < blocks.size(); ++b) {
+                fn(blocks[b]->data(), b * blockLen, blocks[b]->size());
+            }
+        }
+
+        void copyTo(T* out) const {
+            for (const auto& b : blocks) {
+                out = std::copy(b->begin(), b->end(), out);
+            }
+        }
+
+        // The same values as values[0, count), sharing every block of this one
+        // whose contents are equal. A different count starts from scratch.
+        SharedBlocks rebase(const T* values, std::size_t count) const {
+            if (count != total || blockLen == 0) {
+                return SharedBlocks(values, count, blockLen ? blockLen : std::max<std::size_t>(count, 1));
+            }
+            SharedBlocks next;
+            next.total = total;
+            next.blockLen = blockLen;
+            next.blocks.reserve(blocks.size());
+            for (std::size_t b = 0; b < blocks.size(); ++b) {
+                const T* fresh = values + b * blockLen;
+                const Block& mine = *blocks[b];
+                if (std::equal(mine.begin(), mine.end(), fresh)) {
+                    next.blocks.push_back(blocks[b]);
+                } else {
+                    next.blocks.push_back(makeBlock(fresh, mine.size()));
+                }
+            }
+            return next;
+        }
+
+        // The same values as values[0, count), trusting changedBlocks (one bit
+        // per block) for what differs: marked blocks are copied, the others
+        // shared without being read. A different count or bitmap size starts
+        // from scratch.
+        SharedBlocks rebase(const T* values, std::size_t count, const Bitmap& changedBlocks) const {
+            if (count != total || blockLen == 0 || changedBlocks.size() != blocks.size()) {
+                return SharedBlocks(values, count, blockLen ? blockLen : std::max<std::size_t>(count, 1));
+            }
+            SharedBlocks next(*this);
+            changedBlocks.forEachSet([&](std::size_t b) { next.blocks[b] = makeBlock(values + b * blockLen, blocks[b]->size()); });
+            return next;
+        }
+
+        // The blocks that hold the marked rows of rowLength elements, for
+        // rebase() from a writer that tracks rows.
+        Bitmap blocksOfRows(const Bitmap& rows, std::size_t rowLength) const {
+            Bitmap out(blocks.size());
+            if (rowLength != 0) {
+                rows.forEachSet([&](std::size_t r) {
+                    const std::size_t first = r * rowLength;
+                    if (first < total) {
+                        const std::size_t last = std::min(first + rowLength, total) - 1;
+                        for (std::size_t b = blockOf(first); b <= blockOf(last); ++b) {
+                            out.set(b);
+                        }
+                    }
+                });
+            }
+            return out;
+        }
+
+        // A copy with element i set to value; only its block is copied.
+        SharedBlocks with(std::size_t i, const T& value) const {
+            if (i >= total) {
+                throw std::out_of_range("SharedBlocks: index out of range");
+            }
+            SharedBlocks next(*this);
+            const std::size_t b = i / blockLen;
+            auto changed = std::make_shared<Block>(*blocks[b]);
+            (*changed)[i % blockLen] = value;
+            next.blocks[b] = std::move(changed);
+            return next;
+        }
+
+        // Blocks this and other have in common, i.e. were not copied between them.
+        std::size_t sharedBlockCount(const SharedBlocks& other) const {
+            std::size_t shared = 0;
+            for (std::size_t b = 0; b < std::min(blocks.size(), other.blocks.size()); ++b) {
+                shared += blocks[b] == other.blocks[b];
+            }
+            return shared;
+        }
+
+    private:
+        using Block = std::vector<T>;
+
+        static std::shared_ptr<const Block> makeBlock(const T* values, std::size_t count) {
+            return std::make_shared<const Block>(values, values + count);
+        }
+
+        std::vector<std::shared_ptr<const Block>> blocks;
+        std::size_t total = 0;
+        std::size_t blockLen = 0;
+    };
+
+} // namespace utils
+} // namespace hexarch
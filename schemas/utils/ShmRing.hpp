@@ -0,0 +1,557 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+namespace hexarch {
+namespace utils {
+
+    // Local IPC between co-located components (app, dark, white): one
+    // memory-mapped ring per datagram channel, one producer process and one
+    // consumer process.
+    //
+    // The ring lives in POSIX shared memory (/dev/shm/hexarch.<channel>) and
+    // outlives both sides, so either may start first or restart without losing
+    // what is queued. Records are variable-length and contiguous: the producer
+    // claim()s space, encodes straight into the mapping and commit()s; the
+    // consumer's poll() hands out pointers into the mapping, so a codec view
+    // decodes in place. Nothing is copied between encode and decode.
+    //
+    // A side that finds the ring full / empty spins briefly and then sleeps on
+    // a futex in the shared header; the other side wakes it only when it is
+    // actually asleep. Each side records its pid, so the other can tell a peer
+    // that never attached (Absent) from one that exited without detaching
+    // (Dead). Delivery is at-least-once across a consumer crash: records are
+    // released at the end of each poll().
+    //
+    //   ShmProducer out("Customer");                ShmConsumer in("Customer");
+    //   unsigned char* p = out.claim(n);            in.wait(100ms);
+    //   out.commit(CustomerCodec::encode(m, p, n)); in.poll([](const unsigned char* p, std::size_t n) { ... });
+
+    constexpr std::size_t kShmDefaultCapacity = std::size_t(1) << 20;
+
+    enum class PeerState : std::uint8_t { Absent, Alive, Dead };
+
+    inline const char* toString(PeerState state) {
+        switch (state) {
+        case PeerState::Absent: return "absent";
+        case PeerState::Alive: return "alive";
+        default: return "dead";
+        }
+    }
+
+    // Both sides' counters, read from the shared header.
+    struct ShmStats {
+        std::uint64_t written;
+        std::uint64_t read;
+        std::uint64_t bytesWritten;
+        // Claims that found the ring full and had to wait / gave up.
+        std::uint64_t fullWaits;
+        std::uint64_t dropped;
+        // wait() calls that found the ring empty and slept.
+        std::uint64_t emptyWaits;
+        // Ring bytes (with record headers) committed but not yet released.
+        std::uint64_t backlogBytes;
+    };
+
+    namespace detail {
+
+        constexpr std::uint32_t kShmMagic = 0x48584952; // "HXIR"
+        constexpr std::uint32_t kShmVersion = 1;
+        constexpr std::size_t kShmRecordHeader = 8;
+        constexpr std::uint32_t kShmData = 0;
+        constexpr std::uint32_t kShmPadding = 1;
+        // How often a sleeping side wakes up to check on its peer.
+        constexpr std::chrono::milliseconds kShmLivenessSlice{ 50 };
+
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "shared counters must be lock-free");
+        static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "futex word must be 32 bits");
+
+        // One side's state; each on its own cache line so the two processes do
+        // not false-share.
+        struct alignas(64) ShmSide {
+            // Producer: bytes published. Consumer: bytes released.
+            std::atomic<std::uint64_t> position;
+            std::atomic<std::uint64_t> records;
+            std::atomic<std::uint64_t> bytes;
+            std::atomic<std::uint64_t> waits;
+            std::atomic<std::uint64_t> dropped;
+            std::atomic<std::int32_t> pid;
+            // Futex word the other side bumps to wake this one, and whether
+            // this side is (about to be) asleep on it.
+            std::atomic<std::uint32_t> epoch;
+            std::atomic<std::uint32_t> sleeping;
+        };
+
+        struct ShmHeader {
+            // Written last by the creator; openers wait for it.
+            std::atomic<std::uint32_t> magic;
+            std::uint32_t version;
+            std::uint64_t capacity;
+            ShmSide producer;
+            ShmSide consumer;
+        };
+
+        constexpr std::size_t kShmDataOffset = (sizeof(ShmHeader) + 63) / 64 * 64;
+
+        inline std::size_t alignRecord(std::size_t size) {
+            return (size + 7) & ~std::size_t(7);
+        }
+
+        inline PeerState peerState(const ShmSide& side) {
+            const std::int32_t pid = side.pid.load(std::memory_order_acquire);
+            if (pid == 0) {
+                return PeerState::Absent;
+            }
+            // Signal 0 only checks that the pid exists. Assumes both sides
+            // share a pid namespace.
+            return ::kill(pid, 0) == 0 || errno == EPERM ? PeerState::Alive : PeerState::Dead;
+        }
+
+        inline void futexWait(std::atomic<std::uint32_t>& word, std::uint32_t seen, std::chrono::nanoseconds timeout) {
+#ifdef __linux__
+            const auto secs = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+            timespec ts{};
+            ts.tv_sec = static_cast<time_t>(secs.count());
+            ts.tv_nsec = static_cast<long>((timeout - secs).count());
+            // Not FUTEX_WAIT_PRIVATE: the word is shared between processes.
+            syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT, seen, &ts, nullptr, 0);
+#else
+            (void)word;
+            (void)seen;
+            std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(timeout, std::chrono::microseconds(50)));
+#endif
+        }
+
+        inline void futexWake(std::atomic<std::uint32_t>& word) {
+#ifdef __linux__
+            syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#else
+            (void)word;
+#endif
+        }
+
+        // Wakes the side if it is asleep; a fence and a load otherwise.
+        inline void notify(ShmSide& side) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (side.sleeping.load(std::memory_order_seq_cst) == 0) {
+                return;
+            }
+            side.epoch.fetch_add(1, std::memory_order_release);
+            futexWake(side.epoch);
+        }
+
+        // Spins, then sleeps on self until ready() or the deadline. Wakes every
+        // kShmLivenessSlice to ask giveUp() whether the peer is still worth
+        // waiting for.
+        template <typename Ready, typename GiveUp>
+        bool sleepUntil(ShmSide& self, std::chrono::steady_clock::time_point deadline, Ready&& ready, GiveUp&& giveUp) {
+            for (int i = 0; i < 128; ++i) {
+                if (ready()) {
+                    return true;
+                }
+#if defined(__x86_64__) || defined(__i386__)
+                __builtin_ia32_pause();
+#endif
+            }
+            for (;;) {
+                const auto now = std::chrono::steady_clock::now();
+                if (now >= deadline || giveUp()) {
+                    return ready();
+                }
+                self.sleeping.store(1, std::memory_order_seq_cst);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                const std::uint32_t seen = self.epoch.load(std::memory_order_acquire);
+                if (ready()) {
+                    self.sleeping.store(0, std::memory_order_relaxed);
+                    return true;
+                }
+                futexWait(self.epoch, seen, std::min<std::chrono::nanoseconds>(deadline - now, kShmLivenessSlice));
+                self.sleeping.store(0, std::memory_order_relaxed);
+                if (ready()) {
+                    return true;
+                }
+            }
+        }
+
+        // Creates or opens /hexarch.<channel> and maps it. Whoever creates the
+        // segment sizes and initialises it; an opener waits for the magic.
+        class ShmSegment {
+        public:
+            ShmSegment(const std::string& channel, std::size_t capacity) {
+                if (channel.empty() || channel.find('/') != std::string::npos) {
+                    throw std::invalid_argument("ShmRing: channel name must be non-empty and contain no '/'");
+                }
+                if (capacity < 4096 || (capacity & (capacity - 1)) != 0) {
+                    throw std::invalid_argument("ShmRing: capacity must be a power of two of at least 4096");
+                }
+                const std::string name = segmentName(channel);
+                bool creator = true;
+                int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+                if (fd < 0 && errno == EEXIST) {
+                    creator = false;
+                    fd = ::shm_open(name.c_str(), O_RDWR, 0);
+                }
+                if (fd < 0) {
+                    throw std::runtime_error("ShmRing: cannot open " + name + ": " + std::strerror(errno));
+                }
+                const std::size_t total = kShmDataOffset + capacity;
+                if (creator && ::ftruncate(fd, static_cast<off_t>(total)) != 0) {
+                    const int err = errno;
+                    ::close(fd);
+                    ::shm_unlink(name.c_str());
+                    throw std::runtime_error("ShmRing: cannot size " + name + ": " + std::strerror(err));
+                }
+                if (!creator) {
+                    waitForSize(fd, name, capacity);
+                }
+                void* mapping = ::mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                ::close(fd);
+                if (mapping == MAP_FAILED) {
+                    throw std::runtime_error("ShmRing: cannot map " + name + ": " + std::strerror(errno));
+                }
+                base = static_cast<unsigned char*>(mapping);
+                length = total;
+                if (creator) {
+                    // ftruncate zero-fills, which is every counter's initial value.
+                    ShmHeader* h = new (base) ShmHeader;
+                    h->version = kShmVersion;
+                    h->capacity = capacity;
+                    h->magic.store(kShmMagic, std::memory_order_release);
+                } else {
+                    checkHeader(name, capacity);
+                }
+            }
+
+            ~ShmSegment() {
+                ::munmap(base, length);
+            }
+
+            ShmSegment(const ShmSegment&) = delete;
+            ShmSegment& operator=(const ShmSegment&) = delete;
+
+            ShmHeader& header() const { return *reinterpret_cast<ShmHeader*>(base); }
+            unsigned char* data() const { return base + kShmDataOffset; }
+            std::size_t capacity() const { return length - kShmDataOffset; }
+
+            static std::string segmentName(const std::string& channel) {
+                return "/hexarch." + channel;
+            }
+
+        private:
+            static void waitForSize(int fd, const std::string& name, std::size_t capacity) {
+                const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+                struct stat st {};
+                while (::fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) < kShmDataOffset) {
+                    if (std::chrono::steady_clock::now() > deadline) {
+                        ::close(fd);
+                        throw std::runtime_error("ShmRing: " + name + " was never initialised; remove it and restart");
+                    }
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                if (static_cast<std::size_t>(st.st_size) != kShmDataOffset + capacity) {
+                    ::close(fd);
+                    throw std::runtime_error("ShmRing: " + name + " has capacity " +
+                                             std::to_string(st.st_size - static_cast<off_t>(kShmDataOffset)) + ", not " + std::to_string(capacity));
+                }
+            }
+
+            void checkHeader(const std::string& name, std::size_t capacity) const {
+                const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+                while (header().magic.load(std::memory_order_acquire) != kShmMagic) {
+                    if (std::chrono::steady_clock::now() > deadline) {
+                        throw std::runtime_error("ShmRing: " + name + " was never initialised; remove it and restart");
+                    }
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                if (header().version != kShmVersion || header().capacity != capacity) {
+                    throw std::runtime_error("ShmRing: " + name + " has an incompatible layout; remove it and restart");
+                }
+            }
+
+            unsigned char* base = nullptr;
+            std::size_t length = 0;
+        };
+
+        // Claims one side of the ring for this process, refusing if a live
+        // process (this one included) already holds it.
+        inline void attachSide(ShmSide& side, const char* owner, const char* role, const std::string& channel) {
+            const std::int32_t self = static_cast<std::int32_t>(::getpid());
+            std::int32_t current = side.pid.load(std::memory_order_acquire);
+            for (;;) {
+                if (current != 0 && (current == self || peerState(side) == PeerState::Alive)) {
+                    throw std::runtime_error(std::string(owner) + ": channel '" + channel + "' already has a live " +
+                                             role + " (pid " + std::to_string(current) + ")");
+                }
+                if (side.pid.compare_exchange_weak(current, self, std::memory_order_acq_rel)) {
+                    return;
+                }
+            }
+        }
+
+        inline ShmStats readStats(const ShmHeader& h) {
+            ShmStats s{};
+            s.written = h.producer.records.load(std::memory_order_relaxed);
+            s.bytesWritten = h.producer.bytes.load(std::memory_order_relaxed);
+            s.fullWaits = h.producer.waits.load(std::memory_order_relaxed);
+            s.dropped = h.producer.dropped.load(std::memory_order_relaxed);
+            s.read = h.consumer.records.load(std::memory_order_relaxed);
+            s.emptyWaits = h.consumer.waits.load(std::memory_order_relaxed);
+            s.backlogBytes = h.producer.position.load(std::memory_order_acquire) -
+                             h.consumer.position.load(std::memory_order_acquire);
+            return s;
+        }
+
+    } // namespace detail
+
+    // Writing side of a channel. Not thread-safe: one thread per producer.
+    class ShmProducer {
+    public:
+        explicit ShmProducer(std::string channel, std::size_t capacity = kShmDefaultCapacity)
+            : channel(std::move(channel)), segment(this->channel, capacity),
+              h(segment.header()), data(segment.data()), mask(segment.capacity() - 1) {
+            detail::attachSide(h.producer, "ShmProducer", "producer", this->channel);
+            head = h.producer.position.load(std::memory_order_acquire);
+            cachedTail = h.consumer.position.load(std::memory_order_acquire);
+        }
+
+        ~ShmProducer() {
+            h.producer.pid.store(0, std::memory_order_release);
+            detail::notify(h.consumer);
+        }
+
+        ShmProducer(const ShmProducer&) = delete;
+        ShmProducer& operator=(const ShmProducer&) = delete;
+
+        // Largest record claim() accepts.
+        std::size_t maxRecordSize() const {
+            return (mask + 1) / 2 - detail::kShmRecordHeader;
+        }
+
+        // Reserves size contiguous bytes in the mapping to encode into, waiting
+        // up to timeout for the consumer to free space. nullptr (and a drop in
+        // stats()) if it does not, or at once when the ring is full and the
+        // consumer is not running. Nothing is visible until commit().
+        unsigned char* claim(std::size_t size, std::chrono::nanoseconds timeout = std::chrono::milliseconds(100)) {
+            if (size > maxRecordSize()) {
+                throw std::length_error("ShmProducer: record of " + std::to_string(size) + " bytes exceeds the ring's maximum");
+            }
+            const std::size_t need = detail::kShmRecordHeader + detail::alignRecord(size);
+            const std::size_t offset = static_cast<std::size_t>(head & mask);
+            const std::size_t toEnd = mask + 1 - offset;
+            // A record never wraps: the tail of the ring becomes padding instead.
+            const std::size_t total = need <= toEnd ? need : toEnd + need;
+            if (!waitForSpace(total, timeout)) {
+                h.producer.dropped.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            if (need > toEnd) {
+                writeRecordHeader(offset, static_cast<std::uint32_t>(toEnd - detail::kShmRecordHeader), detail::kShmPadding);
+                head += toEnd;
+            }
+            claimed = size;
+            return data + static_cast<std::size_t>(head & mask) + detail::kShmRecordHeader;
+        }
+
+        // Publishes the first size bytes of the last claim (size <= claimed)
+        // and wakes the consumer if it sleeps.
+        void commit(std::size_t size) {
+            if (size > claimed) {
+                throw std::logic_error("ShmProducer: commit() larger than the claim");
+            }
+            writeRecordHeader(static_cast<std::size_t>(head & mask), static_cast<std::uint32_t>(size), detail::kShmData);
+            head += detail::kShmRecordHeader + detail::alignRecord(size);
+            claimed = 0;
+            h.producer.position.store(head, std::memory_order_release);
+            h.producer.records.fetch_add(1, std::memory_order_relaxed);
+            h.producer.bytes.fetch_add(size, std::memory_order_relaxed);
+            detail::notify(h.consumer);
+        }
+
+        // claim() + copy + commit() for bytes that are already encoded.
+        bool send(const void* bytes, std::size_t size, std::chrono::nanoseconds timeout = std::chrono::milliseconds(100)) {
+            unsigned char* out = claim(size, timeout);
+            if (out == nullptr) {
+                return false;
+            }
+            std::memcpy(out, bytes, size);
+            commit(size);
+            return true;
+        }
+
+        PeerState consumer() const { return detail::peerState(h.consumer); }
+        ShmStats stats() const { return detail::readStats(h); }
+        const std::string& name() const { return channel; }
+
+    private:
+        bool waitForSpace(std::size_t total, std::chrono::nanoseconds timeout) {
+            const std::size_t capacity = mask + 1;
+            if (head + total - cachedTail <= capacity) {
+                return true;
+            }
+            auto fits = [&] {
+                cachedTail = h.consumer.position.load(std::memory_order_acquire);
+                return head + total - cachedTail <= capacity;
+            };
+            if (fits()) {
+                return true;
+            }
+            if (timeout.count() <= 0 || consumer() != PeerState::Alive) {
+                return false;
+            }
+            h.producer.waits.fetch_add(1, std::memory_order_relaxed);
+            return detail::sleepUntil(h.producer, std::chrono::steady_clock::now() + timeout, fits,
+                                      [&] { return consumer() != PeerState::Alive; });
+        }
+
+        void writeRecordHeader(std::size_t offset, std::uint32_t size, std::uint32_t kind) {
+            std::memcpy(data + offset, &size, 4);
+            std::memcpy(data + offset + 4, &kind, 4);
+        }
+
+        std::string channel;
+        detail::ShmSegment segment;
+        detail::ShmHeader& h;
+        unsigned char* data;
+        std::uint64_t mask;
+        std::uint64_t head = 0;
+        std::uint64_t cachedTail = 0;
+        std::size_t claimed = 0;
+    };
+
+    // Reading side of a channel. Not thread-safe: one thread per consumer,
+    // except for wake().
+    class ShmConsumer {
+    public:
+        explicit ShmConsumer(std::string channel, std::size_t capacity = kShmDefaultCapacity)
+            : channel(std::move(channel)), segment(this->channel, capacity),
+              h(segment.header()), data(segment.data()), mask(segment.capacity() - 1) {
+            detail::attachSide(h.consumer, "ShmConsumer", "consumer", this->channel);
+            tail = h.consumer.position.load(std::memory_order_acquire);
+        }
+
+        ~ShmConsumer() {
+            h.consumer.pid.store(0, std::memory_order_release);
+            detail::notify(h.producer);
+        }
+
+        ShmConsumer(const ShmConsumer&) = delete;
+        ShmConsumer& operator=(const ShmConsumer&) = delete;
+
+        // Calls fn(const unsigned char* bytes, std::size_t size) for up to
+        // maxRecords committed records, in order, with bytes pointing into the
+        // mapping (valid until fn returns), then releases them to the producer.
+        // If fn throws, that record counts as consumed. Returns the count.
+        template <typename Fn>
+        std::size_t poll(Fn&& fn, std::size_t maxRecords = SIZE_MAX) {
+            const std::uint64_t head = h.producer.position.load(std::memory_order_acquire);
+            std::uint64_t at = tail;
+            std::size_t count = 0;
+            try {
+                while (at != head && count < maxRecords) {
+                    const std::size_t offset = static_cast<std::size_t>(at & mask);
+                    std::uint32_t size;
+                    std::uint32_t kind;
+                    std::memcpy(&size, data + offset, 4);
+                    std::memcpy(&kind, data + offset + 4, 4);
+                    if (size > mask + 1 - offset - detail::kShmRecordHeader) {
+                        throw std::runtime_error("ShmConsumer: corrupt record in channel '" + channel + "'");
+                    }
+                    const std::uint64_t next = at + detail::kShmRecordHeader + detail::alignRecord(size);
+                    if (kind == detail::kShmPadding) {
+                        at = next;
+                        continue;
+                    }
+                    at = next;
+                    ++count;
+                    fn(static_cast<const unsigned char*>(data + offset + detail::kShmRecordHeader), static_cast<std::size_t>(size));
+                }
+            } catch (...) {
+                release(at, count);
+                throw;
+            }
+            release(at, count);
+            return count;
+        }
+
+        // Blocks until a record is committed or timeout passes. Gives up early
+        // (false) when the ring is empty and the producer has died.
+        // Also returns early after wake().
+        bool wait(std::chrono::nanoseconds timeout) {
+            auto ready = [&] { return h.producer.position.load(std::memory_order_acquire) != tail; };
+            auto readyOrWoken = [&] { return ready() || wakeRequested.load(std::memory_order_acquire); };
+            if (!readyOrWoken()) {
+                h.consumer.waits.fetch_add(1, std::memory_order_relaxed);
+                detail::sleepUntil(h.consumer, std::chrono::steady_clock::now() + timeout, readyOrWoken,
+                                   [&] { return producer() == PeerState::Dead; });
+            }
+            wakeRequested.exchange(false, std::memory_order_acq_rel);
+            return ready();
+        }
+
+        // Makes the wait() in progress on another thread return now, or the
+        // next one if none is; what the caller wrote before is visible to that
+        // thread once wait() returns. Safe to call from any thread.
+        void wake() {
+            wakeRequested.store(true, std::memory_order_release);
+            detail::notify(h.consumer);
+        }
+
+        bool empty() const {
+            return h.producer.position.load(std::memory_order_acquire) == tail;
+        }
+
+        PeerState producer() const { return detail::peerState(h.producer); }
+        ShmStats stats() const { return detail::readStats(h); }
+        const std::string& name() const { return channel; }
+
+    private:
+        void release(std::uint64_t at, std::size_t count) {
+            if (at == tail) {
+                return;
+            }
+            tail = at;
+            h.consumer.position.store(tail, std::memory_order_release);
+            h.consumer.records.fetch_add(count, std::memory_order_relaxed);
+            detail::notify(h.producer);
+        }
+
+        std::string channel;
+        detail::ShmSegment segment;
+        detail::ShmHeader& h;
+        unsigned char* data;
+        std::uint64_t mask;
+        std::uint64_t tail = 0;
+        std::atomic<bool> wakeRequested{ false };
+    };
+
+    // Deletes a channel's segment. Processes that have it mapped keep using
+    // their mapping; the next ShmProducer/ShmConsumer creates a fresh one.
+    inline bool removeShmChannel(const std::string& channel) {
+        return ::shm_unlink(detail::ShmSegment::segmentName(channel).c_str()) == 0;
+    }
+
+} // namespace utils
+} // namespace hexarch
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstddef>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HEXARCH_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace hexarch {
+namespace utils {
+
+    // Dot-product kernel families; Scalar is always available.
+    enum class DotKernel { Scalar, Avx2, Avx512 };
+
+    // Rows handled per call, so the shared operand is loaded once for all of them.
+    constexpr std::size_t kDotTile = 4;
+
+    // out[j] = sum_i w[i] * x[j][i] for j < count (count <= kDotTile).
+    // The SIMD kernels use aligned loads: w and every x[j] must be 64-byte aligned
+    // and n a multiple of 64 / sizeof(T), zero-padded past the real length.
+    template <typename T>
+    using DotTileFn = void (*)(const T* w, const T* const* x, std::size_t n, std::size_t count, T* out);
+
+    namespace detail {
+
+        template <typename T>
+        void dotScalar(const T* w, const T* const* x, std::size_t n, std::size_t count, T* out) {
+            for (std::size_t j = 0; j < count; ++j) {
+                T acc = T();
+                for (std::size_t i = 0; i < n; ++i) {
+                    acc += w[i] * x[j][i];
+                }
+                out[j] = acc;
+            }
+        }
+
+#ifdef HEXARCH_X86_KERNELS
+
+        __attribute__((target("avx2,fma")))
+        inline double hsum(__m256d v) {
+            __m128d lo = _mm256_castpd256_pd128(v);
+            __m128d hi = _mm256_extractf128_pd(v, 1);
+            lo = _mm_add_pd(lo, hi);
+            return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+        }
+
+        __attribute__((target("avx2,fma")))
+        inline float hsum(__m256 v) {
+            __m128 lo = _mm256_castps256_ps128(v);
+            __m128 hi = _mm256_extractf128_ps(v, 1);
+            lo = _mm_add_ps(lo, hi);
+            lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+            return _mm_cvtss_f32(_mm_add_ss(lo, _mm_shuffle_ps(lo, lo, 1)));
+        }
+
+        template <std::size_t N>
+        __attribute__((target("avx2,fma")))
+        void dotAvx2Tile(const double* w, const double* const* x, std::size_t n, double* out) {
+            __m256d acc[N];
+            for (std::size_t j = 0; j < N; ++j) acc[j] = _mm256_setzero_pd();
+            for (std::size_t i = 0; i < n; i += 4) {
+                const __m256d wv = _mm256_load_pd(w + i);
+                for (std::size_t j = 0; j < N; ++j) acc[j] = _mm256_fmadd_pd(wv, _mm256_load_pd(x[j] + i), acc[j]);
+            }
+            for (std::size_t j = 0; j < N; ++j) out[j] = hsum(acc[j]);
+        }
+
+        template <std::size_t N>
+        __attribute__((target("avx2,fma")))
+        void dotAvx2Tile(const float* w, const float* const* x, std::size_t n, float* out) {
+            __m256 acc[N];
+            for (std::size_t j = 0; j < N; ++j) acc[j] = _mm256_setzero_ps();
+            for (std::size_t i = 0; i < n; i += 8) {
+                const __m256 wv = _mm256_load_ps(w + i);
+                for (std::size_t j = 0; j < N; ++j) acc[j] = _mm256_fmadd_ps(wv, _mm256_load_ps(x[j] + i), acc[j]);
+            }
+            for (std::size_t j = 0; j < N; ++j) out[j] = hsum(acc[j]);
+        }
+
+        // Spilling to memory sidesteps _mm512_reduce_add_*, whose GCC 12 expansion
+        // trips -Wuninitialized.
+        __attribute__((target("avx512f")))
+        inline double hsum(__m512d v) {
+            alignas(64) double lanes[8];
+            _mm512_store_pd(lanes, v);
+            return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+        }
+
+        __attribute__((target("avx512f")))
+        inline float hsum(__m512 v) {
+            alignas(64) float lanes[16];
+            _mm512_store_ps(lanes, v);
+            float sum = 0.0f;
+            for (float lane : lanes) sum += lane;
+            return sum;
+        }
+
+        template <std::size_t N>
+        __attribute__((target("avx512f")))
+        void dotAvx512Tile(const double* w, const double* const* x, std::size_t n, double* out) {
+            __m512d acc[N];
+            for (std::size_t j = 0; j < N; ++j) acc[j] = _mm512_setzero_pd();
+            for (std::size_t i = 0; i < n; i += 8) {
+                const __m512d wv = _mm512_load_pd(w + i);
+                for (std::size_t j = 0; j < N; ++j) acc[j] = _mm512_fmadd_pd(wv, _mm512_load_pd(x[j] + i), acc[j]);
+            }
+            for (std::size_t j = 0; j < N; ++j) out[j] = hsum(acc[j]);
+        }
+
+        template <std::size_t N>
+        __attribute__((target("avx512f")))
+        void dotAvx512Tile(const float* w, const float* const* x, std::size_t n, float* out) {
+            __m512 acc[N];
+            for (std::size_t j = 0; j < N; ++j) acc[j] = _mm512_setzero_ps();
+            for (std::size_t i = 0; i < n; i += 16) {
+                const __m512 wv = _mm512_load_ps(w + i);
+                for (std::size_t j = 0; j < N; ++j) acc[j] = _mm512_fmadd_ps(wv, _mm512_load_ps(x[j] + i), acc[j]);
+            }
+            for (std::size_t j = 0; j < N; ++j) out[j] = hsum(acc[j]);
+        }
+
+        template <typename T>
+        void dotAvx2(const T* w, const T* const* x, std::size_t n, std::size_t count, T* out) {
+            switch (count) {
+                case 4: dotAvx2Tile<4>(w, x, n, out); break;
+                case 3: dotAvx2Tile<3>(w, x, n, out); break;
+                case 2: dotAvx2Tile<2>(w, x, n, out); break;
+                default: dotAvx2Tile<1>(w, x, n, out); break;
+            }
+        }
+
+        template <typename T>
+        void dotAvx512(const T* w, const T* const* x, std::size_t n, std::size_t count, T* out) {
+            switch (count) {
+                case 4: dotAvx512Tile<4>(w, x, n, out); break;
+                case 3: dotAvx512Tile<3>(w, x, n, out); break;
+                case 2: dotAvx512Tile<2>(w, x, n, out); break;
+                default: dotAvx512Tile<1>(w, x, n, out); break;
+            }
+        }
+
+#endif
+
+    }
+
+    inline bool dotKernelSupported(DotKernel kernel) {
+#ifdef HEXARCH_X86_KERNELS
+        __builtin_cpu_init();
+        switch (kernel) {
+            case DotKernel::Avx512: return __builtin_cpu_supports("avx512f");
+            case DotKernel::Avx2: return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+            case DotKernel::Scalar: return true;
+        }
+        return false;
+#else
+        return kernel == DotKernel::Scalar;
+#endif
+    }
+
+    inline DotKernel bestDotKernel() {
+        if (dotKernelSupported(DotKernel::Avx512)) return DotKernel::Avx512;
+        if (dotKernelSupported(DotKernel::Avx2)) return DotKernel::Avx2;
+        return DotKernel::Scalar;
+    }
+
+    // Callers are expected to have checked dotKernelSupported(kernel).
+    template <typename T>
+    DotTileFn<T> selectDotTile(DotKernel kernel) {
+#ifdef HEXARCH_X86_KERNELS
+        if (kernel == DotKernel::Avx512) return &detail::dotAvx512<T>;
+        if (kernel == DotKernel::Avx2) return &detail::dotAvx2<T>;
+#endif
+        (void)kernel;
+        return &detail::dotScalar<T>;
+    }
+
+} // namespace utils
+} // namespace hexarch
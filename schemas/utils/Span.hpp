@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace hexarch {
+namespace utils {
+
+    // Non-owning view over contiguous elements: the subset of C++20 std::span the
+    // ports and adapters use, so batch interfaces can be spelled the same way
+    // under C++17. Span<const T> binds to vectors, arrays and pointer + count.
+    template <typename T>
+    class Span {
+    public:
+        using element_type = T;
+        using value_type = typename std::remove_cv<T>::type;
+        using iterator = T*;
+
+        constexpr Span() noexcept = default;
+        constexpr Span(T* data, std::size_t size) noexcept : ptr(data), count(size) {}
+
+        template <std::size_t N>
+        constexpr Span(T (&array)[N]) noexcept : ptr(array), count(N) {}
+
+        template <typename Alloc>
+        Span(std::vector<value_type, Alloc>& v) noexcept : ptr(v.data()), count(v.size()) {}
+
+        template <typename Alloc, typename U = T, typename = typename std::enable_if<std::is_const<U>::value>::type>
+        Span(const std::vector<value_type, Alloc>& v) noexcept : ptr(v.data()), count(v.size()) {}
+
+        // Span<T> converts to Span<const T>.
+        template <typename U, typename = typename std::enable_if<std::is_convertible<U (*)[], T (*)[]>::value>::type>
+        constexpr Span(const Span<U>& other) noexcept : ptr(other.data()), count(other.size()) {}
+
+        constexpr T* data() const noexcept { return ptr; }
+        constexpr std::size_t size() const noexcept { return count; }
+        constexpr bool empty() const noexcept { return count == 0; }
+
+        constexpr T* begin() const noexcept { return ptr; }
+        constexpr T* end() const noexcept { return ptr + count; }
+
+        constexpr T& operator[](std::size_t i) const { return ptr[i]; }
+        T& front() const { return ptr[0]; }
+        T& back() const { return ptr[count - 1]; }
+
+        Span subspan(std::size_t offset, std::size_t n) const {
+            if (offset > count || n > count - offset) {
+                throw std::out_of_range("Span: subspan out of range");
+            }
+            return Span(ptr + offset, n);
+        }
+
+        Span first(std::size_t n) const { return subspan(0, n); }
+
+    private:
+        T* ptr = nullptr;
+        std::size_t count = 0;
+    };
+
+} // namespace utils
+} // namespace hexarch
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hexarch {
+namespace utils {
+
+    // Fixed-size worker pool. submit() queues fire-and-forget tasks; parallelFor()
+    // splits an index range into chunks and blocks until every chunk has run,
+    // with the calling thread taking part in the work.
+    class ThreadPool {
+    public:
+        explicit ThreadPool(std::size_t threads = std::thread::hardware_concurrency()) {
+            threads = std::max<std::size_t>(threads, 1);
+            workers.reserve(threads);
+            for (std::size_t i = 0; i < threads; ++i) {
+                workers.emplace_back([this] { workerLoop(); });
+            }
+        }
+
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (std::thread& t : workers) {
+                t.join();
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        std::size_t size() const { return workers.size(); }
+
+        void submit(std::function<void()> task) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                tasks.push_back(std::move(task));
+            }
+            wake.notify_one();
+        }
+
+        // Calls fn(chunkBegin, chunkEnd) over [begin, end) in chunks of at least `grain`.
+        // If fn throws, every chunk already queued still finishes before the
+        // first exception is rethrown here.
+        template <typename Fn>
+        void parallelFor(std::size_t begin, std::size_t end, std::size_t grain, Fn&& fn) {
+            if (begin >= end) {
+                return;
+            }
+            grain = std::max<std::size_t>(grain, 1);
+            const std::size_t total = end - begin;
+            const std::size_t maxChunks = (total + grain - 1) / grain;
+            const std::size_t chunks = std::min(maxChunks, workers.size() + 1);
+            if (chunks <= 1) {
+                fn(begin, end);
+                return;
+            }
+
+            const std::size_t step = (total + chunks - 1) / chunks;
+            struct Join {
+                std::mutex mutex;
+                std::condition_variable cv;
+                std::size_t pending = 0;
+                std::exception_ptr error;
+
+                void fail(std::exception_ptr e) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error) {
+                        error = std::move(e);
+                    }
+                }
+
+                // Queued chunks reference fn and this object, so nothing may
+                // leave parallelFor, by return or by exception, before they ran.
+                ~Join() {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait(lock, [this] { return pending == 0; });
+                }
+            } join;
+
+            for (std::size_t c = 1; c < chunks; ++c) {
+                const std::size_t lo = begin + c * step;
+                const std::size_t hi = std::min(end, lo + step);
+                {
+                    std::lock_guard<std::mutex> lock(join.mutex);
+                    ++join.pending;
+                }
+                try {
+                    submit([&join, &fn, lo, hi] {
+                        try {
+                            if (lo < hi) {
+                                fn(lo, hi);
+                            }
+                        } catch (...) {
+                            join.fail(std::current_exception());
+                        }
+                        std::lock_guard<std::mutex> lock(join.mutex);
+                        if (--join.pending == 0) {
+                            join.cv.notify_one();
+                        }
+                    });
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(join.mutex);
+                    --join.pending;
+                    throw;
+                }
+            }
+
+            try {
+                fn(begin, std::min(end, begin + step));
+            } catch (...) {
+                join.fail(std::current_exception());
+            }
+
+            std::unique_lock<std::mutex> lock(join.mutex);
+            join.cv.wait(lock, [&] { return join.pending == 0; });
+            if (join.error) {
+                std::rethrow_exception(join.error);
+            }
+        }
+
+    private:
+        void workerLoop() {
+            for (;;) {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    wake.wait(lock, [this] { return stopping || !tasks.empty(); });
+                    if (tasks.empty()) {
+                        return;
+                    }
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                }
+                task();
+            }
+        }
+
+        std::vector<std::thread> workers;
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+        std::condition_variable wake;
+        bool stopping = false;
+    };
+
+} // namespace utils
+} // namespace hexarch
@@ -0,0 +1,501 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace hexarch {
+namespace utils {
+
+    // Capture and replay of raw incoming traffic, for load-testing a component
+    // against real traffic shapes without a broker.
+    //
+    // TrafficRecorder appends each received datagram with its arrival time to a
+    // segmented log, <dir>/<channel>-NNNNNN.hxtl. Generated incoming adapters
+    // create one through TrafficRecorder::fromEnv(), i.e. only when
+    // HEXARCH_CAPTURE_DIR is set. TrafficReader maps the segments back in
+    // order, and replayTraffic() feeds them to a handler at the recorded pace,
+    // N times faster, or as fast as possible, and reports throughput and
+    // latency percentiles.
+    //
+    // Segment layout: a 32-byte header (magic, version, segment number, run
+    // id), then per record a LEB128 size, a LEB128 nanosecond delta since the
+    // previous record and the payload: 3-4 bytes of overhead per datagram. A
+    // torn record at the end of a crashed run is ignored on read.
+
+    constexpr const char* kCaptureDirEnv = "HEXARCH_CAPTURE_DIR";
+
+    namespace detail {
+
+        constexpr std::uint32_t kTrafficMagic = 0x4C544858; // "HXTL"
+        constexpr std::uint32_t kTrafficVersion = 1;
+        constexpr std::size_t kTrafficHeaderSize = 32;
+
+        struct TrafficSegmentHeader {
+            std::uint32_t magic;
+            std::uint32_t version;
+            std::uint64_t segment;
+            // system_clock ns when the recording run started; a change between
+            // segments marks a restart.
+            std::uint64_t run;
+            // Run-relative ns the segment's first delta counts from.
+            std::uint64_t base;
+        };
+        static_assert(sizeof(TrafficSegmentHeader) == kTrafficHeaderSize, "segment header layout");
+
+        inline std::size_t putVarint(unsigned char* out, std::uint64_t value) {
+            std::size_t n = 0;
+            while (value >= 0x80) {
+                out[n++] = static_cast<unsigned char>(value | 0x80);
+                value >>= 7;
+            }
+            out[n++] = static_cast<unsigned char>(value);
+            return n;
+        }
+
+        // Reads a varint from [at, end); false if it is cut off.
+        inline bool getVarint(const unsigned char*& at, const unsigned char* end, std::uint64_t& value) {
+            value = 0;
+            for (unsigned shift = 0; at < end && shift < 64; shift += 7) {
+                const unsigned char byte = *at++;
+                value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        inline std::string segmentPath(const std::string& dir, const std::string& channel, std::uint64_t segment) {
+            char suffix[32];
+            std::snprintf(suffix, sizeof(suffix), "-%06llu.hxtl", static_cast<unsigned long long>(segment));
+            return dir + "/" + channel + suffix;
+        }
+
+        // Segment numbers present for channel in dir, ascending.
+        inline std::vector<std::uint64_t> listSegments(const std::string& dir, const std::string& channel) {
+            std::vector<std::uint64_t> segments;
+            DIR* d = ::opendir(dir.c_str());
+            if (d == nullptr) {
+                return segments;
+            }
+            const std::string prefix = channel + "-";
+            while (const dirent* entry = ::readdir(d)) {
+                const std::string name = entry->d_name;
+                if (name.size() == prefix.size() + 11 && name.compare(0, prefix.size(), prefix) == 0 &&
+                    name.compare(name.size() - 5, 5, ".hxtl") == 0) {
+                    const std::string digits = name.substr(prefix.size(), 6);
+                    if (digits.find_first_not_of("0123456789") == std::string::npos) {
+                        segments.push_back(std::strtoull(digits.c_str(), nullptr, 10));
+                    }
+                }
+            }
+            ::closedir(d);
+            std::sort(segments.begin(), segments.end());
+            return segments;
+        }
+
+    } // namespace detail
+
+    // Appends one channel's raw records to segment files. Not thread-safe:
+    // record from the adapter's polling thread.
+    class TrafficRecorder {
+    public:
+        static constexpr std::size_t kDefaultSegmentBytes = std::size_t(64) << 20;
+
+        // Continues after the highest segment already in dir, so several runs
+        // of a component form one log.
+        TrafficRecorder(std::string dir, std::string channel, std::size_t segmentBytes = kDefaultSegmentBytes)
+            : dir(std::move(dir)), channel(std::move(channel)), segmentBytes(segmentBytes),
+              run(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  std::chrono::system_clock::now().time_since_epoch()).count())),
+              start(std::chrono::steady_clock::now()) {
+            if (this->channel.empty() || this->channel.find('/') != std::string::npos) {
+                throw std::invalid_argument("TrafficRecorder: channel name must be non-empty and contain no '/'");
+            }
+            if (::mkdir(this->dir.c_str(), 0755) != 0 && errno != EEXIST) {
+                throw std::runtime_error("TrafficRecorder: cannot create " + this->dir + ": " + std::strerror(errno));
+            }
+            const std::vector<std::uint64_t> existing = detail::listSegments(this->dir, this->channel);
+            segment = existing.empty() ? 0 : existing.back();
+            buffer.reserve(kBufferBytes);
+        }
+
+        // A recorder for channel when HEXARCH_CAPTURE_DIR is set, nullptr otherwise.
+        static std::unique_ptr<TrafficRecorder> fromEnv(const std::string& channel) {
+            const char* dir = std::getenv(kCaptureDirEnv);
+            if (dir == nullptr || *dir == '\0') {
+                return nullptr;
+            }
+            return std::unique_ptr<TrafficRecorder>(new TrafficRecorder(dir, channel));
+        }
+
+        ~TrafficRecorder() {
+            try {
+                close();
+            } catch (...) {
+            }
+        }
+
+        TrafficRecorder(const TrafficRecorder&) = delete;
+        TrafficRecorder& operator=(const TrafficRecorder&) = delete;
+
+        // Records one datagram as received now.
+        void append(const void* bytes, std::size_t size) {
+            const std::uint64_t now = static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+            const std::size_t recordBytes = 20 + size;
+            const std::size_t used = written + buffer.size();
+            if (fd < 0 || (used + recordBytes > segmentBytes && used > detail::kTrafficHeaderSize)) {
+                roll(now);
+            }
+            unsigned char prefix[20];
+            std::size_t n = detail::putVarint(prefix, size);
+            n += detail::putVarint(prefix + n, now - last);
+            last = now;
+            buffer.insert(buffer.end(), prefix, prefix + n);
+            buffer.insert(buffer.end(), static_cast<const unsigned char*>(bytes), static_cast<const unsigned char*>(bytes) + size);
+            ++recorded;
+            if (buffer.size() >= kBufferBytes) {
+                flush();
+            }
+        }
+
+        // Writes buffered records to the current segment.
+        void flush() {
+            const unsigned char* at = buffer.data();
+            std::size_t left = buffer.size();
+            while (left > 0) {
+                const ssize_t n = ::write(fd, at, left);
+                if (n < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw std::runtime_error("TrafficRecorder: write to " + path + " failed: " + std::strerror(errno));
+                }
+                at += n;
+                left -= static_cast<std::size_t>(n);
+            }
+            written += buffer.size();
+            buffer.clear();
+        }
+
+        std::uint64_t records() const { return recorded; }
+        const std::string& currentSegment() const { return path; }
+
+    private:
+        static constexpr std::size_t kBufferBytes = 64 * 1024;
+
+        void close() {
+            if (fd >= 0) {
+                flush();
+                ::close(fd);
+                fd = -1;
+            }
+        }
+
+        void roll(std::uint64_t now) {
+            close();
+            ++segment;
+            path = detail::segmentPath(dir, channel, segment);
+            fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (fd < 0) {
+                throw std::runtime_error("TrafficRecorder: cannot create " + path + ": " + std::strerror(errno));
+            }
+            detail::TrafficSegmentHeader header{ detail::kTrafficMagic, detail::kTrafficVersion, segment, run, now };
+            const unsigned char* raw = reinterpret_cast<const unsigned char*>(&header);
+            buffer.insert(buffer.end(), raw, raw + sizeof(header));
+            written = 0;
+            last = now;
+        }
+
+        std::string dir;
+        std::string channel;
+        std::size_t segmentBytes;
+        std::uint64_t run;
+        std::chrono::steady_clock::time_point start;
+        std::uint64_t segment = 0;
+        std::string path;
+        int fd = -1;
+        std::size_t written = 0;
+        std::uint64_t last = 0;
+        std::uint64_t recorded = 0;
+        std::vector<unsigned char> buffer;
+    };
+
+    // One logged datagram; data points into the mapped segment and stays
+    // valid until the next call to TrafficReader::next().
+    struct TrafficRecord {
+        const unsigned char* data;
+        std::size_t size;
+        // Arrival time, ns since the first record of the log.
+        std::uint64_t timestampNs;
+    };
+
+    // Reads a channel's segments in order, one mmap at a time. Restarts
+    // between recording runs are closed up, so time only moves forward.
+    class TrafficReader {
+    public:
+        TrafficReader(std::string dir, std::string channel)
+            : dir(std::move(dir)), channel(std::move(channel)), segments(detail::listSegments(this->dir, this->channel)) {
+            if (segments.empty()) {
+                throw std::runtime_error("TrafficReader: no " + this->channel + "-*.hxtl segments in " + this->dir);
+            }
+        }
+
+        ~TrafficReader() { unmap(); }
+
+        TrafficReader(const TrafficReader&) = delete;
+        TrafficReader& operator=(const TrafficReader&) = delete;
+
+        // Advances to the next record; false at the end of the log.
+        bool next(TrafficRecord& out) {
+            for (;;) {
+                if (at < end) {
+                    std::uint64_t size = 0;
+                    std::uint64_t delta = 0;
+                    const unsigned char* p = at;
+                    if (detail::getVarint(p, end, size) && detail::getVarint(p, end, delta) &&
+                        size <= static_cast<std::uint64_t>(end - p)) {
+                        segmentTime += delta;
+                        out.data = p;
+                        out.size = static_cast<std::size_t>(size);
+                        out.timestampNs = segmentTime + offset - first;
+                        at = p + size;
+                        lastTime = out.timestampNs;
+                        return true;
+                    }
+                    // Torn tail of a crashed run
+                    at = end;
+                }
+                if (!openNext()) {
+                    return false;
+                }
+            }
+        }
+
+        std::size_t segmentCount() const { return segments.size(); }
+
+    private:
+        bool openNext() {
+            unmap();
+            while (index < segments.size()) {
+                const std::string path = detail::segmentPath(dir, channel, segments[index++]);
+                const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd < 0) {
+                    throw std::runtime_error("TrafficReader: cannot open " + path + ": " + std::strerror(errno));
+                }
+                struct stat st {};
+                ::fstat(fd, &st);
+                const std::size_t size = static_cast<std::size_t>(st.st_size);
+                if (size < detail::kTrafficHeaderSize) {
+                    ::close(fd);
+                    continue;
+                }
+                void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                ::close(fd);
+                if (mapping == MAP_FAILED) {
+                    throw std::runtime_error("TrafficReader: cannot map " + path + ": " + std::strerror(errno));
+                }
+                ::madvise(mapping, size, MADV_SEQUENTIAL);
+                base = static_cast<const unsigned char*>(mapping);
+                length = size;
+                detail::TrafficSegmentHeader header;
+                std::memcpy(&header, base, sizeof(header));
+                if (header.magic != detail::kTrafficMagic || header.version != detail::kTrafficVersion) {
+                    throw std::runtime_error("TrafficReader: " + path + " is not a version " +
+                                             std::to_string(detail::kTrafficVersion) + " traffic log");
+                }
+                if (!started) {
+                    first = header.base;
+                    run = header.run;
+                    started = true;
+                } else if (header.run != run) {
+                    // New recording run: continue right after the previous one.
+                    offset = lastTime + first - header.base;
+                    run = header.run;
+                }
+                segmentTime = header.base;
+                at = base + detail::kTrafficHeaderSize;
+                end = base + size;
+                return true;
+            }
+            return false;
+        }
+
+        void unmap() {
+            if (base != nullptr) {
+                ::munmap(const_cast<unsigned char*>(base), length);
+                base = nullptr;
+                at = end = nullptr;
+            }
+        }
+
+        std::string dir;
+        std::string channel;
+        std::vector<std::uint64_t> segments;
+        std::size_t index = 0;
+        const unsigned char* base = nullptr;
+        std::size_t length = 0;
+        const unsigned char* at = nullptr;
+        const unsigned char* end = nullptr;
+        bool started = false;
+        std::uint64_t run = 0;
+        std::uint64_t first = 0;
+        std::uint64_t offset = 0;
+        std::uint64_t segmentTime = 0;
+        std::uint64_t lastTime = 0;
+    };
+
+    // Log-linear latency histogram in ns: exact below 16, then 16 buckets per
+    // power of two (within 6.25%).
+    class LatencyHistogram {
+    public:
+        void record(std::uint64_t ns) {
+            ++counts[bucketOf(ns)];
+            ++total;
+            maximum = std::max(maximum, ns);
+        }
+
+        // Upper bound of the bucket holding quantile q (0..1).
+        std::uint64_t quantile(double q) const {
+            if (total == 0) {
+                return 0;
+            }
+            const std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(total))));
+            std::uint64_t seen = 0;
+            for (std::size_t b = 0; b < kBuckets; ++b) {
+                seen += counts[b];
+                if (seen >= rank) {
+                    return std::min(maximum, b + 1 < kBuckets ? lowerBound(b + 1) - 1 : maximum);
+                }
+            }
+            return maximum;
+        }
+
+        std::uint64_t count() const { return total; }
+        std::uint64_t max() const { return maximum; }
+
+    private:
+        static constexpr unsigned kSubBits = 4;
+        static constexpr std::size_t kBuckets = (64 - kSubBits + 1) << kSubBits;
+
+        static std::size_t bucketOf(std::uint64_t v) {
+            if (v < (1u << kSubBits)) {
+                return static_cast<std::size_t>(v);
+            }
+            const unsigned top = 63 - static_cast<unsigned>(__builtin_clzll(v));
+            const unsigned shift = top - kSubBits;
+            return ((shift + 1) << kSubBits) + static_cast<std::size_t>((v >> shift) & ((1u << kSubBits) - 1));
+        }
+
+        static std::uint64_t lowerBound(std::size_t b) {
+            if (b < (1u << kSubBits)) {
+                return b;
+            }
+            const unsigned shift = static_cast<unsigned>(b >> kSubBits) - 1;
+            return (static_cast<std::uint64_t>((1u << kSubBits) | (b & ((1u << kSubBits) - 1)))) << shift;
+        }
+
+        std::vector<std::uint64_t> counts = std::vector<std::uint64_t>(kBuckets, 0);
+        std::uint64_t total = 0;
+        std::uint64_t maximum = 0;
+    };
+
+    struct ReplayOptions {
+        // 1 replays at the recorded pace, 10 ten times faster, 0 as fast as possible.
+        double speed = 1.0;
+        // Stop after this many records; 0 replays the whole log.
+        std::uint64_t limit = 0;
+    };
+
+    struct ReplayReport {
+        std::uint64_t records = 0;
+        std::uint64_t bytes = 0;
+        double seconds = 0.0;
+        // Span of the replayed records' timestamps.
+        double recordedSeconds = 0.0;
+        // Paced: from a record's due time to its handler returning, so falling
+        // behind shows up as queueing delay. As fast as possible: handler time.
+        LatencyHistogram latency;
+        // Records whose handler started after their due time (paced only).
+        std::uint64_t late = 0;
+    };
+
+    // Calls handler(const unsigned char* bytes, std::size_t size) for every
+    // record, waiting for each one's due time unless options.speed is 0.
+    // The handler runs on the calling thread; if it only enqueues, the
+    // latencies cover the enqueue.
+    template <typename Handler>
+    ReplayReport replayTraffic(TrafficReader& reader, const ReplayOptions& options, Handler&& handler) {
+        using Clock = std::chrono::steady_clock;
+        ReplayReport report;
+        const bool paced = options.speed > 0.0;
+        const Clock::time_point start = Clock::now();
+        std::uint64_t firstTs = 0;
+        TrafficRecord record{};
+        while ((options.limit == 0 || report.records < options.limit) && reader.next(record)) {
+            if (report.records == 0) {
+                firstTs = record.timestampNs;
+            }
+            Clock::time_point due = Clock::now();
+            if (paced) {
+                due = start + std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double, std::nano>(static_cast<double>(record.timestampNs - firstTs) / options.speed));
+                // Sleep most of the way, then yield the last stretch for accuracy
+                if (due - Clock::now() > std::chrono::microseconds(200)) {
+                    std::this_thread::sleep_until(due - std::chrono::microseconds(100));
+                }
+                while (Clock::now() < due) {
+                    std::this_thread::yield();
+                }
+                if (Clock::now() - due > std::chrono::microseconds(100)) {
+                    ++report.late;
+                }
+            }
+            handler(record.data, record.size);
+            report.latency.record(static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - due).count()));
+            ++report.records;
+            report.bytes += record.size;
+            report.recordedSeconds = static_cast<double>(record.timestampNs - firstTs) / 1e9;
+        }
+        report.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return report;
+    }
+
+    inline void printReplayReport(std::FILE* out, const ReplayReport& r) {
+        const double seconds = r.seconds > 0.0 ? r.seconds : 1e-9;
+        std::fprintf(out, "records      %llu (%.1f MB) in %.3f s, recorded over %.3f s\n",
+                     static_cast<unsigned long long>(r.records), static_cast<double>(r.bytes) / 1e6, r.seconds, r.recordedSeconds);
+        std::fprintf(out, "throughput   %.0f msg/s, %.1f MB/s\n",
+                     static_cast<double>(r.records) / seconds, static_cast<double>(r.bytes) / 1e6 / seconds);
+        std::fprintf(out, "latency us   p50 %.1f  p90 %.1f  p99 %.1f  p99.9 %.1f  max %.1f\n",
+                     static_cast<double>(r.latency.quantile(0.5)) / 1e3, static_cast<double>(r.latency.quantile(0.9)) / 1e3,
+                     static_cast<double>(r.latency.quantile(0.99)) / 1e3, static_cast<double>(r.latency.quantile(0.999)) / 1e3,
+                     static_cast<double>(r.latency.max()) / 1e3);
+        if (r.late > 0) {
+            std::fprintf(out, "late         %llu records started >100 us after their due time\n",
+                         static_cast<unsigned long long>(r.late));
+        }
+    }
+
+} // namespace utils
+} // namespace hexarch
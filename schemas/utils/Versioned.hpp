@@ -0,0 +1,318 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace hexarch {
+namespace utils {
+
+    // Epoch-based reclamation behind Versioned<T>.
+    //
+    // A reading thread announces the global epoch in its own slot for as long
+    // as it holds a snapshot; a writer that replaces a version stamps the old
+    // one with the epoch it retired in and bumps the epoch. The old version is
+    // freed once every slot is idle or announces a later epoch, because such
+    // a reader started after the replacement and cannot have seen it. Readers
+    // never wait and never touch a reference count.
+    class EpochDomain {
+    public:
+        static constexpr std::size_t kMaxReaderThreads = 128;
+
+        // Base of everything handed to retire(); deleted through it.
+        struct Retired {
+            virtual ~Retired() = default;
+            Retired* nextRetired = nullptr;
+            std::uint64_t retireEpoch = 0;
+        };
+
+        static EpochDomain& instance() {
+            static EpochDomain domain;
+            return domain;
+        }
+
+        EpochDomain(const EpochDomain&) = delete;
+        EpochDomain& operator=(const EpochDomain&) = delete;
+
+        ~EpochDomain() {
+            Retired* node = retired.exchange(nullptr);
+            while (node) {
+                Retired* next = node->nextRetired;
+                delete node;
+                node = next;
+            }
+        }
+
+        // Marks the calling thread as reading until the matching leave(); nests.
+        // The first call on a thread claims a slot, and throws when all
+        // kMaxReaderThreads are taken by live threads.
+        void enter() {
+            ThreadSlot& t = threadSlot();
+            if (t.depth == 0) {
+                if (!t.slot) {
+                    t.slot = claimSlot();
+                }
+                t.slot->epoch.store(epoch.load());
+            }
+            ++t.depth;
+        }
+
+        void leave() {
+            ThreadSlot& t = threadSlot();
+            if (--t.depth == 0) {
+                t.slot->epoch.store(kIdle, std::memory_order_release);
+            }
+        }
+
+        // Hands node over for deletion once no reader can still see it. Call
+        // after it was unlinked, so that new readers cannot reach it.
+        void retire(Retired* node) noexcept {
+            node->retireEpoch = epoch.fetch_add(1);
+            Retired* head = retired.load(std::memory_order_relaxed);
+            do {
+                node->nextRetired = head;
+            } while (!retired.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+            pending.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Deletes what no reader can see any more; returns how many.
+        std::size_t reclaim() noexcept {
+            Retired* node = retired.exchange(nullptr, std::memory_order_acquire);
+            if (!node) {
+                return 0;
+            }
+            const std::uint64_t oldest = oldestReader();
+            Retired* keep = nullptr;
+            Retired* keepTail = nullptr;
+            std::size_t freed = 0;
+            while (node) {
+                Retired* next = node->nextRetired;
+                if (node->retireEpoch < oldest) {
+                    delete node;
+                    ++freed;
+                } else {
+                    node->nextRetired = keep;
+                    keep = node;
+                    if (!keepTail) {
+                        keepTail = node;
+                    }
+                }
+                node = next;
+            }
+            if (keep) {
+                Retired* head = retired.load(std::memory_order_relaxed);
+                do {
+                    keepTail->nextRetired = head;
+                } while (!retired.compare_exchange_weak(head, keep, std::memory_order_release, std::memory_order_relaxed));
+            }
+            pending.fetch_sub(freed, std::memory_order_relaxed);
+            return freed;
+        }
+
+        // Retired versions still waiting for a reader to move on.
+        std::size_t pendingCount() const { return pending.load(std::memory_order_relaxed); }
+
+    private:
+        static constexpr std::uint64_t kIdle = std::numeric_limits<std::uint64_t>::max();
+
+        struct alignas(64) Slot {
+            std::atomic<std::uint64_t> epoch{ kIdle };
+            std::atomic<bool> owned{ false };
+        };
+
+        // The calling thread's slot, given back when the thread exits.
+        struct ThreadSlot {
+            Slot* slot = nullptr;
+            unsigned depth = 0;
+
+            ~ThreadSlot() {
+                if (slot) {
+                    slot->epoch.store(kIdle, std::memory_order_release);
+                    slot->owned.store(false, std::memory_order_release);
+                }
+            }
+        };
+
+        EpochDomain() = default;
+
+        static ThreadSlot& threadSlot() {
+            thread_local ThreadSlot t;
+            return t;
+        }
+
+        Slot* claimSlot() {
+            for (std::size_t i = 0; i < kMaxReaderThreads; ++i) {
+                bool expected = false;
+                if (!slots[i].owned.load(std::memory_order_relaxed) && slots[i].owned.compare_exchange_strong(expected, true)) {
+                    std::size_t seen = used.load();
+                    while (seen < i + 1 && !used.compare_exchange_weak(seen, i + 1)) {
+                    }
+                    return &slots[i];
+                }
+            }
+            throw std::runtime_error("EpochDomain: more than 128 threads reading at once");
+        }
+
+        std::uint64_t oldestReader() const {
+            std::uint64_t oldest = kIdle;
+            const std::size_t count = used.load();
+            for (std::size_t i = 0; i < count; ++i) {
+                const std::uint64_t e = slots[i].epoch.load();
+                oldest = e < oldest ? e : oldest;
+            }
+            return oldest;
+        }
+
+        Slot slots[kMaxReaderThreads];
+        // Slots ever claimed; the reclaim scan stops there.
+        std::atomic<std::size_t> used{ 0 };
+        std::atomic<std::uint64_t> epoch{ 1 };
+        std::atomic<Retired*> retired{ nullptr };
+        std::atomic<std::size_t> pending{ 0 };
+    };
+
+    // RCU-style holder for a large, read-mostly value.
+    //
+    // read() returns a snapshot of the current version without locks or
+    // reference counting; the version stays valid, unchanged, for as long as
+    // the snapshot lives, whatever writers do meanwhile. publish() and update()
+    // build the next version aside and swap it in atomically; the previous one
+    // is deleted by EpochDomain once no snapshot holds it. Keep snapshots
+    // short-lived, and on the thread that took them: one held forever keeps
+    // every later retired version alive.
+    //
+    // Concurrent update() calls are safe (the loser recomputes), but the
+    // holder is meant for one writer and many readers. Copying copies the
+    // current value; a moved-from holder is empty.
+    template <typename T>
+    class Versioned {
+        struct Node final : EpochDomain::Retired {
+            template <typename... Args>
+            explicit Node(Args&&... args) : value(std::forward<Args>(args)...) {}
+
+            T value;
+            std::uint64_t version = 1;
+        };
+
+    public:
+        class Snapshot {
+        public:
+            Snapshot(Snapshot&& other) noexcept
+                : node(std::exchange(other.node, nullptr)), active(std::exchange(other.active, false)) {}
+            Snapshot(const Snapshot&) = delete;
+            Snapshot& operator=(const Snapshot&) = delete;
+            Snapshot& operator=(Snapshot&&) = delete;
+
+            ~Snapshot() {
+                if (active) {
+                    EpochDomain::instance().leave();
+                }
+            }
+
+            const T& operator*() const { return node->value; }
+            const T* operator->() const { return &node->value; }
+            const T* get() const { return node ? &node->value : nullptr; }
+            // Starts at 1 and grows by one per published version; 0 when empty.
+            std::uint64_t version() const { return node ? node->version : 0; }
+            explicit operator bool() const { return node != nullptr; }
+
+        private:
+            friend class Versioned;
+
+            explicit Snapshot(const std::atomic<Node*>& current) {
+                EpochDomain::instance().enter();
+                active = true;
+                node = current.load();
+            }
+
+            const Node* node = nullptr;
+            bool active = false;
+        };
+
+        Versioned() : current(new Node()) {}
+        explicit Versioned(T value) : current(new Node(std::move(value))) {}
+
+        Versioned(const Versioned& other) : current(nullptr) {
+            Snapshot s = other.read();
+            if (s) {
+                current.store(new Node(*s));
+            }
+        }
+
+        Versioned(Versioned&& other) noexcept : current(other.current.exchange(nullptr)) {}
+
+        Versioned& operator=(const Versioned& other) {
+            if (this != &other) {
+                Snapshot s = other.read();
+                install(s ? new Node(*s) : nullptr);
+            }
+            return *this;
+        }
+
+        Versioned& operator=(Versioned&& other) noexcept {
+            if (this != &other) {
+                install(other.current.exchange(nullptr));
+            }
+            return *this;
+        }
+
+        ~Versioned() {
+            Node* node = current.exchange(nullptr);
+            if (node) {
+                domain.retire(node);
+            }
+            domain.reclaim();
+        }
+
+        // Wait-free.
+        Snapshot read() const { return Snapshot(current); }
+
+        void publish(T value) { install(new Node(std::move(value))); }
+
+        // Publishes fn(current value) and returns its version. An empty holder
+        // passes a default-constructed T.
+        template <typename Fn>
+        std::uint64_t update(Fn&& fn) {
+            std::uint64_t version = 0;
+            for (bool done = false; !done;) {
+                Snapshot s = read();
+                Node* fresh = new Node(s ? fn(*s) : fn(T()));
+                fresh->version = version = s.version() + 1;
+                Node* expected = const_cast<Node*>(s.node);
+                if (current.compare_exchange_strong(expected, fresh)) {
+                    if (expected) {
+                        domain.retire(expected);
+                    }
+                    done = true;
+                } else {
+                    delete fresh;
+                }
+            }
+            domain.reclaim();
+            return version;
+        }
+
+    private:
+        void install(Node* fresh) noexcept {
+            Node* old = current.load();
+            do {
+                if (fresh) {
+                    fresh->version = old ? old->version + 1 : 1;
+                }
+            } while (!current.compare_exchange_weak(old, fresh));
+            if (old) {
+                domain.retire(old);
+            }
+            domain.reclaim();
+        }
+
+        // Taken first so the domain outlives static holders too.
+        EpochDomain& domain = EpochDomain::instance();
+        std::atomic<Node*> current;
+    };
+
+} // namespace utils
+} // namespace hexarch
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace hexarch {
+namespace utils {
+namespace wire {
+
+    // Runtime support for the datagram codecs generated from datagram XML.
+    //
+    // Every record starts with a 12-byte header:
+    //   +0  uint16  magic "HX"
+    //   +2  uint16  schema version
+    //   +4  uint32  layout fingerprint
+    //   +8  uint32  payload size
+    // followed by the fixed-layout payload. All values are little-endian.
+
+    constexpr std::uint16_t kMagic = 0x5848;
+    constexpr std::size_t kHeaderSize = 12;
+
+    enum class DecodeStatus { Ok, Truncated, BadMagic, VersionMismatch, FingerprintMismatch, SizeMismatch };
+
+    inline const char* toString(DecodeStatus status) {
+        switch (status) {
+            case DecodeStatus::Ok: return "ok";
+            case DecodeStatus::Truncated: return "truncated";
+            case DecodeStatus::BadMagic: return "bad magic";
+            case DecodeStatus::VersionMismatch: return "schema version mismatch";
+            case DecodeStatus::FingerprintMismatch: return "schema fingerprint mismatch";
+            case DecodeStatus::SizeMismatch: return "payload size mismatch";
+        }
+        return "unknown";
+    }
+
+    namespace detail {
+
+        template <std::size_t N> struct UInt;
+        template <> struct UInt<1> { using type = std::uint8_t; };
+        template <> struct UInt<2> { using type = std::uint16_t; };
+        template <> struct UInt<4> { using type = std::uint32_t; };
+        template <> struct UInt<8> { using type = std::uint64_t; };
+
+        template <typename U>
+        inline U toLittle(U v) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            U out = 0;
+            for (std::size_t i = 0; i < sizeof(U); ++i) {
+                out = static_cast<U>((out << 8) | ((v >> (8 * i)) & 0xff));
+            }
+            return out;
+#else
+            return v;
+#endif
+        }
+
+    }
+
+    // Arithmetic values (and bool, as one byte) at an unaligned address.
+    template <typename T>
+    inline void store(unsigned char* p, T value) {
+        static_assert(std::is_arithmetic<T>::value, "wire::store needs an arithmetic type");
+        if constexpr (std::is_same<T, bool>::value) {
+            *p = value ? 1 : 0;
+        } else {
+            using U = typename detail::UInt<sizeof(T)>::type;
+            U bits;
+            std::memcpy(&bits, &value, sizeof(T));
+            bits = detail::toLittle(bits);
+            std::memcpy(p, &bits, sizeof(T));
+        }
+    }
+
+    template <typename T>
+    inline T load(const unsigned char* p) {
+        static_assert(std::is_arithmetic<T>::value, "wire::load needs an arithmetic type");
+        if constexpr (std::is_same<T, bool>::value) {
+            return *p != 0;
+        } else {
+            using U = typename detail::UInt<sizeof(T)>::type;
+            U bits;
+            std::memcpy(&bits, p, sizeof(T));
+            bits = detail::toLittle(bits);
+            T value;
+            std::memcpy(&value, &bits, sizeof(T));
+            return value;
+        }
+    }
+
+    // Fixed-capacity string: uint16 length, then `capacity` bytes, zero-filled
+    // past the end so encoded records are byte-for-byte reproducible.
+    inline bool storeString(unsigned char* p, std::string_view s, std::size_t capacity) {
+        if (s.size() > capacity) {
+            return false;
+        }
+        store(p, static_cast<std::uint16_t>(s.size()));
+        std::memcpy(p + 2, s.data(), s.size());
+        std::memset(p + 2 + s.size(), 0, capacity - s.size());
+        return true;
+    }
+
+    // A corrupt length is clamped to the capacity rather than read past it.
+    inline std::string_view loadString(const unsigned char* p, std::size_t capacity) {
+        std::size_t n = load<std::uint16_t>(p);
+        if (n > capacity) {
+            n = capacity;
+        }
+        return std::string_view(reinterpret_cast<const char*>(p + 2), n);
+    }
+
+    // 64-bit FNV-1a over key fields in their wire representation. Stable across
+    // hosts and runs, so a key maps to the same shard or partition everywhere.
+    constexpr std::uint64_t kKeyHashSeed = 0xcbf29ce484222325ull;
+
+    inline std::uint64_t hashBytes(std::uint64_t h, const unsigned char* p, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            h = (h ^ p[i]) * 0x100000001b3ull;
+        }
+        return h;
+    }
+
+    template <typename T>
+    inline std::uint64_t hashKey(std::uint64_t h, T value) {
+        unsigned char bytes[sizeof(T)];
+        store(bytes, value);
+        return hashBytes(h, bytes, sizeof(T));
+    }
+
+    // Length first, so ("ab", "c") and ("a", "bc") hash differently.
+    inline std::uint64_t hashKey(std::uint64_t h, std::string_view s) {
+        h = hashKey(h, static_cast<std::uint16_t>(s.size()));
+        return hashBytes(h, reinterpret_cast<const unsigned char*>(s.data()), s.size());
+    }
+
+    // The same key fields appended as bytes, for maps keyed by entity (write-behind
+    // coalescing, storage row keys). Equal keys give equal strings.
+    template <typename T>
+    inline void appendKey(std::string& out, T value) {
+        unsigned char bytes[sizeof(T)];
+        store(bytes, value);
+        out.append(reinterpret_cast<const char*>(bytes), sizeof(T));
+    }
+
+    inline void appendKey(std::string& out, std::string_view s) {
+        appendKey(out, static_cast<std::uint16_t>(s.size()));
+        out.append(s.data(), s.size());
+    }
+
+    inline void writeHeader(unsigned char* p, std::uint16_t version, std::uint32_t fingerprint, std::uint32_t payloadSize) {
+        store(p, kMagic);
+        store(p + 2, version);
+        store(p + 4, fingerprint);
+        store(p + 8, payloadSize);
+    }
+
+    inline DecodeStatus checkHeader(const unsigned char* p, std::size_t size,
+                                    std::uint16_t version, std::uint32_t fingerprint, std::uint32_t payloadSize) {
+        if (size < kHeaderSize) return DecodeStatus::Truncated;
+        if (load<std::uint16_t>(p) != kMagic) return DecodeStatus::BadMagic;
+        if (load<std::uint16_t>(p + 2) != version) return DecodeStatus::VersionMismatch;
+        if (load<std::uint32_t>(p + 4) != fingerprint) return DecodeStatus::FingerprintMismatch;
+        if (load<std::uint32_t>(p + 8) != payloadSize) return DecodeStatus::SizeMismatch;
+        if (size < kHeaderSize + payloadSize) return DecodeStatus::Truncated;
+        return DecodeStatus::Ok;
+    }
+
+} // namespace wire
+} // namespace utils
+} // namespace hexarch
@@ -0,0 +1,309 @@
+#pragma once
+
+#include "utils/Span.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace hexarch {
+namespace utils {
+
+    struct WriteBehindOptions {
+        // Size trigger, and the most rows handed to one writeBatch().
+        std::size_t maxBatchRows = 500;
+        // Time trigger: no row stays dirty longer than this (plus one write).
+        std::chrono::milliseconds flushInterval{ 50 };
+        // Backpressure: put() blocks while this many rows wait to be written.
+        std::size_t maxDirty = 50000;
+        // Clean rows kept for reads; the least recently written are dropped first.
+        std::size_t maxCachedRows = 1000000;
+    };
+
+    // The database side of a WriteBehindCache.
+    template <typename Key, typename Value>
+    class WriteBehindSink {
+    public:
+        virtual ~WriteBehindSink() = default;
+
+        // Upserts rows in one round trip (multi-row INSERT ... ON CONFLICT, COPY
+        // into a staging table). Each key appears once. Throw on failure: the rows
+        // stay dirty and are retried after flushInterval.
+        virtual void writeBatch(Span<const std::pair<Key, Value>> rows) = 0;
+
+        // Reads one row on a cache miss.
+        virtual std::optional<Value> load(const Key& key) = 0;
+    };
+
+    struct WriteBehindStats {
+        std::uint64_t puts;
+        // Puts that replaced a value still waiting to be written.
+        std::uint64_t coalesced;
+        std::uint64_t rowsWritten;
+        std::uint64_t batches;
+        std::uint64_t failedBatches;
+        std::uint64_t backpressureWaits;
+        std::uint64_t cacheHits;
+        std::uint64_t cacheMisses;
+        // Rows still failing when the cache was destroyed.
+        std::uint64_t droppedRows;
+        std::size_t dirty;
+        std::size_t cached;
+        double rowsPerSecond;
+        // writeBatch() duration, and the longest a row waited dirty before its batch started.
+        double avgFlushUs;
+        double maxFlushUs;
+        double maxLagUs;
+    };
+
+    // Write-behind cache in front of a persistence adapter.
+    //
+    // put() stores the row and returns; repeated puts of one key before it is
+    // written coalesce into one row. A flusher thread hands dirty rows to the
+    // sink in batches of up to maxBatchRows, when that many are dirty or the
+    // oldest has waited flushInterval. get() answers from the cache and falls
+    // back to sink.load(). Once maxDirty rows are waiting, put() blocks until a
+    // batch completes, so a slow database throttles producers instead of
+    // growing memory. Rows of one key are written in put() order. All members
+    // are thread-safe; the sink is only called from the flusher and get().
+    template <typename Key, typename Value, typename Hash = std::hash<Key>>
+    class WriteBehindCache {
+    public:
+        using Row = std::pair<Key, Value>;
+
+        WriteBehindCache(WriteBehindSink<Key, Value>& sink, WriteBehindOptions options = WriteBehindOptions())
+            : sink(sink), options(options), started(Clock::now()) {
+            if (this->options.maxBatchRows == 0 || this->options.maxDirty == 0) {
+                throw std::invalid_argument("WriteBehindCache: maxBatchRows and maxDirty must be positive");
+            }
+            flusher = std::thread([this] { run(); });
+        }
+
+        // Writes every dirty row, then stops the flusher.
+        ~WriteBehindCache() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            flusher.join();
+        }
+
+        WriteBehindCache(const WriteBehindCache&) = delete;
+        WriteBehindCache& operator=(const WriteBehindCache&) = delete;
+
+        void put(const Key& key, Value value) {
+            std::unique_lock<std::mutex> lock(mutex);
+            ++counters.puts;
+            if (pending() >= options.maxDirty) {
+                ++counters.backpressureWaits;
+                written.wait(lock, [&] { return pending() < options.maxDirty; });
+            }
+            auto it = entries.try_emplace(key).first;
+            Entry& entry = it->second;
+            entry.value = std::move(value);
+            if (entry.dirty) {
+                ++counters.coalesced;
+                return;
+            }
+            entry.dirty = true;
+            entry.dirtySince = Clock::now();
+            dirtyQueue.push_back(key);
+            if (dirtyQueue.size() == 1 || dirtyQueue.size() >= options.maxBatchRows) {
+                wake.notify_one();
+            }
+        }
+
+        std::optional<Value> get(const Key& key) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                const auto it = entries.find(key);
+                if (it != entries.end()) {
+                    ++counters.cacheHits;
+                    return it->second.value;
+                }
+                ++counters.cacheMisses;
+            }
+            std::optional<Value> loaded = sink.load(key);
+            if (loaded) {
+                std::lock_guard<std::mutex> lock(mutex);
+                // A put() that raced with the load wins.
+                auto inserted = entries.try_emplace(key);
+                if (inserted.second) {
+                    inserted.first->second.value = *loaded;
+                    markClean(key, inserted.first->second);
+                    evict();
+                }
+            }
+            return loaded;
+        }
+
+        // Writes every dirty row now. Returns false if a batch failed meanwhile.
+        bool flush() {
+            std::unique_lock<std::mutex> lock(mutex);
+            const std::uint64_t failuresBefore = counters.failedBatches;
+            ++flushRequests;
+            wake.notify_one();
+            written.wait(lock, [&] { return pending() == 0 || counters.failedBatches != failuresBefore; });
+            --flushRequests;
+            return counters.failedBatches == failuresBefore;
+        }
+
+        WriteBehindStats stats() const {
+            std::lock_guard<std::mutex> lock(mutex);
+            WriteBehindStats out = counters;
+            out.dirty = pending();
+            out.cached = entries.size();
+            const double seconds = std::chrono::duration<double>(Clock::now() - started).count();
+            out.rowsPerSecond = seconds > 0.0 ? static_cast<double>(out.rowsWritten) / seconds : 0.0;
+            out.avgFlushUs = out.batches ? flushUsTotal / static_cast<double>(out.batches) : 0.0;
+            return out;
+        }
+
+        const WriteBehindOptions& getOptions() const { return options; }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Entry {
+            Value value{};
+            Clock::time_point dirtySince;
+            bool dirty = false;
+            // In the batch being written; not evictable until it completes.
+            bool writing = false;
+            // Listed in cleanQueue, the eviction order.
+            bool evictable = false;
+        };
+
+        std::size_t pending() const { return dirtyQueue.size() + inFlight; }
+
+        void run() {
+            std::vector<Row> batch;
+            Clock::time_point retryAt;
+            std::unique_lock<std::mutex> lock(mutex);
+            for (;;) {
+                if (dirtyQueue.empty()) {
+                    if (stopping) return;
+                    wake.wait(lock);
+                    continue;
+                }
+                const Clock::time_point now = Clock::now();
+                const Clock::time_point due = std::max(entries.at(dirtyQueue.front()).dirtySince + options.flushInterval, retryAt);
+                const bool forced = (stopping || flushRequests > 0 || dirtyQueue.size() >= options.maxBatchRows) && now >= retryAt;
+                if (!forced && now < due) {
+                    wake.wait_until(lock, due);
+                    continue;
+                }
+
+                batch.clear();
+                while (!dirtyQueue.empty() && batch.size() < options.maxBatchRows) {
+                    Entry& entry = entries.at(dirtyQueue.front());
+                    const double lagUs = std::chrono::duration<double, std::micro>(now - entry.dirtySince).count();
+                    counters.maxLagUs = std::max(counters.maxLagUs, lagUs);
+                    entry.dirty = false;
+                    entry.writing = true;
+                    batch.emplace_back(dirtyQueue.front(), entry.value);
+                    dirtyQueue.pop_front();
+                }
+                inFlight = batch.size();
+                lock.unlock();
+
+                bool ok = true;
+                const Clock::time_point start = Clock::now();
+                try {
+                    sink.writeBatch(Span<const Row>(batch.data(), batch.size()));
+                } catch (...) {
+                    ok = false;
+                }
+                const double flushUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+                lock.lock();
+                inFlight = 0;
+                for (const Row& row : batch) entries.at(row.first).writing = false;
+                if (ok) {
+                    counters.rowsWritten += batch.size();
+                    ++counters.batches;
+                    flushUsTotal += flushUs;
+                    counters.maxFlushUs = std::max(counters.maxFlushUs, flushUs);
+                    for (const Row& row : batch) {
+                        auto it = entries.find(row.first);
+                        if (it != entries.end() && !it->second.dirty) markClean(row.first, it->second);
+                    }
+                    evict();
+                } else {
+                    ++counters.failedBatches;
+                    if (stopping) {
+                        counters.droppedRows += batch.size() + dirtyQueue.size();
+                        dirtyQueue.clear();
+                    } else {
+                        requeue(batch, start);
+                        retryAt = Clock::now() + options.flushInterval;
+                    }
+                }
+                written.notify_all();
+            }
+        }
+
+        // Puts a failed batch back at the head of the queue, unless a newer put
+        // already made the key dirty again.
+        void requeue(std::vector<Row>& batch, Clock::time_point since) {
+            for (auto row = batch.rbegin(); row != batch.rend(); ++row) {
+                Entry& entry = entries.at(row->first);
+                if (entry.dirty) {
+                    continue;
+                }
+                entry.dirty = true;
+                entry.dirtySince = since;
+                dirtyQueue.push_front(row->first);
+            }
+        }
+
+        void markClean(const Key& key, Entry& entry) {
+            if (!entry.evictable) {
+                entry.evictable = true;
+                cleanQueue.push_back(key);
+            }
+        }
+
+        void evict() {
+            while (entries.size() > options.maxCachedRows && !cleanQueue.empty()) {
+                auto it = entries.find(cleanQueue.front());
+                cleanQueue.pop_front();
+                if (it == entries.end()) continue;
+                it->second.evictable = false;
+                if (!it->second.dirty && !it->second.writing) entries.erase(it);
+            }
+        }
+
+        WriteBehindSink<Key, Value>& sink;
+        const WriteBehindOptions options;
+        const Clock::time_point started;
+
+        mutable std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable written;
+        std::unordered_map<Key, Entry, Hash> entries;
+        // Dirty keys in the order they became dirty; each at most once.
+        std::deque<Key> dirtyQueue;
+        std::deque<Key> cleanQueue;
+        std::size_t inFlight = 0;
+        std::size_t flushRequests = 0;
+        bool stopping = false;
+        WriteBehindStats counters{};
+        double flushUsTotal = 0.0;
+        std::thread flusher;
+    };
+
+} // namespace utils
+} // namespace hexarch
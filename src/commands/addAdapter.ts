@@ -44,10 +44,16 @@ async function addAdapter(uri: vscode.Uri, type: 'incoming' | 'outgoing') {
 
     // 3.5 Select Technology
     const mwName = process.env.MW_NAME || 'Kafka';
-    const defaultTechs = ['ZeroMQ', 'RabbitMQ', 'Kafka', 'REST'];
+    // IPC: shared-memory ring to a co-located component, no broker
+    const defaultTechs = ['ZeroMQ', 'RabbitMQ', 'Kafka', 'REST', 'IPC'];
     if (!defaultTechs.includes(mwName)) {
         defaultTechs.push(mwName);
     }
+    // The project database gets the write-behind persistence adapter
+    const dbName = process.env.DB || 'postgres';
+    if (type === 'outgoing' && !defaultTechs.some(t => t.toLowerCase() === dbName.toLowerCase())) {
+        defaultTechs.push(dbName);
+    }
     const techOptions = [...defaultTechs, 'Custom...'];
 
     const selectedTech = await vscode.window.showQuickPick(techOptions, {
@@ -104,7 +110,27 @@ async function addAdapter(uri: vscode.Uri, type: 'incoming' | 'outgoing') {
     const relativePortPath = path.relative(adaptersDir, path.join(portsDir, selectedPortFile)).replace(/\\/g, '/');
 
     let content = { header: '', source: '' };
-    if (type === 'outgoing') {
+    if (type === 'outgoing' && technology.toLowerCase() === dbName.toLowerCase()) {
+        // A keyed datagram codec, when there is one, builds the row key and the row
+        let codec: DatagramCodecInfo | undefined;
+        const codecs = findKeyedCodecs(baseAdaptersDir, adaptersDir);
+        if (codecs.length > 0) {
+            const none = 'None (write key() and encode() by hand)';
+            const names = codecs.map(c => c.type);
+            // The datagram named after the model first
+            names.sort((a, b) => Number(b === modelName) - Number(a === modelName));
+            const selectedCodec = await vscode.window.showQuickPick([...names, none], {
+                placeHolder: `Select the datagram whose codec stores ${modelName} rows`
+            });
+            if (!selectedCodec) return;
+            codec = codecs.find(c => c.type === selectedCodec);
+        }
+        content = generateDatabaseAdapter(namespace, adapterName, modelName, relativePortPath, technology, techPascal, headerExt, codec);
+    } else if (techLower === 'ipc') {
+        content = type === 'outgoing'
+            ? generateIpcOutgoingAdapter(namespace, adapterName, modelName, relativePortPath, headerExt)
+            : generateIpcIncomingAdapter(namespace, adapterName, modelName, relativePortPath, headerExt);
+    } else if (type === 'outgoing') {
         content = generateOutgoingAdapter(namespace, adapterName, modelName, relativePortPath, technology, headerExt);
     } else {
         content = generateIncomingAdapter(namespace, adapterName, modelName, relativePortPath, technology, headerExt);
@@ -113,6 +139,17 @@ async function addAdapter(uri: vscode.Uri, type: 'incoming' | 'outgoing') {
     fs.writeFileSync(adapterHeaderFile, content.header);
     fs.writeFileSync(adapterSourceFile, content.source);
 
+    // 7. Register incoming adapters with the component's replay driver (replay/ReplayMain.cpp)
+    if (type === 'incoming') {
+        const layout = findReplayLayout(adaptersDir);
+        if (layout) {
+            const adapterInclude = path.relative(layout.sourceRoot, adapterHeaderFile).replace(/\\/g, '/');
+            // replay.mk only picks up replay/*.cpp, whatever the component's source extension
+            fs.writeFileSync(path.join(layout.replayDir, `${adapterName}Replay.cpp`),
+                generateReplayRegistration(namespace, adapterName, modelName, adapterInclude, techLower === 'ipc'));
+        }
+    }
+
     // Open the files
     const docHeader = await vscode.workspace.openTextDocument(adapterHeaderFile);
     await vscode.window.showTextDocument(docHeader, { preview: false });
@@ -201,6 +238,64 @@ function findAdaptersDirectory(startPath: string, type: string): string | null {
     return null;
 }
 
+interface DatagramCodecInfo {
+    /** Field struct name; the codec is <type>Codec and the view <type>View */
+    type: string;
+    namespace: string;
+    /** Include path of the codec header, relative to the adapter */
+    include: string;
+    fields: string[];
+    keys: string[];
+}
+
+function findKeyedCodecs(baseAdaptersDir: string, adaptersDir: string): DatagramCodecInfo[] {
+    // baseAdaptersDir: <component>/src/AppName/adapters/outgoing
+    // codecs: <component>/src/AppName/adapters/common/<middleware>/codec/<Datagram>Codec.h(pp)
+    const commonDir = path.join(path.dirname(baseAdaptersDir), 'common');
+    const found: DatagramCodecInfo[] = [];
+    if (!fs.existsSync(commonDir)) {
+        return found;
+    }
+    for (const mw of fs.readdirSync(commonDir)) {
+        const codecDir = path.join(commonDir, mw, 'codec');
+        if (!fs.existsSync(codecDir) || !fs.statSync(codecDir).isDirectory()) continue;
+        for (const file of fs.readdirSync(codecDir).filter(f => /Codec\.(h|hpp)$/.test(f))) {
+            const content = fs.readFileSync(path.join(codecDir, file), 'utf-8');
+            const codecMatch = content.match(/^struct (\w+)Codec \{/m);
+            const namespaceMatch = content.match(/^namespace (\S+) \{/m);
+            // Only codecs of datagrams with <keys> have keyBytes()
+            if (!codecMatch || !namespaceMatch || !content.includes('static void keyBytes(')) continue;
+            const type = codecMatch[1];
+            const body = content.match(new RegExp(`^struct ${type} \\{\\n([\\s\\S]*?)^\\};`, 'm'));
+            const fields = body ? [...body[1].matchAll(/^\s+[\w:]+ (\w+)(?: = [^;]+)?;$/gm)].map(m => m[1]) : [];
+            const keysMatch = content.match(/^\/\/ Keys: (.+)$/m);
+            found.push({
+                type,
+                namespace: namespaceMatch[1],
+                include: path.relative(adaptersDir, path.join(codecDir, file)).replace(/\\/g, '/'),
+                fields,
+                keys: keysMatch ? keysMatch[1].split(',').map(k => k.trim()) : []
+            });
+        }
+    }
+    return found;
+}
+
+function findReplayLayout(adaptersDir: string): { replayDir: string, sourceRoot: string } | null {
+    // adaptersDir: <component>/src/AppName/adapters/incoming/kafka
+    // wanted: <component>/replay, and <component>/src/AppName that includes are relative to
+    const parts = adaptersDir.split(path.sep);
+    const srcIndex = parts.lastIndexOf('src');
+    if (srcIndex < 1 || srcIndex + 1 >= parts.length) {
+        return null;
+    }
+    const replayDir = path.join(parts.slice(0, srcIndex).join(path.sep), 'replay');
+    if (!fs.existsSync(replayDir)) {
+        return null;
+    }
+    return { replayDir, sourceRoot: parts.slice(0, srcIndex + 2).join(path.sep) };
+}
+
 function getNamespaceFromPath(dirPath: string): string {
     // dirPath: .../src/AppName/adapters/incoming/kafka
     // wanted: AppName::adapters::incoming::kafka
@@ -220,29 +315,323 @@ function generateOutgoingAdapter(namespace: string, className: string, modelName
     const header = `#pragma once
 
 #include "${relativePortPath}"
+#include "utils/BatchProducer.hpp"
+#include "utils/PortMetrics.hpp"
+
+#include <string_view>
+#include <vector>
+
+namespace ${namespace} {
+
+// Encodes each ${modelName} and hands it to a BatchProducer, which batches per
+// partition, compresses and delivers asynchronously. The producer's
+// BatchTransport wraps the ${technology} client; utils/LocalBroker.hpp stands in
+// for it in tests. Not thread-safe: call send() from one thread.
+class ${className} : public domain::ports::outgoing::${portClass} {
+public:
+    explicit ${className}(hexarch::utils::BatchProducer& producer);
+    virtual ~${className}() = default;
+
+    void send(const domain::model::${modelName}& data) override;
+    void sendBatch(hexarch::utils::Span<const domain::model::${modelName}> batch) override;
+
+    // Blocks until everything sent so far has been acknowledged or failed
+    void flush();
+
+private:
+    // Serialises one model into out
+    void encode(const domain::model::${modelName}& data, std::vector<unsigned char>& out) const;
+
+    // Partitioning key: records with the same key keep their order. Empty spreads load.
+    std::string_view key(const domain::model::${modelName}& data) const;
+
+    void onDelivery(const hexarch::utils::DeliveryReport& report);
+
+    hexarch::utils::BatchProducer& producer;
+    std::vector<unsigned char> scratch;
+    hexarch::utils::metrics::PortMetrics& metrics;
+};
+
+} // namespace ${namespace}
+`;
+
+    const source = `#include "${className}${headerExt}"
+#include "utils/AsyncLog.hpp"
+
+namespace ${namespace} {
+
+${className}::${className}(hexarch::utils::BatchProducer& producer)
+    : producer(producer),
+      metrics(hexarch::utils::metrics::port("${portClass}", "${className}", hexarch::utils::metrics::Direction::Outgoing)) {}
+
+void ${className}::send(const domain::model::${modelName}& data) {
+    hexarch::utils::metrics::ScopedTimer timer(metrics);
+    scratch.clear();
+    encode(data, scratch);
+    timer.addBytes(scratch.size());
+    producer.send(key(data), scratch.data(), scratch.size(),
+                  [this](const hexarch::utils::DeliveryReport& report) { onDelivery(report); });
+    // Compiled out unless built with -DHEXARCH_LOG_LEVEL=1 or lower
+    HEXARCH_LOG_DEBUG("[${technology}] ${modelName} queued, {} bytes", scratch.size());
+}
+
+void ${className}::sendBatch(hexarch::utils::Span<const domain::model::${modelName}> batch) {
+    // The producer already coalesces records into per-partition batches
+    for (const domain::model::${modelName}& data : batch) {
+        send(data);
+    }
+}
+
+void ${className}::flush() {
+    producer.flush();
+}
+
+void ${className}::encode(const domain::model::${modelName}& data, std::vector<unsigned char>& out) const {
+    // TODO: Serialise ${modelName} for ${technology}, e.g. with the codec from
+    // "Generate Datagram Codecs" (adapters/common/<middleware>/codec)
+    (void)data;
+    (void)out;
+}
+
+std::string_view ${className}::key(const domain::model::${modelName}& data) const {
+    // TODO: Return the entity id so updates to one entity stay ordered
+    (void)data;
+    return {};
+}
+
+void ${className}::onDelivery(const hexarch::utils::DeliveryReport& report) {
+    // Runs on the transport's completion thread
+    if (!report.delivered) {
+        metrics.error();
+        HEXARCH_LOG_WARN("[${technology}] ${modelName} delivery failed on partition {}", report.partition);
+    }
+}
+
+} // namespace ${namespace}
+`;
+
+    return { header, source };
+}
+
+function generateDatabaseAdapter(namespace: string, className: string, modelName: string, relativePortPath: string, technology: string, techPascal: string, headerExt: string, codec?: DatagramCodecInfo): { header: string, source: string } {
+    const portClass = `I${modelName}OutgoingPort`;
+    const tableClass = `${modelName}${techPascal}Table`;
+    const datagram = codec ? `${codec.namespace}::${codec.type}` : '';
+
+    const codecInclude = codec ? `\n#include "${codec.include}"` : '';
+    const rowComment = codec
+        ? `    // Row key: ${codec.type}Codec::keyBytes() of the datagram <keys> (${codec.keys.join(', ')})
+    void key(const domain::model::${modelName}& data, std::string& out) const;
+
+    // Row value: the ${codec.type} wire form
+    void encode(const domain::model::${modelName}& data, std::string& out) const;
+    bool decode(const std::string& row, domain::model::${modelName}& out) const;
+
+    // ${modelName} <-> ${codec.type} fields; false leaves key() and encode() empty
+    bool toDatagram(const domain::model::${modelName}& data, ${datagram}& out) const;
+    bool fromDatagram(const ${codec.namespace}::${codec.type}View& view, domain::model::${modelName}& out) const;`
+        : `    // Row key: the datagram <keys>, e.g. Codec::keyBytes(fields, out)
+    void key(const domain::model::${modelName}& data, std::string& out) const;
+
+    // Row value, e.g. the codec's wire form
+    void encode(const domain::model::${modelName}& data, std::string& out) const;
+    bool decode(const std::string& row, domain::model::${modelName}& out) const;`;
+
+    const header = `#pragma once
+
+#include "${relativePortPath}"${codecInclude}
+#include "utils/PortMetrics.hpp"
+#include "utils/WriteBehindCache.hpp"
+
+#include <optional>
+#include <string>
+#include <utility>
 
 namespace ${namespace} {
 
+// ${modelName} rows in ${technology}, keyed by the entity key: the sink the
+// write-behind cache flushes into. utils/LocalTable.hpp stands in for it in tests.
+class ${tableClass} : public hexarch::utils::WriteBehindSink<std::string, std::string> {
+public:
+    void writeBatch(hexarch::utils::Span<const std::pair<std::string, std::string>> rows) override;
+    std::optional<std::string> load(const std::string& key) override;
+};
+
+// Persists ${modelName} through a WriteBehindCache instead of one ${technology}
+// round trip per write. send() returns once the row is cached (blocking only
+// under the cache's backpressure); repeated updates of one entity coalesce, and
+// the cache's flusher upserts dirty rows in batches. Reads see unflushed rows.
+// Thread-safe.
 class ${className} : public domain::ports::outgoing::${portClass} {
 public:
+    using Cache = hexarch::utils::WriteBehindCache<std::string, std::string>;
+
+    explicit ${className}(Cache& cache);
     virtual ~${className}() = default;
 
+    // Throws std::logic_error while key() or encode() writes nothing: every
+    // ${modelName} would land in one row.
     void send(const domain::model::${modelName}& data) override;
+    void sendBatch(hexarch::utils::Span<const domain::model::${modelName}> batch) override;
+
+    // Latest ${modelName} stored under key (as built by key()), cached or from
+    // ${technology}. Throws std::runtime_error when the stored row does not decode.
+    std::optional<domain::model::${modelName}> find(const std::string& key);
+
+    // Blocks until every row sent so far is written; false if a batch failed
+    bool flush();
+
+    // Coalescing, throughput and flush latency
+    hexarch::utils::WriteBehindStats stats() const;
+
+private:
+${rowComment}
+
+    Cache& cache;
+    hexarch::utils::metrics::PortMetrics& metrics;
 };
 
 } // namespace ${namespace}
 `;
 
+    const fieldList = codec ? codec.fields.map(f => `    //   out.${f} = ...;`).join('\n') : '';
+    const rowFunctions = codec
+        ? `void ${className}::key(const domain::model::${modelName}& data, std::string& out) const {
+    out.clear();
+    ${datagram} msg;
+    if (toDatagram(data, msg)) {
+        ${codec.namespace}::${codec.type}Codec::keyBytes(msg, out);
+    }
+}
+
+void ${className}::encode(const domain::model::${modelName}& data, std::string& out) const {
+    out.clear();
+    ${datagram} msg;
+    if (!toDatagram(data, msg)) {
+        return;
+    }
+    out.resize(${codec.namespace}::${codec.type}Codec::kWireSize);
+    if (${codec.namespace}::${codec.type}Codec::encode(msg, reinterpret_cast<unsigned char*>(&out[0]), out.size()) == 0) {
+        throw std::length_error("${className}::encode(): a ${modelName} string does not fit its ${codec.type} field");
+    }
+}
+
+bool ${className}::decode(const std::string& row, domain::model::${modelName}& out) const {
+    ${codec.namespace}::${codec.type}View view;
+    if (${codec.namespace}::${codec.type}Codec::decode(reinterpret_cast<const unsigned char*>(row.data()), row.size(), view) !=
+        hexarch::utils::wire::DecodeStatus::Ok) {
+        return false;
+    }
+    return fromDatagram(view, out);
+}
+
+bool ${className}::toDatagram(const domain::model::${modelName}& data, ${datagram}& out) const {
+    // TODO: Copy the ${modelName} fields into out and return true; string fields
+    // are views, so point them into data:
+${fieldList}
+    (void)data;
+    (void)out;
+    return false;
+}
+
+bool ${className}::fromDatagram(const ${codec.namespace}::${codec.type}View& view, domain::model::${modelName}& out) const {
+    // TODO: Rebuild ${modelName} from view (view.fields() copies them all) and return true
+    (void)view;
+    (void)out;
+    return false;
+}`
+        : `void ${className}::key(const domain::model::${modelName}& data, std::string& out) const {
+    // TODO: Write the ${modelName} key fields, the ones listed in the datagram <keys>,
+    // into out, e.g. through the codec's ${modelName}Codec::keyBytes(). Equal keys
+    // share one row, so send() throws while out stays empty.
+    (void)data;
+    (void)out;
+}
+
+void ${className}::encode(const domain::model::${modelName}& data, std::string& out) const {
+    // TODO: Serialise ${modelName} for ${technology}; send() throws on an empty row
+    (void)data;
+    (void)out;
+}
+
+bool ${className}::decode(const std::string& row, domain::model::${modelName}& out) const {
+    // TODO: Rebuild ${modelName} from a row written by encode() and return true
+    (void)row;
+    (void)out;
+    return false;
+}`;
+
     const source = `#include "${className}${headerExt}"
-#include <iostream>
+
+#include <stdexcept>
 
 namespace ${namespace} {
 
+void ${tableClass}::writeBatch(hexarch::utils::Span<const std::pair<std::string, std::string>> rows) {
+    // TODO: Write all rows in one ${technology} round trip, e.g.
+    //   INSERT INTO ${modelName.toLowerCase()} (key, row) VALUES ($1, $2), ($3, $4), ...
+    //       ON CONFLICT (key) DO UPDATE SET row = EXCLUDED.row
+    // or COPY into a staging table and upsert from it. Throw on failure; the
+    // cache keeps the rows dirty and retries.
+    (void)rows;
+}
+
+std::optional<std::string> ${tableClass}::load(const std::string& key) {
+    // TODO: SELECT row FROM ${modelName.toLowerCase()} WHERE key = $1
+    (void)key;
+    return std::nullopt;
+}
+
+${className}::${className}(Cache& cache)
+    : cache(cache),
+      metrics(hexarch::utils::metrics::port("${portClass}", "${className}", hexarch::utils::metrics::Direction::Outgoing)) {}
+
 void ${className}::send(const domain::model::${modelName}& data) {
-    // TODO: Implement ${technology} sending logic
-    std::cout << "[${technology}] Adapter sending ${modelName}..." << std::endl;
+    hexarch::utils::metrics::ScopedTimer timer(metrics);
+    std::string rowKey;
+    std::string row;
+    key(data, rowKey);
+    if (rowKey.empty()) {
+        throw std::logic_error("${className}::send(): key() wrote no key; every ${modelName} would overwrite one row");
+    }
+    encode(data, row);
+    if (row.empty()) {
+        throw std::logic_error("${className}::send(): encode() wrote an empty row");
+    }
+    timer.addBytes(rowKey.size() + row.size());
+    cache.put(rowKey, std::move(row));
 }
 
+void ${className}::sendBatch(hexarch::utils::Span<const domain::model::${modelName}> batch) {
+    // The cache batches the writes; each put only touches memory
+    for (const domain::model::${modelName}& data : batch) {
+        send(data);
+    }
+}
+
+std::optional<domain::model::${modelName}> ${className}::find(const std::string& key) {
+    const std::optional<std::string> row = cache.get(key);
+    if (!row) {
+        return std::nullopt;
+    }
+    // A row that is there but does not decode is an error, not a miss
+    domain::model::${modelName} out;
+    if (!decode(*row, out)) {
+        throw std::runtime_error("${className}::find(): the stored ${modelName} row does not decode");
+    }
+    return out;
+}
+
+bool ${className}::flush() {
+    return cache.flush();
+}
+
+hexarch::utils::WriteBehindStats ${className}::stats() const {
+    return cache.stats();
+}
+
+${rowFunctions}
+
 } // namespace ${namespace}
 `;
 
@@ -255,6 +644,8 @@ function generateIncomingAdapter(namespace: string, className: string, modelName
     const header = `#pragma once
 
 #include "${relativePortPath}"
+#include "utils/PortMetrics.hpp"
+#include "utils/TrafficLog.hpp"
 #include <memory>
 
 namespace ${namespace} {
@@ -263,6 +654,9 @@ class ${className} {
 private:
     // Reference to the port (usually implemented by the Domain Service)
     domain::ports::incoming::${portClass}& port;
+    hexarch::utils::metrics::PortMetrics& metrics;
+    // Set when HEXARCH_CAPTURE_DIR is, for replay/ReplayMain.cpp
+    std::unique_ptr<hexarch::utils::TrafficRecorder> recorder;
 
 public:
     explicit ${className}(domain::ports::incoming::${portClass}& port);
@@ -270,27 +664,75 @@ public:
 
     // This method simulates receiving data from ${technology}
     void startListening();
+
+    // Decodes one raw ${technology} record and delivers it; also the replay driver's entry point
+    void receive(const unsigned char* bytes, std::size_t size);
+
+    // Delivers one poll's worth of messages to the port in a single call
+    void deliver(hexarch::utils::Span<const domain::model::${modelName}> batch);
+
+private:
+    bool decode(const unsigned char* bytes, std::size_t size, domain::model::${modelName}& out) const;
 };
 
 } // namespace ${namespace}
 `;
 
     const source = `#include "${className}${headerExt}"
-#include <iostream>
+#include "utils/AsyncLog.hpp"
 
 namespace ${namespace} {
 
 ${className}::${className}(domain::ports::incoming::${portClass}& port) 
-    : port(port) {}
+    : port(port),
+      metrics(hexarch::utils::metrics::port("${portClass}", "${className}", hexarch::utils::metrics::Direction::Incoming)),
+      recorder(hexarch::utils::TrafficRecorder::fromEnv("${modelName}")) {}
 
 void ${className}::startListening() {
     // TODO: Implement ${technology} listening logic
-    std::cout << "[${technology}] Adapter started listening for ${modelName}..." << std::endl;
+    HEXARCH_LOG_INFO("[${technology}] Adapter started listening for ${modelName}...");
     
     // Example usage:
-    // domain::model::${modelName} data;
-    // ... fill data from ${technology} message ...
-    // port.onDataReceived(data);
+    // receive(record.data(), record.size());   // per raw record, or to batch:
+    // std::pmr::monotonic_buffer_resource arena(pollBuffer, sizeof(pollBuffer));
+    // std::pmr::vector<domain::model::${modelName}> batch(&arena);
+    // ... fill batch from one ${technology} poll ...
+    // deliver(batch);   // arena (and every allocator-aware model in it) released at scope exit
+    //
+    // deliver() runs the domain logic on the polling thread. To keep slow logic
+    // from stalling ${technology}, push into a ring from utils/RingBuffer.hpp instead:
+    //   hexarch::utils::SpscRing<domain::model::${modelName}, hexarch::utils::FutexWait> ring(4096);
+    //   poll thread:   ring.pushBatch(batch.data(), batch.size());
+    //   worker thread: while ((n = ring.popBatch(buf, 64)) > 0) deliver({buf, n});
+}
+
+void ${className}::receive(const unsigned char* bytes, std::size_t size) {
+    if (recorder) {
+        recorder->append(bytes, size);
+    }
+    domain::model::${modelName} data;
+    if (!decode(bytes, size, data)) {
+        metrics.error();
+        return;
+    }
+    deliver({ &data, 1 });
+}
+
+void ${className}::deliver(hexarch::utils::Span<const domain::model::${modelName}> batch) {
+    if (!batch.empty()) {
+        // One timed call per batch; a throwing handler counts as an error
+        hexarch::utils::metrics::ScopedTimer timer(metrics, batch.size());
+        port.onBatchReceived(batch);
+    }
+}
+
+bool ${className}::decode(const unsigned char* bytes, std::size_t size, domain::model::${modelName}& out) const {
+    // TODO: Rebuild ${modelName} from one ${technology} record, e.g. through the codec from
+    // "Generate Datagram Codecs" (adapters/common/<middleware>/codec)
+    (void)bytes;
+    (void)size;
+    (void)out;
+    return false;
 }
 
 } // namespace ${namespace}
@@ -298,3 +740,310 @@ void ${className}::startListening() {
 
     return { header, source };
 }
+
+function generateIpcOutgoingAdapter(namespace: string, className: string, modelName: string, relativePortPath: string, headerExt: string): { header: string, source: string } {
+    const portClass = `I${modelName}OutgoingPort`;
+
+    const header = `#pragma once
+
+#include "${relativePortPath}"
+#include "utils/PortMetrics.hpp"
+#include "utils/ShmRing.hpp"
+
+#include <cstddef>
+#include <string>
+
+namespace ${namespace} {
+
+// Hands each ${modelName} to a co-located component through the shared-memory
+// ring of utils/ShmRing.hpp: encoded straight into the mapping, no broker and
+// no copy. The consuming component's IPC incoming adapter must use the same
+// channel; prefix it when several deployments share a host.
+// Not thread-safe: call send() from one thread.
+class ${className} : public domain::ports::outgoing::${portClass} {
+public:
+    explicit ${className}(const std::string& channel = "${modelName}",
+                          std::size_t capacity = hexarch::utils::kShmDefaultCapacity);
+    virtual ~${className}() = default;
+
+    void send(const domain::model::${modelName}& data) override;
+    void sendBatch(hexarch::utils::Span<const domain::model::${modelName}> batch) override;
+
+    // Whether the consuming component is attached (alive), never was (absent) or crashed (dead)
+    hexarch::utils::PeerState consumer() const;
+    hexarch::utils::ShmStats stats() const;
+
+private:
+    // Upper bound of encode()'s output, e.g. the codec's kWireSize
+    static constexpr std::size_t kMaxEncodedSize = 256;
+
+    // Serialises one model into out; returns the byte count, 0 if it does not fit
+    std::size_t encode(const domain::model::${modelName}& data, unsigned char* out, std::size_t capacity) const;
+
+    hexarch::utils::ShmProducer ring;
+    hexarch::utils::metrics::PortMetrics& metrics;
+};
+
+} // namespace ${namespace}
+`;
+
+    const source = `#include "${className}${headerExt}"
+#include "utils/AsyncLog.hpp"
+
+namespace ${namespace} {
+
+${className}::${className}(const std::string& channel, std::size_t capacity)
+    : ring(channel, capacity),
+      metrics(hexarch::utils::metrics::port("${portClass}", "${className}", hexarch::utils::metrics::Direction::Outgoing)) {}
+
+void ${className}::send(const domain::model::${modelName}& data) {
+    hexarch::utils::metrics::ScopedTimer timer(metrics);
+    // Waits up to 100 ms for space while the consumer is alive; drops otherwise
+    unsigned char* out = ring.claim(kMaxEncodedSize);
+    if (out == nullptr) {
+        timer.fail();
+        HEXARCH_LOG_WARN("[IPC] ${modelName} dropped on {}: ring full, consumer {}", ring.name(), hexarch::utils::toString(ring.consumer()));
+        return;
+    }
+    const std::size_t size = encode(data, out, kMaxEncodedSize);
+    if (size == 0) {
+        // Nothing committed; the next claim reuses the space
+        timer.fail();
+        return;
+    }
+    ring.commit(size);
+    timer.addBytes(size);
+}
+
+void ${className}::sendBatch(hexarch::utils::Span<const domain::model::${modelName}> batch) {
+    // Each commit is a store and, only if the consumer sleeps, one futex wake
+    for (const domain::model::${modelName}& data : batch) {
+        send(data);
+    }
+}
+
+hexarch::utils::PeerState ${className}::consumer() const {
+    return ring.consumer();
+}
+
+hexarch::utils::ShmStats ${className}::stats() const {
+    return ring.stats();
+}
+
+std::size_t ${className}::encode(const domain::model::${modelName}& data, unsigned char* out, std::size_t capacity) const {
+    // TODO: Serialise ${modelName} with the codec from "Generate Datagram Codecs", e.g.
+    //   return ${modelName}Codec::encode(fields, out, capacity);
+    (void)data;
+    (void)out;
+    (void)capacity;
+    return 0;
+}
+
+} // namespace ${namespace}
+`;
+
+    return { header, source };
+}
+
+function generateIpcIncomingAdapter(namespace: string, className: string, modelName: string, relativePortPath: string, headerExt: string): { header: string, source: string } {
+    const portClass = `I${modelName}IncomingPort`;
+
+    const header = `#pragma once
+
+#include "${relativePortPath}"
+#include "utils/PortMetrics.hpp"
+#include "utils/ShmRing.hpp"
+#include "utils/TrafficLog.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ${namespace} {
+
+// Receives ${modelName} from a co-located component through the shared-memory
+// ring of utils/ShmRing.hpp, decoding each record in place in the mapping.
+// Everything one poll returns reaches the port as one batch.
+class ${className} {
+private:
+    // Reference to the port (usually implemented by the Domain Service)
+    domain::ports::incoming::${portClass}& port;
+    hexarch::utils::ShmConsumer ring;
+    std::vector<domain::model::${modelName}> batch;
+    hexarch::utils::metrics::PortMetrics& metrics;
+    // Set when HEXARCH_CAPTURE_DIR is, for replay/ReplayMain.cpp
+    std::unique_ptr<hexarch::utils::TrafficRecorder> recorder;
+    // Set once by stop(), never cleared, so a stop() before startListening() holds
+    std::atomic<bool> stopRequested{ false };
+
+public:
+    explicit ${className}(domain::ports::incoming::${portClass}& port,
+                          const std::string& channel = "${modelName}",
+                          std::size_t capacity = hexarch::utils::kShmDefaultCapacity);
+    virtual ~${className}() = default;
+
+    // Polls the ring on the calling thread until stop(); returns at once if stop() came first
+    void startListening();
+    // Safe from any thread; wakes the listener if it is asleep on the ring
+    void stop();
+
+    // Decodes one record and delivers it on its own; the replay driver's entry point
+    void receive(const unsigned char* bytes, std::size_t size);
+
+    // Delivers one poll's worth of messages to the port in a single call
+    void deliver(hexarch::utils::Span<const domain::model::${modelName}> batch);
+
+    // Whether the producing component is attached (alive), never was (absent) or crashed (dead)
+    hexarch::utils::PeerState producer() const;
+
+private:
+    static constexpr std::size_t kMaxBatch = 256;
+
+    // Appends the record's model to batch (recording it first when capturing)
+    void collect(const unsigned char* bytes, std::size_t size);
+
+    // Rebuilds a model from one record; bytes point into shared memory
+    bool decode(const unsigned char* bytes, std::size_t size, domain::model::${modelName}& out) const;
+};
+
+} // namespace ${namespace}
+`;
+
+    const source = `#include "${className}${headerExt}"
+#include "utils/AsyncLog.hpp"
+
+#include <chrono>
+
+namespace ${namespace} {
+
+${className}::${className}(domain::ports::incoming::${portClass}& port, const std::string& channel, std::size_t capacity)
+    : port(port),
+      ring(channel, capacity),
+      metrics(hexarch::utils::metrics::port("${portClass}", "${className}", hexarch::utils::metrics::Direction::Incoming)),
+      recorder(hexarch::utils::TrafficRecorder::fromEnv(channel)) {
+    batch.reserve(kMaxBatch);
+}
+
+void ${className}::startListening() {
+    HEXARCH_LOG_INFO("[IPC] Adapter started listening for ${modelName} on {}", ring.name());
+    hexarch::utils::PeerState last = ring.producer();
+    while (!stopRequested.load(std::memory_order_acquire)) {
+        // Sleeps on the ring's futex; wakes for data, stop() or a producer change
+        if (!ring.wait(std::chrono::milliseconds(100))) {
+            const hexarch::utils::PeerState state = ring.producer();
+            if (state != last) {
+                HEXARCH_LOG_WARN("[IPC] ${modelName} producer on {} is {}", ring.name(), hexarch::utils::toString(state));
+                last = state;
+            }
+            continue;
+        }
+        batch.clear();
+        ring.poll([this](const unsigned char* bytes, std::size_t size) { collect(bytes, size); }, kMaxBatch);
+        deliver(batch);
+    }
+}
+
+void ${className}::stop() {
+    stopRequested.store(true, std::memory_order_release);
+    ring.wake();
+}
+
+void ${className}::receive(const unsigned char* bytes, std::size_t size) {
+    batch.clear();
+    collect(bytes, size);
+    deliver(batch);
+}
+
+void ${className}::collect(const unsigned char* bytes, std::size_t size) {
+    if (recorder) {
+        recorder->append(bytes, size);
+    }
+    batch.emplace_back();
+    if (!decode(bytes, size, batch.back())) {
+        batch.pop_back();
+        metrics.error();
+    }
+}
+
+void ${className}::deliver(hexarch::utils::Span<const domain::model::${modelName}> batch) {
+    if (!batch.empty()) {
+        // One timed call per batch; a throwing handler counts as an error
+        hexarch::utils::metrics::ScopedTimer timer(metrics, batch.size());
+        port.onBatchReceived(batch);
+    }
+}
+
+hexarch::utils::PeerState ${className}::producer() const {
+    return ring.producer();
+}
+
+bool ${className}::decode(const unsigned char* bytes, std::size_t size, domain::model::${modelName}& out) const {
+    // TODO: Read the fields through the codec's view, without copying the record, e.g.
+    //   ${modelName}View view;
+    //   if (${modelName}Codec::decode(bytes, size, view) != wire::DecodeStatus::Ok) return false;
+    //   out.setName(std::string(view.name())); ...
+    (void)bytes;
+    (void)size;
+    (void)out;
+    return false;
+}
+
+} // namespace ${namespace}
+`;
+
+    return { header, source };
+}
+
+function generateReplayRegistration(namespace: string, className: string, modelName: string, adapterInclude: string, isIpc: boolean): string {
+    const portClass = `I${modelName}IncomingPort`;
+
+    // The IPC adapter opens its ring on construction: give it a private one so a
+    // replay never attaches to a running component's channel
+    const makeAdapter = isIpc
+        ? `const std::string ring = "${modelName}-replay-" + std::to_string(::getpid());
+    auto adapter = std::make_shared<${className}>(*service, ring);
+    hexarch::utils::removeShmChannel(ring);`
+        : `auto adapter = std::make_shared<${className}>(*service);`;
+    const ipcIncludes = isIpc ? `
+#include <string>
+#include <unistd.h>` : '';
+
+    return `// Registers ${className} with the replay driver (ReplayMain.cpp) for the
+// "${modelName}" channel it captures, so that
+//   make replay REPLAY_ARGS="<capture dir> ${modelName}"
+// feeds each captured record to its receive().
+//
+// Replayed messages reach ReplaySink, which only counts them: to replay through
+// the domain logic as well, construct the domain service implementing
+// ${portClass} here instead.
+
+#include "ReplayChannels.hpp"
+#include "${adapterInclude}"
+
+#include <cstddef>
+#include <memory>${ipcIncludes}
+
+namespace ${namespace} {
+namespace {
+
+class ReplaySink final : public domain::ports::incoming::${portClass} {
+public:
+    void onDataReceived(const domain::model::${modelName}&) override { ++received; }
+
+    std::size_t received = 0;
+};
+
+const hexarch::replay::ChannelRegistration registration("${modelName}", "${className}", [] {
+    auto service = std::make_shared<ReplaySink>();
+    ${makeAdapter}
+    return hexarch::replay::Handler([service, adapter](const unsigned char* bytes, std::size_t size) {
+        adapter->receive(bytes, size);
+    });
+});
+
+} // namespace
+} // namespace ${namespace}
+`;
+}
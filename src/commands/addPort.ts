@@ -48,7 +48,16 @@ async function addPort(uri: vscode.Uri, type: 'incoming' | 'outgoing') {
     }
 
     // Find the actual file name for the selected model
-    const selectedModelFile = files.find(f => f.startsWith(selectedModel) && (f.endsWith('.h') || f.endsWith('.hpp')));
+    const headers = files.filter(f => f.endsWith('.h') || f.endsWith('.hpp'));
+    const stem = (f: string) => f.replace(/\.(h|hpp)$/, '');
+    const selectedModelFile = headers.find(f => stem(f) === selectedModel);
+
+    // Columnar companion model (OrderBatch, ProductTable), if the project has one
+    const columnarFile = headers.find(f => stem(f) === `${selectedModel}Batch` || stem(f) === `${selectedModel}Table`);
+
+    // Models with field-level change tracking (encodeDelta/applyDelta) get delta methods
+    const tracksChanges = selectedModelFile !== undefined
+        && fs.readFileSync(path.join(modelDir, selectedModelFile), 'utf8').includes('encodeDelta(');
 
     // Generate Port Interface
     // modelDir is .../domain/model
@@ -71,7 +80,7 @@ async function addPort(uri: vscode.Uri, type: 'incoming' | 'outgoing') {
     // Determine namespace
     const namespace = getNamespaceFromPath(modelDir);
 
-    const content = generatePortContent(selectedModel, namespace, selectedModelFile || `${selectedModel}${headerExt}`, type);
+    const content = generatePortContent(selectedModel, namespace, selectedModelFile || `${selectedModel}${headerExt}`, type, columnarFile, tracksChanges);
     
     fs.writeFileSync(portFile, content);
     
@@ -107,14 +116,65 @@ function getNamespaceFromPath(modelDir: string): string {
     return parts[parts.length - 3];
 }
 
-function generatePortContent(modelName: string, namespace: string, modelFileName: string, type: 'incoming' | 'outgoing'): string {
+function generatePortContent(modelName: string, namespace: string, modelFileName: string, type: 'incoming' | 'outgoing', columnarFileName?: string, tracksChanges = false): string {
     const suffix = type === 'incoming' ? 'IncomingPort' : 'OutgoingPort';
     const className = `I${modelName}${suffix}`;
     const methodName = type === 'incoming' ? 'onDataReceived' : 'send';
+    const batchMethodName = type === 'incoming' ? 'onBatchReceived' : 'sendBatch';
+    const batchComment = type === 'incoming'
+        ? '// Called once per middleware poll batch. Override to amortise per-batch work;\n        // the default forwards each message to onDataReceived().'
+        : '// Sends a whole batch. Override to hand it to the transport in one call;\n        // the default sends each message through send().';
+
+    const columnarName = columnarFileName ? columnarFileName.replace(/\.(h|hpp)$/, '') : '';
+    const columnarMethodName = type === 'incoming' ? 'onColumnsReceived' : 'sendColumns';
+    const columnarInclude = columnarFileName ? `\n#include "domain/model/${columnarFileName}"` : '';
+    const columnarMethod = columnarFileName ? `
+
+        ${type === 'incoming'
+            ? `// Columnar form of a batch. Override to aggregate on the columns directly;\n        // the default rebuilds the rows and forwards them to ${batchMethodName}().`
+            : `// Sends a columnar batch. Override when the transport can take columns;\n        // the default rebuilds the rows and sends them through ${batchMethodName}().`}
+        virtual void ${columnarMethodName}(const model::${columnarName}& columns) {
+            const std::vector<model::${modelName}> rows = columns.toRows();
+            ${batchMethodName}(rows);
+        }` : '';
+
+    const deltaMethods = !tracksChanges ? '' : type === 'incoming' ? `
+
+        // A delta record from a publisher's sendChanges(). Applies it to the
+        // local copy and forwards the result to ${methodName}(). Returns false
+        // when the record does not fit the copy; ask the publisher to resend
+        // the whole object (markAllDirty()).
+        virtual bool onDeltaReceived(model::${modelName}& target, hexarch::utils::Span<const unsigned char> delta) {
+            if (!target.applyDelta(delta.data(), delta.size())) {
+                return false;
+            }
+            ${methodName}(target);
+            return true;
+        }` : `
+
+        // Publishes the fields changed since the last call (nothing if none),
+        // then clears them. Override sendDelta() to put the record on the wire.
+        virtual void sendChanges(model::${modelName}& data) {
+            if (data.dirtyFields() == 0) {
+                return;
+            }
+            std::vector<unsigned char> delta;
+            data.encodeDelta(delta);
+            sendDelta(data, hexarch::utils::Span<const unsigned char>(delta.data(), delta.size()));
+            data.clearDirty();
+        }
+
+        // The default sends the whole object through ${methodName}().
+        virtual void sendDelta(const model::${modelName}& data, hexarch::utils::Span<const unsigned char> delta) {
+            (void)delta;
+            ${methodName}(data);
+        }`;
+    const needsVector = columnarFileName !== undefined || (tracksChanges && type === 'outgoing');
 
     return `#pragma once
 
-#include "domain/model/${modelFileName}"
+#include "domain/model/${modelFileName}"${columnarInclude}
+#include "utils/Span.hpp"${needsVector ? '\n\n#include <vector>' : ''}
 
 namespace ${namespace} {
 namespace domain {
@@ -126,6 +186,13 @@ namespace ${type} {
         virtual ~${className}() = default;
         
         virtual void ${methodName}(const model::${modelName}& data) = 0;
+
+        ${batchComment}
+        virtual void ${batchMethodName}(hexarch::utils::Span<const model::${modelName}> batch) {
+            for (const model::${modelName}& data : batch) {
+                ${methodName}(data);
+            }
+        }${columnarMethod}${deltaMethods}
     };
 
 } // namespace ${type}
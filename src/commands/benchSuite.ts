@@ -0,0 +1,353 @@
+import * as vscode from 'vscode';
+import * as fs from 'fs';
+import * as path from 'path';
+
+const COMPONENT_MARKERS = ['.project_white', '.project_dark', '.project_gray'];
+const GENERATED_FILE = 'GeneratedBench.cpp';
+
+interface ModelInfo {
+    name: string;
+    qualifiedName: string;
+    header: string;
+    getters: string[];
+    tracksChanges: boolean;
+}
+
+interface PortInfo {
+    className: string;
+    namespaces: string[];
+    header: string;
+    modelType: string;
+    method: string;
+    batchMethod: string;
+}
+
+interface CodecInfo {
+    name: string;
+    namespace: string;
+    header: string;
+}
+
+/**
+ * Writes bench/GeneratedBench.cpp for the selected component (or for every
+ * component under the selected folder): construction/copy/getter benches for
+ * each model, encode/decode for each generated datagram codec and delta codec,
+ * and virtual dispatch for each port. `make bench` builds it with the static
+ * suite files scaffolded into bench/.
+ */
+export async function generateBenchmarks(uri?: vscode.Uri) {
+    try {
+        if (!uri || !uri.fsPath) {
+            vscode.window.showErrorMessage('No folder selected');
+            return;
+        }
+
+        const components = findComponents(uri.fsPath);
+        if (components.length === 0) {
+            vscode.window.showErrorMessage('Could not find a component (.project_white, .project_dark or .project_gray marker)');
+            return;
+        }
+
+        const generated: string[] = [];
+        for (const componentDir of components) {
+            const srcDir = findSourceDirectory(componentDir);
+            if (!srcDir) {
+                continue;
+            }
+            const content = generateBenchSource(
+                collectModels(srcDir),
+                collectCodecs(srcDir),
+                collectPorts(srcDir));
+            // Only components scaffolded with bench/bench.mk can build it
+            const benchDir = path.join(componentDir, 'bench');
+            if (!fs.existsSync(path.join(benchDir, 'bench.mk'))) {
+                continue;
+            }
+            const outputPath = path.join(benchDir, GENERATED_FILE);
+            fs.writeFileSync(outputPath, content, 'utf-8');
+            generated.push(outputPath);
+        }
+
+        await vscode.commands.executeCommand('workbench.files.action.refreshFilesExplorer');
+
+        if (generated.length === 0) {
+            vscode.window.showWarningMessage('No component with bench/bench.mk and a src/<app>/domain/model directory found.');
+        } else {
+            vscode.window.showInformationMessage(`Generated ${generated.length} benchmark file(s); run "make bench" in the component.`);
+        }
+    } catch (error) {
+        vscode.window.showErrorMessage(`Failed to generate benchmarks: ${error}`);
+        console.error('❌ Generate benchmarks error:', error);
+    }
+}
+
+/**
+ * The component containing startPath, or else every component below it.
+ */
+function findComponents(startPath: string): string[] {
+    let current = startPath;
+    for (let i = 0; i < 15; i++) {
+        if (COMPONENT_MARKERS.some(marker => fs.existsSync(path.join(current, marker)))) {
+            return [current];
+        }
+        const parent = path.dirname(current);
+        if (parent === current) {
+            break;
+        }
+        current = parent;
+    }
+
+    const found: string[] = [];
+    function searchRecursive(dir: string, depth: number) {
+        if (depth > 3) return;
+        try {
+            const entries = fs.readdirSync(dir, { withFileTypes: true });
+            if (entries.some(entry => COMPONENT_MARKERS.includes(entry.name))) {
+                found.push(dir);
+                return;
+            }
+            for (const entry of entries) {
+                if (entry.isDirectory() && !entry.name.startsWith('.')) {
+                    searchRecursive(path.join(dir, entry.name), depth + 1);
+                }
+            }
+        } catch (error) {
+            // Unreadable directories are skipped
+        }
+    }
+    searchRecursive(startPath, 0);
+    return found;
+}
+
+/**
+ * componentDir/src/<app>, the directory holding domain/ and adapters/.
+ */
+function findSourceDirectory(componentDir: string): string | null {
+    const srcPath = path.join(componentDir, 'src');
+    if (!fs.existsSync(srcPath)) {
+        return null;
+    }
+    for (const subdir of fs.readdirSync(srcPath)) {
+        if (fs.existsSync(path.join(srcPath, subdir, 'domain', 'model'))) {
+            return path.join(srcPath, subdir);
+        }
+    }
+    return null;
+}
+
+function listHeaders(dir: string): string[] {
+    if (!fs.existsSync(dir)) {
+        return [];
+    }
+    return fs.readdirSync(dir).filter(f => f.endsWith('.h') || f.endsWith('.hpp')).sort();
+}
+
+function stripComments(source: string): string {
+    return source
+        .replace(/\/\*[\s\S]*?\*\//g, match => match.replace(/[^\n]/g, ' '))
+        .replace(/\/\/[^\n]*/g, match => ' '.repeat(match.length))
+        .replace(/"(?:[^"\\\n]|\\.)*"/g, match => '"' + ' '.repeat(match.length - 2) + '"')
+        .replace(/'(?:[^'\\\n]|\\.)*'/g, match => "'" + ' '.repeat(match.length - 2) + "'");
+}
+
+/**
+ * Namespaces open at `position` (comments already stripped).
+ */
+function namespacesAt(source: string, position: number): string[] {
+    const stack: (string | null)[] = [];
+    const opener = /namespace\s+([A-Za-z_][\w:]*)\s*\{/y;
+    for (let i = 0; i < position; i++) {
+        const ch = source[i];
+        if (ch === 'n') {
+            opener.lastIndex = i;
+            const match = opener.exec(source);
+            if (match && (i === 0 || !/\w/.test(source[i - 1]))) {
+                stack.push(match[1]);
+                i = opener.lastIndex - 1;
+                continue;
+            }
+        }
+        if (ch === '{') stack.push(null);
+        if (ch === '}') stack.pop();
+    }
+    return stack.filter((name): name is string => name !== null).flatMap(name => name.split('::'));
+}
+
+/**
+ * The non-template class or struct `name` defined in source: where its body
+ * starts and its body with nested braces removed.
+ */
+function findClassBody(source: string, name: string): { position: number, isStruct: boolean, body: string } | null {
+    const pattern = new RegExp(`\\b(class|struct)\\s+${name}\\b(\\s+final)?\\s*(:[^{;]*)?\\{`, 'g');
+    const match = pattern.exec(source);
+    if (!match || /template\s*<[^;{}]*>$/.test(source.slice(0, match.index).trimEnd())) {
+        return null;
+    }
+    // Inline member bodies become ';' so each declaration stays separated
+    let depth = 1;
+    let body = '';
+    for (let i = pattern.lastIndex; i < source.length && depth > 0; i++) {
+        const ch = source[i];
+        if (ch === '{') depth++;
+        else if (ch === '}') depth--;
+        if (depth === 1) body += ch === '}' ? ';' : ch;
+    }
+    return { position: match.index, isStruct: match[1] === 'struct', body };
+}
+
+/**
+ * Public, non-void `get*() const`, `is*() const` and `has*() const` members.
+ */
+function publicGetters(body: string, isStruct: boolean): string[] {
+    const getters = new Set<string>();
+    const sections = body.split(/\b(public|private|protected)\s*:/);
+    let access = isStruct ? 'public' : 'private';
+    for (let i = 0; i < sections.length; i++) {
+        if (i % 2 === 1) {
+            access = sections[i];
+            continue;
+        }
+        if (access !== 'public') continue;
+        const getter = /(^|[;{}])\s*(?:\[\[[^\]]*\]\]\s*)?((?:[\w:<>,*&]+\s+)*?[\w:<>,*&]+)\s*\b((?:get|is|has)[A-Z]\w*)\s*\(\s*\)\s*const\b/g;
+        let match: RegExpExecArray | null;
+        while ((match = getter.exec(sections[i])) !== null) {
+            const returnType = match[2].trim();
+            if (/\b(void|static|template|operator)\b/.test(returnType)) continue;
+            getters.add(match[3]);
+        }
+    }
+    return [...getters];
+}
+
+function collectModels(srcDir: string): ModelInfo[] {
+    const modelDir = path.join(srcDir, 'domain', 'model');
+    const models: ModelInfo[] = [];
+    for (const file of listHeaders(modelDir)) {
+        const name = file.replace(/\.(h|hpp)$/, '');
+        const source = stripComments(fs.readFileSync(path.join(modelDir, file), 'utf-8'));
+        const found = findClassBody(source, name);
+        if (!found) {
+            continue;
+        }
+        const namespaces = namespacesAt(source, found.position);
+        models.push({
+            name,
+            qualifiedName: [...namespaces, name].join('::'),
+            header: `domain/model/${file}`,
+            getters: publicGetters(found.body, found.isStruct),
+            tracksChanges: /\bencodeDelta\s*\(/.test(found.body) && /\bapplyDelta\s*\(/.test(found.body)
+        });
+    }
+    return models;
+}
+
+function collectPorts(srcDir: string): PortInfo[] {
+    const ports: PortInfo[] = [];
+    for (const type of ['incoming', 'outgoing']) {
+        const portsDir = path.join(srcDir, 'domain', 'ports', type);
+        for (const file of listHeaders(portsDir)) {
+            const className = file.replace(/\.(h|hpp)$/, '');
+            const source = stripComments(fs.readFileSync(path.join(portsDir, file), 'utf-8'));
+            const found = findClassBody(source, className);
+            if (!found) {
+                continue;
+            }
+            // Only ports whose sole pure virtual is the one addPort generates
+            const pureVirtuals = source.match(/=\s*0\s*;/g) || [];
+            const method = type === 'incoming' ? 'onDataReceived' : 'send';
+            const signature = new RegExp(`virtual\\s+void\\s+${method}\\s*\\(\\s*const\\s+([\\w:]+)\\s*&`).exec(source);
+            if (pureVirtuals.length !== 1 || !signature) {
+                continue;
+            }
+            ports.push({
+                className,
+                namespaces: namespacesAt(source, found.position),
+                header: `domain/ports/${type}/${file}`,
+                modelType: signature[1],
+                method,
+                batchMethod: type === 'incoming' ? 'onBatchReceived' : 'sendBatch'
+            });
+        }
+    }
+    return ports;
+}
+
+function collectCodecs(srcDir: string): CodecInfo[] {
+    const codecs: CodecInfo[] = [];
+    const commonDir = path.join(srcDir, 'adapters', 'common');
+    if (!fs.existsSync(commonDir)) {
+        return codecs;
+    }
+    for (const mw of fs.readdirSync(commonDir).sort()) {
+        const codecDir = path.join(commonDir, mw, 'codec');
+        for (const file of listHeaders(codecDir).filter(f => /Codec\.(h|hpp)$/.test(f))) {
+            const source = stripComments(fs.readFileSync(path.join(codecDir, file), 'utf-8'));
+            const match = /struct\s+(\w+)Codec\s*\{/.exec(source);
+            if (!match) {
+                continue;
+            }
+            codecs.push({
+                name: match[1],
+                namespace: namespacesAt(source, match.index).join('::'),
+                header: `adapters/common/${mw}/codec/${file}`
+            });
+        }
+    }
+    return codecs;
+}
+
+function generateBenchSource(models: ModelInfo[], codecs: CodecInfo[], ports: PortInfo[]): string {
+    const includes = [...models.map(m => m.header), ...codecs.map(c => c.header), ...ports.map(p => p.header)]
+        .map(header => `#include "${header}"`).join('\n');
+
+    // Counting implementations, declared in the port's namespace so the model
+    // type resolves exactly as it does in the port header
+    const sinks = ports.map(p => {
+        const open = p.namespaces.map(ns => `namespace ${ns} {`).join(' ');
+        const close = p.namespaces.map(() => '}').join(' ');
+        return `${open}
+    struct Bench${p.className}Sink final : ${p.className} {
+        using Port = ${p.className};
+        using Model = ${p.modelType};
+        void ${p.method}(const Model& data) override {
+            (void)data;
+            ++calls;
+        }
+        std::size_t calls = 0;
+    };
+${close}`;
+    }).join('\n\n');
+
+    const modelLines = models.map(m => {
+        const getters = m.getters.length > 0
+            ? `[](const ${m.qualifiedName}& m) {\n${m.getters.map(g => `        doNotOptimize(m.${g}());`).join('\n')}\n    }`
+            : `[](const ${m.qualifiedName}& m) { doNotOptimize(m); }`;
+        const delta = m.tracksChanges ? `\n    addDeltaBenches<${m.qualifiedName}>("${m.name}");` : '';
+        return `    addModelBenches<${m.qualifiedName}>("${m.name}", ${getters});${delta}`;
+    });
+
+    const codecLines = codecs.map(c =>
+        `    addCodecBenches<${c.namespace}::${c.name}Codec, ${c.namespace}::${c.name}, ${c.namespace}::${c.name}View>("${c.name}");`);
+
+    const portLines = ports.map(p => {
+        const sink = [...p.namespaces, `Bench${p.className}Sink`].join('::');
+        return `    addPortBenches<${sink}>("${p.className}",
+        [](auto& port, const auto& data) { port.${p.method}(data); },
+        [](auto& port, auto batch) { port.${p.batchMethod}(batch); });`;
+    });
+
+    const section = (title: string, lines: string[]) => lines.length > 0 ? `\n    // ${title}\n${lines.join('\n')}\n` : '';
+
+    return `// Generated by HexDef from domain/model, domain/ports and adapters/common/*/codec;
+// regenerate instead of editing. Specialise hexarch::bench::BenchSample in
+// another bench/*.cpp to measure a populated model instead of a default one.
+
+#include "BenchSuite.hpp"
+${includes ? `\n${includes}\n` : ''}
+#include <cstddef>
+
+using namespace hexarch::bench;
+${sinks ? `\n${sinks}\n` : ''}
+HEXARCH_BENCH_SUITE(registerGeneratedBenches) {${section('Models', modelLines)}${section('Codecs', codecLines)}${section('Ports', portLines)}}
+`;
+}
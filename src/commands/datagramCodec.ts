@@ -0,0 +1,548 @@
+/**
+ * Datagram XML -> C++ binary codec generator.
+ *
+ * Every datagram becomes a fixed-layout, little-endian record:
+ *   12-byte header (magic, schema version, fingerprint, payload size)
+ *   fields in declaration order, no padding
+ *
+ * The generated header contains a plain field struct, a zero-copy view that
+ * reads fields straight out of the received buffer, and a codec with
+ * encode() into a caller buffer and decode() into a view. The runtime helpers
+ * live in utils/WireCodec.hpp.
+ *
+ * generateSchemaHeader() then turns the program XML and all definitions into
+ * one DatagramSchema header of constexpr tables (layouts, keys, roles, a
+ * perfect-hash name -> id map), backed by utils/SchemaTable.hpp.
+ */
+
+export interface DatagramField {
+    name: string;
+    type: string;
+    /** Capacity in bytes for string fields */
+    length?: number;
+}
+
+export interface DatagramDefinition {
+    name: string;
+    version: number;
+    fields: DatagramField[];
+    keys: string[];
+}
+
+interface WireType {
+    cppType: string;
+    size: number;
+}
+
+const WIRE_TYPES: { [xmlType: string]: WireType } = {
+    bool: { cppType: 'bool', size: 1 },
+    char: { cppType: 'std::int8_t', size: 1 },
+    int8: { cppType: 'std::int8_t', size: 1 },
+    byte: { cppType: 'std::uint8_t', size: 1 },
+    uint8: { cppType: 'std::uint8_t', size: 1 },
+    short: { cppType: 'std::int16_t', size: 2 },
+    int16: { cppType: 'std::int16_t', size: 2 },
+    ushort: { cppType: 'std::uint16_t', size: 2 },
+    uint16: { cppType: 'std::uint16_t', size: 2 },
+    int: { cppType: 'std::int32_t', size: 4 },
+    int32: { cppType: 'std::int32_t', size: 4 },
+    uint: { cppType: 'std::uint32_t', size: 4 },
+    uint32: { cppType: 'std::uint32_t', size: 4 },
+    // long is 64-bit on the wire regardless of the host's sizeof(long)
+    long: { cppType: 'std::int64_t', size: 8 },
+    int64: { cppType: 'std::int64_t', size: 8 },
+    ulong: { cppType: 'std::uint64_t', size: 8 },
+    uint64: { cppType: 'std::uint64_t', size: 8 },
+    float: { cppType: 'float', size: 4 },
+    double: { cppType: 'double', size: 8 }
+};
+
+const DEFAULT_STRING_LENGTH = 32;
+const MAX_STRING_LENGTH = 65535;
+const HEADER_SIZE = 12;
+
+const RESERVED_IDENTIFIERS = new Set([
+    'auto', 'bool', 'break', 'case', 'char', 'class', 'const', 'default', 'delete', 'do', 'double',
+    'else', 'enum', 'explicit', 'float', 'for', 'if', 'int', 'long', 'namespace', 'new', 'operator',
+    'private', 'protected', 'public', 'return', 'short', 'signed', 'sizeof', 'static', 'struct',
+    'switch', 'template', 'this', 'throw', 'typedef', 'union', 'unsigned', 'using', 'virtual',
+    'void', 'volatile', 'while',
+    // names the generated view/codec already use
+    'fields', 'payload', 'wire', 'keyHash', 'keyBytes'
+]);
+
+function attribute(tag: string, name: string): string | undefined {
+    const match = tag.match(new RegExp(`\\b${name}\\s*=\\s*"([^"]*)"`));
+    return match ? match[1] : undefined;
+}
+
+/**
+ * Parse a datagram definition file (see schemas/datagram.xml). Throws on
+ * unknown field types so a bad definition fails generation instead of
+ * producing a codec with a silently wrong layout.
+ */
+export function parseDatagramXml(content: string): DatagramDefinition {
+    // Skip the prolog, doctype and comments; the first remaining element is the datagram.
+    const body = content.replace(/<\?[\s\S]*?\?>/g, '').replace(/<!--[\s\S]*?-->/g, '').replace(/<!DOCTYPE[^>]*>/g, '');
+    const root = body.match(/<([A-Za-z_][\w.-]*)\b([^>]*)>/);
+    if (!root) {
+        throw new Error('No datagram element found');
+    }
+    const name = attribute(root[2], 'name');
+    if (!name) {
+        throw new Error(`<${root[1]}> has no name attribute`);
+    }
+    const version = parseInt(attribute(root[2], 'version') || '1', 10);
+    if (!(version >= 0 && version <= 65535)) {
+        throw new Error(`${name}: version must be between 0 and 65535`);
+    }
+
+    const definition = body.match(/<definition\b[^>]*>([\s\S]*?)<\/definition>/);
+    const fields: DatagramField[] = [];
+    const seen = new Set<string>();
+    const fieldRegex = /<field\b([^>]*?)\/?>/g;
+    let match;
+    while (definition && (match = fieldRegex.exec(definition[1])) !== null) {
+        const fieldName = attribute(match[1], 'name');
+        const type = (attribute(match[1], 'type') || '').toLowerCase();
+        if (!fieldName) {
+            throw new Error(`${name}: field without a name`);
+        }
+        if (seen.has(fieldName)) {
+            throw new Error(`${name}: duplicate field '${fieldName}'`);
+        }
+        seen.add(fieldName);
+
+        if (type === 'string') {
+            const length = parseInt(attribute(match[1], 'length') || `${DEFAULT_STRING_LENGTH}`, 10);
+            if (!(length > 0 && length <= MAX_STRING_LENGTH)) {
+                throw new Error(`${name}.${fieldName}: string length must be between 1 and ${MAX_STRING_LENGTH}`);
+            }
+            fields.push({ name: fieldName, type, length });
+        } else if (WIRE_TYPES[type]) {
+            fields.push({ name: fieldName, type });
+        } else {
+            throw new Error(`${name}.${fieldName}: unsupported type '${type}'`);
+        }
+    }
+
+    const keys: string[] = [];
+    const keysBlock = body.match(/<keys\b[^>]*>([\s\S]*?)<\/keys>/);
+    if (keysBlock) {
+        const keyRegex = /<key\b([^>]*?)\/?>/g;
+        while ((match = keyRegex.exec(keysBlock[1])) !== null) {
+            const keyName = attribute(match[1], 'name');
+            if (!keyName) {
+                continue;
+            }
+            if (!seen.has(keyName)) {
+                throw new Error(`${name}: key '${keyName}' is not a field`);
+            }
+            keys.push(keyName);
+        }
+    }
+
+    return { name, version, fields, keys };
+}
+
+/** 32-bit FNV-1a over the canonical layout string; changes whenever the wire layout does. */
+export function datagramFingerprint(def: DatagramDefinition): number {
+    const canonical = `${def.name}{` + def.fields
+        .map(f => f.type === 'string' ? `${f.name}:string[${f.length}]` : `${f.name}:${f.type}`)
+        .join(';') + '}';
+    let hash = 0x811c9dc5;
+    for (let i = 0; i < canonical.length; i++) {
+        hash ^= canonical.charCodeAt(i) & 0xff;
+        hash = Math.imul(hash, 0x01000193) >>> 0;
+    }
+    return hash >>> 0;
+}
+
+function fieldSize(field: DatagramField): number {
+    return field.type === 'string' ? 2 + (field.length as number) : WIRE_TYPES[field.type].size;
+}
+
+export function datagramPayloadSize(def: DatagramDefinition): number {
+    return def.fields.reduce((total, f) => total + fieldSize(f), 0);
+}
+
+function cppIdentifier(name: string): string {
+    let id = name.replace(/[^A-Za-z0-9_]/g, '_');
+    if (/^[0-9]/.test(id)) {
+        id = `_${id}`;
+    }
+    return RESERVED_IDENTIFIERS.has(id) ? `${id}_` : id;
+}
+
+function hex32(value: number): string {
+    return `0x${value.toString(16).padStart(8, '0')}u`;
+}
+
+/**
+ * Generate the codec header for one datagram.
+ * @param namespace C++ namespace, e.g. App::adapters::common::kafka::codec
+ */
+export function generateCodecHeader(def: DatagramDefinition, namespace: string, sourceFile: string): string {
+    const type = cppIdentifier(def.name);
+    const payloadSize = datagramPayloadSize(def);
+    const fingerprint = datagramFingerprint(def);
+
+    let offset = 0;
+    const layout = def.fields.map(f => {
+        const entry = { field: f, id: cppIdentifier(f.name), offset };
+        offset += fieldSize(f);
+        return entry;
+    });
+
+    const layoutComment = layout.map(e => {
+        const wire = e.field.type === 'string' ? `string[${e.field.length}]` : e.field.type;
+        return `//   +${String(e.offset).padEnd(5)} ${wire.padEnd(12)} ${e.field.name}`;
+    }).join('\n');
+
+    const members = layout.map(e => e.field.type === 'string'
+        ? `    std::string_view ${e.id};`
+        : `    ${WIRE_TYPES[e.field.type].cppType} ${e.id}${e.field.type === 'bool' ? ' = false' : ' = 0'};`).join('\n');
+
+    const getters = layout.map(e => e.field.type === 'string'
+        ? `    std::string_view ${e.id}() const { return wire::loadString(payload + ${e.offset}, ${e.field.length}); }`
+        : `    ${WIRE_TYPES[e.field.type].cppType} ${e.id}() const { return wire::load<${WIRE_TYPES[e.field.type].cppType}>(payload + ${e.offset}); }`).join('\n');
+
+    const copies = layout.map(e => `        out.${e.id} = ${e.id}();`).join('\n');
+
+    const stores = layout.map(e => e.field.type === 'string'
+        ? `        if (!wire::storeString(payload + ${e.offset}, msg.${e.id}, ${e.field.length})) return 0;`
+        : `        wire::store(payload + ${e.offset}, msg.${e.id});`).join('\n');
+
+    const keys = def.keys.length > 0 ? `\n// Keys: ${def.keys.join(', ')}` : '';
+    const keyIds = def.keys.map(k => cppIdentifier(k));
+    const viewKeyHash = keyIds.length > 0 ? `
+
+    // Hash of the declared keys, for KeyedExecutor shards and partitioning.
+    std::uint64_t keyHash() const {
+        std::uint64_t h = wire::kKeyHashSeed;
+${keyIds.map(id => `        h = wire::hashKey(h, ${id}());`).join('\n')}
+        return h;
+    }
+
+    // Declared keys as bytes (equal keys, equal strings), for per-entity maps.
+    void keyBytes(std::string& out) const {
+        out.clear();
+${keyIds.map(id => `        wire::appendKey(out, ${id}());`).join('\n')}
+    }` : '';
+    const codecKeyHash = keyIds.length > 0 ? `
+
+    // Same value as ${type}View::keyHash() of the encoded message.
+    static std::uint64_t keyHash(const ${type}& msg) {
+        std::uint64_t h = wire::kKeyHashSeed;
+${keyIds.map(id => `        h = wire::hashKey(h, msg.${id});`).join('\n')}
+        return h;
+    }
+
+    // Same bytes as ${type}View::keyBytes() of the encoded message.
+    static void keyBytes(const ${type}& msg, std::string& out) {
+        out.clear();
+${keyIds.map(id => `        wire::appendKey(out, msg.${id});`).join('\n')}
+    }` : '';
+
+    return `#pragma once
+
+// Generated by HexDef from ${sourceFile}; regenerate instead of editing.
+//
+// Wire layout: ${HEADER_SIZE}-byte header, then ${payloadSize} payload bytes, little-endian, no padding.
+${layoutComment || '//   (no fields)'}${keys}
+
+#include "utils/WireCodec.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace ${namespace} {
+
+namespace wire = hexarch::utils::wire;
+
+// Field values for encode(). String members are views; the caller keeps the
+// referenced characters alive until encode() returns.
+struct ${type} {
+${members || '    // no fields'}
+};
+
+// Zero-copy accessors over a decoded buffer; valid while that buffer is.
+class ${type}View {
+public:
+    ${type}View() = default;
+    explicit ${type}View(const unsigned char* payload) : payload(payload) {}
+
+${getters || '    // no fields'}
+
+    ${type} fields() const {
+        ${type} out;
+${copies}
+        return out;
+    }${viewKeyHash}
+
+private:
+    const unsigned char* payload = nullptr;
+};
+
+struct ${type}Codec {
+    static constexpr std::uint16_t kSchemaVersion = ${def.version};
+    static constexpr std::uint32_t kFingerprint = ${hex32(fingerprint)};
+    static constexpr std::size_t kPayloadSize = ${payloadSize};
+    static constexpr std::size_t kWireSize = wire::kHeaderSize + kPayloadSize;
+
+    // Writes kWireSize bytes into buffer. Returns the byte count, or 0 when
+    // capacity is too small or a string does not fit its fixed length.
+    static std::size_t encode(const ${type}& msg, unsigned char* buffer, std::size_t capacity) {
+        if (capacity < kWireSize) return 0;
+        wire::writeHeader(buffer, kSchemaVersion, kFingerprint, kPayloadSize);
+        unsigned char* payload = buffer + wire::kHeaderSize;
+${stores || '        (void)msg;\n        (void)payload;'}
+        return kWireSize;
+    }
+
+    // Validates the header and points view at the payload; no copies are made.
+    static wire::DecodeStatus decode(const unsigned char* buffer, std::size_t size, ${type}View& view) {
+        const wire::DecodeStatus status = wire::checkHeader(buffer, size, kSchemaVersion, kFingerprint, kPayloadSize);
+        if (status == wire::DecodeStatus::Ok) {
+            view = ${type}View(buffer + wire::kHeaderSize);
+        }
+        return status;
+    }
+
+    // Decodes back-to-back messages (one middleware record carrying a batch)
+    // and calls fn(view) for each, e.g. to append them to a columnar batch.
+    // Stops at the first message that does not decode and returns its status.
+    template <typename Fn>
+    static wire::DecodeStatus decodeEach(const unsigned char* buffer, std::size_t size, Fn&& fn) {
+        ${type}View view;
+        for (std::size_t at = 0; at < size; at += kWireSize) {
+            const wire::DecodeStatus status = decode(buffer + at, size - at, view);
+            if (status != wire::DecodeStatus::Ok) return status;
+            fn(view);
+        }
+        return wire::DecodeStatus::Ok;
+    }${codecKeyHash}
+};
+
+} // namespace ${namespace}
+`;
+}
+
+export interface ProgramDatagram {
+    definition: DatagramDefinition;
+    /** File name of the datagram's generated codec header */
+    codecHeader: string;
+    pub: boolean;
+    sub: boolean;
+}
+
+const FIELD_TYPES: { [cppType: string]: string } = {
+    'bool': 'Bool',
+    'std::int8_t': 'Int8',
+    'std::uint8_t': 'UInt8',
+    'std::int16_t': 'Int16',
+    'std::uint16_t': 'UInt16',
+    'std::int32_t': 'Int32',
+    'std::uint32_t': 'UInt32',
+    'std::int64_t': 'Int64',
+    'std::uint64_t': 'UInt64',
+    'float': 'Float',
+    'double': 'Double'
+};
+
+/** Same function as schema::nameHash() in utils/SchemaTable.hpp. */
+export function schemaNameHash(name: string, seed: number): number {
+    let h = (0x811c9dc5 ^ seed) >>> 0;
+    for (let i = 0; i < name.length; i++) {
+        h ^= name.charCodeAt(i) & 0xff;
+        h = Math.imul(h, 0x01000193) >>> 0;
+    }
+    h ^= h >>> 16;
+    h = Math.imul(h, 0x85ebca6b) >>> 0;
+    h ^= h >>> 13;
+    h = Math.imul(h, 0xc2b2ae35) >>> 0;
+    h ^= h >>> 16;
+    return h >>> 0;
+}
+
+export interface PerfectHash {
+    /** Per-bucket seed, indexed by nameHash(name, 0) % seeds.length */
+    seeds: number[];
+    /** Index into names, or -1; power-of-two length */
+    slots: number[];
+}
+
+/**
+ * Hash-and-displace perfect hash over names: each bucket gets the first seed
+ * that sends all of its names to free slots. Fullest buckets go first.
+ */
+export function buildPerfectHash(names: string[]): PerfectHash {
+    let slotCount = 1;
+    while (slotCount < names.length) {
+        slotCount *= 2;
+    }
+    const bucketCount = Math.max(1, Math.ceil(names.length / 2));
+    const buckets: number[][] = Array.from({ length: bucketCount }, () => []);
+    names.forEach((name, index) => buckets[schemaNameHash(name, 0) % bucketCount].push(index));
+
+    const seeds = new Array<number>(bucketCount).fill(0);
+    const slots = new Array<number>(slotCount).fill(-1);
+    const order = buckets.map((_, b) => b).sort((a, b) => buckets[b].length - buckets[a].length);
+    for (const b of order) {
+        if (buckets[b].length === 0) {
+            continue;
+        }
+        let placed = false;
+        for (let seed = 1; seed < 1000000 && !placed; seed++) {
+            const taken = buckets[b].map(index => schemaNameHash(names[index], seed) & (slotCount - 1));
+            if (taken.every((slot, i) => slots[slot] === -1 && taken.indexOf(slot) === i)) {
+                taken.forEach((slot, i) => { slots[slot] = buckets[b][i]; });
+                seeds[b] = seed;
+                placed = true;
+            }
+        }
+        if (!placed) {
+            throw new Error(`No perfect hash found for ${buckets[b].map(i => names[i]).join(', ')}`);
+        }
+    }
+    return { seeds, slots };
+}
+
+/**
+ * Generate DatagramSchema: constexpr tables for every datagram of one
+ * component, next to (and checked against) the codecs.
+ */
+export function generateSchemaHeader(datagrams: ProgramDatagram[], namespace: string, programFile: string): string {
+    const entries = datagrams.map(d => ({ ...d, id: cppIdentifier(d.definition.name) }));
+    const byFingerprint = new Map<number, string>();
+    for (const e of entries) {
+        const fingerprint = datagramFingerprint(e.definition);
+        const clash = byFingerprint.get(fingerprint);
+        if (clash) {
+            throw new Error(`${clash} and ${e.definition.name} have the same layout fingerprint; rename one`);
+        }
+        byFingerprint.set(fingerprint, e.definition.name);
+    }
+    const hash = buildPerfectHash(entries.map(e => e.definition.name));
+
+    const includes = entries.map(e => `#include "${e.codecHeader}"`).join('\n');
+    const ids = entries.map((e, i) => `    ${e.id} = ${i},`).join('\n');
+
+    const fieldTables = entries.map(e => {
+        if (e.definition.fields.length === 0) {
+            return `constexpr const schema::FieldInfo* k${e.id}Fields = nullptr;`;
+        }
+        let offset = 0;
+        const rows = e.definition.fields.map(f => {
+            const type = f.type === 'string' ? 'String' : FIELD_TYPES[WIRE_TYPES[f.type].cppType];
+            const row = `    { ${JSON.stringify(f.name)}, schema::FieldType::${type}, ${offset}, ${fieldSize(f)}, ${e.definition.keys.includes(f.name)} },`;
+            offset += fieldSize(f);
+            return row;
+        }).join('\n');
+        return `constexpr schema::FieldInfo k${e.id}Fields[] = {\n${rows}\n};`;
+    }).join('\n\n');
+
+    const role = (d: ProgramDatagram) => d.pub && d.sub ? 'PubSub' : d.pub ? 'Pub' : d.sub ? 'Sub' : 'None';
+    const infos = entries.map(e =>
+        `    { ${JSON.stringify(e.definition.name)}, ${e.definition.version}, ${hex32(datagramFingerprint(e.definition))}, ` +
+        `${datagramPayloadSize(e.definition)}, schema::Role::${role(e)}, schema_tables::k${e.id}Fields, ${e.definition.fields.length} },`).join('\n');
+
+    const checks = entries.map(e =>
+        `static_assert(${e.id}Codec::kFingerprint == ${hex32(datagramFingerprint(e.definition))}, "${e.definition.name}: codec and DatagramSchema are out of step; regenerate");`).join('\n');
+    const fingerprintCases = entries.map(e =>
+        `        case ${hex32(datagramFingerprint(e.definition))}: return DatagramId::${e.id};`).join('\n');
+    const visitCases = entries.map(e =>
+        `        case DatagramId::${e.id}: return visitor(schema::CodecTag<${e.id}Codec>{});`).join('\n');
+
+    return `#pragma once
+
+// Generated by HexDef from ${programFile} and ${entries.length} datagram definition(s); regenerate instead of editing.
+//
+// The component's datagram set as constexpr tables: look datagrams up with
+// datagramId("Name") / info(id) instead of reading XML at startup, and route
+// received records with datagramOf() + visit(), both plain switches.
+
+#include "utils/SchemaTable.hpp"
+
+${includes}
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+namespace ${namespace} {
+
+namespace schema = hexarch::utils::schema;
+
+enum class DatagramId : std::uint16_t {
+${ids}
+};
+
+constexpr std::size_t kDatagramCount = ${entries.length};
+
+namespace schema_tables {
+
+${fieldTables}
+
+// Perfect hash over the datagram names (see schema::perfectHashFind)
+constexpr std::uint32_t kSeeds[] = { ${hash.seeds.map(seed => `${seed}u`).join(', ')} };
+constexpr std::int16_t kSlots[] = { ${hash.slots.join(', ')} };
+
+} // namespace schema_tables
+
+// Indexed by DatagramId
+constexpr schema::DatagramInfo kDatagrams[kDatagramCount] = {
+${infos}
+};
+
+${checks}
+
+constexpr const schema::DatagramInfo& info(DatagramId id) {
+    return kDatagrams[static_cast<std::size_t>(id)];
+}
+
+// std::nullopt for a name that is not part of this component.
+constexpr std::optional<DatagramId> datagramId(std::string_view name) {
+    const int index = schema::perfectHashFind(name, schema_tables::kSeeds, schema_tables::kSlots, kDatagrams);
+    if (index < 0) {
+        return std::nullopt;
+    }
+    return static_cast<DatagramId>(index);
+}
+
+constexpr std::optional<DatagramId> datagramForFingerprint(std::uint32_t fingerprint) {
+    switch (fingerprint) {
+${fingerprintCases}
+        default: return std::nullopt;
+    }
+}
+
+// Which datagram an encoded record holds, from its header alone.
+inline std::optional<DatagramId> datagramOf(const unsigned char* bytes, std::size_t size) {
+    std::uint32_t fingerprint = 0;
+    if (!schema::peekFingerprint(bytes, size, fingerprint)) {
+        return std::nullopt;
+    }
+    return datagramForFingerprint(fingerprint);
+}
+
+// Calls visitor(schema::CodecTag<Codec>{}) with the datagram's codec type:
+//   visit(*datagramOf(p, n), [&](auto tag) {
+//       using Codec = typename decltype(tag)::type;
+//       ...
+//   });
+template <typename Visitor>
+decltype(auto) visit(DatagramId id, Visitor&& visitor) {
+    switch (id) {
+${visitCases}
+    }
+    throw std::invalid_argument("visit: unknown DatagramId");
+}
+
+} // namespace ${namespace}
+`;
+}
@@ -3,6 +3,7 @@ import * as fs from 'fs';
 import * as path from 'path';
 import { exec } from 'child_process';
 import { promisify } from 'util';
+import { parseDatagramXml, generateCodecHeader, generateSchemaHeader, ProgramDatagram } from './datagramCodec';
 
 const execAsync = promisify(exec);
 
@@ -293,6 +294,10 @@ export async function runRealClean(uri?: vscode.Uri) {
     await executeMake(uri, 'realclean');
 }
 
+export async function runBench(uri?: vscode.Uri) {
+    await executeMake(uri, 'bench');
+}
+
 
 /**
  * Belirli bir dizin altında Makefile dosyasını recursive olarak bul
@@ -1091,3 +1096,152 @@ function getDatagramWebviewContent(available: Array<{name: string, isLocal: bool
 </body>
 </html>`;
 }
+
+
+/**
+ * adapters/common/${MW_NAME} dizinlerini recursive olarak bul (gray, dark, white)
+ */
+function findMiddlewareDirectories(startPath: string, mwName: string): string[] {
+    const found: string[] = [];
+
+    function searchRecursive(currentPath: string, depth: number) {
+        if (depth > 12) return;
+
+        try {
+            const entries = fs.readdirSync(currentPath, { withFileTypes: true });
+            for (const entry of entries) {
+                if (!entry.isDirectory()) continue;
+                const fullPath = path.join(currentPath, entry.name);
+                if (entry.name === 'adapters') {
+                    const mwDir = path.join(fullPath, 'common', mwName);
+                    if (fs.existsSync(mwDir)) {
+                        found.push(mwDir);
+                    }
+                    continue;
+                }
+                searchRecursive(fullPath, depth + 1);
+            }
+        } catch (error) {
+            // Permission denied vs. hatalarını göz ardı et
+        }
+    }
+
+    searchRecursive(startPath, 0);
+    return found;
+}
+
+/**
+ * .../src/App/adapters/common/kafka/codec -> App::adapters::common::kafka::codec
+ */
+function codecNamespace(codecDir: string): string {
+    const parts = codecDir.split(path.sep);
+    const srcIndex = parts.lastIndexOf('src');
+    const relevant = srcIndex !== -1 ? parts.slice(srcIndex + 1) : ['app', 'codec'];
+    return relevant
+        .map(part => part.replace(/[^A-Za-z0-9_]/g, '_').replace(/^([0-9])/, '_$1'))
+        .join('::');
+}
+
+/**
+ * Seçili ve yerel datagram tanımlarından C++ binary codec header'ları üret
+ */
+export async function generateDatagramCodecs(uri?: vscode.Uri) {
+    try {
+        if (!uri || !uri.fsPath) {
+            vscode.window.showErrorMessage('No folder selected');
+            return;
+        }
+
+        const projectRoot = findProjectRoot(uri.fsPath);
+        if (!projectRoot) {
+            vscode.window.showErrorMessage('Could not find project root (.project_root marker not found)');
+            return;
+        }
+
+        const projectName = path.basename(projectRoot);
+        const mwName = process.env.MW_NAME || 'Kafka';
+        const newDatagramTarget = process.env.NEW_DATAGRAM_TARGET_NAME || 'new_datagram';
+        const globalDatagramDir = process.env.DATAGRAM_DIR_PATH;
+
+        const mwDirs = findMiddlewareDirectories(path.join(projectRoot, 'src'), mwName);
+        if (mwDirs.length === 0) {
+            vscode.window.showErrorMessage(`No adapters/common/${mwName} directory found under ${projectRoot}`);
+            return;
+        }
+
+        const generated: string[] = [];
+        const errors: string[] = [];
+
+        for (const mwDir of mwDirs) {
+            // Program XML'de seçili datagram'lar + yerel tanımlar
+            const selected = getSelectedDatagrams(path.join(mwDir, `${projectName}.xml`));
+            const names = new Set<string>(selected.map(d => d.name));
+            const localDir = path.join(mwDir, newDatagramTarget);
+            if (fs.existsSync(localDir)) {
+                fs.readdirSync(localDir)
+                    .filter(file => file.toLowerCase().endsWith('.xml'))
+                    .forEach(file => names.add(path.basename(file, '.xml')));
+            }
+            if (names.size === 0) {
+                continue;
+            }
+
+            const codecDir = path.join(mwDir, 'codec');
+            const headerExt = mwDir.includes('white_src') ? '.hpp' : '.h';
+            const namespace = codecNamespace(codecDir);
+            fs.mkdirSync(codecDir, { recursive: true });
+            const program: ProgramDatagram[] = [];
+
+            for (const name of names) {
+                // Yerel tanım global olanı ezer
+                const candidates = [path.join(localDir, `${name}.xml`)];
+                if (globalDatagramDir) {
+                    candidates.push(path.join(globalDatagramDir, `${name}.xml`));
+                }
+                const definitionPath = candidates.find(candidate => fs.existsSync(candidate));
+                if (!definitionPath) {
+                    errors.push(`${name}: definition not found`);
+                    continue;
+                }
+
+                try {
+                    const definition = parseDatagramXml(fs.readFileSync(definitionPath, 'utf-8'));
+                    const header = generateCodecHeader(definition, namespace, path.basename(definitionPath));
+                    const outputPath = path.join(codecDir, `${name}Codec${headerExt}`);
+                    fs.writeFileSync(outputPath, header, 'utf-8');
+                    generated.push(outputPath);
+                    console.log(`✅ Generated codec: ${outputPath}`);
+                    const roles = selected.find(d => d.name === name);
+                    program.push({ definition, codecHeader: path.basename(outputPath), pub: roles ? roles.pub : false, sub: roles ? roles.sub : false });
+                } catch (error) {
+                    errors.push(`${path.basename(definitionPath)}: ${error instanceof Error ? error.message : error}`);
+                }
+            }
+
+            // Tek header'da constexpr tablolar: başlangıçta XML okunmaz
+            if (program.length > 0) {
+                try {
+                    const schemaPath = path.join(codecDir, `DatagramSchema${headerExt}`);
+                    fs.writeFileSync(schemaPath, generateSchemaHeader(program, namespace, `${projectName}.xml`), 'utf-8');
+                    generated.push(schemaPath);
+                } catch (error) {
+                    errors.push(`DatagramSchema: ${error instanceof Error ? error.message : error}`);
+                }
+            }
+        }
+
+        await vscode.commands.executeCommand('workbench.files.action.refreshFilesExplorer');
+
+        if (errors.length > 0) {
+            vscode.window.showWarningMessage(
+                `Generated ${generated.length} codec header(s), ${errors.length} failed:\n${errors.map(e => `  • ${e}`).join('\n')}`
+            );
+        } else {
+            vscode.window.showInformationMessage(`Generated ${generated.length} datagram codec header(s)`);
+        }
+
+    } catch (error) {
+        vscode.window.showErrorMessage(`Failed to generate codecs: ${error}`);
+        console.error('❌ Generate codecs error:', error);
+    }
+}
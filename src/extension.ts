@@ -1,7 +1,8 @@
 import * as vscode from 'vscode';
 import { loadConfig } from './config';
 import { createMultipleProjects } from './commands/multiScaffold';
-import { addRemoveDatagrams, createNewDatagram, regenerateCode, runMake, runClean, runRealClean } from './commands/kafka';
+import { addRemoveDatagrams, createNewDatagram, generateDatagramCodecs, regenerateCode, runMake, runClean, runRealClean, runBench } from './commands/kafka';
+import { generateBenchmarks } from './commands/benchSuite';
 import { addIncomingPort, addOutgoingPort } from './commands/addPort';
 import { addIncomingAdapter, addOutgoingAdapter } from './commands/addAdapter';
 
@@ -33,6 +34,14 @@ export function activate(context: vscode.ExtensionContext) {
             await runRealClean(uri);
         }),
 
+        vscode.commands.registerCommand('hexdef.runBench', async (uri: vscode.Uri) => {
+            await runBench(uri);
+        }),
+
+        vscode.commands.registerCommand('hexdef.generateBenchmarks', async (uri: vscode.Uri) => {
+            await generateBenchmarks(uri);
+        }),
+
         vscode.commands.registerCommand('hexdef.regenerateCode', async (uri: vscode.Uri) => {
             await regenerateCode(uri);
         }),
@@ -45,6 +54,10 @@ export function activate(context: vscode.ExtensionContext) {
             await createNewDatagram(uri);
         }),
 
+        vscode.commands.registerCommand('hexdef.middleware.generateCodecs', async (uri: vscode.Uri) => {
+            await generateDatagramCodecs(uri);
+        }),
+
         vscode.commands.registerCommand('hexdef.addPort.incoming', async (uri: vscode.Uri) => {
             await addIncomingPort(uri);
         }),